@@ -129,6 +129,8 @@ void ApplicationFrame::ConnectEvents()
 {
     Connect(wxEVT_CLOSE_WINDOW,
         wxCloseEventHandler(ApplicationFrame::OnClose));
+    Connect(wxEVT_IDLE,
+        wxIdleEventHandler(ApplicationFrame::OnIdle));
     //m_manager->Connect(wxEVT_AUI_PANE_BUTTON,
     //    wxAuiManagerEventHandler(ApplicationFrame::OnAuiPaneButton), NULL, this);
     m_manager->Connect(wxEVT_AUI_PANE_CLOSE,
@@ -457,6 +459,21 @@ void ApplicationFrame::OnClose(wxCloseEvent& event)
 }
 
 
+//----------------------------------------------------------------
+void ApplicationFrame::OnIdle(wxIdleEvent& event)
+/**
+ * \brief Occurs when the application is idle. Executes the commands,
+ * which are posted with CommandList::Post().
+ * \param event Event.
+ **/
+{
+    if (Environment::Get()->GetCommandList()->ProcessPostedCommands()) {
+        event.RequestMore();
+    }
+    event.Skip();
+}
+
+
 //----------------------------------------------------------------
 void ApplicationFrame::OnAuiPaneButton(wxAuiManagerEvent& event)
 /**
@@ -70,6 +70,7 @@ class ApplicationFrame : public wxFrame
 
     private:
         void OnClose(wxCloseEvent& event);
+        void OnIdle(wxIdleEvent& event);
 
         void OnAuiPaneButton(wxAuiManagerEvent& event);
         void OnAuiPaneClose(wxAuiManagerEvent& event);
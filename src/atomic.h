@@ -0,0 +1,51 @@
+/*
+ * atomic.h - Definition of the atomic counter functions
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_ATOMIC_H_
+#define _PENV_ATOMIC_H_
+
+#include <stddef.h>
+
+
+namespace penv {
+
+/**
+ * \brief Increments a counter, which is used by more than one thread.
+ * wxWidgets 2.8 has no atomic functions, so the buildin atomic
+ * functions of the compiler are used.
+ * \param value The counter.
+ * \return The incremented value.
+ **/
+inline size_t AtomicIncrement(volatile size_t* value)
+{
+#ifdef __GNUC__ // Check if GNUC is used
+    return (__sync_add_and_fetch(value, 1));
+#else
+    #warning No atomic increment defined for the compiler
+    return (++(*value));
+#endif
+}
+
+/**
+ * \brief Decrements a counter, which is used by more than one thread.
+ * \param value The counter.
+ * \return The decremented value.
+ **/
+inline size_t AtomicDecrement(volatile size_t* value)
+{
+#ifdef __GNUC__ // Check if GNUC is used
+    return (__sync_sub_and_fetch(value, 1));
+#else
+    #warning No atomic decrement defined for the compiler
+    return (--(*value));
+#endif
+}
+
+} // namespace penv
+
+#endif // _PENV_ATOMIC_H_
@@ -13,6 +13,8 @@
 
 namespace penv {
 
+bool Command::s_profiling = false;
+
 //----------------------------------------------------------------
 Command::Command()
 /**
@@ -27,6 +29,9 @@ Command::Command()
     m_visible = true;
     m_funcarray = NULL;
     m_event = false;
+    m_profilecount = 0;
+    m_profiletotal = 0;
+    m_profilemax = 0;
 }
 
 
@@ -47,6 +52,9 @@ Command::Command(const wxString& id, const wxString& name, const wxString& help,
     m_visible = true;
     m_funcarray = NULL;
     m_event = isevent;
+    m_profilecount = 0;
+    m_profiletotal = 0;
+    m_profilemax = 0;
 }
 
 
@@ -208,24 +216,36 @@ void Command::Enable(bool enable)
     m_enabled = enable;
     // Events are not connected to toolbar item or menu item
     if (m_event) return;
-    // Find all toolbar or menuitems connected with this command
-    MenuBar* menubar = Environment::Get()->GetCommandList()->GetMenuBar();
-    ToolBarList* tbarlist = Environment::Get()->GetCommandList()->GetToolBarList();
-    // Search in MenuBar
-    Array<MenuItem>* mitems = menubar->FindMenuItems(m_id);
-    for (size_t i=0; i<mitems->Count(); ++i)
+    // Get all toolbar or menuitems connected with this command
+    //  from the item index, no need to search the menubar and toolbars
+    CommandList* cmdlist = Environment::Get()->GetCommandList();
+    Array<MenuItem>* mitems = cmdlist->GetMenuItems(m_id);
+    if (mitems != NULL)
     {
-        wxMenuItem* menuitem = (*mitems)[i]->GetMenuItem();
-        if (menuitem != NULL) menuitem->Enable(m_enabled);
+        for (size_t i=0; i<mitems->Count(); ++i)
+        {
+            wxMenuItem* menuitem = mitems->ItemUnchecked(i)->GetMenuItem();
+            if (menuitem != NULL) menuitem->Enable(m_enabled);
+        }
     }
-    // Search in ToolBars
-    Array<ToolBarItem>* tbitems = tbarlist->FindToolBarItems(m_id);
-    for (size_t i=0; i<tbitems->Count(); ++i)
+    // Enable the tool directly in its toolbar, so there is
+    //  no need to realize the toolbars again
+    Array<ToolBarItem>* tbitems = cmdlist->GetToolBarItems(m_id);
+    if (tbitems != NULL)
     {
-        wxToolBarToolBase* toolitem = (*tbitems)[i]->GetTool();
-        if (toolitem != NULL) toolitem->Enable(m_enabled);
+        for (size_t i=0; i<tbitems->Count(); ++i)
+        {
+            wxToolBarToolBase* toolitem = tbitems->ItemUnchecked(i)->GetTool();
+            if (toolitem == NULL) continue;
+            if (toolitem->GetToolBar() != NULL) {
+                // Redraw the toolbar only once at the end of a update
+                if (cmdlist->IsUpdating()) cmdlist->FreezeToolBar(toolitem->GetToolBar());
+                toolitem->GetToolBar()->EnableTool(toolitem->GetId(), m_enabled);
+            } else {
+                toolitem->Enable(m_enabled);
+            }
+        }
     }
-    tbarlist->RealizeAllToolBars();
 }
 
 
@@ -330,7 +350,7 @@ size_t Command::Connect(CommandObject* object)
     // Testen ob Funktion schon im Array existiert
     for (size_t i=0; i<m_funcarray->Count(); ++i) {
         // Testen ob schon registriert
-        if (unlikely(object->Compare(m_funcarray->ItemPtr(i)))) {
+        if (unlikely(object->Compare(m_funcarray->ItemUnchecked(i)))) {
             // Wenn schon registriert aber nicht verbunden, dann
             // wieder verbinden und ohne Warning beenden.
             if (unlikely(!object->IsConnected())) {
@@ -390,9 +410,9 @@ void Command::Disconnect(CommandObject* object)
     // Find callback
     for (size_t i=0; i<m_funcarray->Count(); ++i)
     {
-        if (object->Compare((*m_funcarray)[i]))
+        if (object->Compare(m_funcarray->ItemUnchecked(i)))
         {
-            (*m_funcarray)[i]->Connected(false);
+            m_funcarray->ItemUnchecked(i)->Connected(false);
             return;
         }
     }
@@ -413,11 +433,19 @@ void Command::Execute()
     }
     if (m_funcarray == NULL) return;
     CommandEvent event(this);
+#if penvCOMMON_COMMANDPROFILER
+    if (unlikely(s_profiling)) {
+        ExecuteProfiled(event);
+        return;
+    }
+#endif
     // Alle verbundenen Funktionen aufrufen
+    // NOTE: Callbacks could connect new callbacks, so the array
+    //   could be reallocated and iterators are not allowed here.
     for (size_t i=0; i<m_funcarray->Count(); ++i)
     {
         // Funktion holen und aufrufen
-        CommandObject* function = (*m_funcarray)[i];
+        CommandObject* function = m_funcarray->ItemUnchecked(i);
         if (likely(function->IsConnected())) {
             function->Execute(event);
         }
@@ -441,11 +469,19 @@ void Command::Execute(const wxVariant& variant)
     }
     if (m_funcarray == NULL) return;
     CommandEvent event(this, variant);
+#if penvCOMMON_COMMANDPROFILER
+    if (unlikely(s_profiling)) {
+        ExecuteProfiled(event);
+        return;
+    }
+#endif
     // Alle verbundenen Funktionen aufrufen
+    // NOTE: Callbacks could connect new callbacks, so the array
+    //   could be reallocated and iterators are not allowed here.
     for (size_t i=0; i<m_funcarray->Count(); ++i)
     {
         // Funktion holen und aufrufen
-        CommandObject* function = (*m_funcarray)[i];
+        CommandObject* function = m_funcarray->ItemUnchecked(i);
         if (likely(function->IsConnected())) {
             function->Execute(event);
         }
@@ -454,6 +490,133 @@ void Command::Execute(const wxVariant& variant)
 
 
 
+//----------------------------------------------------------------
+void Command::ExecuteProfiled(CommandEvent& event)
+/**
+ * \brief Executes all registered callbacks and measures the execution
+ * time of every callback and of the whole command.
+ * \param event The event for the callbacks.
+ **/
+{
+    wxLongLong start = PenvHelper::GetMicroseconds();
+    for (size_t i=0; i<m_funcarray->Count(); ++i)
+    {
+        CommandObject* function = m_funcarray->ItemUnchecked(i);
+        if (likely(function->IsConnected())) {
+            wxLongLong begin = PenvHelper::GetMicroseconds();
+            function->Execute(event);
+            wxLongLong time = PenvHelper::GetMicroseconds() - begin;
+            function->m_profilecount++;
+            function->m_profiletotal += time;
+            if (time > function->m_profilemax) function->m_profilemax = time;
+        }
+    }
+    wxLongLong time = PenvHelper::GetMicroseconds() - start;
+    m_profilecount++;
+    m_profiletotal += time;
+    if (time > m_profilemax) m_profilemax = time;
+}
+
+
+//----------------------------------------------------------------
+CommandObject* Command::GetCallback(size_t connectid)
+/**
+ * \brief Returns a connected callback by its connect id.
+ * \param connectid The id of the callback, see GetCallbacksCount().
+ * \return The callback or NULL if the id is out of range.
+ **/
+{
+    if (unlikely(m_funcarray == NULL || connectid >= m_funcarray->Count())) {
+        return (NULL);
+    }
+    return (m_funcarray->ItemUnchecked(connectid));
+}
+
+
+//----------------------------------------------------------------
+size_t Command::GetProfileCount() const
+/**
+ * \brief Returns how often this command was executed, while the
+ * profiler was enabled. See EnableProfiling().
+ * \return Number of profiled executions.
+ **/
+{
+    return (m_profilecount);
+}
+
+
+//----------------------------------------------------------------
+const wxLongLong& Command::GetProfileTotalTime() const
+/**
+ * \brief Returns the total execution time of this command with all
+ * its callbacks in microseconds, while the profiler was enabled.
+ * \return Total execution time in microseconds.
+ **/
+{
+    return (m_profiletotal);
+}
+
+
+//----------------------------------------------------------------
+const wxLongLong& Command::GetProfileMaxTime() const
+/**
+ * \brief Returns the longest execution time of this command with
+ * all its callbacks in microseconds, while the profiler was enabled.
+ * \return Longest execution time in microseconds.
+ **/
+{
+    return (m_profilemax);
+}
+
+
+//----------------------------------------------------------------
+void Command::ResetProfile()
+/**
+ * \brief Resets the profiling information of this command and of
+ * all its callbacks.
+ **/
+{
+    m_profilecount = 0;
+    m_profiletotal = 0;
+    m_profilemax = 0;
+    if (m_funcarray == NULL) return;
+    for (size_t i=0; i<m_funcarray->Count(); ++i)
+    {
+        m_funcarray->ItemUnchecked(i)->ResetProfile();
+    }
+}
+
+
+//----------------------------------------------------------------
+void Command::EnableProfiling(bool enable)
+/**
+ * \brief Enables or disables the profiler for all commands. If enabled,
+ * every execution of a command measures the time of the command and
+ * of all its callbacks. The profiler is only availible, if
+ * penvCOMMON_COMMANDPROFILER is true.
+ * \param enable True to enable the profiler.
+ **/
+{
+#if penvCOMMON_COMMANDPROFILER
+    s_profiling = enable;
+#else
+    wxLogWarning(_T("[penv::Command::EnableProfiling] The command profiler is not compiled into the framework."));
+#endif
+}
+
+
+//----------------------------------------------------------------
+bool Command::IsProfilingEnabled()
+/**
+ * \brief Checks if the profiler is enabled for all commands.
+ * \return True if the profiler is enabled; false otherwise.
+ **/
+{
+    return (s_profiling);
+}
+
+
+
 //----------------------------------------------------------------
 void Command::OnExecute(wxCommandEvent& event)
 /**
@@ -15,6 +15,7 @@
 #include "container/objarray.h"
 #include "commandobject.h"
 #include "commandcallback.h"
+#include "globals.h"
 
 
 namespace penv {
@@ -66,6 +67,17 @@ class Command : public wxEvtHandler
         void Execute(const wxVariant& variant);
         void OnExecute(wxCommandEvent& event);
 
+        CommandObject* GetCallback(size_t connectid);
+        size_t GetProfileCount() const;
+        const wxLongLong& GetProfileTotalTime() const;
+        const wxLongLong& GetProfileMaxTime() const;
+        void ResetProfile();
+        static void EnableProfiling(bool enable = true);
+        static bool IsProfilingEnabled();
+
+    private:
+        void ExecuteProfiled(CommandEvent& event);
+
     private:
         wxString m_id;
         wxString m_name;
@@ -75,6 +87,10 @@ class Command : public wxEvtHandler
         bool m_visible;
         bool m_event;
         Array<CommandObject>* m_funcarray;
+        size_t m_profilecount;
+        wxLongLong m_profiletotal;
+        wxLongLong m_profilemax;
+        static bool s_profiling;
 };
 
 
@@ -0,0 +1,146 @@
+/*
+ * commandeventid.h - Declaration of the CommandEventId enumerator
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_COMMANDEVENTID_H_
+#define _PENV_COMMANDEVENTID_H_
+
+
+namespace penv {
+
+
+/**
+ * \brief The CommandEventId enumerator spezifies all events, which
+ * are executed by the framework (all events beginning with 'PENV_EVT_').
+ * The value of every enumerator is also the index of the event inside
+ * the CommandList, so the framework can execute these events without
+ * a lookup in the hash map. See CommandList::InitializeEvents() for
+ * the string ids of the events. New events must be added before
+ * penvCE_Count and to the registry in the CommandList.
+ **/
+enum CommandEventId
+{
+    /**
+     * \brief PENV_EVT_WINDOW_REGISTERED
+     **/
+    penvCE_WindowRegistered = 0,
+    /**
+     * \brief PENV_EVT_WINDOW_UNREGISTERED
+     **/
+    penvCE_WindowUnregistered,
+    /**
+     * \brief PENV_EVT_WINDOW_ADDED
+     **/
+    penvCE_WindowAdded,
+    /**
+     * \brief PENV_EVT_WINDOW_CLOSED
+     **/
+    penvCE_WindowClosed,
+    /**
+     * \brief PENV_EVT_PROJECTTREECTRL_ADDCLICKED
+     **/
+    penvCE_ProjectTreeCtrlAddClicked,
+    /**
+     * \brief PENV_EVT_PROJECTTREECTRL_ITEM_ACTIVATED
+     **/
+    penvCE_ProjectTreeCtrlItemActivated,
+    /**
+     * \brief PENV_EVT_PROJECTTREECTRL_COPIED
+     **/
+    penvCE_ProjectTreeCtrlCopied,
+    /**
+     * \brief PENV_EVT_PROJECTTREECTRL_MOVED
+     **/
+    penvCE_ProjectTreeCtrlMoved,
+    /**
+     * \brief PENV_EVT_PROJECTTREECTRL_RENAMED
+     **/
+    penvCE_ProjectTreeCtrlRenamed,
+    /**
+     * \brief PENV_EVT_PROJECTTREECTRL_DELETED
+     **/
+    penvCE_ProjectTreeCtrlDeleted,
+    /**
+     * \brief PENV_EVT_PROJECT_COPIED
+     **/
+    penvCE_ProjectCopied,
+    /**
+     * \brief PENV_EVT_PROJECT_MOVED
+     **/
+    penvCE_ProjectMoved,
+    /**
+     * \brief PENV_EVT_PROJECTITEM_COPIED
+     **/
+    penvCE_ProjectItemCopied,
+    /**
+     * \brief PENV_EVT_PROJECTITEM_MOVED
+     **/
+    penvCE_ProjectItemMoved,
+    /**
+     * \brief PENV_EVT_ACTIVATED_WORKSPACE
+     **/
+    penvCE_ActivatedWorkspace,
+    /**
+     * \brief PENV_EVT_ACTIVATED_PROJECT
+     **/
+    penvCE_ActivatedProject,
+    /**
+     * \brief PENV_EVT_ACTIVATED_PROJECTITEMFILE
+     **/
+    penvCE_ActivatedProjectItemFile,
+    /**
+     * \brief PENV_EVT_ACTIVATED_PROJECTITEMDIRECTORY
+     **/
+    penvCE_ActivatedProjectItemDirectory,
+    /**
+     * \brief PENV_EVT_ACTIVATED_PROJECTITEMLINKEDITEMS
+     **/
+    penvCE_ActivatedProjectItemLinkedItems,
+    /**
+     * \brief PENV_EVT_ACTIVATED_PROJECTITEMSUBPROJECT
+     **/
+    penvCE_ActivatedProjectItemSubProject,
+    /**
+     * \brief PENV_EVT_SAVE_VIRTUAL_PROJECTITEMFILE
+     **/
+    penvCE_SaveVirtualProjectItemFile,
+    /**
+     * \brief PENV_EVT_WORKSPACES_SAVED
+     **/
+    penvCE_WorkspacesSaved,
+    /**
+     * \brief PENV_EVT_PROJECTITEM_ADDED
+     **/
+    penvCE_ProjectItemAdded,
+    /**
+     * \brief PENV_EVT_PROJECTITEM_REMOVED
+     **/
+    penvCE_ProjectItemRemoved,
+    /**
+     * \brief PENV_EVT_PROJECTITEM_RENAMED
+     **/
+    penvCE_ProjectItemRenamed,
+    /**
+     * \brief PENV_EVT_DIRECTORYWATCHER_CHANGED
+     **/
+    penvCE_DirectoryWatcherChanged,
+    /**
+     * \brief PENV_EVT_PROJECTTREEFILTER_FINISHED
+     **/
+    penvCE_ProjectTreeFilterFinished,
+    /**
+     * \brief Number of framework events, this is not an event.
+     **/
+    penvCE_Count
+};
+
+
+
+} // namespace penv
+
+
+#endif //  _PENV_COMMANDEVENTID_H_
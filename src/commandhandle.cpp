@@ -0,0 +1,83 @@
+/*
+ * commandhandle.cpp - Implementation of the CommandHandle class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "commandhandle.h"
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+CommandHandle::CommandHandle()
+/**
+ * \brief Constructor, initializes a invalid CommandHandle object.
+ **/
+{
+    m_index = (size_t)-1;
+}
+
+
+//----------------------------------------------------------------
+CommandHandle::CommandHandle(size_t index)
+/**
+ * \brief Constructor (private), initializes the CommandHandle object
+ * with the index of the command inside the CommandList.
+ * \param index Index of the command.
+ **/
+{
+    m_index = index;
+}
+
+
+//----------------------------------------------------------------
+bool CommandHandle::IsOk() const
+/**
+ * \brief Checks if this handle was resolved by a CommandList.
+ * \return True if the handle is valid; false otherwise.
+ **/
+{
+    return (m_index != (size_t)-1);
+}
+
+
+//----------------------------------------------------------------
+size_t CommandHandle::GetIndex() const
+/**
+ * \brief Returns the index of the command inside the CommandList.
+ * \return Index of the command.
+ **/
+{
+    return (m_index);
+}
+
+
+//----------------------------------------------------------------
+bool CommandHandle::operator==(const CommandHandle& handle) const
+/**
+ * \brief Compares two handles.
+ * \param handle The other handle.
+ * \return True if both handles point to the same command id.
+ **/
+{
+    return (m_index == handle.m_index);
+}
+
+
+//----------------------------------------------------------------
+bool CommandHandle::operator!=(const CommandHandle& handle) const
+/**
+ * \brief Compares two handles.
+ * \param handle The other handle.
+ * \return True if the handles point to different command ids.
+ **/
+{
+    return (m_index != handle.m_index);
+}
+
+
+} // namespace penv
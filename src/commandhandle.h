@@ -0,0 +1,53 @@
+/*
+ * commandhandle.h - Declaration of the CommandHandle class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_COMMANDHANDLE_H_
+#define _PENV_COMMANDHANDLE_H_
+
+#include <stddef.h> // for size_t
+
+
+namespace penv {
+
+
+/**
+ * \brief The CommandHandle class is a resolved command id. Use
+ * CommandList::GetHandle() once to resolve the id of a command and
+ * then use the handle to execute or get the command, without building
+ * and hashing a string on every call. A handle stays valid for the
+ * whole lifetime of the CommandList, even if the command is removed
+ * and added again, or if the command is added after the handle was
+ * resolved.<br>
+ * Example:<br>
+ * <code>
+ * CommandHandle handle = list->GetHandle(_T("EDITOR_FILE_SAVE"));<br>
+ * list->GetCommand(handle)->Enable(true);<br>
+ * list->Execute(handle);<br>
+ * </code>
+ **/
+class CommandHandle
+{
+    private:
+        friend class CommandList;
+        explicit CommandHandle(size_t index);
+    public:
+        CommandHandle();
+
+        bool IsOk() const;
+        size_t GetIndex() const;
+
+        bool operator==(const CommandHandle& handle) const;
+        bool operator!=(const CommandHandle& handle) const;
+
+    private:
+        size_t m_index;
+};
+
+} // namespace penv
+
+#endif // _PENV_COMMANDHANDLE_H_
@@ -35,6 +35,19 @@ CommandList::CommandList(ApplicationFrame* frame, wxAuiManager* manager, wxMenuB
  **/
 {
     m_hashmap = new CommandHashMap();
+    m_handlemap = new CommandHandleHashMap();
+    m_handles = new Array<Command>(false);
+    m_handleids = new wxArrayString();
+    m_posted = new Array<PostedCommand>();
+    m_postedmap = new PostedCommandHashMap();
+    m_processing = new Array<PostedCommand>();
+    m_processingindex = 0;
+    m_menuitemindex = new MenuItemIndexHashMap();
+    m_toolbaritemindex = new ToolBarItemIndexHashMap();
+    m_updatecount = 0;
+    m_frozentoolbars = new Array<wxToolBarBase>(false);
+    m_realizetoolbars = false;
+    m_updatemanager = false;
     m_toolbarlist = new ToolBarList(frame, manager);
     m_menubar = new MenuBar(menubar);
     m_shortcutlist = new ShortcutList();
@@ -52,39 +65,136 @@ CommandList::~CommandList()
     if (m_menubar != NULL) delete m_menubar;
     if (m_shortcutlist != NULL) delete m_shortcutlist;
     if (m_hashmap != NULL) delete m_hashmap;
+    if (m_handlemap != NULL) delete m_handlemap;
+    if (m_handles != NULL) delete m_handles;
+    if (m_handleids != NULL) delete m_handleids;
+    if (m_posted != NULL) delete m_posted;
+    if (m_postedmap != NULL) delete m_postedmap;
+    if (m_processing != NULL) delete m_processing;
+    if (m_frozentoolbars != NULL) delete m_frozentoolbars;
+    // Index erst nach MenuBar und ToolBars lschen, weil sich die
+    // Elemente im Destruktor aus dem Index entfernen
+    if (m_menuitemindex != NULL) {
+        MenuItemIndexHashMap::iterator itr;
+        for (itr = m_menuitemindex->begin(); itr != m_menuitemindex->end(); ++itr) {
+            delete itr->second;
+        }
+        delete m_menuitemindex;
+    }
+    if (m_toolbaritemindex != NULL) {
+        ToolBarItemIndexHashMap::iterator itr;
+        for (itr = m_toolbaritemindex->begin(); itr != m_toolbaritemindex->end(); ++itr) {
+            delete itr->second;
+        }
+        delete m_toolbaritemindex;
+    }
 }
 
 
 
+/**
+ * \brief Registry of all events, which will be executed by the penv
+ * Framework. The index of every entry is the value of the appropriate
+ * CommandEventId, so the entries must have the same order as the
+ * enumerator.
+ **/
+static const struct {
+    CommandEventId eventid;
+    const wxChar* id;
+    const wxChar* name;
+    const wxChar* help;
+} CommandEventRegistry[] = {
+    {penvCE_WindowRegistered, _T("PENV_EVT_WINDOW_REGISTERED"), _T("penv window type registered"),
+        _T("Occurs when a window type is registered to the framework.")},
+    {penvCE_WindowUnregistered, _T("PENV_EVT_WINDOW_UNREGISTERED"), _T("penv window type unregistered"),
+        _T("Occurs when a window type is unregistered from the framework.")},
+    {penvCE_WindowAdded, _T("PENV_EVT_WINDOW_ADDED"), _T("penv window added"),
+        _T("Occurs when a window is added to the framework.")},
+    {penvCE_WindowClosed, _T("PENV_EVT_WINDOW_CLOSED"), _T("penv window closed"),
+        _T("Occurs when a window is closed in the framework.")},
+
+    {penvCE_ProjectTreeCtrlAddClicked, _T("PENV_EVT_PROJECTTREECTRL_ADDCLICKED"), _T("penv projecttreecontrol add clicked"),
+        _T("Occurs when a toolbar item 'add item' is clicked in the projecttreecontrol.")},
+    {penvCE_ProjectTreeCtrlItemActivated, _T("PENV_EVT_PROJECTTREECTRL_ITEM_ACTIVATED"), _T("penv projecttreecontrol item activated"),
+        _T("Occurs when tree item is double clicked in the projecttreecontrol.")},
+
+    {penvCE_ProjectTreeCtrlCopied, _T("PENV_EVT_PROJECTTREECTRL_COPIED"), _T("penv projecttreecontrol item copied"),
+        _T("Occurs when tree item is copied in the projecttreecontrol.")},
+    {penvCE_ProjectTreeCtrlMoved, _T("PENV_EVT_PROJECTTREECTRL_MOVED"), _T("penv projecttreecontrol item moved"),
+        _T("Occurs when tree item is moved in the projecttreecontrol.")},
+    {penvCE_ProjectTreeCtrlRenamed, _T("PENV_EVT_PROJECTTREECTRL_RENAMED"), _T("penv projecttreecontrol item renamed"),
+        _T("Occurs when tree item is renamed in the projecttreecontrol.")},
+    {penvCE_ProjectTreeCtrlDeleted, _T("PENV_EVT_PROJECTTREECTRL_DELETED"), _T("penv projecttreecontrol item deleted"),
+        _T("Occurs when tree item is deleted in the projecttreecontrol.")},
+
+    {penvCE_ProjectCopied, _T("PENV_EVT_PROJECT_COPIED"), _T("penv project copied"),
+        _T("Occurs when a project is successfully copied to another workspace.")},
+    {penvCE_ProjectMoved, _T("PENV_EVT_PROJECT_MOVED"), _T("penv project moved"),
+        _T("Occurs when a project is successfully moved to another workspace.")},
+    {penvCE_ProjectItemCopied, _T("PENV_EVT_PROJECTITEM_COPIED"), _T("penv project item copied"),
+        _T("Occurs when a project is item successfully copied to another project or project item.")},
+    {penvCE_ProjectItemMoved, _T("PENV_EVT_PROJECTITEM_MOVED"), _T("penv project item moved"),
+        _T("Occurs when a project item is successfully moved to another project or project item.")},
+
+    {penvCE_ActivatedWorkspace, _T("PENV_EVT_ACTIVATED_WORKSPACE"), _T("penv workspace activated"),
+        _T("Occurs when a workspace is activated.")},
+    {penvCE_ActivatedProject, _T("PENV_EVT_ACTIVATED_PROJECT"), _T("penv project activated"),
+        _T("Occurs when a project is activated.")},
+    {penvCE_ActivatedProjectItemFile, _T("PENV_EVT_ACTIVATED_PROJECTITEMFILE"), _T("penv project item file activated"),
+        _T("Occurs when a project item file is activated.")},
+    {penvCE_ActivatedProjectItemDirectory, _T("PENV_EVT_ACTIVATED_PROJECTITEMDIRECTORY"), _T("penv project item directory activated"),
+        _T("Occurs when a project item directory is activated.")},
+    {penvCE_ActivatedProjectItemLinkedItems, _T("PENV_EVT_ACTIVATED_PROJECTITEMLINKEDITEMS"), _T("penv project item linked items activated"),
+        _T("Occurs when a project item linked items is activated.")},
+    {penvCE_ActivatedProjectItemSubProject, _T("PENV_EVT_ACTIVATED_PROJECTITEMSUBPROJECT"), _T("penv project item sub project activated"),
+        _T("Occurs when a project item sub project is activated.")},
+
+    {penvCE_SaveVirtualProjectItemFile, _T("PENV_EVT_SAVE_VIRTUAL_PROJECTITEMFILE"), _T("penv virtual project item file save"),
+        _T("Occurs when a virtual project item file should be saved.")},
+    {penvCE_WorkspacesSaved, _T("PENV_EVT_WORKSPACES_SAVED"), _T("penv workspaces saved"),
+        _T("Occurs once after the modified workspaces and projects are saved. The parameter is the number of saved files.")},
+    {penvCE_ProjectItemAdded, _T("PENV_EVT_PROJECTITEM_ADDED"), _T("penv project item added"),
+        _T("Occurs when the directory watcher has added a project item for a new file or directory. The parameter is the project item.")},
+    {penvCE_ProjectItemRemoved, _T("PENV_EVT_PROJECTITEM_REMOVED"), _T("penv project item removed"),
+        _T("Occurs before the directory watcher removes the project item of a deleted file or directory. The parameter is the project item.")},
+    {penvCE_ProjectItemRenamed, _T("PENV_EVT_PROJECTITEM_RENAMED"), _T("penv project item renamed"),
+        _T("Occurs when the directory watcher has renamed the project item of a renamed file. The parameter is the project item.")},
+    {penvCE_DirectoryWatcherChanged, _T("PENV_EVT_DIRECTORYWATCHER_CHANGED"), _T("penv directory watcher changed"),
+        _T("Posted by the directory watcher thread, when changes of the watched directories are waiting.")},
+    {penvCE_ProjectTreeFilterFinished, _T("PENV_EVT_PROJECTTREEFILTER_FINISHED"), _T("penv project tree filter finished"),
+        _T("Posted by the filter thread of the project tree, when the results of a search are waiting.")}
+};
+
+wxCOMPILE_TIME_ASSERT(WXSIZEOF(CommandEventRegistry) == penvCE_Count, CommandEventRegistryIncomplete);
+
+
+
 //----------------------------------------------------------------
 void CommandList::InitializeEvents()
 /**
  * \brief Initialize all common events which will be executed by the penv
- * Framework. All events of that type, begin with 'PENV_EVT_'.
- **/
-{
-    Add(new Command(_T("PENV_EVT_WINDOW_REGISTERED"), _T("penv window type registered"),
-        _T("Occurs when a window type is registered to the framework."), true));
-    Add(new Command(_T("PENV_EVT_WINDOW_UNREGISTERED"), _T("penv window type unregistered"),
-        _T("Occurs when a window type is unregistered from the framework."), true));
-    Add(new Command(_T("PENV_EVT_WINDOW_ADDED"), _T("penv window added"),
-        _T("Occurs when a window is added to the framework."), true));
-    Add(new Command(_T("PENV_EVT_WINDOW_CLOSED"), _T("penv window closed"),
-        _T("Occurs when a window is closed in the framework."), true));
-
-    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_ADDCLICKED"), _T("penv projecttreecontrol add clicked"),
-        _T("Occurs when a toolbar item 'add item' is clicked in the projecttreecontrol."), true));
-    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_ITEM_ACTIVATED"), _T("penv projecttreecontrol item activated"),
-        _T("Occurs when tree item is double clicked in the projecttreecontrol."), true));
-
-    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_COPIED"), _T("penv projecttreecontrol item copied"),
-        _T("Occurs when tree item is copied in the projecttreecontrol."), true));
-    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_MOVED"), _T("penv projecttreecontrol item moved"),
-        _T("Occurs when tree item is moved in the projecttreecontrol."), true));
-    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_RENAMED"), _T("penv projecttreecontrol item renamed"),
-        _T("Occurs when tree item is renamed in the projecttreecontrol."), true));
-    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_DELETED"), _T("penv projecttreecontrol item deleted"),
-        _T("Occurs when tree item is deleted in the projecttreecontrol."), true));
+ * Framework. All events of that type, begin with 'PENV_EVT_'. The events
+ * are taken from the CommandEventRegistry and are resolved first, so
+ * the handle of every event is its CommandEventId.
+ **/
+{
+    for (size_t i=0; i<(size_t)penvCE_Count; ++i)
+    {
+        wxASSERT((size_t)CommandEventRegistry[i].eventid == i);
+        CommandHandle handle = GetHandle(CommandEventRegistry[i].id);
+        // Execute(CommandEventId) benutzt die CommandEventId als Index
+        if (unlikely(handle.GetIndex() != i))
+        {
+            wxLogError(_T("[penv::CommandList::InitializeEvents] Handle of '%s' does not match its CommandEventId."),
+                CommandEventRegistry[i].id);
+            wxASSERT(handle.GetIndex() == i);
+        }
+    }
+    for (size_t i=0; i<(size_t)penvCE_Count; ++i)
+    {
+        Add(new Command(CommandEventRegistry[i].id, CommandEventRegistry[i].name,
+            CommandEventRegistry[i].help, true));
+    }
 
 //    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_COPIED_PROJECT_TO_WORKSPACE"), _T("penv project copied to workspace"),
 //        _T("Occurs when a project is copied to a workspace."), true));
@@ -102,40 +212,6 @@ void CommandList::InitializeEvents()
 //        _T("Occurs when a project item is moved to a project."), true));
 //    Add(new Command(_T("PENV_EVT_PROJECTTREECTRL_MOVED_PROJECTITEM_TO_PROJECTITEM"), _T("penv projectitem moved to projectitem"),
 //        _T("Occurs when a projectitem is moved to a projectitem."), true));
-
-
-    Add(new Command(_T("PENV_EVT_PROJECT_COPIED"), _T("penv project copied"),
-        _T("Occurs when a project is successfully copied to another workspace."), true));
-    Add(new Command(_T("PENV_EVT_PROJECT_MOVED"), _T("penv project moved"),
-        _T("Occurs when a project is successfully moved to another workspace."), true));
-    Add(new Command(_T("PENV_EVT_PROJECTITEM_COPIED"), _T("penv project item copied"),
-        _T("Occurs when a project is item successfully copied to another project or project item."), true));
-    Add(new Command(_T("PENV_EVT_PROJECTITEM_MOVED"), _T("penv project item moved"),
-        _T("Occurs when a project item is successfully moved to another project or project item."), true));
-
-
-    Add(new Command(_T("PENV_EVT_ACTIVATED_WORKSPACE"), _T("penv workspace activated"),
-        _T("Occurs when a workspace is activated."), true));
-    Add(new Command(_T("PENV_EVT_ACTIVATED_PROJECT"), _T("penv project activated"),
-        _T("Occurs when a project is activated."), true));
-    Add(new Command(_T("PENV_EVT_ACTIVATED_PROJECTITEMFILE"), _T("penv project item file activated"),
-        _T("Occurs when a project item file is activated."), true));
-    Add(new Command(_T("PENV_EVT_ACTIVATED_PROJECTITEMDIRECTORY"), _T("penv project item directory activated"),
-        _T("Occurs when a project item directory is activated."), true));
-    Add(new Command(_T("PENV_EVT_ACTIVATED_PROJECTITEMLINKEDITEMS"), _T("penv project item linked items activated"),
-        _T("Occurs when a project item linked items is activated."), true));
-    Add(new Command(_T("PENV_EVT_ACTIVATED_PROJECTITEMSUBPROJECT"), _T("penv project item sub project activated"),
-        _T("Occurs when a project item sub project is activated."), true));
-
-
-
-
-
-
-
-
-
-
 }
 
 
@@ -197,6 +273,59 @@ Command* CommandList::GetCommand(const wxString& id)
 }
 
 
+//----------------------------------------------------------------
+Command* CommandList::GetCommand(const CommandHandle& handle)
+/**
+ * \brief Returns a command by its handle. See GetHandle().
+ * \param handle Resolved command id.
+ * \return command with the given handle; or NULL if command not exists.
+ **/
+{
+    if (unlikely(handle.m_index >= m_handles->Count())) {
+        return (NULL);
+    }
+    return (m_handles->ItemUnchecked(handle.m_index));
+}
+
+
+//----------------------------------------------------------------
+Command* CommandList::GetCommand(CommandEventId eventid)
+/**
+ * \brief Returns a framework event by its CommandEventId. This is
+ * a direct access without any lookup.
+ * \param eventid Id of the framework event.
+ * \return event with the given id; or NULL if event not exists.
+ **/
+{
+    return (GetCommand(CommandHandle((size_t)eventid)));
+}
+
+
+//----------------------------------------------------------------
+CommandHandle CommandList::GetHandle(const wxString& id)
+/**
+ * \brief Resolves a command id to a handle. Use the handle to get or
+ * execute the command without any string lookup. The command must not
+ * exist, when the handle is resolved. The handle will point to the
+ * command, as soon as a command with this id is added.
+ * \param id Command ID.
+ * \return Handle for the command id.
+ **/
+{
+    CommandHandleHashMap::iterator itr = m_handlemap->find(id);
+    if (likely(itr != m_handlemap->end())) {
+        return (CommandHandle(itr->second));
+    }
+    // Neuen Eintrag fr die ID anlegen, Command wird evtl. erst spter hinzugefgt
+    size_t index = m_handles->Count();
+    CommandHashMap::iterator cmditr = m_hashmap->find(id);
+    m_handles->Add(cmditr != m_hashmap->end() ? cmditr->second : NULL);
+    m_handleids->Add(id);
+    (*m_handlemap)[id] = index;
+    return (CommandHandle(index));
+}
+
+
 //----------------------------------------------------------------
 bool CommandList::Add(Command* cmd)
 /**
@@ -228,6 +357,7 @@ bool CommandList::Add(Command* cmd)
     }
     // Hinzufgen zu Hashmap
     (*m_hashmap)[cmd->m_id] = cmd;
+    (*m_handles)[GetHandle(cmd->m_id).m_index] = cmd;
     return (true);
 }
 
@@ -252,6 +382,8 @@ bool CommandList::Remove(const wxString& id, bool free)
         wxLogError(_T("[penv::CommandList::Remove] Could not remove event or command with id \"%s\" from hash table."), id.c_str());
         return (false);
     }
+    // Handle bleibt gltig, zeigt aber auf kein Command mehr
+    (*m_handles)[(*m_handlemap)[id]] = NULL;
     return (true);
 }
 
@@ -265,6 +397,10 @@ void CommandList::Clear()
 {
     // TODO: Clear event registration if any in menubar, toolbars and shortcuts
     m_hashmap->clear();
+    for (size_t i=0; i<m_handles->Count(); ++i)
+    {
+        (*m_handles)[i] = NULL;
+    }
 }
 
 
@@ -305,6 +441,569 @@ bool CommandList::Execute(const wxString& id, const wxVariant& variant)
 }
 
 
+//----------------------------------------------------------------
+bool CommandList::Execute(const CommandHandle& handle)
+/**
+ * \brief Executes a event or command by its handle. See GetHandle().
+ * \param handle Resolved command id.
+ * \return True on succcess; false otherwise.
+ **/
+{
+    Command* cmd = GetCommand(handle);
+    if (unlikely(cmd == NULL)) {
+        wxLogWarning(_T("[penv::CommandList::Execute] The command id '%s' does not exist in this container."),
+            GetHandleId(handle).c_str());
+        return (false);
+    }
+    cmd->Execute();
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Execute(const CommandHandle& handle, const wxVariant& variant)
+/**
+ * \brief Executes a event or command by its handle. See GetHandle().
+ * \param handle Resolved command id.
+ * \param variant Additional information for the callback registered
+ * to this command or event.
+ * \return True on succcess; false otherwise.
+ **/
+{
+    Command* cmd = GetCommand(handle);
+    if (unlikely(cmd == NULL)) {
+        wxLogWarning(_T("[penv::CommandList::Execute] The command id '%s' does not exist in this container."),
+            GetHandleId(handle).c_str());
+        return (false);
+    }
+    cmd->Execute(variant);
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Execute(CommandEventId eventid)
+/**
+ * \brief Executes a framework event by its CommandEventId. This is
+ * a direct access without any lookup.
+ * \param eventid Id of the framework event.
+ * \return True on succcess; false otherwise.
+ **/
+{
+    return (Execute(CommandHandle((size_t)eventid)));
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Execute(CommandEventId eventid, const wxVariant& variant)
+/**
+ * \brief Executes a framework event by its CommandEventId. This is
+ * a direct access without any lookup.
+ * \param eventid Id of the framework event.
+ * \param variant Additional information for the callback registered
+ * to this event.
+ * \return True on succcess; false otherwise.
+ **/
+{
+    return (Execute(CommandHandle((size_t)eventid), variant));
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Post(const wxString& id, const wxVariant& variant, bool coalesce)
+/**
+ * \brief Posts a event or command, which will be executed on the
+ * main thread during idle time. This method is thread safe and can
+ * be called from worker threads.
+ * \param id The command id of the command which should be executed.
+ * \param variant Additional information for the callback registered
+ * to this command or event. A null variant executes the command
+ * without additional information.
+ * \param coalesce True if the command should not be posted again, if
+ * the same command with an equal variant is already waiting.
+ * \return True on success; false if the post was coalesced.
+ **/
+{
+    PostedCommand* posted = new PostedCommand();
+    // Tiefe Kopie, da wxString Referenzen nicht thread safe sind
+    posted->id = wxString(id.c_str());
+    posted->variant = CopyVariant(variant);
+    posted->coalesce = coalesce;
+    return (Post(posted));
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Post(const CommandHandle& handle, const wxVariant& variant, bool coalesce)
+/**
+ * \brief Posts a event or command by its handle. See Post() for more
+ * details. This method is thread safe, but the handle must be resolved
+ * on the main thread.
+ * \param handle Resolved command id.
+ * \param variant Additional information for the callback.
+ * \param coalesce True if duplicate posts should be coalesced.
+ * \return True on success; false if the post was coalesced.
+ **/
+{
+    PostedCommand* posted = new PostedCommand();
+    posted->handle = handle;
+    posted->variant = CopyVariant(variant);
+    posted->coalesce = coalesce;
+    return (Post(posted));
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Post(CommandEventId eventid, const wxVariant& variant, bool coalesce)
+/**
+ * \brief Posts a framework event by its CommandEventId. See Post() for
+ * more details. This method is thread safe.
+ * \param eventid Id of the framework event.
+ * \param variant Additional information for the callback.
+ * \param coalesce True if duplicate posts should be coalesced.
+ * \return True on success; false if the post was coalesced.
+ **/
+{
+    return (Post(CommandHandle((size_t)eventid), variant, coalesce));
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::Post(PostedCommand* posted)
+/**
+ * \brief Adds a posted command to the waiting queue and wakes up
+ * the main thread.
+ * \param posted The posted command, will be deleted by this class.
+ * \return True on success; false if the post was coalesced.
+ **/
+{
+    {
+        wxMutexLocker lock(m_postmutex);
+        if (posted->coalesce)
+        {
+            wxString key = posted->id;
+            if (posted->handle.IsOk()) key = wxString::Format(_T("#%u"), (unsigned int)posted->handle.GetIndex());
+            PostedCommandHashMap::iterator itr = m_postedmap->find(key);
+            if (itr != m_postedmap->end() && itr->second->variant == posted->variant) {
+                delete posted;
+                return (false);
+            }
+            (*m_postedmap)[key] = posted;
+        }
+        m_posted->Add(posted);
+    }
+    wxWakeUpIdle();
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+wxVariant CommandList::CopyVariant(const wxVariant& variant)
+/**
+ * \brief Copies a variant for a posted command. The name and string
+ * values are copied deeply, because the reference counting of wxString
+ * is not thread safe and the copy is used on the main thread.
+ * \param variant The variant of the posting thread.
+ * \return The copy.
+ **/
+{
+    wxString name = wxString(variant.GetName().c_str());
+    if (variant.IsNull()) {
+        wxVariant copy;
+        copy.SetName(name);
+        return (copy);
+    }
+    if (variant.GetType() == _T("string")) {
+        return (wxVariant(wxString(variant.GetString().c_str()), name));
+    }
+    if (variant.GetType() == _T("arrstring")) {
+        wxArrayString strings = variant.GetArrayString();
+        wxArrayString copies;
+        for (size_t i=0; i<strings.Count(); ++i) copies.Add(wxString(strings[i].c_str()));
+        return (wxVariant(copies, name));
+    }
+    wxVariant copy = variant;
+    copy.SetName(name);
+    return (copy);
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::ProcessPostedCommands(size_t maxcount)
+/**
+ * \brief Executes the posted commands in order of their posting.
+ * This method is called by the ApplicationFrame during idle time and
+ * must only be called from the main thread.
+ * \param maxcount Maximum number of commands to execute.
+ * \return True if there are more commands waiting; false otherwise.
+ **/
+{
+    wxASSERT(wxIsMainThread());
+    // Wartende Commands auf einen Schlag bernehmen
+    if (m_processingindex >= m_processing->Count())
+    {
+        m_processing->Clear();
+        m_processingindex = 0;
+        wxMutexLocker lock(m_postmutex);
+        if (m_posted->Count() == 0) return (false);
+        Array<PostedCommand>* swap = m_processing;
+        m_processing = m_posted;
+        m_posted = swap;
+        m_postedmap->clear();
+    }
+    size_t count = 0;
+    while (m_processingindex < m_processing->Count() && count < maxcount)
+    {
+        PostedCommand* posted = m_processing->ItemUnchecked(m_processingindex);
+        m_processingindex++;
+        count++;
+        CommandHandle handle = posted->handle;
+        if (!handle.IsOk()) handle = GetHandle(posted->id);
+        if (posted->variant.IsNull()) {
+            Execute(handle);
+        } else {
+            Execute(handle, posted->variant);
+        }
+    }
+    if (m_processingindex < m_processing->Count()) return (true);
+    wxMutexLocker lock(m_postmutex);
+    return (m_posted->Count() != 0);
+}
+
+
+//----------------------------------------------------------------
+void CommandList::ResetProfiles()
+/**
+ * \brief Resets the profiling information of all commands and
+ * their callbacks. See Command::EnableProfiling().
+ **/
+{
+    CommandHashMap::iterator itr;
+    for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
+    {
+        itr->second->ResetProfile();
+    }
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::ExportProfiles(const wxString& filename)
+/**
+ * \brief Writes the profiling information of all commands and their
+ * callbacks into a file, sorted by command id. If the filename ends
+ * with '.json' a JSON file will be written; otherwise a CSV file with
+ * the columns id, callback, count, total_us and max_us. The callback
+ * column is empty for the command itself. All times are in microseconds.
+ * \param filename The file to write.
+ * \return True on success; false otherwise.
+ **/
+{
+    bool json = filename.Lower().EndsWith(_T(".json"));
+    wxArrayString* ids = GetCommands();
+    ids->Sort();
+    wxString output;
+    if (json) output = _T("{\n  \"commands\": [");
+    else output = _T("id,callback,count,total_us,max_us\n");
+    for (size_t i=0; i<ids->Count(); ++i)
+    {
+        Command* cmd = (*m_hashmap)[ids->Item(i)];
+        if (json)
+        {
+            wxString id = cmd->GetId();
+            id.Replace(_T("\\"), _T("\\\\"));
+            id.Replace(_T("\""), _T("\\\""));
+            if (i != 0) output += _T(",");
+            output += wxString::Format(_T("\n    {\"id\": \"%s\", \"count\": %u, \"total_us\": %s, \"max_us\": %s, \"callbacks\": ["),
+                id.c_str(), (unsigned int)cmd->GetProfileCount(), cmd->GetProfileTotalTime().ToString().c_str(),
+                cmd->GetProfileMaxTime().ToString().c_str());
+            for (size_t j=0; j<cmd->GetCallbacksCount(); ++j)
+            {
+                CommandObject* callback = cmd->GetCallback(j);
+                if (j != 0) output += _T(", ");
+                output += wxString::Format(_T("{\"count\": %u, \"total_us\": %s, \"max_us\": %s}"),
+                    (unsigned int)callback->GetProfileCount(), callback->GetProfileTotalTime().ToString().c_str(),
+                    callback->GetProfileMaxTime().ToString().c_str());
+            }
+            output += _T("]}");
+        }
+        else
+        {
+            output += wxString::Format(_T("%s,,%u,%s,%s\n"), cmd->GetId().c_str(),
+                (unsigned int)cmd->GetProfileCount(), cmd->GetProfileTotalTime().ToString().c_str(),
+                cmd->GetProfileMaxTime().ToString().c_str());
+            for (size_t j=0; j<cmd->GetCallbacksCount(); ++j)
+            {
+                CommandObject* callback = cmd->GetCallback(j);
+                output += wxString::Format(_T("%s,%u,%u,%s,%s\n"), cmd->GetId().c_str(), (unsigned int)j,
+                    (unsigned int)callback->GetProfileCount(), callback->GetProfileTotalTime().ToString().c_str(),
+                    callback->GetProfileMaxTime().ToString().c_str());
+            }
+        }
+    }
+    if (json) output += _T("\n  ]\n}\n");
+    delete ids;
+
+    wxFile file;
+    if (unlikely(!file.Create(filename, true))) {
+        wxLogError(_T("[penv::CommandList::ExportProfiles] Could not create file \"%s\"."), filename.c_str());
+        return (false);
+    }
+    if (unlikely(!file.Write(output))) {
+        wxLogError(_T("[penv::CommandList::ExportProfiles] Could not write file \"%s\"."), filename.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+Array<MenuItem>* CommandList::GetMenuItems(const wxString& id)
+/**
+ * \brief Returns all menu items, which are currently displayed in the
+ * menubar for the given command. The returned array belongs to the
+ * command list and must not be deleted or modified.
+ * \param id Command id.
+ * \return Menu items of the command or NULL if there are none.
+ **/
+{
+    MenuItemIndexHashMap::iterator itr = m_menuitemindex->find(id);
+    if (itr == m_menuitemindex->end()) return (NULL);
+    return (itr->second);
+}
+
+
+//----------------------------------------------------------------
+Array<ToolBarItem>* CommandList::GetToolBarItems(const wxString& id)
+/**
+ * \brief Returns all toolbar items, which are currently displayed in
+ * a toolbar for the given command. The returned array belongs to the
+ * command list and must not be deleted or modified.
+ * \param id Command id.
+ * \return Toolbar items of the command or NULL if there are none.
+ **/
+{
+    ToolBarItemIndexHashMap::iterator itr = m_toolbaritemindex->find(id);
+    if (itr == m_toolbaritemindex->end()) return (NULL);
+    return (itr->second);
+}
+
+
+//----------------------------------------------------------------
+void CommandList::BindMenuItem(MenuItem* item)
+/**
+ * \brief Adds a menu item to the item index of its command. This
+ * method is used only framework internally by MenuItem::AddItems().
+ * \param item The menu item, which is displayed in the menubar.
+ **/
+{
+    Array<MenuItem>* items = NULL;
+    MenuItemIndexHashMap::iterator itr = m_menuitemindex->find(item->GetId());
+    if (itr == m_menuitemindex->end()) {
+        items = new Array<MenuItem>(false);
+        (*m_menuitemindex)[item->GetId()] = items;
+    } else {
+        items = itr->second;
+    }
+    for (size_t i=0; i<items->Count(); ++i) {
+        if (items->ItemUnchecked(i) == item) return;
+    }
+    items->Add(item);
+}
+
+
+//----------------------------------------------------------------
+void CommandList::UnbindMenuItem(MenuItem* item)
+/**
+ * \brief Removes a menu item from the item index. This method is
+ * used only framework internally, for example if the item is deleted.
+ * \param item The menu item to remove.
+ **/
+{
+    MenuItemIndexHashMap::iterator itr = m_menuitemindex->find(item->GetId());
+    if (itr == m_menuitemindex->end()) return;
+    Array<MenuItem>* items = itr->second;
+    for (size_t i=0; i<items->Count(); ++i)
+    {
+        if (items->ItemUnchecked(i) == item) {
+            items->Remove(i, false);
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------
+void CommandList::UnbindAllMenuItems()
+/**
+ * \brief Removes all menu items from the item index. This method
+ * is used only framework internally by MenuBar::Update(), before
+ * the menubar is build again.
+ **/
+{
+    MenuItemIndexHashMap::iterator itr;
+    for (itr = m_menuitemindex->begin(); itr != m_menuitemindex->end(); ++itr) {
+        itr->second->Clear(false);
+    }
+}
+
+
+//----------------------------------------------------------------
+void CommandList::BindToolBarItem(ToolBarItem* item)
+/**
+ * \brief Adds a toolbar item to the item index of its command. This
+ * method is used only framework internally by ToolBar::Update().
+ * \param item The toolbar item, which is displayed in a toolbar.
+ **/
+{
+    Array<ToolBarItem>* items = NULL;
+    ToolBarItemIndexHashMap::iterator itr = m_toolbaritemindex->find(item->GetId());
+    if (itr == m_toolbaritemindex->end()) {
+        items = new Array<ToolBarItem>(false);
+        (*m_toolbaritemindex)[item->GetId()] = items;
+    } else {
+        items = itr->second;
+    }
+    for (size_t i=0; i<items->Count(); ++i) {
+        if (items->ItemUnchecked(i) == item) return;
+    }
+    items->Add(item);
+}
+
+
+//----------------------------------------------------------------
+void CommandList::UnbindToolBarItem(ToolBarItem* item)
+/**
+ * \brief Removes a toolbar item from the item index. This method is
+ * used only framework internally, for example if the item is deleted.
+ * \param item The toolbar item to remove.
+ **/
+{
+    ToolBarItemIndexHashMap::iterator itr = m_toolbaritemindex->find(item->GetId());
+    if (itr == m_toolbaritemindex->end()) return;
+    Array<ToolBarItem>* items = itr->second;
+    for (size_t i=0; i<items->Count(); ++i)
+    {
+        if (items->ItemUnchecked(i) == item) {
+            items->Remove(i, false);
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------
+void CommandList::BeginUpdate()
+/**
+ * \brief Begins a update of many commands. Until EndUpdate() is
+ * called, the toolbars will not be realized and the aui manager
+ * will not be updated. Calls can be nested, every call must have
+ * a matching EndUpdate(). Use CommandUpdateLocker to make sure,
+ * that EndUpdate() will be called.
+ **/
+{
+    m_updatecount++;
+}
+
+
+//----------------------------------------------------------------
+void CommandList::EndUpdate()
+/**
+ * \brief Ends a update of many commands. If this is the outermost
+ * update, the changed toolbars will be refreshed and all deferred
+ * updates will be done once.
+ **/
+{
+    if (unlikely(m_updatecount == 0)) {
+        wxLogError(_T("[penv::CommandList::EndUpdate] EndUpdate() called without BeginUpdate()."));
+        return;
+    }
+    m_updatecount--;
+    if (m_updatecount > 0) return;
+    // Toolbars wieder zeichnen
+    for (size_t i=0; i<m_frozentoolbars->Count(); ++i)
+    {
+        m_frozentoolbars->ItemUnchecked(i)->Thaw();
+    }
+    m_frozentoolbars->Clear(false);
+    // Verzgerte Updates einmalig ausfhren
+    if (m_realizetoolbars) {
+        m_realizetoolbars = false;
+        m_updatemanager = false;
+        m_toolbarlist->RealizeAllToolBars();
+    } else if (m_updatemanager) {
+        m_updatemanager = false;
+        Environment::Get()->GetFrame()->GetManager()->Update();
+    }
+}
+
+
+//----------------------------------------------------------------
+bool CommandList::IsUpdating() const
+/**
+ * \brief Checks if a update of many commands is in progress.
+ * \return True if BeginUpdate() was called; false otherwise.
+ **/
+{
+    return (m_updatecount > 0);
+}
+
+
+//----------------------------------------------------------------
+void CommandList::FreezeToolBar(wxToolBarBase* toolbar)
+/**
+ * \brief Freezes the toolbar until the update ends, so it will be
+ * redrawn only once. This method is used only framework internally
+ * by Command::Enable(). Do not remove toolbars during a update.
+ * \param toolbar The toolbar which will be changed.
+ **/
+{
+    if (m_updatecount == 0) return;
+    for (size_t i=0; i<m_frozentoolbars->Count(); ++i) {
+        if (m_frozentoolbars->ItemUnchecked(i) == toolbar) return;
+    }
+    toolbar->Freeze();
+    m_frozentoolbars->Add(toolbar);
+}
+
+
+//----------------------------------------------------------------
+void CommandList::RealizeToolBarsLater()
+/**
+ * \brief Realizes all toolbars and updates the aui manager when the
+ * update ends. This method is used only framework internally by
+ * ToolBarList::RealizeAllToolBars().
+ **/
+{
+    m_realizetoolbars = true;
+}
+
+
+//----------------------------------------------------------------
+void CommandList::UpdateManagerLater()
+/**
+ * \brief Updates the aui manager when the update ends. This method
+ * is used only framework internally.
+ **/
+{
+    m_updatemanager = true;
+}
+
+
+//----------------------------------------------------------------
+wxString CommandList::GetHandleId(const CommandHandle& handle)
+/**
+ * \brief Returns the command id of a handle.
+ * \param handle Resolved command id.
+ * \return Command id or a empty string if the handle is invalid.
+ **/
+{
+    if (unlikely(handle.m_index >= m_handleids->Count())) {
+        return (wxEmptyString);
+    }
+    return (m_handleids->Item(handle.m_index));
+}
+
+
 
 
 //----------------------------------------------------------------
@@ -11,6 +11,10 @@
 
 #include "wxincludes.h"
 #include "command.h"
+#include "commandhandle.h"
+#include "commandeventid.h"
+#include "commandupdatelocker.h"
+#include "globals.h"
 #include "menubar.h"
 #include "toolbarlist.h"
 #include "shortcutlist.h"
@@ -32,6 +36,22 @@ namespace penv {
  * is registered in this class.<br>
  * <b>Execute a command:</b> You can execute an command simply by
  * calling the Execute() method and deliver the command ID as a parameter.<br>
+ * <b>Command handles:</b> If a command is executed often, resolve its
+ * ID once with GetHandle() and use the CommandHandle instead of the ID.
+ * The framework events can be accessed directly with their
+ * CommandEventId.<br>
+ * <b>Post a command:</b> Commands can not be executed from other threads
+ * than the main thread, because all callbacks would run on that thread.
+ * Instead use Post(), which is thread safe. The command will be executed
+ * on the main thread during idle time.<br>
+ * <b>Item index:</b> The command list knows which menu items and
+ * toolbar items are displayed for a command. The index is maintained
+ * by MenuBar::Update() and ToolBar::Update(), so that enabling or
+ * disabling a command only touches its own items.<br>
+ * <b>Update many commands:</b> If the state of many commands changes
+ * at once, use BeginUpdate() and EndUpdate() or a CommandUpdateLocker.
+ * The toolbars will be realized and the aui manager will be updated
+ * only once at the end.<br>
  * \todo Clear event registrations in menubar, toolbar and shortcut if any.
  **/
 class CommandList
@@ -49,12 +69,43 @@ class CommandList
 
         wxArrayString* GetCommands();
         Command* GetCommand(const wxString& id);
+        Command* GetCommand(const CommandHandle& handle);
+        Command* GetCommand(CommandEventId eventid);
+        CommandHandle GetHandle(const wxString& id);
+        wxString GetHandleId(const CommandHandle& handle);
         bool Add(Command* cmd);
         bool Remove(const wxString& id, bool free = true);
         void Clear();
 
         bool Execute(const wxString& id);
         bool Execute(const wxString& id, const wxVariant& variant);
+        bool Execute(const CommandHandle& handle);
+        bool Execute(const CommandHandle& handle, const wxVariant& variant);
+        bool Execute(CommandEventId eventid);
+        bool Execute(CommandEventId eventid, const wxVariant& variant);
+
+        bool Post(const wxString& id, const wxVariant& variant = wxVariant(), bool coalesce = false);
+        bool Post(const CommandHandle& handle, const wxVariant& variant = wxVariant(), bool coalesce = false);
+        bool Post(CommandEventId eventid, const wxVariant& variant = wxVariant(), bool coalesce = false);
+        bool ProcessPostedCommands(size_t maxcount = penvCOMMON_POSTEDCOMMANDSPERIDLE);
+
+        void ResetProfiles();
+        bool ExportProfiles(const wxString& filename);
+
+        Array<MenuItem>* GetMenuItems(const wxString& id);
+        Array<ToolBarItem>* GetToolBarItems(const wxString& id);
+        void BindMenuItem(MenuItem* item);
+        void UnbindMenuItem(MenuItem* item);
+        void UnbindAllMenuItems();
+        void BindToolBarItem(ToolBarItem* item);
+        void UnbindToolBarItem(ToolBarItem* item);
+
+        void BeginUpdate();
+        void EndUpdate();
+        bool IsUpdating() const;
+        void FreezeToolBar(wxToolBarBase* toolbar);
+        void RealizeToolBarsLater();
+        void UpdateManagerLater();
 
 
     private: // Wird nur von Evironment aufgerufen!!
@@ -65,9 +116,42 @@ class CommandList
         wxXmlNode* WriteToolBarsConfiguration();
         wxXmlNode* WriteShortcutsConfiguration();
 
+    private:
+        /**
+         * \brief A command which was posted and waits for its execution.
+         * Either the handle or the id is set.
+         **/
+        struct PostedCommand
+        {
+            CommandHandle handle;
+            wxString id;
+            wxVariant variant;
+            bool coalesce;
+        };
+        bool Post(PostedCommand* posted);
+        static wxVariant CopyVariant(const wxVariant& variant);
+
     private:
         WX_DECLARE_STRING_HASH_MAP(Command*, CommandHashMap);
         CommandHashMap* m_hashmap;
+        WX_DECLARE_STRING_HASH_MAP(size_t, CommandHandleHashMap);
+        CommandHandleHashMap* m_handlemap;
+        Array<Command>* m_handles;
+        wxArrayString* m_handleids;
+        WX_DECLARE_STRING_HASH_MAP(PostedCommand*, PostedCommandHashMap);
+        wxMutex m_postmutex;
+        Array<PostedCommand>* m_posted;
+        PostedCommandHashMap* m_postedmap;
+        Array<PostedCommand>* m_processing;
+        size_t m_processingindex;
+        WX_DECLARE_STRING_HASH_MAP(Array<MenuItem>*, MenuItemIndexHashMap);
+        MenuItemIndexHashMap* m_menuitemindex;
+        WX_DECLARE_STRING_HASH_MAP(Array<ToolBarItem>*, ToolBarItemIndexHashMap);
+        ToolBarItemIndexHashMap* m_toolbaritemindex;
+        size_t m_updatecount;
+        Array<wxToolBarBase>* m_frozentoolbars;
+        bool m_realizetoolbars;
+        bool m_updatemanager;
         ToolBarList* m_toolbarlist;
         MenuBar* m_menubar;
         ShortcutList* m_shortcutlist;
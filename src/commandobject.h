@@ -28,7 +28,8 @@ class CommandObject
         /**
          * \brief Constructor, initializes this class.
          **/
-        CommandObject() : m_connected(true) {}
+        CommandObject() : m_connected(true), m_profilecount(0),
+            m_profiletotal(0), m_profilemax(0) {}
 
         /**
          * \brief Destructor.
@@ -67,10 +68,45 @@ class CommandObject
          **/
         inline bool IsConnected() const
         { return (m_connected); }
+
+    public:
+        /**
+         * \brief Returns how often this callback was executed, while
+         * the profiler was enabled. See Command::EnableProfiling().
+         * \return Number of profiled executions.
+         **/
+        inline size_t GetProfileCount() const
+        { return (m_profilecount); }
+
+        /**
+         * \brief Returns the total execution time of this callback
+         * in microseconds, while the profiler was enabled.
+         * \return Total execution time in microseconds.
+         **/
+        inline const wxLongLong& GetProfileTotalTime() const
+        { return (m_profiletotal); }
+
+        /**
+         * \brief Returns the longest execution time of this callback
+         * in microseconds, while the profiler was enabled.
+         * \return Longest execution time in microseconds.
+         **/
+        inline const wxLongLong& GetProfileMaxTime() const
+        { return (m_profilemax); }
+
+        /**
+         * \brief Resets the profiling information of this callback.
+         **/
+        inline void ResetProfile()
+        { m_profilecount = 0; m_profiletotal = 0; m_profilemax = 0; }
+
     public:
         bool m_connected;
         void* m_ptr1;
         void* m_ptr2;
+        size_t m_profilecount;
+        wxLongLong m_profiletotal;
+        wxLongLong m_profilemax;
 };
 
 
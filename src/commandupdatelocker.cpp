@@ -0,0 +1,57 @@
+/*
+ * commandupdatelocker.cpp - Implementation of the CommandUpdateLocker class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "commandupdatelocker.h"
+#include "commandlist.h"
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+CommandUpdateLocker::CommandUpdateLocker(CommandList* list)
+/**
+ * \brief Constructor, begins a update of the command list.
+ * \param list The command list or NULL to do nothing.
+ **/
+{
+    m_list = list;
+    if (m_list != NULL) m_list->BeginUpdate();
+}
+
+
+//----------------------------------------------------------------
+CommandUpdateLocker::~CommandUpdateLocker()
+/**
+ * \brief Destructor, ends the update of the command list.
+ **/
+{
+    if (m_list != NULL) m_list->EndUpdate();
+}
+
+
+//----------------------------------------------------------------
+CommandUpdateLocker::CommandUpdateLocker(const CommandUpdateLocker& locker)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+CommandUpdateLocker& CommandUpdateLocker::operator=(const CommandUpdateLocker& locker)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+} // namespace penv
@@ -0,0 +1,47 @@
+/*
+ * commandupdatelocker.h - Declaration of the CommandUpdateLocker class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_COMMANDUPDATELOCKER_H_
+#define _PENV_COMMANDUPDATELOCKER_H_
+
+
+namespace penv {
+
+class CommandList;
+
+/**
+ * \brief The CommandUpdateLocker class calls CommandList::BeginUpdate()
+ * in the constructor and CommandList::EndUpdate() in the destructor.
+ * While the locker exists the toolbars are not realized and the aui
+ * manager is not updated, this will be done once when the locker is
+ * destroyed. Use it when many commands change their state at once.<br>
+ * Example:<br>
+ * <code>
+ * {<br>
+ * &nbsp;&nbsp;CommandUpdateLocker locker(Environment::Get()->GetCommandList());<br>
+ * &nbsp;&nbsp;list->GetCommand(handle1)->Enable(false);<br>
+ * &nbsp;&nbsp;list->GetCommand(handle2)->Enable(false);<br>
+ * } // Toolbars will be updated here<br>
+ * </code>
+ **/
+class CommandUpdateLocker
+{
+    public:
+        CommandUpdateLocker(CommandList* list);
+        ~CommandUpdateLocker();
+    private:
+        CommandUpdateLocker(const CommandUpdateLocker& locker);
+        CommandUpdateLocker& operator=(const CommandUpdateLocker& locker);
+
+    private:
+        CommandList* m_list;
+};
+
+} // namespace penv
+
+#endif // _PENV_COMMANDUPDATELOCKER_H_
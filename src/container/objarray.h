@@ -30,17 +30,51 @@
 
 namespace penv{
 
+/**
+ * \brief The ArrayGrowth enumerator spezifies how the capacity
+ * of an Array is increased, if a new element does not fit into
+ * the allocated memory.
+ **/
+enum ArrayGrowth
+{
+    /**
+     * \brief The capacity is increased by the join size. This keeps
+     * the memory overhead small, but adding n elements costs O(n^2).
+     **/
+    penvAG_Fixed,
+    /**
+     * \brief The capacity is doubled (at least by the join size).
+     * Adding an element is amortized O(1).
+     **/
+    penvAG_Geometric
+};
+
+
 /**
  * \brief The Array template class is a array implementation.
  * This array implementation only stores pointer to any type.
  * Because this array stores only pointers, it is allowed to
- * store a NULL pointer into this array.
+ * store a NULL pointer into this array.<br>
+ * The elements are stored contiguous, so the iterators are
+ * plain pointers into the array and can be used with the
+ * algorithms of the standard library.<br>
+ * Example:<br>
+ * <code>
+ * Array<MyClass>::iterator itr = std::find(array.begin(), array.end(), element);<br>
+ * </code>
+ * Iterators and data() are invalidated by every operation which
+ * changes the capacity of the array (Add(), Insert(), Alloc(), ...).
  **/
 template <typename T>
 class Array
 {
+    public:
+        typedef T* value_type;
+        typedef T** iterator;
+        typedef T* const* const_iterator;
+
 	public:
-		Array(bool free = true);
+		Array(bool free = true, ArrayGrowth growth = penvAG_Geometric);
 		~Array();
     private:
         Array(Array& copy);
@@ -51,6 +85,52 @@ class Array
         T* ItemPtr(const size_t index);
         T& ItemRef(const size_t index);
 
+        /**
+         * \brief Returns a element by its index without any range
+         * check. Use only in loops where the index is known to be
+         * smaller than Count().
+         * \param index Index of an element in the array.
+         * \return Element at the index.
+         **/
+        inline T* ItemUnchecked(const size_t index) const
+        { return (m_array[index]); }
+
+        /**
+         * \brief Returns a iterator to the first element.
+         * \return Iterator to the first element.
+         **/
+        inline iterator begin()
+        { return (m_array); }
+
+        /**
+         * \brief Returns a iterator behind the last element.
+         * \return Iterator behind the last element.
+         **/
+        inline iterator end()
+        { return (m_array+m_size); }
+
+        /**
+         * \brief Returns a constant iterator to the first element.
+         * \return Iterator to the first element.
+         **/
+        inline const_iterator begin() const
+        { return (m_array); }
+
+        /**
+         * \brief Returns a constant iterator behind the last element.
+         * \return Iterator behind the last element.
+         **/
+        inline const_iterator end() const
+        { return (m_array+m_size); }
+
+        /**
+         * \brief Returns the contiguous memory block of the elements.
+         * The block contains Count() elements.
+         * \return Pointer to the first element.
+         **/
+        inline T** data()
+        { return (m_array); }
+
 		void Add(T* element);
 		bool Insert(size_t index, T* element);
 		bool Del(T*& element, bool free = true);
@@ -60,6 +140,7 @@ class Array
 
 		void Shrink();
 		void Alloc(size_t size);
+		void Reserve(size_t capacity);
 
 		void Clear(bool free = true);
 
@@ -80,6 +161,30 @@ class Array
         inline size_t GetJoinSize() const
         { return (m_joinsize); }
 
+        /**
+         * \brief Sets the growth policy, which is used for
+         * reallocation of the dynamic array.
+         * \param growth Growth policy.
+         **/
+        inline void SetGrowth(ArrayGrowth growth)
+        { m_growth = growth; }
+
+        /**
+         * \brief Returns the growth policy, which is used for
+         * reallocation of the dynamic array.
+         * \return Growth policy.
+         **/
+        inline ArrayGrowth GetGrowth() const
+        { return (m_growth); }
+
+        /**
+         * \brief Returns the number of elements which fit into the
+         * array without reallocation.
+         * \return Capacity of the array.
+         **/
+        inline size_t Capacity() const
+        { return (m_allocsize); }
+
         /**
          * \brief Sets the empty element of this array.
          * \param empty Empty element of this array.
@@ -98,19 +203,24 @@ class Array
          * \brief Returns the number of elements in the array.
          * \return Number elements in the array.
          **/
-		inline size_t Count()
+		inline size_t Count() const
 		{ return (m_size); }
 
         #ifdef __ARRAY_DEBUG__
 		void Print(bool alloc = false);
 		#endif
 
+    private:
+        void Grow();
+        void Realloc(size_t capacity);
+
 	public:
         T** m_array;
         size_t m_size;
         size_t m_allocsize;
         T* m_empty;
         size_t m_joinsize;
+        ArrayGrowth m_growth;
         bool m_free;
 };
 
@@ -119,11 +229,12 @@ class Array
 
 //----------------------------------------------------------------
 template <typename T>
-Array<T>::Array(bool free)
+Array<T>::Array(bool free, ArrayGrowth growth)
 /**
  * \brief Constructor, initializes the Array<T> object.
  * \param free If set to true, the Del(), Remove(), Clear() and
  * Destructor, will not free any memory.
+ * \param growth Growth policy for reallocations, see ArrayGrowth.
  **/
 {
 	// Besorge Speicher ...
@@ -136,6 +247,7 @@ Array<T>::Array(bool free)
     m_allocsize = m_joinsize;
 	// Initalisiere das Array
 	m_array = (T**)memset((void*)m_array, 0, m_allocsize*sizeof(T*));
+	m_growth = growth;
 	m_free = free;
 }
 
@@ -229,7 +341,7 @@ void Array<T>::Add(T* element)
  */
 {
 	if (unlikely(m_size >= m_allocsize)) {
-		Alloc(m_joinsize);
+		Grow();
 	}
 	m_array[m_size] = element;
 	m_size++;
@@ -255,10 +367,10 @@ bool Array<T>::Insert(size_t index, T* element)
         return (true);
     }
     if (unlikely(m_allocsize <= m_size)) {
-        Alloc(m_joinsize);
+        Grow();
     }
-    size_t typesize = sizeof(T*);
-    memcpy(m_array+index+1, m_array+index, (m_size-index)*typesize);
+    // Regions overlap, therefore memmove() instead of memcpy()
+    memmove(m_array+index+1, m_array+index, (m_size-index)*sizeof(T*));
     m_array[index] = element;
 	m_size++;
     return (true);
@@ -358,7 +470,8 @@ bool Array<T>::Remove(size_t index, bool free)
         return (false);
     }
     if (free) delete m_array[index];
-    memcpy(m_array+index, m_array+index+1, (m_size-index)*sizeof(T*));
+    // Regions overlap, therefore memmove() instead of memcpy()
+    memmove(m_array+index, m_array+index+1, (m_size-index-1)*sizeof(T*));
     m_size--;
     m_array[m_size] = NULL;
     return (true);
@@ -398,17 +511,63 @@ void Array<T>::Alloc(size_t size)
  */
 {
     if (unlikely(size == 0)) return;
+    Realloc(m_allocsize+size);
+}
+
+
+//----------------------------------------------------------------
+template <typename T>
+void Array<T>::Reserve(size_t capacity)
+/**
+ * Increases the capacity of the array, so that at least capacity
+ * elements fit into the array without reallocation. Does nothing
+ * if the capacity is already big enough.
+ * \param capacity The minimum capacity of the array.
+ */
+{
+    if (capacity <= m_allocsize) return;
+    Realloc(capacity);
+}
+
+
+//----------------------------------------------------------------
+template <typename T>
+void Array<T>::Grow()
+/**
+ * Increases the capacity of the array after the growth policy,
+ * see SetGrowth(). Called if the array is full.
+ */
+{
+    size_t size = m_joinsize;
+    if (m_growth == penvAG_Geometric && m_allocsize > size) {
+        size = m_allocsize;
+    }
+    if (unlikely(size == 0)) size = 1;
+    Realloc(m_allocsize+size);
+}
+
+
+//----------------------------------------------------------------
+template <typename T>
+void Array<T>::Realloc(size_t capacity)
+/**
+ * Moves the elements of the array into a new memory block with
+ * the given capacity. Only the unused part of the new memory
+ * block will be initialized.
+ * \param capacity The new capacity, must be >= Count().
+ */
+{
 	// Versuche neuen Speicher zu besorgen.
-	T** newarray = new T*[m_allocsize+size];
-	// Initalisiere restliche Elemente des Array
-	newarray = (T**)memset((void*)(newarray), 0, (m_allocsize+size)*sizeof(T*));
+	T** newarray = new T*[capacity];
 	// Kopiere alle Elemente vom alten Array in das Neue
-    newarray = (T**)memcpy(newarray, m_array, m_allocsize*sizeof(T*));
+	if (m_size > 0) memcpy(newarray, m_array, m_size*sizeof(T*));
+	// Initalisiere restliche Elemente des Array
+	memset((void*)(newarray+m_size), 0, (capacity-m_size)*sizeof(T*));
     // Neues Array setzten und altes lschen
     delete [] m_array;
     m_array = newarray;
     // Gre setzten
-    m_allocsize += size;
+    m_allocsize = capacity;
 }
 
 
@@ -0,0 +1,1125 @@
+/*
+ * directorywatcher.cpp - Implementation of the DirectoryWatcher class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "directorywatcher.h"
+#include "expect.h"
+#include "environment.h"
+#include "commandlist.h"
+#include "projectitemlist.h"
+#include "projectitemfile.h"
+#include "projectitemdirectory.h"
+
+#ifdef __LINUX__
+    #include <sys/inotify.h>
+    #include <poll.h>   // for poll()
+    #include <unistd.h> // for read(), write(), pipe()
+    #include <fcntl.h>  // for fcntl()
+    #include <errno.h>
+#endif
+
+
+namespace penv {
+
+
+/**
+ * \brief The DirectoryWatcherThread class is the worker thread of the
+ * DirectoryWatcher. It watches the directories, collects the changes and
+ * posts them to the main thread. All members are only used by this
+ * thread, the requests and the changes are exchanged with the watcher
+ * under the lock of the watcher.
+ **/
+class DirectoryWatcherThread : public wxThread
+{
+    public:
+        DirectoryWatcherThread(DirectoryWatcher* watcher);
+        ~DirectoryWatcherThread();
+        virtual ExitCode Entry();
+        void Wake();
+        bool IsPolling() const;
+
+    private:
+        /**
+         * \brief A watched directory. The entries are only stored if
+         * the directory is polled, directories end with a separator.
+         **/
+        struct Directory
+        {
+            wxString path;
+            int descriptor;
+            wxArrayString entries;
+        };
+
+        /**
+         * \brief A not yet posted change of an entry, state is 1 if
+         * the entry was added, -1 if it was removed and 0 if it was
+         * renamed to newname.
+         **/
+        struct Pending
+        {
+            wxString directory;
+            wxString name;
+            wxString newname;
+            int state;
+            bool isdirectory;
+            bool rescan;
+        };
+
+        /**
+         * \brief A file, which was renamed inside of a directory.
+         **/
+        struct Rename
+        {
+            wxString directory;
+            wxString oldname;
+            wxString newname;
+        };
+
+        WX_DECLARE_STRING_HASH_MAP(Directory*, DirectoryHashMap);
+        WX_DECLARE_HASH_MAP(int, Directory*, wxIntegerHash, wxIntegerEqual, DescriptorHashMap);
+        WX_DECLARE_STRING_HASH_MAP(Pending*, PendingHashMap);
+        WX_DECLARE_HASH_MAP(wxUint32, wxString, wxIntegerHash, wxIntegerEqual, MoveHashMap);
+
+        bool ProcessRequests();
+        void RunNotify();
+        void RunPolling();
+        void ReadNotify();
+        void PollDirectory(Directory* directory);
+        void AddPending(const wxString& directory, const wxString& name, bool isdirectory, bool added);
+        void AddRescan(const wxString& directory);
+        void AddRename(const wxString& directory, const wxString& oldname, const wxString& newname);
+        long GetTimeout(wxLongLong now) const;
+        void Flush();
+
+    private:
+        DirectoryWatcher* m_watcher;
+        bool m_polling;
+        long m_delay;
+        DirectoryHashMap m_directories;
+        DescriptorHashMap m_descriptors;
+        PendingHashMap m_pending;
+        MoveHashMap m_moves;
+        Array<Rename> m_renames;
+        wxLongLong m_first;
+        wxLongLong m_last;
+        wxSemaphore m_semaphore;
+        int m_notify;
+        int m_pipe[2];
+};
+
+
+
+//----------------------------------------------------------------
+static bool IsIgnored(const wxString& name)
+/**
+ * \brief Returns true for entries, which get no project item.
+ * \param name Name of the file or directory.
+ * \return True for hidden files and backup files.
+ **/
+{
+    return (name.IsEmpty() || name[0] == _T('.') || name.Last() == _T('~'));
+}
+
+
+//----------------------------------------------------------------
+static void ListDirectory(const wxString& path, wxArrayString& entries)
+/**
+ * \brief Lists the files and directories of a directory sorted by
+ * name. The names of the directories end with a separator.
+ * \param path The directory.
+ * \param entries Receives the entries.
+ **/
+{
+    entries.Clear();
+    // Vorher pruefen, damit wxDir keine Fehler loggt
+    if (!wxDir::Exists(path)) return;
+    wxDir dir(path);
+    if (unlikely(!dir.IsOpened())) return;
+    wxString name;
+    bool found = dir.GetFirst(&name, wxEmptyString, wxDIR_FILES);
+    while (found)
+    {
+        if (!IsIgnored(name)) entries.Add(name);
+        found = dir.GetNext(&name);
+    }
+    found = dir.GetFirst(&name, wxEmptyString, wxDIR_DIRS);
+    while (found)
+    {
+        if (!IsIgnored(name)) entries.Add(name + wxFILE_SEP_PATH);
+        found = dir.GetNext(&name);
+    }
+    entries.Sort();
+}
+
+
+//----------------------------------------------------------------
+static wxString GetKey(const wxString& path)
+/**
+ * \brief Returns the key of a path for the index of the project
+ * items. On case insensitive file systems the key is lower case.
+ * \param path Full path of a file or directory.
+ * \return The key.
+ **/
+{
+    if (wxFileName::IsCaseSensitive()) return (path);
+    return (path.Lower());
+}
+
+
+
+//----------------------------------------------------------------
+DirectoryWatcherThread::DirectoryWatcherThread(DirectoryWatcher* watcher)
+    : wxThread(wxTHREAD_JOINABLE), m_renames(true)
+/**
+ * \brief Constructor, initializes the DirectoryWatcherThread object.
+ * Uses inotify if it is available; otherwise the directories
+ * are polled.
+ * \param watcher The watcher, which owns this thread.
+ **/
+{
+    m_watcher = watcher;
+    m_polling = true;
+    m_notify = -1;
+    m_pipe[0] = -1;
+    m_pipe[1] = -1;
+#ifdef __LINUX__
+    m_notify = inotify_init();
+    if (m_notify >= 0 && pipe(m_pipe) == 0)
+    {
+        fcntl(m_notify, F_SETFL, fcntl(m_notify, F_GETFL) | O_NONBLOCK);
+        fcntl(m_notify, F_SETFD, FD_CLOEXEC);
+        for (size_t i=0; i<2; ++i)
+        {
+            fcntl(m_pipe[i], F_SETFL, fcntl(m_pipe[i], F_GETFL) | O_NONBLOCK);
+            fcntl(m_pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+        m_polling = false;
+    }
+    else if (m_notify >= 0)
+    {
+        close(m_notify);
+        m_notify = -1;
+    }
+#endif
+    // Beim Pollen wird bis zur naechsten Runde ohne Aenderung gesammelt
+    m_delay = (m_polling ? penvDIRECTORYWATCHER_POLLINTERVAL : penvDIRECTORYWATCHER_DELAY);
+}
+
+
+//----------------------------------------------------------------
+DirectoryWatcherThread::~DirectoryWatcherThread()
+/**
+ * \brief Destructor, stops watching all directories.
+ **/
+{
+    DirectoryHashMap::iterator itr;
+    for (itr = m_directories.begin(); itr != m_directories.end(); ++itr)
+    {
+        delete itr->second;
+    }
+    PendingHashMap::iterator pending;
+    for (pending = m_pending.begin(); pending != m_pending.end(); ++pending)
+    {
+        delete pending->second;
+    }
+#ifdef __LINUX__
+    if (m_notify >= 0) close(m_notify);
+    if (m_pipe[0] >= 0) close(m_pipe[0]);
+    if (m_pipe[1] >= 0) close(m_pipe[1]);
+#endif
+}
+
+
+//----------------------------------------------------------------
+wxThread::ExitCode DirectoryWatcherThread::Entry()
+/**
+ * \brief Entry point of the worker thread. Watches the directories
+ * until the watcher is stopped.
+ * \return Always 0.
+ **/
+{
+    if (m_polling) {
+        RunPolling();
+    } else {
+        RunNotify();
+    }
+    return (0);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::Wake()
+/**
+ * \brief Wakes up the thread, so it processes the waiting requests.
+ * Can be called from any thread.
+ **/
+{
+#ifdef __LINUX__
+    if (!m_polling)
+    {
+        char byte = 0;
+        if (write(m_pipe[1], &byte, 1) < 0) {
+            // Pipe ist voll, der Thread wird sowieso geweckt
+        }
+        return;
+    }
+#endif
+    m_semaphore.Post();
+}
+
+
+//----------------------------------------------------------------
+bool DirectoryWatcherThread::IsPolling() const
+/**
+ * \brief Returns true if the directories are polled.
+ * \return True if polled; false if inotify is used.
+ **/
+{
+    return (m_polling);
+}
+
+
+//----------------------------------------------------------------
+bool DirectoryWatcherThread::ProcessRequests()
+/**
+ * \brief Takes the waiting requests from the watcher and starts or
+ * stops watching the directories.
+ * \return False if the thread should stop; true otherwise.
+ **/
+{
+    Array<DirectoryWatcher::Change> requests(true);
+    {
+        wxMutexLocker lock(m_watcher->m_mutex);
+        if (m_watcher->m_stop) return (false);
+        for (size_t i=0; i<m_watcher->m_requests->Count(); ++i)
+        {
+            requests.Add(m_watcher->m_requests->ItemUnchecked(i));
+        }
+        m_watcher->m_requests->Clear(false);
+    }
+    for (size_t i=0; i<requests.Count(); ++i)
+    {
+        DirectoryWatcher::Change* request = requests.ItemUnchecked(i);
+        const wxString& path = request->directory;
+        DirectoryHashMap::iterator itr = m_directories.find(path);
+        if (request->type == DirectoryWatcher::ChangeWatch)
+        {
+            if (itr != m_directories.end()) continue;
+            Directory* directory = new Directory();
+            // Tiefe Kopie, der Request wird hier geloescht
+            directory->path = wxString(path.c_str());
+            directory->descriptor = -1;
+            m_directories[directory->path] = directory;
+#ifdef __LINUX__
+            if (!m_polling)
+            {
+                directory->descriptor = inotify_add_watch(m_notify, directory->path.fn_str(),
+                    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+                if (directory->descriptor >= 0) m_descriptors[directory->descriptor] = directory;
+            }
+#endif
+            if (m_polling) ListDirectory(directory->path, directory->entries);
+        }
+        else if (request->type == DirectoryWatcher::ChangeUnwatch)
+        {
+            if (itr == m_directories.end()) continue;
+            Directory* directory = itr->second;
+#ifdef __LINUX__
+            if (directory->descriptor >= 0)
+            {
+                inotify_rm_watch(m_notify, directory->descriptor);
+                m_descriptors.erase(directory->descriptor);
+            }
+#endif
+            m_directories.erase(itr);
+            delete directory;
+        }
+        else if (request->type == DirectoryWatcher::ChangeRescan)
+        {
+            AddRescan(path);
+        }
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::RunNotify()
+/**
+ * \brief Waits for inotify events and requests, until the watcher
+ * is stopped.
+ **/
+{
+#ifdef __LINUX__
+    while (ProcessRequests())
+    {
+        wxLongLong now = wxGetLocalTimeMillis();
+        long timeout = GetTimeout(now);
+        if (timeout == 0) {
+            Flush();
+            timeout = -1;
+        }
+        pollfd fds[2];
+        fds[0].fd = m_notify;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = m_pipe[0];
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        if (poll(fds, 2, (int)timeout) < 0 && errno != EINTR) break;
+        if (fds[1].revents & POLLIN)
+        {
+            char bytes[64];
+            while (read(m_pipe[0], bytes, sizeof(bytes)) > 0);
+        }
+        if (fds[0].revents & POLLIN) ReadNotify();
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::RunPolling()
+/**
+ * \brief Compares the contents of the directories every
+ * penvDIRECTORYWATCHER_POLLINTERVAL milliseconds, until the
+ * watcher is stopped.
+ **/
+{
+    wxLongLong nextpoll = wxGetLocalTimeMillis() + penvDIRECTORYWATCHER_POLLINTERVAL;
+    while (ProcessRequests())
+    {
+        wxLongLong now = wxGetLocalTimeMillis();
+        if (now >= nextpoll)
+        {
+            DirectoryHashMap::iterator itr;
+            for (itr = m_directories.begin(); itr != m_directories.end(); ++itr)
+            {
+                PollDirectory(itr->second);
+            }
+            nextpoll = now + penvDIRECTORYWATCHER_POLLINTERVAL;
+        }
+        long timeout = GetTimeout(now);
+        if (timeout == 0) {
+            Flush();
+            timeout = -1;
+        }
+        long polltimeout = (nextpoll - now).ToLong();
+        if (timeout < 0 || timeout > polltimeout) timeout = polltimeout;
+        m_semaphore.WaitTimeout(timeout > 0 ? timeout : 1);
+    }
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::ReadNotify()
+/**
+ * \brief Reads all waiting inotify events and collects the changes.
+ **/
+{
+#ifdef __LINUX__
+    // Als inotify_event deklariert, damit der Puffer ausgerichtet ist
+    inotify_event buffer[1024];
+    ssize_t length;
+    while ((length = read(m_notify, buffer, sizeof(buffer))) > 0)
+    {
+        char* pos = (char*)buffer;
+        char* last = pos + length;
+        while (pos < last)
+        {
+            inotify_event* event = (inotify_event*)pos;
+            pos += sizeof(inotify_event) + event->len;
+            if (unlikely(event->mask & IN_Q_OVERFLOW))
+            {
+                // Ereignisse verloren, alle Verzeichnisse neu einlesen
+                DirectoryHashMap::iterator itr;
+                for (itr = m_directories.begin(); itr != m_directories.end(); ++itr)
+                {
+                    AddRescan(itr->second->path);
+                }
+                continue;
+            }
+            DescriptorHashMap::iterator itr = m_descriptors.find(event->wd);
+            if (itr == m_descriptors.end()) continue;
+            Directory* directory = itr->second;
+            if (event->mask & IN_IGNORED)
+            {
+                // Das Verzeichnis wurde geloescht
+                directory->descriptor = -1;
+                m_descriptors.erase(itr);
+                continue;
+            }
+            if (event->len == 0) continue;
+            wxString name(event->name, *wxConvFileName);
+            if (IsIgnored(name)) continue;
+            bool isdirectory = ((event->mask & IN_ISDIR) != 0);
+            if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                AddPending(directory->path, name, isdirectory, false);
+            }
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                AddPending(directory->path, name, isdirectory, true);
+            }
+            if ((event->mask & IN_MOVED_FROM) && !isdirectory) {
+                m_moves[event->cookie] = directory->path + _T('\n') + name;
+            }
+            if ((event->mask & IN_MOVED_TO) && !isdirectory)
+            {
+                MoveHashMap::iterator move = m_moves.find(event->cookie);
+                if (move == m_moves.end()) continue;
+                wxString from = move->second;
+                m_moves.erase(move);
+                // Nur innerhalb eines Verzeichnisses bleibt das Element erhalten
+                if (from.BeforeLast(_T('\n')) == directory->path) {
+                    AddRename(directory->path, from.AfterLast(_T('\n')), name);
+                }
+            }
+        }
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::PollDirectory(Directory* directory)
+/**
+ * \brief Compares the contents of a directory with the contents
+ * of the last poll and collects the differences.
+ * \param directory The directory.
+ **/
+{
+    wxArrayString entries;
+    ListDirectory(directory->path, entries);
+    const wxArrayString& old = directory->entries;
+    size_t i = 0;
+    size_t j = 0;
+    // Beide Listen sind sortiert
+    while (i < old.Count() || j < entries.Count())
+    {
+        int cmp = 0;
+        if (i >= old.Count()) cmp = 1;
+        else if (j >= entries.Count()) cmp = -1;
+        else cmp = old[i].Cmp(entries[j]);
+        if (cmp == 0) {
+            ++i;
+            ++j;
+            continue;
+        }
+        const wxString& entry = (cmp < 0 ? old[i] : entries[j]);
+        bool isdirectory = (entry.Last() == wxFILE_SEP_PATH);
+        wxString name = (isdirectory ? entry.Left(entry.Length()-1) : entry);
+        AddPending(directory->path, name, isdirectory, cmp > 0);
+        if (cmp < 0) ++i; else ++j;
+    }
+    directory->entries = entries;
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::AddPending(const wxString& directory, const wxString& name,
+    bool isdirectory, bool added)
+/**
+ * \brief Collects a change of a file or directory. A removed entry,
+ * which is added again (or the other way round), is dropped.
+ * \param directory The watched directory.
+ * \param name The name of the changed entry.
+ * \param isdirectory True if the entry is a directory.
+ * \param added True if the entry was added; false if removed.
+ **/
+{
+    wxString key = directory + _T('\n') + name;
+    if (isdirectory) key += wxFILE_SEP_PATH;
+    int state = (added ? 1 : -1);
+    PendingHashMap::iterator itr = m_pending.find(key);
+    if (itr == m_pending.end())
+    {
+        Pending* pending = new Pending();
+        pending->directory = directory;
+        pending->name = name;
+        pending->state = state;
+        pending->isdirectory = isdirectory;
+        pending->rescan = false;
+        m_pending[key] = pending;
+    }
+    else if (itr->second->state == -state)
+    {
+        // Aenderungen heben sich auf
+        delete itr->second;
+        m_pending.erase(itr);
+    }
+    m_last = wxGetLocalTimeMillis();
+    if (m_pending.size() == 1) m_first = m_last;
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::AddRescan(const wxString& directory)
+/**
+ * \brief Collects a rescan of a directory, the main thread adds
+ * project items for all entries of the directory.
+ * \param directory The watched directory.
+ **/
+{
+    wxString key = directory + _T('\n');
+    if (m_pending.find(key) != m_pending.end()) return;
+    Pending* pending = new Pending();
+    pending->directory = directory;
+    pending->state = 1;
+    pending->isdirectory = true;
+    pending->rescan = true;
+    m_pending[key] = pending;
+    m_last = wxGetLocalTimeMillis();
+    if (m_pending.size() == 1) m_first = m_last;
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::AddRename(const wxString& directory,
+    const wxString& oldname, const wxString& newname)
+/**
+ * \brief Collects the rename of a file. The removal and the addition
+ * must be collected before with AddPending().
+ * \param directory The watched directory.
+ * \param oldname The old name of the file.
+ * \param newname The new name of the file.
+ **/
+{
+    // Mehrfaches Umbenennen zusammenfassen
+    for (size_t i=0; i<m_renames.Count(); ++i)
+    {
+        Rename* rename = m_renames.ItemUnchecked(i);
+        if (rename->newname == oldname && rename->directory == directory)
+        {
+            rename->newname = newname;
+            return;
+        }
+    }
+    Rename* rename = new Rename();
+    rename->directory = directory;
+    rename->oldname = oldname;
+    rename->newname = newname;
+    m_renames.Add(rename);
+}
+
+
+//----------------------------------------------------------------
+long DirectoryWatcherThread::GetTimeout(wxLongLong now) const
+/**
+ * \brief Returns the time until the collected changes must be posted.
+ * \param now The current time.
+ * \return Time in milliseconds, 0 if the changes must be posted
+ * now or -1 if there are no changes.
+ **/
+{
+    if (m_pending.empty()) return (-1);
+    wxLongLong due = m_last + m_delay;
+    if (due > m_first + penvDIRECTORYWATCHER_MAXDELAY) due = m_first + penvDIRECTORYWATCHER_MAXDELAY;
+    if (due <= now) return (0);
+    return ((due - now).ToLong());
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcherThread::Flush()
+/**
+ * \brief Posts the collected changes to the main thread. The changes
+ * are sorted by directory and name, so the changes of a directory
+ * follow each other.
+ **/
+{
+    // Entfernen und Hinzufuegen einer Datei wird zum Umbenennen
+    for (size_t i=0; i<m_renames.Count(); ++i)
+    {
+        Rename* rename = m_renames.ItemUnchecked(i);
+        PendingHashMap::iterator from = m_pending.find(rename->directory + _T('\n') + rename->oldname);
+        PendingHashMap::iterator to = m_pending.find(rename->directory + _T('\n') + rename->newname);
+        if (from == m_pending.end() || to == m_pending.end()) continue;
+        if (from->second->state != -1 || to->second->state != 1) continue;
+        from->second->state = 0;
+        from->second->newname = rename->newname;
+        delete to->second;
+        m_pending.erase(to);
+    }
+    m_renames.Clear();
+    m_moves.clear();
+    wxArrayString keys;
+    PendingHashMap::iterator itr;
+    for (itr = m_pending.begin(); itr != m_pending.end(); ++itr)
+    {
+        keys.Add(itr->first);
+    }
+    // Ein '\n' ist kleiner als alle Zeichen eines Namens, dadurch
+    // stehen die Aenderungen eines Verzeichnisses hintereinander
+    keys.Sort();
+    Array<DirectoryWatcher::Change> changes(false);
+    changes.Reserve(keys.Count());
+    for (size_t i=0; i<keys.Count(); ++i)
+    {
+        Pending* pending = m_pending[keys[i]];
+        DirectoryWatcher::Change* change = new DirectoryWatcher::Change();
+        if (pending->rescan) change->type = DirectoryWatcher::ChangeRescan;
+        else if (pending->state == 0) change->type = DirectoryWatcher::ChangeRenamed;
+        else if (pending->state > 0) change->type = DirectoryWatcher::ChangeAdded;
+        else change->type = DirectoryWatcher::ChangeRemoved;
+        // Tiefe Kopien, da wxString Referenzen nicht thread safe sind
+        change->directory = wxString(pending->directory.c_str());
+        change->name = wxString(pending->name.c_str());
+        change->newname = wxString(pending->newname.c_str());
+        change->isdirectory = pending->isdirectory;
+        changes.Add(change);
+        delete pending;
+    }
+    m_pending.clear();
+    wxMutexLocker lock(m_watcher->m_mutex);
+    for (size_t i=0; i<changes.Count(); ++i)
+    {
+        m_watcher->m_changes->Add(changes.ItemUnchecked(i));
+    }
+    changes.Clear(false);
+    // Unter dem Lock, nach Stop() gibt es die CommandList evtl. nicht mehr
+    if (!m_watcher->m_stop) {
+        Environment::Get()->GetCommandList()->Post(penvCE_DirectoryWatcherChanged, wxVariant(), true);
+    }
+}
+
+
+
+//----------------------------------------------------------------
+DirectoryWatcher::DirectoryWatcher()
+/**
+ * \brief Constructor, initializes the DirectoryWatcher object and
+ * starts the thread, if penvCOMMON_DIRECTORYWATCHER is true.
+ **/
+{
+    m_items = new ItemsHashMap();
+    m_requests = new Array<Change>();
+    m_changes = new Array<Change>();
+    m_thread = NULL;
+    m_stop = false;
+    if (!penvCOMMON_DIRECTORYWATCHER) return;
+    CommandList* list = Environment::Get()->GetCommandList();
+    Command* cmd = list->GetCommand(penvCE_DirectoryWatcherChanged);
+    if (cmd != NULL) {
+        cmd->Connect(new CommandCallback<DirectoryWatcher>(this,&DirectoryWatcher::OnChanged));
+    }
+    m_thread = new DirectoryWatcherThread(this);
+    if (unlikely(m_thread->Create() != wxTHREAD_NO_ERROR || m_thread->Run() != wxTHREAD_NO_ERROR))
+    {
+        wxLogError(_T("[penv::DirectoryWatcher::DirectoryWatcher] Could not start the thread, directories are not watched."));
+        delete m_thread;
+        m_thread = NULL;
+    }
+}
+
+
+//----------------------------------------------------------------
+DirectoryWatcher::~DirectoryWatcher()
+/**
+ * \brief Destructor, stops the thread. Not yet processed changes
+ * are dropped. See Stop().
+ **/
+{
+    Stop();
+    ItemsHashMap::iterator itr;
+    for (itr = m_items->begin(); itr != m_items->end(); ++itr)
+    {
+        delete itr->second;
+    }
+    delete m_items;
+    delete m_requests;
+    delete m_changes;
+}
+
+
+//----------------------------------------------------------------
+DirectoryWatcher::DirectoryWatcher(const DirectoryWatcher& watcher)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+DirectoryWatcher& DirectoryWatcher::operator=(const DirectoryWatcher& watcher)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcher::Add(ProjectItemDirectory* item, const wxString& path)
+/**
+ * \brief Watches the directory of a project item. Called by the
+ * ProjectItemDirectory, when its path is set. The item must keep the
+ * path and remove itself with it, see Remove(). This method is thread
+ * safe, so directories can be added while loading projects.
+ * \param item The directory item.
+ * \param path The directory of the item.
+ **/
+{
+    if (m_thread == NULL || item == NULL) return;
+    if (path.IsEmpty()) return;
+    wxMutexLocker lock(m_mutex);
+    ItemsHashMap::iterator itr = m_items->find(path);
+    if (itr != m_items->end())
+    {
+        itr->second->Add(item);
+        return;
+    }
+    Array<ProjectItemDirectory>* items = new Array<ProjectItemDirectory>(false);
+    items->Add(item);
+    (*m_items)[path] = items;
+    AddRequest(ChangeWatch, path);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcher::Remove(ProjectItemDirectory* item, const wxString& path)
+/**
+ * \brief Stops watching the directory of a project item, if no other
+ * item has the same directory. Called by the ProjectItemDirectory in
+ * the destructor or before its path changes. If the item is not
+ * registered for the given path, it is searched in all directories,
+ * so no deleted item stays in the watcher. This method is
+ * thread safe.
+ * \param item The directory item.
+ * \param path The path, which was given to Add().
+ **/
+{
+    if (m_thread == NULL || item == NULL) return;
+    wxMutexLocker lock(m_mutex);
+    ItemsHashMap::iterator itr = m_items->find(path);
+    if (itr != m_items->end() && RemoveItem(itr, item)) return;
+    for (itr = m_items->begin(); itr != m_items->end(); ++itr)
+    {
+        if (RemoveItem(itr, item)) return;
+    }
+}
+
+
+//----------------------------------------------------------------
+bool DirectoryWatcher::RemoveItem(ItemsHashMap::iterator itr, ProjectItemDirectory* item)
+/**
+ * \brief Removes an item from the items of a directory (private).
+ * If no other item has the directory, the directory is no longer
+ * watched and the iterator gets invalid. The mutex must be locked
+ * by the caller.
+ * \param itr The directory in the hash map.
+ * \param item The directory item.
+ * \return True if the item was removed; false if the item is not
+ * registered for the directory.
+ **/
+{
+    Array<ProjectItemDirectory>* items = itr->second;
+    size_t i = 0;
+    while (i < items->Count() && items->ItemUnchecked(i) != item) ++i;
+    if (i == items->Count()) return (false);
+    items->Remove(i, false);
+    if (items->Count() > 0) return (true);
+    wxString path = itr->first;
+    delete items;
+    m_items->erase(itr);
+    AddRequest(ChangeUnwatch, path);
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcher::Rescan(const wxString& path)
+/**
+ * \brief Adds project items for all files and directories of a
+ * watched directory, which have no project item yet. The directory
+ * is read after the thread started watching it, so no file gets lost.
+ * This method is thread safe.
+ * \param path The watched directory.
+ **/
+{
+    if (m_thread == NULL) return;
+    wxMutexLocker lock(m_mutex);
+    AddRequest(ChangeRescan, path);
+}
+
+
+//----------------------------------------------------------------
+size_t DirectoryWatcher::Count()
+/**
+ * \brief Returns the number of watched directories.
+ * \return Number of directories.
+ **/
+{
+    wxMutexLocker lock(m_mutex);
+    return (m_items->size());
+}
+
+
+//----------------------------------------------------------------
+bool DirectoryWatcher::IsPolling() const
+/**
+ * \brief Returns true if the directories are compared in intervals,
+ * because the operating system does not notify about changes.
+ * \return True if polled; false otherwise.
+ **/
+{
+    return (m_thread != NULL && m_thread->IsPolling());
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcher::Stop()
+/**
+ * \brief Stops the thread, the directories are no longer watched.
+ * Must be called before the CommandList is destroyed, because the
+ * thread posts its changes there.
+ **/
+{
+    if (m_thread == NULL) return;
+    {
+        wxMutexLocker lock(m_mutex);
+        m_stop = true;
+    }
+    m_thread->Wake();
+    m_thread->Wait();
+    delete m_thread;
+    m_thread = NULL;
+}
+
+
+//----------------------------------------------------------------
+size_t DirectoryWatcher::ProcessChanges()
+/**
+ * \brief Applies the changes, which were posted by the thread, to
+ * the project items of the watched directories. This is done
+ * automatically, when the main thread is idle.
+ * Must be called from the main thread.
+ * \return Number of added, removed and renamed project items.
+ **/
+{
+    wxASSERT(wxIsMainThread());
+    Array<Change> changes(true);
+    {
+        wxMutexLocker lock(m_mutex);
+        for (size_t i=0; i<m_changes->Count(); ++i)
+        {
+            changes.Add(m_changes->ItemUnchecked(i));
+        }
+        m_changes->Clear(false);
+    }
+    size_t count = 0;
+    size_t first = 0;
+    while (first < changes.Count())
+    {
+        // Die Aenderungen eines Verzeichnisses stehen hintereinander
+        wxString directory = changes.ItemUnchecked(first)->directory;
+        size_t last = first+1;
+        while (last < changes.Count() && changes.ItemUnchecked(last)->directory == directory) ++last;
+        Array<ProjectItemDirectory> items(false);
+        {
+            wxMutexLocker lock(m_mutex);
+            ItemsHashMap::iterator itr = m_items->find(directory);
+            if (itr != m_items->end())
+            {
+                for (size_t i=0; i<itr->second->Count(); ++i)
+                {
+                    items.Add(itr->second->ItemUnchecked(i));
+                }
+            }
+        }
+        for (size_t i=0; i<items.Count(); ++i)
+        {
+            ProjectItemDirectory* item = items.ItemUnchecked(i);
+            // Koennte durch eine vorherige Aenderung geloescht sein
+            if (!IsWatched(item, directory) || item->IsVirtual()) continue;
+            // Index ueber die Pfade, damit nicht jede Aenderung die
+            // ganze Liste durchsucht
+            PathHashMap index;
+            ProjectItemList* list = item->GetItemList();
+            for (size_t j=0; j<list->Count(); ++j)
+            {
+                ProjectItem* child = list->GetItem(j);
+                if (child->IsVirtual()) continue;
+                if (child->GetType() == penvPI_File) {
+                    index[GetKey(child->GetPathString())] = child;
+                } else if (child->GetType() == penvPI_Directory) {
+                    index[GetKey(child->GetPath().GetPath())] = child;
+                }
+            }
+            for (size_t j=first; j<last; ++j)
+            {
+                count += ApplyChange(item, &index, changes.ItemUnchecked(j));
+            }
+        }
+        items.Clear(false);
+        first = last;
+    }
+    return (count);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcher::AddRequest(ChangeType type, const wxString& path)
+/**
+ * \brief Adds a request for the thread and wakes it up. The mutex
+ * must be locked by the caller.
+ * \param type ChangeWatch, ChangeUnwatch or ChangeRescan.
+ * \param path The directory.
+ **/
+{
+    Change* request = new Change();
+    request->type = type;
+    // Tiefe Kopie, da wxString Referenzen nicht thread safe sind
+    request->directory = wxString(path.c_str());
+    request->isdirectory = true;
+    m_requests->Add(request);
+    m_thread->Wake();
+}
+
+
+//----------------------------------------------------------------
+bool DirectoryWatcher::IsWatched(ProjectItemDirectory* item, const wxString& path)
+/**
+ * \brief Returns true if the item is still registered for the path.
+ * \param item The directory item.
+ * \param path The directory.
+ * \return True if the item is registered; false otherwise.
+ **/
+{
+    wxMutexLocker lock(m_mutex);
+    ItemsHashMap::iterator itr = m_items->find(path);
+    if (itr == m_items->end()) return (false);
+    for (size_t i=0; i<itr->second->Count(); ++i)
+    {
+        if (itr->second->ItemUnchecked(i) == item) return (true);
+    }
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+size_t DirectoryWatcher::ApplyChange(ProjectItemDirectory* item, PathHashMap* index, Change* change)
+/**
+ * \brief Applies one change to the project items of a directory item.
+ * The change is ignored if the project items are already up to date.
+ * \param item The directory item.
+ * \param index The project items of the directory item by their path.
+ * \param change The change.
+ * \return Number of changed project items.
+ **/
+{
+    if (change->type == ChangeRescan) return (ApplyRescan(item, index, change->directory));
+    ProjectItemList* list = item->GetItemList();
+    wxString path = change->directory + wxFILE_SEP_PATH + change->name;
+    PathHashMap::iterator itr = index->find(GetKey(path));
+    ProjectItem* found = NULL;
+    if (itr != index->end() && (itr->second->GetType() == penvPI_Directory) == change->isdirectory) {
+        found = itr->second;
+    }
+    CommandList* commands = Environment::Get()->GetCommandList();
+    if (change->type == ChangeAdded)
+    {
+        if (found != NULL) return (0);
+        return (AddItem(list, index, change->directory, change->name, change->isdirectory) != NULL ? 1 : 0);
+    }
+    if (found == NULL) return (0);
+    if (change->type == ChangeRemoved)
+    {
+        wxVariant variant = (void*)found;
+        commands->Execute(penvCE_ProjectItemRemoved, variant);
+        index->erase(itr);
+        int position = list->GetItemIndex(found);
+        if (position >= 0) list->Remove(position);
+        return (1);
+    }
+    // Umbenannte Datei, die Eigenschaften bleiben erhalten
+    wxString newpath = change->directory + wxFILE_SEP_PATH + change->newname;
+    if (index->find(GetKey(newpath)) != index->end()) return (0);
+    if (found->GetName() == change->name) found->SetName(change->newname);
+    ((ProjectItemFile*)found)->SetPath(newpath);
+    index->erase(itr);
+    (*index)[GetKey(newpath)] = found;
+    wxVariant variant = (void*)found;
+    commands->Execute(penvCE_ProjectItemRenamed, variant);
+    return (1);
+}
+
+
+//----------------------------------------------------------------
+size_t DirectoryWatcher::ApplyRescan(ProjectItemDirectory* item, PathHashMap* index, const wxString& directory)
+/**
+ * \brief Adds project items for all files and directories, which
+ * have no project item yet. Project items of not existing files are
+ * not removed, because they may be created later (for example by
+ * a build).
+ * \param item The directory item.
+ * \param index The project items of the directory item by their path.
+ * \param directory The directory.
+ * \return Number of added project items.
+ **/
+{
+    wxArrayString entries;
+    ListDirectory(directory, entries);
+    size_t count = 0;
+    for (size_t i=0; i<entries.Count(); ++i)
+    {
+        const wxString& entry = entries[i];
+        bool isdirectory = (entry.Last() == wxFILE_SEP_PATH);
+        wxString name = (isdirectory ? entry.Left(entry.Length()-1) : entry);
+        if (index->find(GetKey(directory + wxFILE_SEP_PATH + name)) != index->end()) continue;
+        if (AddItem(item->GetItemList(), index, directory, name, isdirectory) != NULL) count++;
+    }
+    return (count);
+}
+
+
+//----------------------------------------------------------------
+ProjectItem* DirectoryWatcher::AddItem(ProjectItemList* list, PathHashMap* index,
+    const wxString& directory, const wxString& name, bool isdirectory)
+/**
+ * \brief Adds a project item for a new file or directory. The
+ * entries of a new directory are added by a rescan.
+ * \param list The project items of the watched directory.
+ * \param index The project items of the directory item by their path.
+ * \param directory The watched directory.
+ * \param name Name of the file or directory.
+ * \param isdirectory True for a directory; false for a file.
+ * \return The new project item or NULL on error.
+ **/
+{
+    ProjectItem* item = list->CreateProjectItem(isdirectory ? penvPI_Directory : penvPI_File);
+    if (unlikely(item == NULL)) return (NULL);
+    wxString path = directory + wxFILE_SEP_PATH + name;
+    item->SetName(name);
+    if (isdirectory) {
+        ((ProjectItemDirectory*)item)->SetPath(path);
+    } else {
+        ((ProjectItemFile*)item)->SetPath(path);
+    }
+    list->Add(item);
+    (*index)[GetKey(path)] = item;
+    // Das neue Verzeichnis wird jetzt ueberwacht, der Rescan findet
+    // auch die Dateien, die vorher erzeugt wurden
+    if (isdirectory) Rescan(path);
+    wxVariant variant = (void*)item;
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemAdded, variant);
+    return (item);
+}
+
+
+//----------------------------------------------------------------
+void DirectoryWatcher::OnChanged(CommandEvent& event)
+/**
+ * \brief Occurs on the main thread, when the thread has posted
+ * changes. See ProcessChanges().
+ * \param event The event.
+ **/
+{
+    ProcessChanges();
+}
+
+} // namespace penv
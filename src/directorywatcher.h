@@ -0,0 +1,135 @@
+/*
+ * directorywatcher.h - Declaration of the DirectoryWatcher class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_DIRECTORYWATCHER_H_
+#define _PENV_DIRECTORYWATCHER_H_
+
+#include "wxincludes.h"
+#include "globals.h"
+#include "container/objarray.h"
+#include "commandevent.h"
+
+
+/**
+ * \brief Definition of the time in milliseconds, which must pass
+ * without a change, before the collected changes are applied. A burst
+ * of changes (like a checkout) is applied at once.
+ **/
+#define penvDIRECTORYWATCHER_DELAY 300
+
+/**
+ * \brief Definition of the maximum time in milliseconds, the changes
+ * are collected. Permanent changes are applied at least this often.
+ **/
+#define penvDIRECTORYWATCHER_MAXDELAY 3000
+
+/**
+ * \brief Definition of the interval in milliseconds, in which the
+ * directories are compared with their last contents, if the operating
+ * system does not notify about changes.
+ **/
+#define penvDIRECTORYWATCHER_POLLINTERVAL 2000
+
+
+namespace penv {
+
+class ProjectItem;
+class ProjectItemList;
+class ProjectItemDirectory;
+class DirectoryWatcherThread;
+
+/**
+ * \brief The DirectoryWatcher class keeps the project items of not
+ * virtual directory items in sync with the file system. Every directory
+ * item registers itself with Add() after its path is known and removes
+ * itself with the same path in the destructor. The watcher is owned by the WorkspaceList.<br>
+ * A worker thread watches the directories with inotify on linux. On other
+ * systems, or if inotify is not available, the thread compares the
+ * contents of the directories every penvDIRECTORYWATCHER_POLLINTERVAL
+ * milliseconds. The changes are collected until nothing changed for
+ * penvDIRECTORYWATCHER_DELAY milliseconds. Changes which cancel each
+ * other (a file is removed and created again, like on a checkout) are
+ * dropped, a renamed file keeps its project item.<br>
+ * The collected changes are posted to the main thread, where
+ * ProcessChanges() adds, removes and renames the project items and
+ * executes penvCE_ProjectItemAdded, penvCE_ProjectItemRemoved and
+ * penvCE_ProjectItemRenamed for every changed item. Hidden files and
+ * backup files (ending with '~') are ignored.
+ **/
+class DirectoryWatcher
+{
+    public:
+        friend class DirectoryWatcherThread;
+        DirectoryWatcher();
+        ~DirectoryWatcher();
+    private:
+        DirectoryWatcher(const DirectoryWatcher& watcher);
+        DirectoryWatcher& operator=(const DirectoryWatcher& watcher);
+
+    public:
+        void Add(ProjectItemDirectory* item, const wxString& path);
+        void Remove(ProjectItemDirectory* item, const wxString& path);
+        void Rescan(const wxString& path);
+        size_t Count();
+        bool IsPolling() const;
+        void Stop();
+
+        size_t ProcessChanges();
+
+    private:
+        /**
+         * \brief The type of a change or a request to the thread.
+         **/
+        enum ChangeType
+        {
+            ChangeAdded,
+            ChangeRemoved,
+            ChangeRenamed,
+            ChangeRescan,
+            ChangeWatch,
+            ChangeUnwatch
+        };
+
+        /**
+         * \brief A change of a watched directory, which was collected
+         * by the thread, or a request to the thread (watch, unwatch or
+         * rescan a directory).
+         **/
+        struct Change
+        {
+            ChangeType type;
+            wxString directory;
+            wxString name;
+            wxString newname;
+            bool isdirectory;
+        };
+
+        WX_DECLARE_STRING_HASH_MAP(Array<ProjectItemDirectory>*, ItemsHashMap);
+        WX_DECLARE_STRING_HASH_MAP(ProjectItem*, PathHashMap);
+
+        void AddRequest(ChangeType type, const wxString& path);
+        bool RemoveItem(ItemsHashMap::iterator itr, ProjectItemDirectory* item);
+        bool IsWatched(ProjectItemDirectory* item, const wxString& path);
+        size_t ApplyChange(ProjectItemDirectory* item, PathHashMap* index, Change* change);
+        size_t ApplyRescan(ProjectItemDirectory* item, PathHashMap* index, const wxString& directory);
+        ProjectItem* AddItem(ProjectItemList* list, PathHashMap* index, const wxString& directory,
+            const wxString& name, bool isdirectory);
+        void OnChanged(CommandEvent& event);
+
+    private:
+        wxMutex m_mutex;
+        ItemsHashMap* m_items;
+        Array<Change>* m_requests;
+        Array<Change>* m_changes;
+        DirectoryWatcherThread* m_thread;
+        bool m_stop;
+};
+
+} // namespace penv
+
+#endif // _PENV_DIRECTORYWATCHER_H_
@@ -8,6 +8,7 @@
 
 
 #include "environment.h"
+#include "directorywatcher.h"
 #include "expect.h"
 #include "penvhelper.h"
 #include "commandcallback.h"
@@ -89,6 +90,8 @@ Environment::~Environment()
  * \brief Destructor.
  **/
 {
+    // Der Thread des DirectoryWatchers benutzt die CommandList
+    if (m_workspacelist != NULL) m_workspacelist->GetDirectoryWatcher()->Stop();
     if (m_windowlist != NULL) delete m_windowlist;
     if (m_commandlist != NULL) delete m_commandlist;
     if (m_workspacelist != NULL) delete m_workspacelist;
@@ -126,13 +129,13 @@ void Environment::InitializeEvents()
  * Framework. All events of that type, begin with 'PENV_EVT_'.
  **/
 {
-    m_commandlist->GetCommand(_T("PENV_EVT_WINDOW_REGISTERED"))->
+    m_commandlist->GetCommand(penvCE_WindowRegistered)->
         Connect(new penv::CommandCallback<Environment>(this,&Environment::OnPenvWindowRegistered));
-    m_commandlist->GetCommand(_T("PENV_EVT_WINDOW_UNREGISTERED"))->
+    m_commandlist->GetCommand(penvCE_WindowUnregistered)->
         Connect(new penv::CommandCallback<Environment>(this,&Environment::OnPenvWindowUnRegistered));
-    m_commandlist->GetCommand(_T("PENV_EVT_WINDOW_ADDED"))->
+    m_commandlist->GetCommand(penvCE_WindowAdded)->
         Connect(new penv::CommandCallback<Environment>(this,&Environment::OnPenvWindowAdded));
-    m_commandlist->GetCommand(_T("PENV_EVT_WINDOW_CLOSED"))->
+    m_commandlist->GetCommand(penvCE_WindowClosed)->
         Connect(new penv::CommandCallback<Environment>(this,&Environment::OnPenvWindowClosed));
 }
 
@@ -311,18 +314,29 @@ bool Environment::SaveConfiguration()
 {
     // Konfigurationsdatei ermittlen
     wxString configfile = GetConfigurationFile(true);
-    wxXmlDocument doc;
-    doc.SetFileEncoding(_T("UTF-8"));
-    wxXmlNode* rootnode = PenvHelper::CreateXmlNode(_T("configuration"));
-    doc.SetRoot(rootnode);
-    wxXmlNode* envnode = WriteEnvironmentConfiguration();
-    PenvHelper::AddXmlChildNode(rootnode, envnode);
-    wxXmlNode* menubarnode = m_commandlist->WriteMenuBarConfiguration();
-    PenvHelper::AddXmlChildNode(rootnode, menubarnode);
-    wxXmlNode* toolbarnode = m_commandlist->WriteToolBarsConfiguration();
-    PenvHelper::AddXmlChildNode(rootnode, toolbarnode);
-    rootnode->AddChild(m_commandlist->WriteShortcutsConfiguration());
-    return (doc.Save(configfile, 1));
+    XmlWriter writer;
+    if (!writer.Open(configfile)) return (false);
+    // Die Teile nacheinander schreiben und wieder freigeben, so
+    // wird nie das ganze Dokument im Speicher gehalten
+    writer.WriteStartElement(_T("configuration"));
+    wxXmlNode* node = WriteEnvironmentConfiguration();
+    writer.WriteNode(node);
+    delete node;
+    node = m_commandlist->WriteMenuBarConfiguration();
+    writer.WriteNode(node);
+    delete node;
+    node = m_commandlist->WriteToolBarsConfiguration();
+    writer.WriteNode(node);
+    delete node;
+    node = m_commandlist->WriteShortcutsConfiguration();
+    writer.WriteNode(node);
+    delete node;
+    writer.WriteEndElement();
+    bool result = writer.Close();
+    // Snapshot fuer den naechsten Start, ein Fehler ist hier nicht
+    // schlimm, dann werden die Xml Dateien gelesen
+    m_workspacelist->WriteSnapshot(GetWorkspacesSnapshotFile());
+    return (result);
 }
 
 
@@ -405,7 +419,8 @@ bool Environment::LoadConfiguration()
         childnode = childnode->GetNext();
     }
 
-    // Laden des Workspaces
+    // Laden des Workspaces, wenn moeglich aus dem Snapshot
+    if (m_workspacelist->ReadSnapshot(GetWorkspacesSnapshotFile())) return (true);
     wxString workspaceconfigfile = GetWorkspacesFile(false);
     wxXmlDocument docworkspace(workspaceconfigfile);
     // Prfen ob Datei korrekt geladen ...
@@ -853,6 +868,20 @@ wxString Environment::GetWorkspacesFile(bool save)
 }
 
 
+//----------------------------------------------------------------
+wxString Environment::GetWorkspacesSnapshotFile()
+/**
+ * \brief Returns the path to the binary snapshot of the workspaces,
+ * which lies next to the workspaces file. See
+ * WorkspaceList::WriteSnapshot().
+ * \return Path to the workspaces snapshot file.
+ **/
+{
+    wxString workspacepath = Path::RemoveLastEntry(GetWorkspacesFile(false));
+    return (Path::Combine(workspacepath, _T("workspaces.snapshot")));
+}
+
+
 
 //----------------------------------------------------------------
 void Environment::OnPenvWindowRegistered(CommandEvent& event)
@@ -93,6 +93,7 @@ class Environment
     public:
         wxString GetConfigurationFile(bool save);
         wxString GetWorkspacesFile(bool save);
+        wxString GetWorkspacesSnapshotFile();
 
     private: // Interne registrierte Events
         void OnPenvWindowRegistered(CommandEvent& event);
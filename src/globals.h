@@ -41,6 +41,63 @@
 #define penvCOMMON_LOGFILEPATH "penv.log"
 
 
+/**
+ * \brief Definition if projects should allocate their project items,
+ * properties and tree item datas from a MemoryPool. 'true' to use
+ * a pool for every project; 'false' to allocate every object from
+ * the heap.
+ **/
+#define penvCOMMON_USEMEMORYPOOL true
+
+/**
+ * \brief Definition of the number of worker threads, which load the
+ * project files of a workspace in parallel. '0' to use one thread
+ * per processor; '1' to load all projects in the main thread.
+ **/
+#define penvCOMMON_PROJECTLOADERTHREADS 0
+
+/**
+ * \brief Definition if the project items inside of directories,
+ * linked items and subprojects are read on demand. 'true' to read
+ * them the first time they are accessed; 'false' to read them all
+ * when the project is loaded. See ProjectItemList::Defer().
+ **/
+#define penvCOMMON_LAZYPROJECTITEMS true
+
+/**
+ * \brief Definition of the maximum number of threads, which check
+ * the existence of project, workspace and directory paths while
+ * loading. The checks mostly wait for the file system (for example
+ * on network drives), so more threads than processors are useful.
+ * '1' to check all paths in the calling thread. See PathChecker.
+ **/
+#define penvCOMMON_PATHCHECKERTHREADS 8
+
+/**
+ * \brief Definition if the directories of not virtual directory items
+ * are watched for changes on the file system. 'true' to add, remove
+ * and rename the project items of a directory, when its files change;
+ * 'false' otherwise. See DirectoryWatcher.
+ **/
+#define penvCOMMON_DIRECTORYWATCHER true
+
+
+/**
+ * \brief Definition if the command profiler is compiled into the
+ * framework. If 'true' the profiler can be switched on at runtime
+ * with Command::EnableProfiling(), see DebugPageCommands. If 'false'
+ * Command::Execute() has no profiling overhead at all.
+ **/
+#define penvCOMMON_COMMANDPROFILER true
+
+
+/**
+ * \brief Definition of the maximum number of posted commands, which
+ * will be executed in one idle event. See CommandList::Post().
+ **/
+#define penvCOMMON_POSTEDCOMMANDSPERIDLE 64
+
+
 /**
  * \brief Definition for the standard toolbar style.
  **/
@@ -55,9 +112,8 @@
 /**
  * \brief Defines the selection mode of the project tree ctrl.
  * This can be wxTR_SINGLE or wxTR_MULTIPLE.
- * \todo Implement wxTR_MULTIPLE.
  **/
-#define penvPROJECTTREECTRL_SELECTIONMODE wxTR_SINGLE
+#define penvPROJECTTREECTRL_SELECTIONMODE wxTR_MULTIPLE
 
 
 /**
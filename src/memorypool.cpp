@@ -0,0 +1,240 @@
+/*
+ * memorypool.cpp - Implementation of the MemoryPool class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+
+
+#include "memorypool.h"
+#include "expect.h"
+#include <new>      // for ::operator new()
+#include <string.h> // for memset()
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+MemoryPool::MemoryPool(size_t slabsize)
+/**
+ * \brief Constructor, initializes the MemoryPool object. No memory
+ * will be allocated until the first object is created in the pool.
+ * \param slabsize Size of one memory block in bytes.
+ **/
+{
+    m_slabs = NULL;
+    m_current = NULL;
+    m_remaining = 0;
+    m_slabsize = slabsize;
+    if (m_slabsize < 2*penvMEMORYPOOL_MAXOBJECTSIZE) {
+        m_slabsize = 2*penvMEMORYPOOL_MAXOBJECTSIZE;
+    }
+    m_slabcount = 0;
+    m_objectcount = 0;
+    m_allocationcount = 0;
+    m_released = false;
+    memset(m_freelists, 0, sizeof(m_freelists));
+}
+
+
+//----------------------------------------------------------------
+MemoryPool::~MemoryPool()
+/**
+ * \brief Destructor (private). Frees all memory blocks at once.
+ * Use Release() to destroy the pool.
+ **/
+{
+    while (m_slabs != NULL)
+    {
+        char* next = *((char**)m_slabs);
+        delete [] m_slabs;
+        m_slabs = next;
+    }
+}
+
+
+//----------------------------------------------------------------
+MemoryPool::MemoryPool(const MemoryPool& pool)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+MemoryPool& MemoryPool::operator=(const MemoryPool& pool)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+void MemoryPool::Release()
+/**
+ * \brief Releases the pool from its owner. If there are no more
+ * objects in the pool, the pool will be destroyed immediately.
+ * Otherwise the pool will be destroyed, when the last object is
+ * deleted. Do not use the pool after calling this method.
+ **/
+{
+    m_released = true;
+    if (m_objectcount == 0) delete this;
+}
+
+
+//----------------------------------------------------------------
+size_t MemoryPool::GetObjectCount() const
+/**
+ * \brief Returns the number of objects which currently live in
+ * this pool.
+ * \return Number of objects in the pool.
+ **/
+{
+    return (m_objectcount);
+}
+
+
+//----------------------------------------------------------------
+size_t MemoryPool::GetAllocationCount() const
+/**
+ * \brief Returns the number of objects which were ever created
+ * in this pool. Without the pool this would be the number of
+ * heap allocations.
+ * \return Number of allocations from this pool.
+ **/
+{
+    return (m_allocationcount);
+}
+
+
+//----------------------------------------------------------------
+size_t MemoryPool::GetSlabCount() const
+/**
+ * \brief Returns the number of memory blocks, which are allocated
+ * from the heap by this pool.
+ * \return Number of memory blocks.
+ **/
+{
+    return (m_slabcount);
+}
+
+
+//----------------------------------------------------------------
+size_t MemoryPool::GetMemorySize() const
+/**
+ * \brief Returns the size of the memory in bytes, which is allocated
+ * from the heap by this pool.
+ * \return Allocated memory in bytes.
+ **/
+{
+    return (m_slabcount*m_slabsize);
+}
+
+
+//----------------------------------------------------------------
+void* MemoryPool::New(size_t size, MemoryPool* pool)
+/**
+ * \brief Allocates memory for an object. If pool is NULL or the
+ * object is to big, the memory will be allocated from the heap.
+ * This method is used by the DECLARE_MEMORYPOOL_OPERATORS() macro.
+ * \param size Size of the object in bytes.
+ * \param pool The pool to allocate the object from or NULL.
+ * \return Memory for the object.
+ **/
+{
+    size_t total = sizeof(Header) + size;
+    total = (total + penvMEMORYPOOL_GRANULARITY - 1) & ~(size_t)(penvMEMORYPOOL_GRANULARITY - 1);
+    Header* header = NULL;
+    if (likely(pool != NULL && total <= penvMEMORYPOOL_MAXOBJECTSIZE)) {
+        header = (Header*)pool->Allocate(total);
+        header->info.pool = pool;
+    } else {
+        header = (Header*)::operator new(total);
+        header->info.pool = NULL;
+    }
+    header->info.size = total;
+    return ((void*)(header+1));
+}
+
+
+//----------------------------------------------------------------
+void MemoryPool::Delete(void* ptr)
+/**
+ * \brief Frees the memory of an object, allocated with New().
+ * This method is used by the DECLARE_MEMORYPOOL_OPERATORS() macro.
+ * \param ptr The object to free.
+ **/
+{
+    if (unlikely(ptr == NULL)) return;
+    Header* header = ((Header*)ptr)-1;
+    if (header->info.pool == NULL) {
+        ::operator delete((void*)header);
+    } else {
+        header->info.pool->Free((void*)header, header->info.size);
+    }
+}
+
+
+//----------------------------------------------------------------
+void* MemoryPool::Allocate(size_t size)
+/**
+ * \brief Allocates memory from the pool. Reuses freed memory with
+ * the same size or takes the memory from the current slab.
+ * \param size Size in bytes, already rounded to the granularity.
+ * \return Allocated memory.
+ **/
+{
+    m_objectcount++;
+    m_allocationcount++;
+    // Freigegebenen Speicher wiederverwenden
+    size_t index = size/penvMEMORYPOOL_GRANULARITY;
+    if (m_freelists[index] != NULL)
+    {
+        FreeEntry* entry = m_freelists[index];
+        m_freelists[index] = entry->next;
+        return ((void*)entry);
+    }
+    // Neuen Slab besorgen, erstes Element zeigt auf den letzten Slab
+    if (unlikely(m_remaining < size))
+    {
+        char* slab = new char[m_slabsize];
+        *((char**)slab) = m_slabs;
+        m_slabs = slab;
+        m_current = slab + sizeof(Header);
+        m_remaining = m_slabsize - sizeof(Header);
+        m_slabcount++;
+    }
+    void* ptr = (void*)m_current;
+    m_current += size;
+    m_remaining -= size;
+    return (ptr);
+}
+
+
+//----------------------------------------------------------------
+void MemoryPool::Free(void* ptr, size_t size)
+/**
+ * \brief Returns memory to the pool. The memory will be reused for
+ * the next object with the same size. If the pool is released and
+ * this was the last object, the pool will be destroyed.
+ * \param ptr Memory to free.
+ * \param size Size in bytes, already rounded to the granularity.
+ **/
+{
+    FreeEntry* entry = (FreeEntry*)ptr;
+    size_t index = size/penvMEMORYPOOL_GRANULARITY;
+    entry->next = m_freelists[index];
+    m_freelists[index] = entry;
+    m_objectcount--;
+    if (m_released && m_objectcount == 0) delete this;
+}
+
+
+} // namespace penv
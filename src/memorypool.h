@@ -0,0 +1,135 @@
+/*
+ * memorypool.h - Declaration of the MemoryPool class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+
+#ifndef _PENV_MEMORYPOOL_H_
+#define _PENV_MEMORYPOOL_H_
+
+#include <stddef.h> // for size_t
+
+
+/**
+ * \brief Definition of the size of one memory block (slab) in a
+ * MemoryPool in bytes.
+ **/
+#define penvMEMORYPOOL_SLABSIZE 65536
+
+/**
+ * \brief Definition of the biggest object in bytes, which will be
+ * allocated from a MemoryPool. Bigger objects will be allocated
+ * from the heap.
+ **/
+#define penvMEMORYPOOL_MAXOBJECTSIZE 512
+
+/**
+ * \brief Definition of the granularity of the object sizes in a
+ * MemoryPool. Every object size is rounded up to this value.
+ **/
+#define penvMEMORYPOOL_GRANULARITY 8
+
+
+/**
+ * \brief Declares the operators new and delete for a class, so that
+ * objects of this class (and inherited classes) can be created inside
+ * a MemoryPool. After using this macro make sure that you switch to
+ * private or whatever.<br>
+ * Example:<br>
+ * <code>
+ * MyClass* obj = new (pool) MyClass(); // Allocated in the pool<br>
+ * MyClass* obj = new MyClass(); // Allocated on the heap<br>
+ * delete obj; // Works for both objects<br>
+ * </code>
+ **/
+#define DECLARE_MEMORYPOOL_OPERATORS() \
+    public: \
+    static void* operator new(size_t size) \
+        { return (penv::MemoryPool::New(size, NULL)); } \
+    static void* operator new(size_t size, penv::MemoryPool* pool) \
+        { return (penv::MemoryPool::New(size, pool)); } \
+    static void operator delete(void* ptr) \
+        { penv::MemoryPool::Delete(ptr); } \
+    static void operator delete(void* ptr, penv::MemoryPool* pool) \
+        { penv::MemoryPool::Delete(ptr); }
+
+
+namespace penv {
+
+/**
+ * \brief The MemoryPool class is a slab allocator for small objects,
+ * like project items, properties and tree item datas. Objects are
+ * allocated in big memory blocks (slabs), which will be freed all at
+ * once when the pool is destroyed. Freed objects will be reused by
+ * new objects of the same size.<br>
+ * The owner of the pool (for example a Project) does not delete the
+ * pool, instead it calls Release(). The pool destroys itself after
+ * it is released and the last object inside the pool is deleted.
+ * Therefore objects can be moved from one owner to another, without
+ * caring about the pool.<br>
+ * Objects can only be created in a pool, if the class uses the
+ * DECLARE_MEMORYPOOL_OPERATORS() macro. This class is not thread safe.
+ **/
+class MemoryPool
+{
+    public:
+        MemoryPool(size_t slabsize = penvMEMORYPOOL_SLABSIZE);
+    private:
+        ~MemoryPool();
+        MemoryPool(const MemoryPool& pool);
+        MemoryPool& operator=(const MemoryPool& pool);
+
+    public:
+        void Release();
+
+        size_t GetObjectCount() const;
+        size_t GetAllocationCount() const;
+        size_t GetSlabCount() const;
+        size_t GetMemorySize() const;
+
+        static void* New(size_t size, MemoryPool* pool);
+        static void Delete(void* ptr);
+
+    private:
+        void* Allocate(size_t size);
+        void Free(void* ptr, size_t size);
+
+    private:
+        /**
+         * \brief Header in front of every object, allocated with New().
+         * The union makes sure, that the object behind is aligned.
+         **/
+        union Header
+        {
+            struct {
+                MemoryPool* pool;
+                size_t size;
+            } info;
+            double align;
+        };
+
+        /**
+         * \brief Entry in a free list, is placed into the freed memory.
+         **/
+        struct FreeEntry
+        {
+            FreeEntry* next;
+        };
+
+        char* m_slabs;
+        char* m_current;
+        size_t m_remaining;
+        size_t m_slabsize;
+        size_t m_slabcount;
+        size_t m_objectcount;
+        size_t m_allocationcount;
+        bool m_released;
+        FreeEntry* m_freelists[penvMEMORYPOOL_MAXOBJECTSIZE/penvMEMORYPOOL_GRANULARITY+2];
+};
+
+} // namespace penv
+
+#endif // _PENV_MEMORYPOOL_H_
@@ -8,6 +8,7 @@
 
 #include "menubar.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "environment.h"
 
 
@@ -217,7 +218,7 @@ Array<MenuItem>* MenuBar::FindMenuItems(const wxString& commandid)
     {
         // First level only contains submenus so there
         //  will be no menuitem to add!
-        MenuItem* item = (*m_array)[i];
+        MenuItem* item = m_array->ItemUnchecked(i);
         item->FindMenuItems(array, commandid);
     }
     return (array);
@@ -236,7 +237,8 @@ bool MenuBar::Update()
         wxLogError(_T("[penv::MenuBar::Update] Cannot update menubar, because the menubar is not initialized."));
         return (false);
     }
-    // Alte MenuBar lschen
+    // Alte MenuBar lschen, die MenuItems werden neu indiziert
+    Environment::Get()->GetCommandList()->UnbindAllMenuItems();
     for (size_t i=0, count=m_menubar->GetMenuCount(); i<count; ++i)
     {
         // TODO SO : Events lschen
@@ -326,6 +328,7 @@ wxXmlNode* MenuBar::WriteNode()
  **/
 {
     wxXmlNode* menubarnode = PenvHelper::CreateXmlNode(_T("menubar"));
+    XmlNodeBuilder builder(menubarnode);
     for (size_t i=0; i<m_array->Count(); ++i)
     {
         wxXmlNode* itemnode = (*m_array)[i]->WriteXml();
@@ -333,7 +336,7 @@ wxXmlNode* MenuBar::WriteNode()
             wxLogError(_T("[penv::MenuBar::WriteNode] Error writing 'menuitem' node, skipping this node."));
             continue;
         }
-        PenvHelper::AddXmlChildNode(menubarnode, itemnode);
+        builder.Append(itemnode);
     }
     return (menubarnode);
 }
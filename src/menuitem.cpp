@@ -10,6 +10,7 @@
 #include "menuitem.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "environment.h"
 
 namespace penv {
@@ -79,6 +80,11 @@ MenuItem::~MenuItem()
  * \brief Destructor.
  **/
 {
+    // Aus dem Index der CommandList entfernen
+    if (m_menuitem != NULL && m_type == penvMI_Command) {
+        CommandList* cmdlist = Environment::Get()->GetCommandList();
+        if (cmdlist != NULL) cmdlist->UnbindMenuItem(this);
+    }
     if (m_submenu != NULL) delete m_submenu;
 }
 
@@ -481,10 +487,11 @@ wxXmlNode* MenuItem::WriteXml()
         node->AddProperty(_T("name"), m_name);
         node->AddProperty(_T("enabled"), PenvHelper::CreateBoolean(m_enabled));
         node->AddProperty(_T("visible"), PenvHelper::CreateBoolean(m_visible));
+        XmlNodeBuilder builder(node);
         for (size_t i=0; i<m_submenu->Count(); ++i)
         {
             wxXmlNode* itemnode = (*m_submenu)[i]->WriteXml();
-            PenvHelper::AddXmlChildNode(node, itemnode);
+            builder.Append(itemnode);
         }
     }
     else if (m_type == penvMI_Checkbox)
@@ -554,6 +561,7 @@ void MenuItem::AddItems(wxMenu* menu, bool connect)
         }
         menu->Append(item);
         item->Enable(m_command->IsEnabled());
+        env->GetCommandList()->BindMenuItem(this);
         // Verbinden mit MenuBar falls noch nicht verbunden
         if (unlikely(!m_connected)) {
             // Verbinden mit Command
@@ -607,7 +615,7 @@ void MenuItem::FindMenuItems(Array<MenuItem>* array, const wxString& commandid)
     {
         for (size_t i=0; i<m_submenu->Count(); ++i)
         {
-            MenuItem* item = (*m_submenu)[i];
+            MenuItem* item = m_submenu->ItemUnchecked(i);
             item->FindMenuItems(array, commandid);
         }
     }
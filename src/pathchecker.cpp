@@ -0,0 +1,240 @@
+/*
+ * pathchecker.cpp - Implementation of the PathChecker class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "pathchecker.h"
+#include "expect.h"
+
+
+namespace penv {
+
+
+/**
+ * \brief The PathCheckerThread class is a worker thread of the
+ * PathChecker. It checks paths until there are no more paths left.
+ **/
+class PathCheckerThread : public wxThread
+{
+    public:
+        PathCheckerThread(PathChecker* checker);
+        virtual ExitCode Entry();
+
+    private:
+        PathChecker* m_checker;
+};
+
+
+
+//----------------------------------------------------------------
+PathCheckerThread::PathCheckerThread(PathChecker* checker)
+    : wxThread(wxTHREAD_JOINABLE)
+/**
+ * \brief Constructor, initializes the PathCheckerThread object.
+ * \param checker The checker which contains the paths.
+ **/
+{
+    m_checker = checker;
+}
+
+
+//----------------------------------------------------------------
+wxThread::ExitCode PathCheckerThread::Entry()
+/**
+ * \brief Entry point of the worker thread. Checks paths until
+ * there are no more paths left.
+ * \return Always 0.
+ **/
+{
+    while (m_checker->RunNextJob());
+    return (0);
+}
+
+
+
+//----------------------------------------------------------------
+PathChecker::PathChecker(size_t threadcount)
+/**
+ * \brief Constructor, initializes the PathChecker object.
+ * \param threadcount Maximum number of threads including the calling
+ * thread, which check the paths.
+ **/
+{
+    m_jobs = new Array<Job>(true);
+    m_threadcount = (threadcount > 0 ? threadcount : 1);
+    m_nextjob = 0;
+}
+
+
+//----------------------------------------------------------------
+PathChecker::~PathChecker()
+/**
+ * \brief Destructor.
+ **/
+{
+    delete m_jobs;
+}
+
+
+//----------------------------------------------------------------
+PathChecker::PathChecker(const PathChecker& checker)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+PathChecker& PathChecker::operator=(const PathChecker& checker)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+size_t PathChecker::AddFile(const wxString& path)
+/**
+ * \brief Adds a file, which existence should be checked.
+ * \param path Path to the file.
+ * \return Index of the path for Exists().
+ **/
+{
+    return (AddJob(path, false));
+}
+
+
+//----------------------------------------------------------------
+size_t PathChecker::AddDirectory(const wxString& path)
+/**
+ * \brief Adds a directory, which existence should be checked.
+ * \param path Path to the directory.
+ * \return Index of the path for Exists().
+ **/
+{
+    return (AddJob(path, true));
+}
+
+
+//----------------------------------------------------------------
+size_t PathChecker::Count() const
+/**
+ * \brief Returns the number of paths in the checker.
+ * \return Number of paths.
+ **/
+{
+    return (m_jobs->Count());
+}
+
+
+//----------------------------------------------------------------
+void PathChecker::Run()
+/**
+ * \brief Checks all paths, which were added since the last call.
+ * The worker threads and the calling thread take the paths one after
+ * another from the list. Returns after all paths are checked.
+ **/
+{
+    size_t count = m_jobs->Count() - m_nextjob;
+    size_t threadcount = m_threadcount;
+    if (count < penvPATHCHECKER_MINPARALLEL) threadcount = 1;
+    if (threadcount > count) threadcount = count;
+    Array<PathCheckerThread> threads(false);
+    for (size_t i=1; i<threadcount; ++i)
+    {
+        PathCheckerThread* thread = new PathCheckerThread(this);
+        if (thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR)
+        {
+            delete thread;
+            break;
+        }
+        threads.Add(thread);
+    }
+    // Der aufrufende Thread arbeitet mit
+    while (RunNextJob());
+    for (size_t i=0; i<threads.Count(); ++i)
+    {
+        threads.ItemUnchecked(i)->Wait();
+        delete threads.ItemUnchecked(i);
+    }
+    threads.Clear(false);
+}
+
+
+//----------------------------------------------------------------
+const wxString& PathChecker::GetPath(size_t index) const
+/**
+ * \brief Returns a path by its index.
+ * \param index Index of the path, see AddFile() and AddDirectory().
+ * \return The path.
+ **/
+{
+    wxASSERT(index < m_jobs->Count());
+    return (m_jobs->ItemUnchecked(index)->path);
+}
+
+
+//----------------------------------------------------------------
+bool PathChecker::Exists(size_t index) const
+/**
+ * \brief Returns the result of the check of a path. Run() must be
+ * called before.
+ * \param index Index of the path, see AddFile() and AddDirectory().
+ * \return True if the path exists; false if it does not exist or
+ * it is not checked yet.
+ **/
+{
+    if (unlikely(index >= m_jobs->Count())) return (false);
+    return (m_jobs->ItemUnchecked(index)->exists);
+}
+
+
+//----------------------------------------------------------------
+size_t PathChecker::AddJob(const wxString& path, bool directory)
+/**
+ * \brief Adds a path to the list. Must not be called while Run()
+ * is working.
+ * \param path The path.
+ * \param directory True if the path is a directory.
+ * \return Index of the path.
+ **/
+{
+    Job* job = new Job();
+    // Eigene Kopie, die Threads duerfen keinen Puffer teilen
+    job->path = path.c_str();
+    job->directory = directory;
+    job->exists = false;
+    m_jobs->Add(job);
+    return (m_jobs->Count()-1);
+}
+
+
+//----------------------------------------------------------------
+bool PathChecker::RunNextJob()
+/**
+ * \brief Takes the next path from the list and checks it. This
+ * method is thread safe.
+ * \return True if a path was checked; false if there are no paths left.
+ **/
+{
+    Job* job = NULL;
+    {
+        wxMutexLocker lock(m_mutex);
+        if (m_nextjob >= m_jobs->Count()) return (false);
+        job = m_jobs->ItemUnchecked(m_nextjob++);
+    }
+    if (job->directory) {
+        job->exists = wxDir::Exists(job->path);
+    } else {
+        job->exists = wxFile::Exists(job->path);
+    }
+    return (true);
+}
+
+} // namespace penv
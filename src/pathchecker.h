@@ -0,0 +1,88 @@
+/*
+ * pathchecker.h - Declaration of the PathChecker class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_PATHCHECKER_H_
+#define _PENV_PATHCHECKER_H_
+
+#include "wxincludes.h"
+#include "globals.h"
+#include "container/objarray.h"
+
+
+/**
+ * \brief Definition of the minimum number of paths, which are checked
+ * on more than one thread. Less paths are checked in the calling
+ * thread, because starting the threads would take longer.
+ **/
+#define penvPATHCHECKER_MINPARALLEL 8
+
+
+namespace penv {
+
+class PathCheckerThread;
+
+/**
+ * \brief The PathChecker class checks the existence of many files or
+ * directories at once. On network drives every check is a round trip
+ * to the server, so the paths are collected while reading a file and
+ * checked together on a pool of threads afterwards. The existence of
+ * a path can then be queried with Exists().<br>
+ * Example:<br>
+ * <code>
+ * PathChecker checker;<br>
+ * size_t index = checker.AddFile(filename);<br>
+ * checker.Run();<br>
+ * if (!checker.Exists(index)) wxLogWarning(...);<br>
+ * </code>
+ * The checker does not log any messages, so the callers can report
+ * missing paths in the order they were added.
+ **/
+class PathChecker
+{
+    public:
+        friend class PathCheckerThread;
+        PathChecker(size_t threadcount = penvCOMMON_PATHCHECKERTHREADS);
+        ~PathChecker();
+    private:
+        PathChecker(const PathChecker& checker);
+        PathChecker& operator=(const PathChecker& checker);
+
+    public:
+        size_t AddFile(const wxString& path);
+        size_t AddDirectory(const wxString& path);
+        size_t Count() const;
+
+        void Run();
+
+        const wxString& GetPath(size_t index) const;
+        bool Exists(size_t index) const;
+
+    private:
+        /**
+         * \brief A path, which should be checked.
+         **/
+        struct Job
+        {
+            wxString path;
+            bool directory;
+            bool exists;
+        };
+
+        size_t AddJob(const wxString& path, bool directory);
+        bool RunNextJob();
+
+    private:
+        Array<Job>* m_jobs;
+        size_t m_threadcount;
+        size_t m_nextjob;
+        wxMutex m_mutex;
+};
+
+} // namespace penv
+
+#endif // _PENV_PATHCHECKER_H_
@@ -14,15 +14,21 @@
 #include "command.h"
 #include "commandcallback.h"
 #include "commandevent.h"
+#include "commandeventid.h"
+#include "commandhandle.h"
 #include "commandlist.h"
 #include "commandobject.h"
+#include "commandupdatelocker.h"
+#include "directorywatcher.h"
 #include "environment.h"
+#include "memorypool.h"
 #include "menubar.h"
 #include "menuitem.h"
 #include "menuitemtype.h"
 #include "package.h"
 #include "packagedependency.h"
 #include "packagelist.h"
+#include "pathchecker.h"
 #include "project.h"
 #include "projectitem.h"
 #include "projectitemdirectory.h"
@@ -32,10 +38,13 @@
 #include "projectitemsubproject.h"
 #include "projectitemtype.h"
 #include "projectlist.h"
+#include "projectloader.h"
 #include "propertylist.h"
 #include "property.h"
 #include "shortcut.h"
 #include "shortcutlist.h"
+#include "snapshotreader.h"
+#include "snapshotwriter.h"
 #include "statusbar.h"
 #include "toolbar.h"
 #include "toolbaritem.h"
@@ -50,6 +59,10 @@
 #include "workspace.h"
 #include "workspacelist.h"
 #include "wxincludes.h"
+#include "xmlnodebuilder.h"
+#include "xmlreader.h"
+#include "xmlreadernodetype.h"
+#include "xmlwriter.h"
 
 #include "ui/commanddialog.h"
 #include "ui/commandmenutreedata.h"
@@ -65,6 +78,7 @@
 #include "ui/messagewindow.h"
 #include "ui/projecttreectrl.h"
 #include "ui/projecttreectrlapperance.h"
+#include "ui/projecttreefilter.h"
 #include "ui/projecttreeitemdata.h"
 #include "ui/projecttreeitemdataobject.h"
 
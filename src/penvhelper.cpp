@@ -11,6 +11,11 @@
 #include "penvhelper.h"
 #include <cstdlib>
 #include "environment.h"
+#ifdef __WXMSW__
+    #include <wx/msw/wrapwin.h> // QueryPerformanceCounter()
+#else
+    #include <sys/time.h>       // gettimeofday()
+#endif
 
 
 namespace penv {
@@ -156,6 +161,134 @@ bool PenvHelper::AddXmlChildNode(wxXmlNode* parent, wxXmlNode* node)
 }
 
 
+//----------------------------------------------------------------
+wxLongLong PenvHelper::GetMicroseconds()
+/**
+ * \brief Returns a high resolution timestamp in microseconds. The
+ * timestamp has no defined start, so it can only be used to measure
+ * time differences. wxStopWatch only has a resolution of milliseconds.
+ * \return Timestamp in microseconds.
+ **/
+{
+#ifdef __WXMSW__
+    static LARGE_INTEGER frequency = {{0, 0}};
+    if (unlikely(frequency.QuadPart == 0)) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (wxLongLong(counter.QuadPart / frequency.QuadPart * 1000000 +
+        (counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart));
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (wxLongLong(tv.tv_sec) * 1000000 + tv.tv_usec);
+#endif
+}
+
+
+/**
+ * \brief Checks if a character separates values in a list, which will
+ * be parsed with PenvHelper::ParseIntegers() and similar methods.
+ **/
+#define penvIS_LISTSEPARATOR(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+
+
+//----------------------------------------------------------------
+size_t PenvHelper::ParseIntegers(const wxChar* strg, int* values, size_t count)
+/**
+ * \brief Parses a list of integers, which are separated by whitespaces,
+ * in one pass without allocating memory. Invalid characters inside a
+ * value are ignored. If values is NULL, only the number of values in
+ * the list will be returned.
+ * \param strg The list of integers.
+ * \param values Array for the parsed values or NULL.
+ * \param count Size of the values array.
+ * \return Number of parsed values.
+ **/
+{
+    size_t index = 0;
+    const wxChar* p = strg;
+    while (true)
+    {
+        while (penvIS_LISTSEPARATOR(*p)) ++p;
+        if (*p == 0 || (values != NULL && index >= count)) break;
+        bool negative = (*p == '-');
+        if (*p == '-' || *p == '+') ++p;
+        long value = 0;
+        while (*p >= '0' && *p <= '9')
+        {
+            value = value*10 + (*p - '0');
+            ++p;
+        }
+        while (*p != 0 && !penvIS_LISTSEPARATOR(*p)) ++p;
+        if (values != NULL) values[index] = (int)(negative ? -value : value);
+        index++;
+    }
+    return (index);
+}
+
+
+//----------------------------------------------------------------
+size_t PenvHelper::ParseDoubles(const wxChar* strg, double* values, size_t count)
+/**
+ * \brief Parses a list of doubles, which are separated by whitespaces,
+ * in one pass without allocating memory. Invalid values are set to 0.
+ * If values is NULL, only the number of values in the list will be
+ * returned.
+ * \param strg The list of doubles.
+ * \param values Array for the parsed values or NULL.
+ * \param count Size of the values array.
+ * \return Number of parsed values.
+ **/
+{
+    size_t index = 0;
+    const wxChar* p = strg;
+    while (true)
+    {
+        while (penvIS_LISTSEPARATOR(*p)) ++p;
+        if (*p == 0 || (values != NULL && index >= count)) break;
+        if (values != NULL)
+        {
+            wxChar* end = NULL;
+            values[index] = wxStrtod(p, &end);
+            if (end == p) values[index] = 0;
+            else p = end;
+        }
+        while (*p != 0 && !penvIS_LISTSEPARATOR(*p)) ++p;
+        index++;
+    }
+    return (index);
+}
+
+
+//----------------------------------------------------------------
+size_t PenvHelper::ParseBooleans(const wxChar* strg, bool* values, size_t count)
+/**
+ * \brief Parses a list of booleans, which are separated by whitespaces,
+ * in one pass without allocating memory. Values starting with 't', 'T'
+ * or '1' are true, all other values are false. If values is NULL, only
+ * the number of values in the list will be returned.
+ * \param strg The list of booleans.
+ * \param values Array for the parsed values or NULL.
+ * \param count Size of the values array.
+ * \return Number of parsed values.
+ **/
+{
+    size_t index = 0;
+    const wxChar* p = strg;
+    while (true)
+    {
+        while (penvIS_LISTSEPARATOR(*p)) ++p;
+        if (*p == 0 || (values != NULL && index >= count)) break;
+        if (values != NULL) values[index] = (*p == 't' || *p == 'T' || *p == '1');
+        while (*p != 0 && !penvIS_LISTSEPARATOR(*p)) ++p;
+        index++;
+    }
+    return (index);
+}
+
+
 
 
 
@@ -64,6 +64,10 @@ class PenvHelper
         static wxXmlNode* CreateXmlNode(const wxString& elementname,
             const wxString& textcontent = wxEmptyString);
         static bool AddXmlChildNode(wxXmlNode* parent, wxXmlNode* node);
+        static wxLongLong GetMicroseconds();
+        static size_t ParseIntegers(const wxChar* strg, int* values, size_t count);
+        static size_t ParseDoubles(const wxChar* strg, double* values, size_t count);
+        static size_t ParseBooleans(const wxChar* strg, bool* values, size_t count);
 
 
 };
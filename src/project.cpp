@@ -12,6 +12,7 @@
 #include "penvhelper.h"
 #include "projectlist.h"
 #include "workspace.h"
+#include "projectitemsubproject.h"
 
 namespace penv {
 
@@ -23,6 +24,7 @@ Project::Project()
  * \brief Constructor (private).
  **/
 {
+    m_pool = NULL;
 }
 
 //----------------------------------------------------------------
@@ -36,6 +38,8 @@ Project::Project(ProjectList* parent)
 {
     m_modified = false;
     m_name = wxEmptyString;
+    m_pool = NULL;
+    if (penvCOMMON_USEMEMORYPOOL) m_pool = new MemoryPool();
     m_properties = new PropertyList();
     m_projectitems = new ProjectItemList(this);
     m_parent = parent;
@@ -48,8 +52,15 @@ Project::~Project()
  * \brief Destructor.
  **/
 {
+    if (m_modified && m_penvitemtype == penvIT_Project && m_parent != NULL &&
+        m_parent->GetParent() != NULL)
+    {
+        m_parent->GetParent()->AddModifiedProjects(-1);
+    }
     if (m_properties != NULL) delete m_properties;
     if (m_projectitems != NULL) delete m_projectitems;
+    // The pool destroys itself, when the last object is deleted
+    if (m_pool != NULL) m_pool->Release();
 }
 
 
@@ -67,11 +78,23 @@ bool Project::IsModified() const
 //----------------------------------------------------------------
 void Project::Modified(bool modified)
 /**
- * \brief Marks this project as modified.
+ * \brief Marks this project as modified. The change is only passed
+ * on if the state changes: a project updates the modified counter of
+ * its workspace, a modified subproject marks the project which
+ * contains it as modified. Marking a project as not modified also
+ * resets its subprojects, because they are saved into the same file.
  * \param modified True if Project should be marked as modified.
  **/
 {
+    if (m_modified == modified) return;
     m_modified = modified;
+    if (m_penvitemtype == penvIT_ProjectItemSubProject) {
+        ProjectItemList* list = ((ProjectItemSubProject*)this)->ProjectItem::GetParent();
+        if (modified && list != NULL) list->Modified(true);
+    } else if (m_parent != NULL && m_parent->GetParent() != NULL) {
+        m_parent->GetParent()->AddModifiedProjects(modified ? 1 : -1);
+    }
+    if (!modified && m_projectitems != NULL) m_projectitems->ClearModified();
 }
 
 //----------------------------------------------------------------
@@ -94,8 +117,9 @@ void Project::SetName(const wxString& name)
  * \param name Name of this project.
  **/
 {
+    DetachClones();
     m_name = name;
-    m_modified = true;
+    Modified(true);
 }
 
 
@@ -160,11 +184,18 @@ ProjectList* Project::GetParent()
 //----------------------------------------------------------------
 void Project::SetParent(ProjectList* projectlist)
 /**
- * \brief Sets the parent conatiner of this project.
+ * \brief Sets the parent conatiner of this project. A modified
+ * project is moved to the modified counter of the new workspace.
  * \param projectlist Parent container of this project.
  **/
 {
+    if (m_modified && m_parent != NULL && m_parent->GetParent() != NULL) {
+        m_parent->GetParent()->AddModifiedProjects(-1);
+    }
     m_parent = projectlist;
+    if (m_modified && m_parent != NULL && m_parent->GetParent() != NULL) {
+        m_parent->GetParent()->AddModifiedProjects(1);
+    }
 }
 
 //----------------------------------------------------------------
@@ -208,23 +239,55 @@ PropertyList* Project::GetPropertyList()
  * \return Properties of this project.
  **/
 {
+    DetachClones();
     return (m_properties);
 }
 
+
+//----------------------------------------------------------------
+void Project::DetachClones()
+/**
+ * \brief Must be called before a subproject is changed (private).
+ * Not yet copied clones of the list, which contains the subproject,
+ * copy their project items first. See ProjectItemList::Clone().
+ **/
+{
+    if (m_penvitemtype != penvIT_ProjectItemSubProject) return;
+    ProjectItemList* list = ((ProjectItemSubProject*)this)->ProjectItem::GetParent();
+    if (list != NULL) list->DetachClones();
+}
+
+//----------------------------------------------------------------
+MemoryPool* Project::GetMemoryPool()
+/**
+ * \brief Returns the memory pool of this project. All project items
+ * and their properties inside this project are created in this pool.
+ * Can return NULL if penvCOMMON_USEMEMORYPOOL is false.
+ * \return Memory pool or NULL.
+ **/
+{
+    return (m_pool);
+}
+
+
 //----------------------------------------------------------------
 Project* Project::Clone()
 /**
  * \brief Clones this class and returns it.
  * Parent will not be cloned, instead this
- * variable will be NULL.
+ * variable will be NULL. The project items and properties are
+ * shared until they are changed, see ProjectItemList::Clone().
  * \return Cloned instance of this class.
  **/
 {
     Project* project = new Project(NULL);
     project->m_name = m_name;
     project->m_modified = false;
+    delete project->m_properties;
     project->m_properties = m_properties->Clone();
+    delete project->m_projectitems;
     project->m_projectitems = m_projectitems->Clone();
+    project->m_projectitems->SetProjectParent(project);
     project->m_parent = NULL;
     return (project);
 }
@@ -239,6 +302,33 @@ bool Project::ReadNode(wxXmlNode* node)
  * \param node The 'project' xml element node.
  * \return True on success; false otherwise.
  **/
+{
+    if (!ReadReference(node)) return (false);
+    if (!wxFile::Exists(m_filename.GetPath()))
+    {
+        wxLogError(_T("[penv::Project::ReadNode] Project filename '%s' does not exist."), m_filename.GetPath().c_str());
+        return (false);
+    }
+    if (!Load())
+    {
+        wxLogError(_T("[penv::Project::ReadNode] Reading project filename '%s' failed."), m_filename.GetPath().c_str());
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool Project::ReadReference(wxXmlNode* node)
+/**
+ * \brief Reads out the name and the filename from a 'project' xml
+ * element node, without loading the project file and without checking
+ * if the file exists. Used by ReadNode() and by ProjectList::ReadNode(),
+ * which checks all project files with a PathChecker and loads them
+ * with a ProjectLoader.
+ * \param node The 'project' xml element node.
+ * \return True on success; false otherwise.
+ **/
 {
     if(node == NULL)
     {
@@ -263,22 +353,45 @@ bool Project::ReadNode(wxXmlNode* node)
         wspath = Path::RemoveLastEntry(wspath);
         path = Path::Combine(wspath, path);
     }
-    if (!wxFile::Exists(path))
-    {
-        wxLogError(_T("[penv::Project::ReadNode] Project filename '%s' does not exist."), path.c_str());
-        return (false);
-    }
     m_filename.SetPath(path);
-    if (!Load())
-    {
-        wxLogError(_T("[penv::Project::ReadNode] Reading project filename '%s' failed."), path.c_str());
-        return (false);
-    }
     return (true);
 }
 
 
 
+//----------------------------------------------------------------
+bool Project::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the project from a snapshot instead of the project
+ * file. The project is not set to modified.
+ * See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    m_name = reader->ReadString();
+    m_filename.SetPath(reader->ReadString());
+    if (!m_properties->ReadSnapshot(reader)) return (false);
+    return (m_projectitems->ReadSnapshot(reader));
+}
+
+
+//----------------------------------------------------------------
+void Project::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the project with all its project items into a
+ * snapshot. See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteString(m_name);
+    writer->WriteString(m_filename.GetPath());
+    m_properties->WriteSnapshot(writer);
+    m_projectitems->WriteSnapshot(writer);
+}
+
+
+
 //----------------------------------------------------------------
 wxXmlNode* Project::WriteNode()
 /**
@@ -300,32 +413,38 @@ bool Project::Save()
 /**
  * \brief Saves the appropriate project file.
  * The structure of project file is defined in class destription.
+ * The project items are written directly into the file with a
+ * XmlWriter, without creating a xml document. Project items which
+ * are not read yet (see ProjectItemList::Defer()) are read before
+ * the file is overwritten.
  * \return True on success, otherwise false.
  **/
 {
-    wxXmlDocument doc;
-    doc.SetFileEncoding(_T("UTF-8"));
-    wxXmlNode* node = PenvHelper::CreateXmlNode(_T("project"));
-    doc.SetRoot(node);
-
-    wxXmlNode* nodename = PenvHelper::CreateXmlNode(_T("name"), m_name);
-    PenvHelper::AddXmlChildNode(node, nodename);
-
-    wxXmlNode* nodeitems = m_projectitems->WriteNode();
-    if(nodeitems == NULL)
+    wxString filename = m_filename.GetPath();
+    // Nicht gelesene Projektelemente stehen noch in der Datei,
+    // die gleich ueberschrieben wird
+    if (!m_projectitems->LoadItems(true))
     {
-        wxLogError(_T("[penv::Project::Save] projectitems: Could not write XML-Structure."));
+        wxLogError(_T("[penv::Project::Save] Could not read all project items, project file '%s' is not saved."), filename.c_str());
+        return (false);
     }
-    PenvHelper::AddXmlChildNode(node, nodeitems);
-
-    wxXmlNode* nodeprops = m_properties->WriteNode();
-    if(nodeitems == NULL)
+    XmlWriter writer;
+    if (!writer.Open(filename))
     {
-        wxLogError(_T("[penv::Project::Save] projectproperties: Could not write XML-Structure."));
+        wxLogError(_T("[penv::Project::Save] Could not create project file '%s'."), filename.c_str());
+        return (false);
     }
-    PenvHelper::AddXmlChildNode(node, nodeprops);
-
-    return (node);
+    writer.WriteStartElement(_T("project"));
+    writer.WriteElement(_T("name"), m_name);
+    m_projectitems->WriteNode(&writer);
+    m_properties->WriteNode(&writer);
+    writer.WriteEndElement();
+    if (!writer.Close())
+    {
+        wxLogError(_T("[penv::Project::Save] Could not write project file '%s'."), filename.c_str());
+        return (false);
+    }
+    return (true);
 }
 
 //----------------------------------------------------------------
@@ -333,55 +452,53 @@ bool Project::Load()
 /**
  * \brief Reads out the appropriate project file.
  * The structure of project file is defined in class destription.
+ * The file is read with a XmlReader, so the project items are created
+ * while reading and the xml document is never completly in memory.
  * \return True on success, otherwise false.
  **/
 {
     wxString filename = m_filename.GetPath();
-    wxXmlDocument doc(filename, _T("UTF-8"));
-    if (!doc.IsOk())
+    XmlReader reader;
+    if (!reader.Open(filename) || !reader.ReadRootElement())
     {
-        wxLogError(_T("[penv::Project::Load] Could not read file '%s'."), filename.c_str());
+        wxLogError(_T("[penv::Project::Load] Could not read file '%s'. %s"), filename.c_str(), reader.GetError().c_str());
         return (false);
     }
-    wxXmlNode* root = doc.GetRoot();
-    if (root->GetType() != wxXML_ELEMENT_NODE || root->GetName() != _T("project"))
+    if (reader.GetName() != _T("project"))
     {
         wxLogError(_T("[penv::Project::Load] Node should be an element node with name 'project'."));
         return (false);
     }
-    wxXmlNode* node = root->GetChildren();
-    while (node != NULL)
+    size_t depth = reader.GetDepth();
+    while (reader.NextChild(depth))
     {
-        if (node->GetType() ==  wxXML_ELEMENT_NODE)
+        if (reader.GetName() == _T("name"))
         {
-            if (node->GetName() == _T("name"))
+            wxString name = reader.ReadElementContent();
+            if (!name.IsEmpty())
             {
-                wxString name = node->GetNodeContent();
-                if (!name.IsEmpty())
-                {
-                    m_name = name;
-                }
+                m_name = name;
             }
-            else if (node->GetName() == _T("projectitems"))
+        }
+        else if (reader.GetName() == _T("projectitems"))
+        {
+            if (!m_projectitems->ReadNode(&reader))
             {
-                if (!m_projectitems->ReadNode(node))
-                {
-                    wxLogError(_T("[penv::Project::Load] Failed reading 'projectitems' node from workspace file '%s'."), filename.c_str());
-                    node = node->GetNext();
-                    continue;
-                }
+                wxLogError(_T("[penv::Project::Load] Failed reading 'projectitems' node from workspace file '%s'."), filename.c_str());
             }
-            else if (node->GetName() == _T("properties"))
+        }
+        else if (reader.GetName() == _T("properties"))
+        {
+            if (!m_properties->ReadNode(&reader))
             {
-                if (!m_properties->ReadNode(node))
-                {
-                    wxLogError(_T("[penv::Project::Load] Failed reading 'properties' node from workspace file '%s'."), filename.c_str());
-                    node = node->GetNext();
-                    continue;
-                }
+                wxLogError(_T("[penv::Project::Load] Failed reading 'properties' node from workspace file '%s'."), filename.c_str());
             }
         }
-        node = node->GetNext();
+    }
+    if (reader.HasError())
+    {
+        wxLogError(_T("[penv::Project::Load] Error in file '%s': %s"), filename.c_str(), reader.GetError().c_str());
+        return (false);
     }
     return (true);
 }
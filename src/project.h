@@ -13,6 +13,7 @@
 #include "propertylist.h"
 #include "projectitemlist.h"
 #include "penvitem.h"
+#include "memorypool.h"
 
 namespace penv {
 
@@ -68,14 +69,21 @@ class Project : public PenvItem
 
         ProjectItemList* GetProjectItemList();
         PropertyList* GetPropertyList();
+        MemoryPool* GetMemoryPool();
 
         Project* Clone();
         bool ReadNode(wxXmlNode* node);
         wxXmlNode* WriteNode();
+        bool ReadSnapshot(SnapshotReader* reader);
+        void WriteSnapshot(SnapshotWriter* writer);
 
         bool Save();
         bool Load();
 
+    private:
+        bool ReadReference(wxXmlNode* node);
+        void DetachClones();
+
     protected:
         bool m_modified;
         wxString m_name;
@@ -84,6 +92,7 @@ class Project : public PenvItem
         ProjectItemList* m_projectitems;
         wxTreeItemId m_treeitem;
         ProjectList* m_parent;
+        MemoryPool* m_pool;
 };
 
 } // namespace penv
@@ -55,7 +55,9 @@ ProjectItem::ProjectItem(ProjectItemList* parent)
     m_windowid = wxEmptyString;
     m_windowtype = wxEmptyString;
     m_virtual = false;
-    m_properties = new PropertyList();
+    MemoryPool* pool = NULL;
+    if (parent != NULL) pool = parent->GetMemoryPool();
+    m_properties = new (pool) PropertyList(NULL, pool);
     m_parent = parent;
 }
 
@@ -88,6 +90,7 @@ void ProjectItem::SetName(const wxString& name)
  * \param name Name of the project item.
  **/
 {
+    Changed();
     m_name = name;
 }
 
@@ -163,6 +166,7 @@ void ProjectItem::SetWindowClassId(const wxString& windowtype)
     {
         wxLogWarning(_T("[penv::ProjectItem::SetWindowType] Window class id '%s' does not exists. If no window type will be registered then this could end in an unexpected behaivor."), windowtype.c_str());
     }
+    if (m_parent != NULL) m_parent->DetachClones();
     m_windowtype = windowtype;
 }
 
@@ -190,6 +194,7 @@ void ProjectItem::Virtual(bool fvirtual)
  * \param fvirtual True if the project item is virtual.
  **/
 {
+    if (m_parent != NULL) m_parent->DetachClones();
     m_virtual = fvirtual;
 }
 
@@ -274,10 +279,13 @@ void ProjectItem::SetTreeItemId(const wxTreeItemId& treeitemid)
 //----------------------------------------------------------------
 PropertyList* ProjectItem::GetPropertyList()
 /**
- * \brief Returns the property list for this project item.
+ * \brief Returns the property list for this project item. Because
+ * the properties can be changed, not yet copied clones of the list
+ * which contains this item copy their project items first.
  * \return Property list for this project item.
  **/
 {
+    if (m_parent != NULL) m_parent->DetachClones();
     return (m_properties);
 }
 
@@ -383,5 +391,52 @@ bool ProjectItem::CopyTo(ProjectItem* projectitem)
 }
 
 
+//----------------------------------------------------------------
+bool ProjectItem::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the common values of the project item from a snapshot.
+ * Inherited classes read their own values after calling this method.
+ * See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    m_name = reader->ReadString();
+    m_windowtype = reader->ReadString();
+    m_virtual = reader->ReadBool();
+    return (m_properties->ReadSnapshot(reader));
+}
+
+
+//----------------------------------------------------------------
+void ProjectItem::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the common values of the project item into a snapshot.
+ * Inherited classes write their own values after calling this method.
+ * See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteString(m_name);
+    writer->WriteString(m_windowtype);
+    writer->WriteBool(m_virtual);
+    m_properties->WriteSnapshot(writer);
+}
+
+
+//----------------------------------------------------------------
+void ProjectItem::Changed()
+/**
+ * \brief Must be called before an attribute of the project item is
+ * changed. Not yet copied clones of the list, which contains this
+ * item, copy their project items first and the project is set
+ * to modified.
+ **/
+{
+    if (m_parent == NULL) return;
+    m_parent->DetachClones();
+    m_parent->Modified(true);
+}
+
 
 } // namespace penv
@@ -50,6 +50,7 @@ enum ProjectItemType;
  **/
 class ProjectItem : public PenvItem
 {
+    DECLARE_MEMORYPOOL_OPERATORS()
     public:
         friend class ProjectItemList;
         ProjectItem();
@@ -122,6 +123,14 @@ class ProjectItem : public PenvItem
          * \return Cloned project item.
          **/
         virtual bool ReadNode(wxXmlNode* node) = 0;
+        /**
+         * \brief Reads a 'projectitem' xml element from a XmlReader.
+         * This method is abstract and only implemented in the
+         * inherited class. See description of this method in the
+         * inherited class.
+         * \return True on success; false otherwise.
+         **/
+        virtual bool ReadNode(XmlReader* reader) = 0;
         /**
          * \brief Writes a 'projectitem' xml element. This method
          * is abstract and only implemented in the inherited class.
@@ -129,6 +138,19 @@ class ProjectItem : public PenvItem
          * \return Cloned project item.
          **/
         virtual wxXmlNode* WriteNode() = 0;
+        /**
+         * \brief Writes a 'projectitem' xml element directly into a
+         * XmlWriter. This method is abstract and only implemented in
+         * the inherited class. See description of this method in the
+         * inherited class.
+         **/
+        virtual void WriteNode(XmlWriter* writer) = 0;
+
+        virtual bool ReadSnapshot(SnapshotReader* reader);
+        virtual void WriteSnapshot(SnapshotWriter* writer);
+
+    protected:
+        void Changed();
 
     protected:
         wxString m_name;
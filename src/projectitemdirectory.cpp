@@ -10,8 +10,11 @@
 #include "projectitemdirectory.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "projectitemlist.h"
 #include "project.h"
+#include "environment.h"
+#include "directorywatcher.h"
 
 namespace penv {
 
@@ -36,6 +39,7 @@ ProjectItemDirectory::ProjectItemDirectory(ProjectItemList* parent)
  **/
 {
     m_innerlist = new ProjectItemList(this);
+    m_watched = false;
     m_type = penvPI_Directory;
     m_penvitemtype = penvIT_ProjectItemDirectory;
 }
@@ -47,6 +51,7 @@ ProjectItemDirectory::~ProjectItemDirectory()
  * \brief Destructor.
  **/
 {
+    Unwatch();
     if (m_innerlist != NULL) delete m_innerlist;
 }
 
@@ -73,6 +78,21 @@ wxFileName ProjectItemDirectory::GetPath() const
 }
 
 
+//----------------------------------------------------------------
+void ProjectItemDirectory::SetPath(const wxString& path)
+/**
+ * \brief Sets the path of the directory. A not virtual directory
+ * is watched for changes, see DirectoryWatcher.
+ * \param path Full path to the directory.
+ **/
+{
+    Changed();
+    Unwatch();
+    m_directory.SetPath(path);
+    Watch();
+}
+
+
 //----------------------------------------------------------------
 ProjectItemList* ProjectItemDirectory::GetItemList()
 /**
@@ -123,8 +143,9 @@ bool ProjectItemDirectory::Load()
 ProjectItem* ProjectItemDirectory::Clone()
 /**
  * \brief Clones this project item and all its underlying
- * project items. The parent will not be cloned, instead
- * this will always be null.
+ * project items. The underlying project items are copied the first
+ * time they are accessed, see ProjectItemList::Clone(). The parent
+ * will not be cloned, instead this will always be null.
  * \return Return the cloned project item.
  **/
 {
@@ -134,10 +155,14 @@ ProjectItem* ProjectItemDirectory::Clone()
     item->m_windowid = wxEmptyString;
     item->m_windowtype = m_windowtype;
     item->m_virtual = m_virtual;
+    item->m_directory = m_directory;
+    delete item->m_properties;
     item->m_properties = m_properties->Clone();
     item->m_parent = NULL;
+    delete item->m_innerlist;
     item->m_innerlist = m_innerlist->Clone();
     item->m_innerlist->SetProjectItemParent(item);
+    item->Watch();
     return (item);
 }
 
@@ -190,12 +215,8 @@ bool ProjectItemDirectory::ReadNode(wxXmlNode* node)
                 } else {
                     path = Path::Combine(m_parent->GetProjectItemParent()->GetPathString(), path);
                 }
-                if(!wxDir::Exists(path) && !m_virtual)
-                {
-                    wxLogWarning(_T("[penv::ProjectItemDirectory::ReadNode] Directory '%s' does not exist."), path.c_str());
-                    innernode = innernode->GetNext();
-                    continue;
-                }
+                // Die Existenz wird von ProjectItemList::CheckPaths()
+                // fuer alle Verzeichnisse zusammen geprueft
                 m_directory.SetPath(path);
             }
             else if (innernode->GetName() == _T("projectitem"))
@@ -218,7 +239,8 @@ bool ProjectItemDirectory::ReadNode(wxXmlNode* node)
                     innernode = innernode->GetNext();
                     continue;
                 }
-                m_innerlist->Add(item);
+                // Beim Laden nicht als geaendert markieren
+                m_innerlist->m_array->Add(item);
             }
             else if (innernode->GetName() == _T("properties"))
             {
@@ -230,10 +252,106 @@ bool ProjectItemDirectory::ReadNode(wxXmlNode* node)
         }
         innernode = innernode->GetNext();
     }
+    m_innerlist->CheckPaths();
+    Watch();
     return (true);
 }
 
 
+//----------------------------------------------------------------
+bool ProjectItemDirectory::ReadNode(XmlReader* reader)
+/**
+ * \brief Read out a 'projectitem' xml element node from a XmlReader.
+ * The reader must be positioned on the start of the element, after
+ * this call it is positioned on the end of the element.
+ * See class description for more information.
+ * \param reader The XmlReader positioned on the 'projectitem' element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Knoten muss vom Typ Element sein
+    if (reader == NULL)
+    {
+        wxLogError(_T("[penv::ProjectItemDirectory::ReadNode] Argument 'reader' is NULL."));
+        return (false);
+    }
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("projectitem"))
+    {
+        wxLogError(_T("[penv::ProjectItemDirectory::ReadNode] Node should be an element node with name 'projectitem'."));
+        return (false);
+    }
+    wxString type = reader->GetAttribute(_T("type"), wxEmptyString);
+    if (type != _T("directory"))
+    {
+        wxLogError(_T("[penv::ProjectItemDirectory::ReadNode] ProjectItem must be ProjectItemDirectory."));
+        return (false);
+    }
+    m_name = reader->GetAttribute(_T("name"),wxEmptyString);
+    if(m_name.IsEmpty())
+    {
+       wxLogWarning(_T("[penv::ProjectItemDirectory::ReadNode] ProjectItemDirectory is nameless"));
+    }
+    m_virtual = PenvHelper::ParseBoolean(reader->GetAttribute(_T("virtual"), _T("false")));
+    wxFileOffset offset = reader->GetOffset();
+    // Durch alle Knoten unterhalb von 'projectitem' loopen, nicht
+    // gelesene Knoten werden von NextChild() uebersprungen
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() == _T("path"))
+        {
+            wxString path = reader->ReadElementContent();
+            if (m_parent->GetProjectParent() != NULL) {
+                path = Path::Combine(Path::RemoveLastEntry(m_parent->GetProjectParent()->GetFileNameString()), path);
+            } else {
+                path = Path::Combine(m_parent->GetProjectItemParent()->GetPathString(), path);
+            }
+            // Die Existenz wird von ProjectItemList::CheckPaths()
+            // fuer alle Verzeichnisse zusammen geprueft
+            m_directory.SetPath(path);
+        }
+        else if (reader->GetName() == _T("projectitem"))
+        {
+            // Unterelemente erst bei Bedarf lesen
+            if (m_innerlist->Defer(reader, offset))
+            {
+                reader->Skip();
+                continue;
+            }
+            wxString type = reader->GetAttribute(_T("type"),wxEmptyString);
+            if(type.IsEmpty())
+            {
+                wxLogError(_T("[penv::ProjectItemDirectory::ReadNode] Type attribut is missing."));
+                return(false);
+            }
+            ProjectItem* item = m_innerlist->CreateProjectItem(type);
+            if (item == NULL)
+            {
+                wxLogError(_T("[penv::ProjectItemDirectory::ReadNode] ProjectItemType '%s' undefined."), type.c_str());
+                return(false);
+            }
+            if (!item->ReadNode(reader))
+            {
+                wxLogWarning(_T("[penv::ProjectItemDirectory::ReadNode] ProjectItem failed to read."), type.c_str());
+                continue;
+            }
+            // Beim Laden nicht als geaendert markieren
+            m_innerlist->m_array->Add(item);
+        }
+        else if (reader->GetName() == _T("properties"))
+        {
+            if (!m_properties->ReadNode(reader))
+            {
+                wxLogError(_T("[penv::ProjectItemDirectory::ReadNode] Cannot read properties in ProjectItemDirectory."));
+            }
+        }
+    }
+    m_innerlist->CheckPaths();
+    Watch();
+    return (!reader->HasError());
+}
+
+
 //----------------------------------------------------------------
 wxXmlNode* ProjectItemDirectory::WriteNode()
 /**
@@ -256,19 +374,114 @@ wxXmlNode* ProjectItemDirectory::WriteNode()
     }
     wxXmlNode* path = PenvHelper::CreateXmlNode(_T("path"),
         Path::MakeRelative(parentpath, m_directory.GetPath()));
-    PenvHelper::AddXmlChildNode(node, path);
-    for(size_t i = 0; m_innerlist->Count(); i++)
+    XmlNodeBuilder builder(node);
+    builder.Append(path);
+    for(size_t i = 0; i < m_innerlist->Count(); i++)
     {
         ProjectItem* item = m_innerlist->GetItem(i);
         wxXmlNode* itemnode = item->WriteNode();
-        PenvHelper::AddXmlChildNode(node, itemnode);
+        builder.Append(itemnode);
     }
     wxXmlNode* propnode = m_properties->WriteNode();
-    PenvHelper::AddXmlChildNode(node, propnode);
+    builder.Append(propnode);
 
     return (node);
 }
 
 
+//----------------------------------------------------------------
+void ProjectItemDirectory::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'projectitem' xml element directly into a XmlWriter.
+ * See class description for more information.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("projectitem"));
+    writer->WriteAttribute(_T("name"), m_name);
+    writer->WriteAttribute(_T("type"), _T("directory"));
+    writer->WriteAttribute(_T("virtual"), PenvHelper::CreateBoolean(m_virtual));
+    wxString parentpath;
+    if (m_parent->GetProjectParent() == NULL) {
+        ProjectItem* item = m_parent->GetProjectItemParent();
+        parentpath = item->GetPathString();
+    } else {
+        Project* project = m_parent->GetProjectParent();
+        parentpath = project->GetFileNameString();
+    }
+    writer->WriteElement(_T("path"), Path::MakeRelative(parentpath, m_directory.GetPath()));
+    for(size_t i = 0; i < m_innerlist->Count(); i++)
+    {
+        m_innerlist->GetItem(i)->WriteNode(writer);
+    }
+    m_properties->WriteNode(writer);
+    writer->WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemDirectory::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the project item from a snapshot, including
+ * the path and the inner project items of the directory. See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (!ProjectItem::ReadSnapshot(reader)) return (false);
+    m_directory.SetPath(reader->ReadString());
+    if (!m_innerlist->ReadSnapshot(reader)) return (false);
+    Watch();
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemDirectory::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the project item into a snapshot, including
+ * the path and the inner project items of the directory. See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    ProjectItem::WriteSnapshot(writer);
+    writer->WriteString(m_directory.GetPath());
+    m_innerlist->WriteSnapshot(writer);
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemDirectory::Watch()
+/**
+ * \brief Registers the directory at the DirectoryWatcher, if it is
+ * not virtual and its path is known.
+ **/
+{
+    if (!penvCOMMON_DIRECTORYWATCHER || m_watched || m_virtual) return;
+    if (m_directory.GetPath().IsEmpty()) return;
+    WorkspaceList* workspaces = Environment::Get()->GetWorkspaceList();
+    if (unlikely(workspaces == NULL)) return;
+    // Der Pfad wird gemerkt, da m_directory sich aendern kann,
+    // bevor Unwatch() aufgerufen wird
+    m_watchedpath = m_directory.GetPath();
+    workspaces->GetDirectoryWatcher()->Add(this, m_watchedpath);
+    m_watched = true;
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemDirectory::Unwatch()
+/**
+ * \brief Removes the directory from the DirectoryWatcher.
+ **/
+{
+    if (!m_watched) return;
+    WorkspaceList* workspaces = Environment::Get()->GetWorkspaceList();
+    if (likely(workspaces != NULL)) workspaces->GetDirectoryWatcher()->Remove(this, m_watchedpath);
+    m_watchedpath = wxEmptyString;
+    m_watched = false;
+}
+
+
 } // namespace penv
 
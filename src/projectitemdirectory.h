@@ -33,6 +33,8 @@ namespace penv {
  * &nbsp;&nbsp;&lt;/properties&gt;<br>
  * &lt;/projectitem&gt;<br>
  * </code>
+ * The project items of a not virtual directory are kept in sync with
+ * the file system by the DirectoryWatcher.
  **/
 class ProjectItemDirectory : public ProjectItem
 {
@@ -49,6 +51,7 @@ class ProjectItemDirectory : public ProjectItem
 
         virtual wxString GetPathString() const;
         virtual wxFileName GetPath() const;
+        void SetPath(const wxString& path);
 
         virtual ProjectItemList* GetItemList();
 
@@ -56,11 +59,21 @@ class ProjectItemDirectory : public ProjectItem
         virtual bool Load();
         virtual ProjectItem* Clone();
         virtual bool ReadNode(wxXmlNode* node);
+        virtual bool ReadNode(XmlReader* reader);
         virtual wxXmlNode* WriteNode();
+        virtual void WriteNode(XmlWriter* writer);
+        virtual bool ReadSnapshot(SnapshotReader* reader);
+        virtual void WriteSnapshot(SnapshotWriter* writer);
+
+    private:
+        void Watch();
+        void Unwatch();
 
     protected:
         wxFileName m_directory;
         ProjectItemList* m_innerlist;
+        bool m_watched;
+        wxString m_watchedpath;
 
 };
 
@@ -10,6 +10,7 @@
 #include "projectitemfile.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "projectitemlist.h"
 #include "project.h"
 #include "environment.h"
@@ -39,7 +40,13 @@ ProjectItemFile::ProjectItemFile(ProjectItemList* parent)
  **/
 {
     m_type = penvPI_File;
-    m_windowtype = Environment::Get()->GetDefaultDocument();
+    // Der Referenzzaehler von wxString ist nicht threadsicher, deshalb
+    // wird in den Threads des ProjectLoader eine Kopie angelegt
+    if (likely(wxIsMainThread())) {
+        m_windowtype = Environment::Get()->GetDefaultDocument();
+    } else {
+        m_windowtype = Environment::Get()->GetDefaultDocument().c_str();
+    }
     m_penvitemtype = penvIT_ProjectItemFile;
 }
 
@@ -79,6 +86,18 @@ wxFileName ProjectItemFile::GetPath() const
 }
 
 
+//----------------------------------------------------------------
+void ProjectItemFile::SetPath(const wxString& path)
+/**
+ * \brief Sets the full path of the file.
+ * \param path Full path to the file.
+ **/
+{
+    Changed();
+    m_filename.SetPath(path);
+}
+
+
 //----------------------------------------------------------------
 ProjectItemList* ProjectItemFile::GetItemList()
 /**
@@ -103,7 +122,7 @@ bool ProjectItemFile::Save()
     if (m_virtual) {
         // TODO
         wxVariant variant(_T("TODO"));
-        Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_SAVE_VIRTUAL_PROJECTITEMFILE"), variant);
+        Environment::Get()->GetCommandList()->Execute(penvCE_SaveVirtualProjectItemFile, variant);
         return (true);
     }
     // Wenn kein Fenster zu ndern der Datei geffnet wurde,
@@ -180,6 +199,8 @@ ProjectItem* ProjectItemFile::Clone()
     item->m_windowid = wxEmptyString;
     item->m_windowtype = m_windowtype;
     item->m_virtual = m_virtual;
+    item->m_filename = m_filename;
+    delete item->m_properties;
     item->m_properties = m_properties->Clone();
     item->m_parent = NULL;
     return (item);
@@ -254,6 +275,74 @@ bool ProjectItemFile::ReadNode(wxXmlNode* node)
 }
 
 
+//----------------------------------------------------------------
+bool ProjectItemFile::ReadNode(XmlReader* reader)
+/**
+ * \brief Read out a 'projectitem' xml element node from a XmlReader.
+ * The reader must be positioned on the start of the element, after
+ * this call it is positioned on the end of the element.
+ * See class description for more information.
+ * \param reader The XmlReader positioned on the 'projectitem' element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Knoten muss vom Typ Element sein
+    if (reader == NULL)
+    {
+        wxLogError(_T("[penv::ProjectItemFile::ReadNode] Argument 'reader' is NULL."));
+        return (false);
+    }
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("projectitem"))
+    {
+        wxLogError(_T("[penv::ProjectItemFile::ReadNode] Node should be an element node with name 'projectitem'."));
+        return (false);
+    }
+    wxString type = reader->GetAttribute(_T("type"), wxEmptyString);
+    if (type != _T("file"))
+    {
+        wxLogError(_T("[penv::ProjectItemFile::ReadNode] ProjectItem must be ProjectItemFile."));
+        return (false);
+    }
+    m_name = reader->GetAttribute(_T("name"),wxEmptyString);
+    if(m_name.IsEmpty())
+    {
+       wxLogWarning(_T("[penv::ProjectItemFile::ReadNode] ProjectItem is nameless"));
+    }
+    m_virtual = PenvHelper::ParseBoolean(reader->GetAttribute(_T("virtual"), _T("false")));
+    // Durch alle Knoten unterhalb von 'projectitem' loopen, nicht
+    // gelesene Knoten werden von NextChild() uebersprungen
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() == _T("filename"))
+        {
+            wxString path = reader->ReadElementContent();
+            if (!Path::IsAbsolute(path))
+            {
+                // Relativer Pfad
+                wxString wspath;
+                if (m_parent->GetProjectParent() != NULL) {
+                    wspath = m_parent->GetProjectParent()->GetFileNameString();
+                    wspath = Path::RemoveLastEntry(wspath);
+                } else {
+                    wspath = m_parent->GetProjectItemParent()->GetPathString();
+                }
+                path = Path::Combine(wspath, path);
+            }
+            m_filename.SetPath(path);
+        }
+        else if (reader->GetName() == _T("properties"))
+        {
+            if (!m_properties->ReadNode(reader))
+            {
+                wxLogError(_T("[penv::ProjectItemFile::ReadNode] Cannot read properties in ProjectItemFile."));
+            }
+        }
+    }
+    return (!reader->HasError());
+}
+
+
 //----------------------------------------------------------------
 wxXmlNode* ProjectItemFile::WriteNode()
 /**
@@ -277,13 +366,68 @@ wxXmlNode* ProjectItemFile::WriteNode()
     }
     wxXmlNode* filename = PenvHelper::CreateXmlNode(_T("filename"),
         Path::MakeRelative(parentpath, m_filename.GetPath()));
-    PenvHelper::AddXmlChildNode(node, filename);
+    XmlNodeBuilder builder(node);
+    builder.Append(filename);
 
     wxXmlNode* propnode = m_properties->WriteNode();
-    PenvHelper::AddXmlChildNode(node, propnode);
+    builder.Append(propnode);
 
     return (node);
 }
 
+
+//----------------------------------------------------------------
+void ProjectItemFile::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'projectitem' xml element directly into a XmlWriter.
+ * See class description for more information.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("projectitem"));
+    writer->WriteAttribute(_T("name"), m_name);
+    writer->WriteAttribute(_T("type"), _T("file"));
+    writer->WriteAttribute(_T("virtual"), PenvHelper::CreateBoolean(m_virtual));
+    wxString parentpath;
+    if (m_parent->GetProjectParent() == NULL) {
+        ProjectItem* item = m_parent->GetProjectItemParent();
+        parentpath = item->GetPathString();
+    } else {
+        Project* project = m_parent->GetProjectParent();
+        parentpath = project->GetFileNameString();
+    }
+    writer->WriteElement(_T("filename"), Path::MakeRelative(parentpath, m_filename.GetPath()));
+    m_properties->WriteNode(writer);
+    writer->WriteEndElement();
+}
+
+//----------------------------------------------------------------
+bool ProjectItemFile::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the project item from a snapshot, including
+ * the path of the file. See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (!ProjectItem::ReadSnapshot(reader)) return (false);
+    m_filename.SetPath(reader->ReadString());
+    return (!reader->HasError());
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemFile::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the project item into a snapshot, including
+ * the path of the file. See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    ProjectItem::WriteSnapshot(writer);
+    writer->WriteString(m_filename.GetPath());
+}
+
+
 } // namespace penv
 
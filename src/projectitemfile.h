@@ -44,13 +44,18 @@ class ProjectItemFile : public ProjectItem
 
         virtual wxString GetPathString() const;
         virtual wxFileName GetPath() const;
+        void SetPath(const wxString& path);
         virtual ProjectItemList* GetItemList();
 
         virtual bool Save();
         virtual bool Load();
         virtual ProjectItem* Clone();
         virtual bool ReadNode(wxXmlNode* node);
+        virtual bool ReadNode(XmlReader* reader);
         virtual wxXmlNode* WriteNode();
+        virtual void WriteNode(XmlWriter* writer);
+        virtual bool ReadSnapshot(SnapshotReader* reader);
+        virtual void WriteSnapshot(SnapshotWriter* writer);
 
     private:
         wxFileName m_filename;
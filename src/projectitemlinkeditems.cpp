@@ -9,6 +9,7 @@
 #include "projectitemlinkeditems.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "projectitemlist.h"
 
 
@@ -122,8 +123,9 @@ bool ProjectItemLinkedItems::Load()
 ProjectItem* ProjectItemLinkedItems::Clone()
 /**
  * \brief Clones this project item and all its underlying
- * project items. The parent will not be cloned, instead
- * this will always be null.
+ * project items. The underlying project items are copied the first
+ * time they are accessed, see ProjectItemList::Clone(). The parent
+ * will not be cloned, instead this will always be null.
  * \return Return the cloned project item.
  **/
 {
@@ -133,8 +135,10 @@ ProjectItem* ProjectItemLinkedItems::Clone()
     item->m_windowid = wxEmptyString;
     item->m_windowtype = m_windowtype;
     item->m_virtual = m_virtual;
+    delete item->m_properties;
     item->m_properties = m_properties->Clone();
     item->m_parent = NULL;
+    delete item->m_innerlist;
     item->m_innerlist = m_innerlist->Clone();
     item->m_innerlist->SetProjectItemParent(item);
     return (item);
@@ -203,7 +207,8 @@ bool ProjectItemLinkedItems::ReadNode(wxXmlNode* node)
                     innernode = innernode->GetNext();
                     continue;
                 }
-                m_innerlist->Add(item);
+                // Beim Laden nicht als geaendert markieren
+                m_innerlist->m_array->Add(item);
             }
             else if (innernode->GetName() == _T("properties"))
             {
@@ -215,10 +220,96 @@ bool ProjectItemLinkedItems::ReadNode(wxXmlNode* node)
         }
         innernode = innernode->GetNext();
     }
+    m_innerlist->CheckPaths();
     return (true);
 }
 
 
+//----------------------------------------------------------------
+bool ProjectItemLinkedItems::ReadNode(XmlReader* reader)
+/**
+ * \brief Read out a 'projectitem' xml element node from a XmlReader.
+ * The reader must be positioned on the start of the element, after
+ * this call it is positioned on the end of the element.
+ * See class description for more information.
+ * \param reader The XmlReader positioned on the 'projectitem' element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Knoten muss vom Typ Element sein
+    if (reader == NULL)
+    {
+        wxLogError(_T("[penv::ProjectItemLinkedItems::ReadNode] Argument 'reader' is NULL."));
+        return (false);
+    }
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("projectitem"))
+    {
+        wxLogError(_T("[penv::ProjectItemLinkedItems::ReadNode] Node should be an element node with name 'projectitem'."));
+        return (false);
+    }
+    wxString type = reader->GetAttribute(_T("type"), wxEmptyString);
+    if (type != _T("linkeditem"))
+    {
+        wxLogError(_T("[penv::ProjectItemLinkedItems::ReadNode] ProjectItem must be ProjectItemLinkedItems."));
+        return (false);
+    }
+    m_name = reader->GetAttribute(_T("name"),wxEmptyString);
+    if(m_name.IsEmpty())
+    {
+       wxLogWarning(_T("[penv::ProjectItemLinkedItems::ReadNode] ProjectItem is nameless"));
+    }
+    m_virtual = PenvHelper::ParseBoolean(reader->GetAttribute(_T("virtual"), _T("false")));
+    wxFileOffset offset = reader->GetOffset();
+    // Durch alle Knoten unterhalb von 'projectitem' loopen, nicht
+    // gelesene Knoten werden von NextChild() uebersprungen
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() == _T("mainitem"))
+        {
+            m_name = reader->ReadElementContent();
+        }
+        else if (reader->GetName() == _T("projectitem"))
+        {
+            // Unterelemente erst bei Bedarf lesen
+            if (m_innerlist->Defer(reader, offset))
+            {
+                reader->Skip();
+                continue;
+            }
+            wxString type = reader->GetAttribute(_T("type"),wxEmptyString);
+            if(type.IsEmpty())
+            {
+                wxLogError(_T("[penv::ProjectItemLinkedItems::ReadNode] Type attribut is missing."));
+                return(false);
+            }
+            ProjectItem* item = m_innerlist->CreateProjectItem(type);
+            if (item == NULL)
+            {
+                wxLogError(_T("[penv::ProjectItemLinkedItems::ReadNode] ProjectItemType '%s' undefined."), type.c_str());
+                return(false);
+            }
+            if (!item->ReadNode(reader))
+            {
+                wxLogWarning(_T("[penv::ProjectItemLinkedItems::ReadNode] ProjectItem failed to read."), type.c_str());
+                continue;
+            }
+            // Beim Laden nicht als geaendert markieren
+            m_innerlist->m_array->Add(item);
+        }
+        else if (reader->GetName() == _T("properties"))
+        {
+            if (!m_properties->ReadNode(reader))
+            {
+                wxLogError(_T("[penv::ProjectItemLinkedItems::ReadNode] Cannot read properties in ProjectItemLinkedItems."));
+            }
+        }
+    }
+    m_innerlist->CheckPaths();
+    return (!reader->HasError());
+}
+
+
 
 //----------------------------------------------------------------
 wxXmlNode* ProjectItemLinkedItems::WriteNode()
@@ -234,21 +325,71 @@ wxXmlNode* ProjectItemLinkedItems::WriteNode()
     node->AddProperty(_T("virtual"), PenvHelper::CreateBoolean(m_virtual));
 
     wxXmlNode* mainitemnode = PenvHelper::CreateXmlNode(_T("mainitem"), m_name);
-    PenvHelper::AddXmlChildNode(node, mainitemnode);
-    for(size_t i = 0; m_innerlist->Count(); i++)
+    XmlNodeBuilder builder(node);
+    builder.Append(mainitemnode);
+    for(size_t i = 0; i < m_innerlist->Count(); i++)
     {
         ProjectItem* item = m_innerlist->GetItem(i);
         wxXmlNode* itemnode = item->WriteNode();
-        PenvHelper::AddXmlChildNode(node, itemnode);
+        builder.Append(itemnode);
     }
     wxXmlNode* propnode = m_properties->WriteNode();
-    PenvHelper::AddXmlChildNode(node, propnode);
+    builder.Append(propnode);
 
     return (node);
 }
 
 
+//----------------------------------------------------------------
+void ProjectItemLinkedItems::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'projectitem' xml element directly into a XmlWriter.
+ * See class description for more information.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("projectitem"));
+    writer->WriteAttribute(_T("name"), m_name);
+    writer->WriteAttribute(_T("type"), _T("linkeditem"));
+    writer->WriteAttribute(_T("virtual"), PenvHelper::CreateBoolean(m_virtual));
+    writer->WriteElement(_T("mainitem"), m_name);
+    for(size_t i = 0; i < m_innerlist->Count(); i++)
+    {
+        m_innerlist->GetItem(i)->WriteNode(writer);
+    }
+    m_properties->WriteNode(writer);
+    writer->WriteEndElement();
+}
+
+
+
 
 
+//----------------------------------------------------------------
+bool ProjectItemLinkedItems::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the project item from a snapshot, including
+ * the linked project items. See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (!ProjectItem::ReadSnapshot(reader)) return (false);
+    return (m_innerlist->ReadSnapshot(reader));
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemLinkedItems::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the project item into a snapshot, including
+ * the linked project items. See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    ProjectItem::WriteSnapshot(writer);
+    m_innerlist->WriteSnapshot(writer);
+}
+
 
 } // namespace penv
@@ -52,7 +52,11 @@ class ProjectItemLinkedItems : public ProjectItem
         virtual bool Load();
         virtual ProjectItem* Clone();
         virtual bool ReadNode(wxXmlNode* node);
+        virtual bool ReadNode(XmlReader* reader);
         virtual wxXmlNode* WriteNode();
+        virtual void WriteNode(XmlWriter* writer);
+        virtual bool ReadSnapshot(SnapshotReader* reader);
+        virtual void WriteSnapshot(SnapshotWriter* writer);
 
     private:
         ProjectItemList* m_innerlist;
@@ -11,6 +11,7 @@
 #include "projectitemlist.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "project.h"
 #include "projectitem.h"
 #include "projectitemfile.h"
@@ -18,11 +19,17 @@
 #include "projectitemlinkeditems.h"
 #include "projectitemsubproject.h"
 #include "environment.h"
+#include "pathchecker.h"
+#include <algorithm>
 
 
 namespace penv {
 
 
+// Anzahl der Klone, die ihre Items noch nicht kopiert haben
+size_t ProjectItemList::s_clonecount = 0;
+
+
 //----------------------------------------------------------------
 ProjectItemList::ProjectItemList()
 /**
@@ -42,6 +49,8 @@ ProjectItemList::ProjectItemList(Project* parent)
     m_projectparent = parent;
     m_projectitemparent = NULL;
     m_array = new Array<ProjectItem>();
+    m_deferred = NULL;
+    m_clones = NULL;
 }
 
 
@@ -56,6 +65,8 @@ ProjectItemList::ProjectItemList(ProjectItem* parent)
     m_projectitemparent = parent;
     m_projectparent = NULL;
     m_array = new Array<ProjectItem>();
+    m_deferred = NULL;
+    m_clones = NULL;
 }
 
 
@@ -66,7 +77,11 @@ ProjectItemList::~ProjectItemList()
  * \brief Destructor.
  **/
 {
+    // Klone dieser Liste brauchen jetzt ihre eigenen Items
+    LoadClones();
+    if (m_deferred != NULL && m_deferred->source != NULL) m_deferred->source->RemoveClone(this);
     if(m_array != NULL) delete m_array;
+    if(m_deferred != NULL) delete m_deferred;
 }
 
 
@@ -78,6 +93,7 @@ ProjectItem* ProjectItemList::GetItem(size_t index)
  * \return Project item on success; false otherwise.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     if (index < 0 || index >= m_array->Count())
     {
         wxLogError(_T("[penv::ProjectItemList::Item] Index is out of range."));
@@ -95,16 +111,10 @@ int ProjectItemList::GetItemIndex(ProjectItem* item)
  * \return Index of the ProjectItem on success; -1 if not found.
  **/
 {
-    int index = -1;
-
-    for(size_t i = 0; i < m_array->Count(); i++)
-    {
-        if (item == m_array->ItemPtr(i)) {
-            index = i;
-            break;
-        }
-    }
-    return index;
+    if (unlikely(m_deferred != NULL)) LoadItems();
+    Array<ProjectItem>::iterator itr = std::find(m_array->begin(), m_array->end(), item);
+    if (itr == m_array->end()) return (-1);
+    return (int)(itr - m_array->begin());
 }
 
 //----------------------------------------------------------------
@@ -120,6 +130,8 @@ bool ProjectItemList::Add(ProjectItem* prjitem)
         wxLogError(_T("[penv::ProjectItemList::Add] Argument 'prjitem' must be not NULL."));
         return(false);
     }
+    if (unlikely(m_deferred != NULL)) LoadItems();
+    DetachClones();
     m_array->Add(prjitem);
     Modified(true);
     return(true);
@@ -134,11 +146,13 @@ bool ProjectItemList::Remove(size_t index)
  * \return True on success; false otherwise.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     if(index < 0 || index >= m_array->Count())
     {
         wxLogError(_T("[penv::ProjectItemList::Remove] index out of range."));
         return(false);
     }
+    DetachClones();
     m_array->Remove(index);
     Modified(true);
     return (true);
@@ -149,10 +163,15 @@ bool ProjectItemList::Remove(size_t index)
 void ProjectItemList::Clear()
 /**
  * \brief Removes all project items from this container. This
- * method does not set the parent project to modified.
+ * method does not set the parent project to modified. Not yet read
+ * project items are dropped.
  **/
 {
+    DetachClones();
     m_array->Clear();
+    if (m_deferred != NULL && m_deferred->source != NULL) m_deferred->source->RemoveClone(this);
+    if (m_deferred != NULL) delete m_deferred;
+    m_deferred = NULL;
 }
 
 
@@ -163,6 +182,7 @@ size_t ProjectItemList::Count()
  * \return Number of project items in this container.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     return(m_array->Count());
 }
 
@@ -225,7 +245,7 @@ bool ProjectItemList::MoveProjectItem(size_t index, Project* dest)
  * \return True on success; false otherwise.
  **/
 {
-
+    if (unlikely(m_deferred != NULL)) LoadItems();
     if (index < 0 || index >= m_array->Count())
     {
         wxLogError(_T("[penv::ProjectItemList::MoveProjectItem] Index is out of range."));
@@ -236,6 +256,10 @@ bool ProjectItemList::MoveProjectItem(size_t index, Project* dest)
         return (true);
     }
     ProjectItem* item = (*m_array)[index];
+    if (item->GetItemList() != NULL) item->GetItemList()->LoadItems(true);
+    dest->GetProjectItemList()->LoadItems();
+    DetachClones();
+    dest->GetProjectItemList()->DetachClones();
     item->SetParent(dest->GetProjectItemList());
     dest->GetProjectItemList()->m_array->Add(item);
     dest->Modified();
@@ -248,7 +272,7 @@ bool ProjectItemList::MoveProjectItem(size_t index, Project* dest)
         }
     }
     m_array->Remove(index, false);
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_PROJECTITEM_MOVED"));
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemMoved);
     return(true);
 }
 
@@ -265,17 +289,20 @@ bool ProjectItemList::CopyProjectItem(size_t index, Project* dest)
  * \return True on success; false otherwise.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     if(index < 0 || index >= m_array->Count())
     {
         wxLogError(_T("[penv::ProjectItemList::CopyProjectItem] Index out of range."));
         return (false);
     }
     ProjectItem* item = (*m_array)[index]->Clone();
+    dest->GetProjectItemList()->LoadItems();
+    dest->GetProjectItemList()->DetachClones();
     item->SetParent(dest->GetProjectItemList());
     dest->GetProjectItemList()->m_array->Add(item);
     dest->Modified();
 
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_PROJECTITEM_COPIED"));
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemCopied);
     return(true);
 }
 
@@ -292,6 +319,7 @@ bool ProjectItemList::MoveProjectItem(size_t index, ProjectItem* dest)
  * \return True on success; false otherwise.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     if (index < 0 || index >= m_array->Count())
     {
         wxLogError(_T("[penv::ProjectItemList::MoveProjectItem] Index is out of range."));
@@ -306,6 +334,10 @@ bool ProjectItemList::MoveProjectItem(size_t index, ProjectItem* dest)
         return (false);
     }
     ProjectItem* item = (*m_array)[index];
+    if (item->GetItemList() != NULL) item->GetItemList()->LoadItems(true);
+    dest->GetItemList()->LoadItems();
+    DetachClones();
+    dest->GetItemList()->DetachClones();
     item->SetParent(dest->GetItemList());
     dest->GetItemList()->m_array->Add(item);
     if(dest->GetType() == penvPI_SubProject)
@@ -321,7 +353,7 @@ bool ProjectItemList::MoveProjectItem(size_t index, ProjectItem* dest)
         }
     }
     m_array->Remove(index, false);
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_PROJECTITEM_MOVED"));
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemMoved);
     return(true);
 }
 
@@ -338,12 +370,15 @@ bool ProjectItemList::CopyProjectItem(size_t index, ProjectItem* dest)
  * \return True on success; false otherwise.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     if(index < 0 || index >= m_array->Count())
     {
         wxLogError(_T("[penv::ProjectItemList::CopyProjectItem] Index out of range."));
         return (false);
     }
     ProjectItem* item = (*m_array)[index]->Clone();
+    dest->GetItemList()->LoadItems();
+    dest->GetItemList()->DetachClones();
     item->SetParent(dest->GetItemList());
     dest->GetItemList()->m_array->Add(item);
     if(dest->GetType() == penvPI_SubProject)
@@ -351,28 +386,172 @@ bool ProjectItemList::CopyProjectItem(size_t index, ProjectItem* dest)
         ((ProjectItemSubProject*)dest)->Modified();
     }
 
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_PROJECTITEM_COPIED"));
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemCopied);
     return(true);
 }
 
 
+//----------------------------------------------------------------
+size_t ProjectItemList::MoveProjectItems(Array<ProjectItem>* items, ProjectItemList* dest)
+/**
+ * \brief Moves project items from their containers to another
+ * container at once. Every changed container is set modified once and
+ * one 'PENV_EVT_PROJECTITEM_MOVED' event is generated, which contains
+ * the number of moved project items. Project items below other given
+ * project items are moved with them, project items which are already
+ * in the destination are skipped. This method fails if the destination
+ * is below one of the project items.
+ * \param items The project items, the array must not own them.
+ * \param dest Destination container.
+ * \return Number of moved project items.
+ **/
+{
+    if (unlikely(items == NULL || dest == NULL))
+    {
+        wxLogError(_T("[penv::ProjectItemList::MoveProjectItems] Argument 'items' or 'dest' is NULL."));
+        return (0);
+    }
+    ItemHashMap index;
+    Array<ProjectItem> moved(false);
+    GetTopItems(items, &moved, &index);
+    if (IsBelow(dest, &index))
+    {
+        wxLogError(_T("[penv::ProjectItemList::MoveProjectItems] Cannot move a project item below itself."));
+        return (0);
+    }
+    // Jede Quelle wird nur einmal geaendert
+    Array<ProjectItemList> sources(false);
+    for (size_t i=0; i<moved.Count(); ++i)
+    {
+        ProjectItem* item = moved.ItemUnchecked(i);
+        ProjectItemList* source = item->GetParent();
+        if (source == dest) continue;
+        if (item->GetItemList() != NULL) item->GetItemList()->LoadItems(true);
+        if (std::find(sources.begin(), sources.end(), source) != sources.end()) continue;
+        source->DetachClones();
+        sources.Add(source);
+    }
+    if (sources.Count() == 0) return (0);
+    if (unlikely(dest->m_deferred != NULL)) dest->LoadItems();
+    dest->DetachClones();
+    size_t count = 0;
+    for (size_t i=0; i<moved.Count(); ++i)
+    {
+        ProjectItem* item = moved.ItemUnchecked(i);
+        if (item->GetParent() == dest) continue;
+        item->SetParent(dest);
+        dest->m_array->Add(item);
+        count++;
+    }
+    for (size_t i=0; i<sources.Count(); ++i)
+    {
+        sources.ItemUnchecked(i)->RemoveItems(&index, false);
+        sources.ItemUnchecked(i)->Modified();
+    }
+    dest->Modified();
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemMoved, wxVariant((long)count));
+    return (count);
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectItemList::CopyProjectItems(Array<ProjectItem>* items, ProjectItemList* dest)
+/**
+ * \brief Copies project items to another container at once. The
+ * destination is set modified once and one 'PENV_EVT_PROJECTITEM_COPIED'
+ * event is generated, which contains the number of copied project items.
+ * Project items below other given project items are copied with them.
+ * This method fails if the destination is below one of the project items.
+ * \param items The project items, the array must not own them.
+ * \param dest Destination container.
+ * \return Number of copied project items.
+ **/
+{
+    if (unlikely(items == NULL || dest == NULL))
+    {
+        wxLogError(_T("[penv::ProjectItemList::CopyProjectItems] Argument 'items' or 'dest' is NULL."));
+        return (0);
+    }
+    ItemHashMap index;
+    Array<ProjectItem> copied(false);
+    GetTopItems(items, &copied, &index);
+    if (copied.Count() == 0) return (0);
+    if (IsBelow(dest, &index))
+    {
+        wxLogError(_T("[penv::ProjectItemList::CopyProjectItems] Cannot copy a project item below itself."));
+        return (0);
+    }
+    if (unlikely(dest->m_deferred != NULL)) dest->LoadItems();
+    dest->DetachClones();
+    dest->m_array->Reserve(dest->m_array->Count() + copied.Count());
+    for (size_t i=0; i<copied.Count(); ++i)
+    {
+        ProjectItem* item = copied.ItemUnchecked(i)->Clone();
+        item->SetParent(dest);
+        dest->m_array->Add(item);
+    }
+    dest->Modified();
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectItemCopied, wxVariant((long)copied.Count()));
+    return (copied.Count());
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectItemList::RemoveProjectItems(Array<ProjectItem>* items)
+/**
+ * \brief Removes and deletes project items from their containers at
+ * once. Every changed container is set modified once. Project items
+ * below other given project items are deleted with them.
+ * \param items The project items, the array must not own them.
+ * \return Number of removed project items.
+ **/
+{
+    if (unlikely(items == NULL))
+    {
+        wxLogError(_T("[penv::ProjectItemList::RemoveProjectItems] Argument 'items' is NULL."));
+        return (0);
+    }
+    ItemHashMap index;
+    Array<ProjectItem> removed(false);
+    GetTopItems(items, &removed, &index);
+    Array<ProjectItemList> sources(false);
+    for (size_t i=0; i<removed.Count(); ++i)
+    {
+        ProjectItemList* source = removed.ItemUnchecked(i)->GetParent();
+        if (std::find(sources.begin(), sources.end(), source) != sources.end()) continue;
+        source->DetachClones();
+        sources.Add(source);
+    }
+    for (size_t i=0; i<sources.Count(); ++i)
+    {
+        sources.ItemUnchecked(i)->RemoveItems(&index, true);
+        sources.ItemUnchecked(i)->Modified();
+    }
+    return (removed.Count());
+}
+
+
 //----------------------------------------------------------------
 ProjectItemList* ProjectItemList::Clone()
 /**
  * \brief Clones this class and returns it.
  * Parent project and projectitem will not be cloned, instead this
- * variable will be NULL.
+ * variable will be NULL. The project items are not copied now, the
+ * clone copies them the first time it is accessed, or before this list
+ * or a list above is changed. See class description.
  * \return Cloned instance of this class.
  **/
 {
     ProjectItemList* projectitemlist = new ProjectItemList((ProjectItem*)NULL);
     projectitemlist->m_projectparent = NULL;
     projectitemlist->m_projectitemparent = NULL;
-    for (size_t i=0; i<m_array->Count(); ++i)
-    {
-        ProjectItem* item = (*m_array)[i]->Clone();
-        projectitemlist->m_array->Add(item);
-    }
+    projectitemlist->m_deferred = new DeferredItems();
+    projectitemlist->m_deferred->offset = 0;
+    projectitemlist->m_deferred->modified = 0;
+    projectitemlist->m_deferred->source = this;
+    if (m_clones == NULL) m_clones = new Array<ProjectItemList>(false);
+    m_clones->Add(projectitemlist);
+    s_clonecount++;
     return (projectitemlist);
 }
 
@@ -398,6 +577,7 @@ bool ProjectItemList::ReadNode(wxXmlNode* node)
         return (false);
     }
     // Durch alle knoten unterhalb von 'projectitems' loopen
+    size_t first = m_array->Count();
     wxXmlNode* itemnode = node->GetChildren();
     while (itemnode != NULL)
     {
@@ -426,10 +606,79 @@ bool ProjectItemList::ReadNode(wxXmlNode* node)
         }
         itemnode = itemnode->GetNext();
     }
+    CheckPaths(first);
     return (true);
 }
 
 
+//----------------------------------------------------------------
+bool ProjectItemList::ReadNode(XmlReader* reader)
+/**
+ * \brief Read out a 'projectitems' xml element node from a XmlReader.
+ * The project items are created while the file is read, so the xml
+ * document is never completly in memory. The reader must be positioned
+ * on the start of the element, after this call it is positioned on
+ * the end of the element.
+ * See class description for structure of such an xml node.
+ * \param reader The XmlReader positioned on the 'projectitems' element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Knoten muss vom Typ Element sein
+    if (reader == NULL)
+    {
+        wxLogError(_T("[penv::ProjectItemList::ReadNode] Argument 'reader' is NULL."));
+        return (false);
+    }
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("projectitems"))
+    {
+        wxLogError(_T("[penv::ProjectItemList::ReadNode] Node should be an element node with name 'projectitems'."));
+        return (false);
+    }
+    return (ReadItems(reader));
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::ReadItems(XmlReader* reader)
+/**
+ * \brief Reads all 'projectitem' child elements of the current
+ * element from a XmlReader and adds them to this list. Other child
+ * elements are skipped.
+ * \param reader The XmlReader positioned on the parent element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Durch alle Knoten unterhalb des Elements loopen
+    size_t first = m_array->Count();
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() != _T("projectitem")) continue;
+        wxString type = reader->GetAttribute(_T("type"),wxEmptyString);
+        if(type.IsEmpty())
+        {
+            wxLogError(_T("[penv::ProjectItemList::ReadNode] Type attribut is missing."));
+            return(false);
+        }
+        ProjectItem* item = CreateProjectItem(type);
+        if (item == NULL)
+        {
+            wxLogError(_T("[penv::ProjectItemList::ReadNode] ProjectItemType '%s' undefined."), type.c_str());
+            return(false);
+        }
+        if (!item->ReadNode(reader))
+        {
+            wxLogWarning(_T("[penv::ProjectItemList::ReadNode] ProjectItem failed to read."), type.c_str());
+            continue;
+        }
+        m_array->Add(item);
+    }
+    CheckPaths(first);
+    return (!reader->HasError());
+}
+
+
 
 //----------------------------------------------------------------
 wxXmlNode* ProjectItemList::WriteNode()
@@ -439,21 +688,328 @@ wxXmlNode* ProjectItemList::WriteNode()
  * \return The 'projectitems' xml element node; or NULL on error.
  **/
 {
+    if (unlikely(m_deferred != NULL)) LoadItems();
     wxXmlNode* node = PenvHelper::CreateXmlNode(_T("projectitems"));
-    for(size_t i = 0; i < m_array->Count(); i++)
+    XmlNodeBuilder builder(node);
+    Array<ProjectItem>::iterator itr;
+    for (itr = m_array->begin(); itr != m_array->end(); ++itr)
     {
-        wxXmlNode* nodeitem = (*m_array)[i]->WriteNode();
+        wxXmlNode* nodeitem = (*itr)->WriteNode();
         if(nodeitem == NULL)
         {
-            wxLogError(_T("[penv::ProjectItemList::WriteNode] Could not write project item '%s' xml node."), (*m_array)[i]->GetName().c_str());
+            wxLogError(_T("[penv::ProjectItemList::WriteNode] Could not write project item '%s' xml node."), (*itr)->GetName().c_str());
             continue;
         }
-        PenvHelper::AddXmlChildNode(node, nodeitem);
+        builder.Append(nodeitem);
     }
     return (node);
 }
 
 
+//----------------------------------------------------------------
+void ProjectItemList::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'projectitems' xml element directly into a
+ * XmlWriter, without creating xml nodes for the project items.
+ * See class description for structure of such an xml node.
+ * \param writer The XmlWriter.
+ **/
+{
+    if (unlikely(m_deferred != NULL)) LoadItems();
+    writer->WriteStartElement(_T("projectitems"));
+    Array<ProjectItem>::iterator itr;
+    for (itr = m_array->begin(); itr != m_array->end(); ++itr)
+    {
+        (*itr)->WriteNode(writer);
+    }
+    writer->WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the project items from a snapshot, which was written
+ * by WriteSnapshot(). Not yet read project items stay deferred.
+ * The project is not set to modified.
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (reader->ReadBool())
+    {
+        if (m_deferred == NULL) m_deferred = new DeferredItems();
+        m_deferred->source = NULL;
+        m_deferred->filename = reader->ReadString();
+        m_deferred->encoding = reader->ReadString();
+        m_deferred->offset = reader->ReadOffset();
+        m_deferred->modified = (time_t)reader->ReadOffset();
+        return (!reader->HasError());
+    }
+    size_t count = reader->ReadUInt32();
+    for (size_t i=0; i<count && !reader->HasError(); ++i)
+    {
+        ProjectItem* item = CreateProjectItem((ProjectItemType)reader->ReadUInt32());
+        if (item == NULL) return (false);
+        if (!item->ReadSnapshot(reader))
+        {
+            delete item;
+            return (false);
+        }
+        m_array->Add(item);
+    }
+    return (!reader->HasError());
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the project items into a snapshot. Deferred project
+ * items are not read, only their position in the project file is
+ * written. See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    // Klone haben keine Position in einer Datei
+    if (m_deferred != NULL && m_deferred->source != NULL) LoadItems();
+    writer->WriteBool(m_deferred != NULL);
+    if (m_deferred != NULL)
+    {
+        writer->WriteString(m_deferred->filename);
+        writer->WriteString(m_deferred->encoding);
+        writer->WriteOffset(m_deferred->offset);
+        writer->WriteOffset((wxFileOffset)m_deferred->modified);
+        return;
+    }
+    writer->WriteUInt32((wxUint32)m_array->Count());
+    Array<ProjectItem>::iterator itr;
+    for (itr = m_array->begin(); itr != m_array->end(); ++itr)
+    {
+        writer->WriteUInt32((*itr)->GetType());
+        (*itr)->WriteSnapshot(writer);
+    }
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::Defer(XmlReader* reader, wxFileOffset offset)
+/**
+ * \brief Remembers the position of the project items in the file,
+ * instead of reading them now. The items are read by LoadItems(),
+ * the first time the list is accessed. The element at the position
+ * must be a 'projectitems' element or a 'projectitem' element with
+ * 'projectitem' child elements. Returns false if reading on demand
+ * is switched off with penvCOMMON_LAZYPROJECTITEMS, then the caller
+ * must read the items itself.
+ * \param reader The XmlReader which reads the project file.
+ * \param offset Position of the element, see XmlReader::GetOffset().
+ * \return True if the items are read later; false otherwise.
+ **/
+{
+    if (!penvCOMMON_LAZYPROJECTITEMS) return (false);
+    if (m_deferred != NULL) return (true);
+    m_deferred = new DeferredItems();
+    m_deferred->source = NULL;
+    m_deferred->filename = reader->GetFileName();
+    m_deferred->encoding = reader->GetEncoding();
+    m_deferred->offset = offset;
+    m_deferred->modified = wxFileModificationTime(m_deferred->filename);
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::IsDeferred() const
+/**
+ * \brief Returns true if the project items of this list are not
+ * read yet or not yet copied from the cloned list. See Defer() and
+ * Clone().
+ * \return True if the items are not read yet; false otherwise.
+ **/
+{
+    return (m_deferred != NULL);
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::LoadItems(bool recursive)
+/**
+ * \brief Reads the project items, which were deferred with Defer(),
+ * or copies the project items of the cloned list (see Clone()).
+ * Does nothing if the items are already read. The project is not set
+ * to modified. If the project file was changed since the project was
+ * loaded, the items can not be read and an error is logged.
+ * \param recursive True to read all project items below this list,
+ * for example before the project file is overwritten.
+ * \return True on success; false otherwise.
+ **/
+{
+    bool result = true;
+    if (m_deferred != NULL && m_deferred->source != NULL)
+    {
+        // Items der geklonten Liste kopieren, die Listen darunter
+        // werden wieder als Klone erzeugt
+        ProjectItemList* source = m_deferred->source;
+        delete m_deferred;
+        m_deferred = NULL;
+        source->RemoveClone(this);
+        if (unlikely(source->m_deferred != NULL)) result = source->LoadItems();
+        m_array->Reserve(source->m_array->Count());
+        for (size_t i=0; i<source->m_array->Count(); ++i)
+        {
+            ProjectItem* item = source->m_array->ItemUnchecked(i)->Clone();
+            item->SetParent(this);
+            m_array->Add(item);
+        }
+    }
+    else if (m_deferred != NULL)
+    {
+        // Zuerst austragen, damit Count() usw. beim Lesen nicht
+        // wieder hierher kommen
+        DeferredItems* deferred = m_deferred;
+        m_deferred = NULL;
+        XmlReader reader;
+        if (wxFileModificationTime(deferred->filename) != deferred->modified)
+        {
+            wxLogError(_T("[penv::ProjectItemList::LoadItems] Project file '%s' was changed, project items could not be read."), deferred->filename.c_str());
+            result = false;
+        }
+        else if (!reader.Open(deferred->filename, deferred->offset, deferred->encoding) || !reader.ReadRootElement())
+        {
+            wxLogError(_T("[penv::ProjectItemList::LoadItems] Could not read project items from file '%s'. %s"), deferred->filename.c_str(), reader.GetError().c_str());
+            result = false;
+        }
+        else if (!ReadItems(&reader))
+        {
+            wxLogError(_T("[penv::ProjectItemList::LoadItems] Error in file '%s': %s"), deferred->filename.c_str(), reader.GetError().c_str());
+            result = false;
+        }
+        delete deferred;
+    }
+    if (recursive)
+    {
+        for (size_t i=0; i<m_array->Count(); ++i)
+        {
+            ProjectItemList* list = m_array->ItemUnchecked(i)->GetItemList();
+            if (list != NULL && !list->LoadItems(true)) result = false;
+        }
+    }
+    return (result);
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::HasPendingClones()
+/**
+ * \brief Returns true if there are clones, which have not yet copied
+ * the project items of the cloned list. Such clones read the cloned
+ * list when they are accessed, so the cloned and the cloning project
+ * must not be accessed from different threads.
+ * \return True if there are clones left; false otherwise.
+ **/
+{
+    return (s_clonecount > 0);
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::DetachClones()
+/**
+ * \brief Must be called before this list or one of its project items
+ * is changed (private). The not yet copied clones of the lists above
+ * and of this list copy their project items now, so they keep the
+ * state of the moment they were cloned. Only the lists on the path to
+ * this list are copied.
+ **/
+{
+    if (likely(s_clonecount == 0)) return;
+    // Zuerst die Klone der Listen darueber, sie erzeugen dabei neue
+    // Klone dieser Liste
+    ProjectItemList* parent = NULL;
+    if (m_projectitemparent != NULL) {
+        parent = m_projectitemparent->GetParent();
+    } else if (m_projectparent != NULL &&
+               m_projectparent->GetPenvItemType() == penvIT_ProjectItemSubProject) {
+        parent = ((ProjectItemSubProject*)m_projectparent)->ProjectItem::GetParent();
+    }
+    if (parent != NULL) parent->DetachClones();
+    LoadClones();
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::LoadClones()
+/**
+ * \brief Lets all not yet copied clones of this list copy their
+ * project items (private).
+ **/
+{
+    if (m_clones == NULL) return;
+    while (m_clones->Count() > 0)
+    {
+        // LoadItems() entfernt den Klon aus der Liste
+        m_clones->ItemUnchecked(m_clones->Count()-1)->LoadItems();
+    }
+    delete m_clones;
+    m_clones = NULL;
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::RemoveClone(ProjectItemList* clone)
+/**
+ * \brief Removes a clone, which copied its project items or which
+ * is deleted, from the clones of this list (private).
+ * \param clone The clone.
+ **/
+{
+    if (m_clones == NULL) return;
+    for (size_t i=0; i<m_clones->Count(); ++i)
+    {
+        if (m_clones->ItemUnchecked(i) != clone) continue;
+        m_clones->Remove(i, false);
+        s_clonecount--;
+        return;
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::CheckPaths(size_t first)
+/**
+ * \brief Checks if the directories of the read directory items exist.
+ * The directories are checked at once by a PathChecker after the
+ * items are read, instead of one after another while reading. Virtual
+ * directory items are not checked. A directory item, whose directory
+ * does not exist, keeps no path and a warning is logged.
+ * \param first Index of the first item, which should be checked.
+ **/
+{
+    if (m_deferred != NULL) return;
+    PathChecker checker;
+    Array<ProjectItemDirectory> directories(false);
+    for (size_t i=first; i<m_array->Count(); ++i)
+    {
+        ProjectItem* item = m_array->ItemUnchecked(i);
+        if (item->GetType() != penvPI_Directory || item->IsVirtual()) continue;
+        ProjectItemDirectory* directory = (ProjectItemDirectory*)item;
+        directories.Add(directory);
+        checker.AddDirectory(directory->m_directory.GetPath());
+    }
+    if (checker.Count() == 0) return;
+    checker.Run();
+    for (size_t i=0; i<directories.Count(); ++i)
+    {
+        if (checker.Exists(i)) continue;
+        wxLogWarning(_T("[penv::ProjectItemDirectory::ReadNode] Directory '%s' does not exist."), checker.GetPath(i).c_str());
+        directories.ItemUnchecked(i)->Unwatch();
+        directories.ItemUnchecked(i)->m_directory.Clear();
+    }
+    directories.Clear(false);
+}
+
+
 //----------------------------------------------------------------
 ProjectItem* ProjectItemList::CreateProjectItem(const wxString& type)
 /**
@@ -464,17 +1020,18 @@ ProjectItem* ProjectItemList::CreateProjectItem(const wxString& type)
  **/
 {
     ProjectItem* item = NULL;
+    MemoryPool* pool = GetMemoryPool();
     if(type == _T("file"))  {
-        item = new ProjectItemFile(this);
+        item = new (pool) ProjectItemFile(this);
     }
     else if(type == _T("directory")) {
-        item = new ProjectItemDirectory(this);
+        item = new (pool) ProjectItemDirectory(this);
     }
     else if(type == _T("linkeditem")) {
-        item = new ProjectItemLinkedItems(this);
+        item = new (pool) ProjectItemLinkedItems(this);
     }
     else if(type == _T("subproject")) {
-        item = new ProjectItemSubProject(this);
+        item = new (pool) ProjectItemSubProject(this);
     }
     else {
         wxLogError(_T("[penv::ProjectItemList::CreateProjectItem] ProjectItemType '%s' undefined."), type.c_str());
@@ -493,17 +1050,18 @@ ProjectItem* ProjectItemList::CreateProjectItem(ProjectItemType type)
  **/
 {
     ProjectItem* item = NULL;
+    MemoryPool* pool = GetMemoryPool();
     if(type == penvPI_File)  {
-        item = new ProjectItemFile(this);
+        item = new (pool) ProjectItemFile(this);
     }
     else if(type == penvPI_Directory) {
-        item = new ProjectItemDirectory(this);
+        item = new (pool) ProjectItemDirectory(this);
     }
     else if(type == penvPI_LinkedItems) {
-        item = new ProjectItemLinkedItems(this);
+        item = new (pool) ProjectItemLinkedItems(this);
     }
     else if(type == penvPI_SubProject) {
-        item = new ProjectItemSubProject(this);
+        item = new (pool) ProjectItemSubProject(this);
     }
     else {
         wxLogError(_T("[penv::ProjectItemList::CreateProjectItem] ProjectItemType is undefined."));
@@ -512,33 +1070,160 @@ ProjectItem* ProjectItemList::CreateProjectItem(ProjectItemType type)
 }
 
 
+//----------------------------------------------------------------
+MemoryPool* ProjectItemList::GetMemoryPool()
+/**
+ * \brief Returns the memory pool of the project, which contains this
+ * list. New project items will be created in this pool.
+ * \return Memory pool or NULL, if the list has no parent project.
+ **/
+{
+    if (m_projectparent != NULL) {
+        return (m_projectparent->GetMemoryPool());
+    }
+    if (m_projectitemparent != NULL && m_projectitemparent->GetParent() != NULL) {
+        return (m_projectitemparent->GetParent()->GetMemoryPool());
+    }
+    return (NULL);
+}
+
+
 //----------------------------------------------------------------
 void ProjectItemList::Modified(bool modified)
 /**
- * \brief Sets the parent project or subproject modified.
+ * \brief Sets the parent project or subproject modified. Only the
+ * directories up to the next project or subproject are walked, the
+ * project passes the change on only if its state changes (see
+ * Project::Modified()).
  * \param modified True if modified.
  **/
 {
-    if (m_projectparent != NULL) {
-        m_projectparent->Modified(true);
-    } else {
-        // SubProject is modified
-        if (m_projectitemparent->GetType() == penvPI_SubProject) {
-            ((ProjectItemSubProject*)m_projectitemparent)->Modified(true);
-        }
-        // If parent ProjectItem is not a ProjectItemFile then
-        //    deepest project must be set modified
-        ProjectItemList* list = this;
-        while (list->GetProjectItemParent() != NULL)
+    ProjectItemList* list = this;
+    while (list->m_projectparent == NULL)
+    {
+        if (unlikely(list->m_projectitemparent == NULL ||
+            list->m_projectitemparent->GetParent() == NULL))
         {
-            list = list->GetProjectItemParent()->GetParent();
-        }
-        Project* project = list->GetProjectParent();
-        if (project == NULL) {
             wxLogError(_T("[penv::ProjectItemList::Modified] There is a mismatch between the project and project items."));
             return;
         }
-        project->Modified(true);
+        list = list->m_projectitemparent->GetParent();
+    }
+    list->m_projectparent->Modified(true);
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::RemoveItems(ItemHashMap* index, bool free)
+/**
+ * \brief Removes all project items of the index from this container
+ * in one pass.
+ * \param index The project items to remove.
+ * \param free True if the project items should be deleted.
+ **/
+{
+    Array<ProjectItem> kept(false);
+    kept.Reserve(m_array->Count());
+    for (size_t i=0; i<m_array->Count(); ++i)
+    {
+        ProjectItem* item = m_array->ItemUnchecked(i);
+        if (index->find(item) == index->end()) {
+            kept.Add(item);
+        } else if (free) {
+            delete item;
+        }
+    }
+    m_array->Clear(false);
+    m_array->Reserve(kept.Count());
+    for (size_t i=0; i<kept.Count(); ++i)
+    {
+        m_array->Add(kept.ItemUnchecked(i));
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::GetTopItems(Array<ProjectItem>* items, Array<ProjectItem>* result,
+    ItemHashMap* index)
+/**
+ * \brief Returns the project items, which are not below another of
+ * the project items. Project items without container and duplicates
+ * are skipped.
+ * \param items The project items.
+ * \param result Array for the top project items, must not own them.
+ * \param index Receives all project items, a subproject is also
+ * stored as project.
+ **/
+{
+    for (size_t i=0; i<items->Count(); ++i)
+    {
+        ProjectItem* item = items->ItemUnchecked(i);
+        if (item == NULL || item->GetParent() == NULL) continue;
+        (*index)[item] = item;
+        if (item->GetType() == penvPI_SubProject)
+        {
+            // Die Liste eines Unterprojekts kennt nur das Projekt
+            (*index)[(Project*)(ProjectItemSubProject*)item] = item;
+        }
+    }
+    result->Reserve(index->size());
+    for (size_t i=0; i<items->Count(); ++i)
+    {
+        ProjectItem* item = items->ItemUnchecked(i);
+        if (item == NULL || item->GetParent() == NULL) continue;
+        if (IsBelow(item->GetParent(), index)) continue;
+        // Doppelte Elemente nur einmal uebernehmen
+        ItemHashMap::iterator itr = index->find(item);
+        if (itr->second == NULL) continue;
+        itr->second = NULL;
+        result->Add(item);
+    }
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemList::IsBelow(ProjectItemList* list, ItemHashMap* index)
+/**
+ * \brief Checks if a container is below one of the project items.
+ * The parents are walked up to the next project, which is not one of
+ * the project items.
+ * \param list The container.
+ * \param index The project items, see GetTopItems().
+ * \return True if the container is below a project item; false otherwise.
+ **/
+{
+    while (list != NULL)
+    {
+        ItemHashMap::iterator itr;
+        if (list->m_projectitemparent != NULL) {
+            itr = index->find(list->m_projectitemparent);
+        } else {
+            itr = index->find(list->m_projectparent);
+        }
+        if (itr != index->end()) return (true);
+        if (list->m_projectitemparent == NULL) break;
+        list = list->m_projectitemparent->GetParent();
+    }
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemList::ClearModified()
+/**
+ * \brief Marks all subprojects in this container and in the directories
+ * as not modified (private). Called by Project::Modified(false), not
+ * yet read project items are not loaded.
+ **/
+{
+    for (size_t i=0; i<m_array->Count(); ++i)
+    {
+        ProjectItem* item = m_array->ItemUnchecked(i);
+        if (item->GetType() == penvPI_SubProject) {
+            ((ProjectItemSubProject*)item)->Project::Modified(false);
+        } else if (item->GetItemList() != NULL) {
+            item->GetItemList()->ClearModified();
+        }
     }
 }
 
@@ -15,6 +15,9 @@
 #include "container/objarray.h"
 #include "projectitemtype.h"
 #include "penvhelper.h"
+#include "memorypool.h"
+#include "xmlreader.h"
+#include "xmlwriter.h"
 
 namespace penv {
 
@@ -29,12 +32,28 @@ namespace penv {
  *  &nbsp;&nbsp;&lt;!-- projectitem elements should be here --&gt;<br>
  *  &lt;/projectitems&gt;<br>
  * </code>
+ * The project items inside of directories, linked items and subprojects
+ * are not read when the project is loaded. Instead the list remembers
+ * the position of its xml element in the project file (see Defer())
+ * and reads the items the first time the list is accessed. So a project
+ * is opened in a time proportional to its top level.<br>
+ * A clone (see Clone()) is deferred in the same way: it copies the
+ * project items of the cloned list the first time it is accessed. Before
+ * a list or one of its project items is changed, the not yet copied
+ * clones of the list and of the lists above get their own project items
+ * (copy on write). So copying a big subproject and changing one project
+ * item only copies the lists on the path to the changed item.<br>
+ * MoveProjectItems(), CopyProjectItems() and RemoveProjectItems() change
+ * many project items at once, every changed container is set modified
+ * only once and a move or copy generates only one event.
  **/
 class ProjectItemList
 {
     private:
         friend class Project;
         friend class ProjectItem;
+        friend class ProjectItemDirectory;
+        friend class ProjectItemLinkedItems;
         ProjectItemList();
         DECLARE_NO_COPY_CONSTRUCTOR(ProjectItemList);
         DECLARE_NO_ASSIGNMENT_OPERATOR(ProjectItemList);
@@ -60,20 +79,61 @@ class ProjectItemList
         bool CopyProjectItem(size_t index, Project* dest);
         bool MoveProjectItem(size_t index, ProjectItem* dest);
         bool CopyProjectItem(size_t index, ProjectItem* dest);
+        static size_t MoveProjectItems(Array<ProjectItem>* items, ProjectItemList* dest);
+        static size_t CopyProjectItems(Array<ProjectItem>* items, ProjectItemList* dest);
+        static size_t RemoveProjectItems(Array<ProjectItem>* items);
 
         ProjectItemList* Clone();
         bool ReadNode(wxXmlNode* node);
+        bool ReadNode(XmlReader* reader);
         wxXmlNode* WriteNode();
+        void WriteNode(XmlWriter* writer);
+
+        bool ReadSnapshot(SnapshotReader* reader);
+        void WriteSnapshot(SnapshotWriter* writer);
+
+        bool Defer(XmlReader* reader, wxFileOffset offset);
+        bool IsDeferred() const;
+        bool LoadItems(bool recursive = false);
 
         ProjectItem* CreateProjectItem(const wxString& type);
         ProjectItem* CreateProjectItem(ProjectItemType type);
+        MemoryPool* GetMemoryPool();
+        void CheckPaths(size_t first = 0);
+        static bool HasPendingClones();
     private:
+        WX_DECLARE_HASH_MAP(const void*, ProjectItem*, wxPointerHash, wxPointerEqual, ItemHashMap);
+
         void Modified(bool modified = true);
+        void ClearModified();
+        bool ReadItems(XmlReader* reader);
+        void DetachClones();
+        void LoadClones();
+        void RemoveClone(ProjectItemList* clone);
+        void RemoveItems(ItemHashMap* index, bool free);
+        static void GetTopItems(Array<ProjectItem>* items, Array<ProjectItem>* result, ItemHashMap* index);
+        static bool IsBelow(ProjectItemList* list, ItemHashMap* index);
 
     private:
+        /**
+         * \brief Position of the not yet read project items in
+         * the project file or the list, which was cloned.
+         **/
+        struct DeferredItems
+        {
+            wxString filename;
+            wxString encoding;
+            wxFileOffset offset;
+            time_t modified;
+            ProjectItemList* source;
+        };
+
         ProjectItem* m_projectitemparent;
         Project* m_projectparent;
         Array<ProjectItem>* m_array;
+        DeferredItems* m_deferred;
+        Array<ProjectItemList>* m_clones;
+        static size_t s_clonecount;
 };
 
 } // namespace penv
@@ -10,6 +10,7 @@
 #include "projectitemsubproject.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 
 
 namespace penv {
@@ -97,8 +98,9 @@ bool ProjectItemSubProject::Load()
 ProjectItem* ProjectItemSubProject::Clone()
 /**
  * \brief Clones this project item and all its underlying
- * project items. The parent will not be cloned, instead
- * this will always be null.
+ * project items. The underlying project items are copied the first
+ * time they are accessed, see ProjectItemList::Clone(). The parent
+ * will not be cloned, instead this will always be null.
  * \return Return the cloned project item.
  **/
 {
@@ -108,11 +110,13 @@ ProjectItem* ProjectItemSubProject::Clone()
     item->m_windowid = wxEmptyString;
     item->m_windowtype = m_windowtype;
     item->m_virtual = m_virtual;
+    delete item->Project::m_properties;
     item->Project::m_properties = Project::m_properties->Clone();
     item->Project::m_parent = NULL;
     item->ProjectItem::m_parent = NULL;
+    delete item->Project::m_projectitems;
     item->Project::m_projectitems = Project::m_projectitems->Clone();
-    item->Project::m_projectitems->SetProjectItemParent(item);
+    item->Project::m_projectitems->SetProjectParent(item);
     return (item);
 }
 
@@ -218,6 +222,106 @@ bool ProjectItemSubProject::ReadProjectNode(wxXmlNode* root)
 }
 
 
+//----------------------------------------------------------------
+bool ProjectItemSubProject::ReadNode(XmlReader* reader)
+/**
+ * \brief Read out a 'projectitem' xml element node from a XmlReader.
+ * The reader must be positioned on the start of the element, after
+ * this call it is positioned on the end of the element.
+ * See class description for more information.
+ * \param reader The XmlReader positioned on the 'projectitem' element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Knoten muss vom Typ Element sein
+    if (reader == NULL)
+    {
+        wxLogError(_T("[penv::ProjectItemSubProject::ReadNode] Argument 'reader' is NULL."));
+        return (false);
+    }
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("projectitem"))
+    {
+        wxLogError(_T("[penv::ProjectItemSubProject::ReadNode] Node should be an element node with name 'projectitem'."));
+        return (false);
+    }
+    wxString type = reader->GetAttribute(_T("type"), wxEmptyString);
+    if (type != _T("subproject"))
+    {
+        wxLogError(_T("[penv::ProjectItemSubProject::ReadNode] ProjectItem must be ProjectItemFile."));
+        return (false);
+    }
+    Project::m_name = reader->GetAttribute(_T("name"),wxEmptyString);
+    if(Project::m_name.IsEmpty())
+    {
+       wxLogWarning(_T("[penv::ProjectItemSubProject::ReadNode] ProjectItem is nameless"));
+    }
+    m_virtual = PenvHelper::ParseBoolean(reader->GetAttribute(_T("virtual"), _T("false")));
+    // Durch alle Knoten unterhalb von 'projectitem' loopen
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() == _T("project"))
+        {
+            bool result = ReadProjectNode(reader);
+            // Den Rest bis zum Ende von 'projectitem' ueberspringen
+            while (reader->NextChild(depth)) reader->Skip();
+            return (result && !reader->HasError());
+        }
+    }
+    wxLogError(_T("[penv::ProjectItemSubProject::ReadNode] Node 'project' in ProjectItem SubProject not found."));
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemSubProject::ReadProjectNode(XmlReader* reader)
+/**
+ * \brief Read out a 'project' xml element node from a XmlReader.
+ * See class description for more information.
+ * \param reader The XmlReader positioned on the 'project' element.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("project"))
+    {
+        wxLogError(_T("[penv::ProjectItemSubProject::ReadProjectNode] Node should be an element node with name 'project'."));
+        return (false);
+    }
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() == _T("name"))
+        {
+            wxString name = reader->ReadElementContent();
+            if (!name.IsEmpty())
+            {
+                Project::m_name = name;
+            }
+        }
+        else if (reader->GetName() == _T("projectitems"))
+        {
+            // Projektelemente erst bei Bedarf lesen
+            if (Project::m_projectitems->Defer(reader, reader->GetOffset()))
+            {
+                reader->Skip();
+            }
+            else if (!Project::m_projectitems->ReadNode(reader))
+            {
+                wxLogError(_T("[penv::ProjectItemSubProject::ReadProjectNode] Failed reading 'projectitems' node from project."));
+            }
+        }
+        else if (reader->GetName() == _T("properties"))
+        {
+            if (!Project::m_properties->ReadNode(reader))
+            {
+                wxLogError(_T("[penv::ProjectItemSubProject::ReadProjectNode] Failed reading 'properties' node from project."));
+            }
+        }
+    }
+    return (!reader->HasError());
+}
+
+
 
 //----------------------------------------------------------------
 wxXmlNode* ProjectItemSubProject::WriteNode()
@@ -271,5 +375,70 @@ wxXmlNode* ProjectItemSubProject::WriteProjectNode()
 }
 
 
+//----------------------------------------------------------------
+void ProjectItemSubProject::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'projectitem' xml element directly into a XmlWriter.
+ * See class description for more information.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("projectitem"));
+    writer->WriteAttribute(_T("name"), Project::m_name);
+    writer->WriteAttribute(_T("type"), _T("subproject"));
+    writer->WriteAttribute(_T("virtual"), PenvHelper::CreateBoolean(m_virtual));
+    WriteProjectNode(writer);
+    writer->WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemSubProject::WriteProjectNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'project' xml element directly into a XmlWriter.
+ * See class description for more information.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("project"));
+    writer->WriteElement(_T("name"), Project::m_name);
+    Project::m_projectitems->WriteNode(writer);
+    Project::m_properties->WriteNode(writer);
+    writer->WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+bool ProjectItemSubProject::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the subproject from a snapshot. Like in the xml file
+ * the name, the project items and the properties of the project are
+ * used. See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    Project::m_name = reader->ReadString();
+    m_virtual = reader->ReadBool();
+    if (!Project::m_properties->ReadSnapshot(reader)) return (false);
+    return (Project::m_projectitems->ReadSnapshot(reader));
+}
+
+
+//----------------------------------------------------------------
+void ProjectItemSubProject::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the subproject into a snapshot.
+ * See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteString(Project::m_name);
+    writer->WriteBool(m_virtual);
+    Project::m_properties->WriteSnapshot(writer);
+    Project::m_projectitems->WriteSnapshot(writer);
+}
+
+
 } // namespace penv
 
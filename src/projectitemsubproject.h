@@ -53,9 +53,15 @@ class ProjectItemSubProject : public Project, public ProjectItem
         virtual bool Load();
         virtual ProjectItem* Clone();
         virtual bool ReadNode(wxXmlNode* node);
+        virtual bool ReadNode(XmlReader* reader);
         bool ReadProjectNode(wxXmlNode* root);
+        bool ReadProjectNode(XmlReader* reader);
         virtual wxXmlNode* WriteNode();
+        virtual void WriteNode(XmlWriter* writer);
         wxXmlNode* WriteProjectNode();
+        void WriteProjectNode(XmlWriter* writer);
+        virtual bool ReadSnapshot(SnapshotReader* reader);
+        virtual void WriteSnapshot(SnapshotWriter* writer);
 
     private:
 
@@ -10,8 +10,12 @@
 #include "projectlist.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
+#include "projectloader.h"
+#include "pathchecker.h"
 #include "workspace.h"
 #include "environment.h"
+#include <algorithm>
 
 namespace penv {
 
@@ -73,16 +77,9 @@ int ProjectList::GetItemIndex(Project* project)
  * \return Index of the Project on success; -1 if not found.
  **/
 {
-    int index = -1;
-
-    for(size_t i = 0; i < m_array->Count(); i++)
-    {
-        if (project == m_array->ItemPtr(i)) {
-            index = i;
-            break;
-        }
-    }
-    return index;
+    Array<Project>::iterator itr = std::find(m_array->begin(), m_array->end(), project);
+    if (itr == m_array->end()) return (-1);
+    return (int)(itr - m_array->begin());
 }
 
 //----------------------------------------------------------------
@@ -163,7 +160,15 @@ void ProjectList::SetParent(Workspace* workspace)
  * \param workspace The parent workspace.
  **/
 {
-   m_parent = workspace;
+    // Geaenderte Projekte zum Zaehler des neuen Workspaces verschieben
+    int count = 0;
+    for (size_t i=0; i<m_array->Count(); ++i)
+    {
+        if (m_array->ItemUnchecked(i)->IsModified()) count++;
+    }
+    if (count > 0 && m_parent != NULL) m_parent->AddModifiedProjects(-count);
+    m_parent = workspace;
+    if (count > 0 && m_parent != NULL) m_parent->AddModifiedProjects(count);
 }
 
 //----------------------------------------------------------------
@@ -193,7 +198,7 @@ bool ProjectList::MoveProject(size_t index, Workspace* dest)
     dest->Modified();
     m_parent->Modified();
     m_array->Remove(index, false);
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_PROJECT_MOVED"));
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectMoved);
     return(true);
 }
 
@@ -222,18 +227,105 @@ bool ProjectList::CopyProject(size_t index, Workspace* dest)
     dest->GetProjectList()->m_array->Add(project);
     dest->Modified();
 
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_PROJECT_COPIED"));
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectCopied);
     return(true);
 }
 
 
+//----------------------------------------------------------------
+size_t ProjectList::MoveProjects(Array<Project>* projects, Workspace* dest)
+/**
+ * \brief Moves projects from their workspaces to another workspace at
+ * once. Every changed workspace is set modified once and one
+ * 'PENV_EVT_PROJECT_MOVED' event is generated, which contains the
+ * number of moved projects. Projects which are already in the
+ * destination are skipped.
+ * \param projects The projects, the array must not own them.
+ * \param dest Destination workspace.
+ * \return Number of moved projects.
+ **/
+{
+    if (unlikely(projects == NULL || dest == NULL))
+    {
+        wxLogError(_T("[penv::ProjectList::MoveProjects] Argument 'projects' or 'dest' is NULL."));
+        return (0);
+    }
+    ProjectList* destlist = dest->GetProjectList();
+    Array<ProjectList> sources(false);
+    size_t count = 0;
+    for (size_t i=0; i<projects->Count(); ++i)
+    {
+        Project* project = projects->ItemUnchecked(i);
+        if (project == NULL) continue;
+        ProjectList* source = project->GetParent();
+        if (source == NULL || source == destlist) continue;
+        int index = source->GetItemIndex(project);
+        if (index == -1) continue;
+        source->m_array->Remove((size_t)index, false);
+        project->SetParent(destlist);
+        destlist->m_array->Add(project);
+        if (std::find(sources.begin(), sources.end(), source) == sources.end()) sources.Add(source);
+        count++;
+    }
+    if (count == 0) return (0);
+    for (size_t i=0; i<sources.Count(); ++i)
+    {
+        if (sources.ItemUnchecked(i)->m_parent != NULL) sources.ItemUnchecked(i)->m_parent->Modified();
+    }
+    dest->Modified();
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectMoved, wxVariant((long)count));
+    return (count);
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectList::CopyProjects(Array<Project>* projects, Workspace* dest)
+/**
+ * \brief Copies projects to another workspace at once. The workspace
+ * is set modified once and one 'PENV_EVT_PROJECT_COPIED' event is
+ * generated, which contains the number of copied projects.
+ * \param projects The projects, the array must not own them.
+ * \param dest Destination workspace.
+ * \return Number of copied projects.
+ **/
+{
+    if (unlikely(projects == NULL || dest == NULL))
+    {
+        wxLogError(_T("[penv::ProjectList::CopyProjects] Argument 'projects' or 'dest' is NULL."));
+        return (0);
+    }
+    ProjectList* destlist = dest->GetProjectList();
+    size_t count = 0;
+    for (size_t i=0; i<projects->Count(); ++i)
+    {
+        if (projects->ItemUnchecked(i) == NULL) continue;
+        Project* project = projects->ItemUnchecked(i)->Clone();
+        project->SetParent(destlist);
+        destlist->m_array->Add(project);
+        count++;
+    }
+    if (count == 0) return (0);
+    dest->Modified();
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectCopied, wxVariant((long)count));
+    return (count);
+}
+
+
 
 //----------------------------------------------------------------
-bool ProjectList::ReadNode(wxXmlNode* node)
+bool ProjectList::ReadNode(wxXmlNode* node, ProjectLoader* loader)
 /**
  * \brief Read out a 'projects' xml element node.
  * See class description for structure of such an xml node.
+ * The existence of the project files is checked at once by a
+ * PathChecker, then the files are loaded in parallel by a
+ * ProjectLoader and added in the order of the xml node.<br>
+ * If a loader is given, the projects are only added to this loader
+ * and the caller must run the loader and call AddLoadedProjects().
+ * So the projects of all workspaces can be loaded together
+ * (see WorkspaceList::ReadNode()).
  * \param node The 'projects' xml element node.
+ * \param loader The loader for the projects or NULL.
  * \return True on success; false otherwise.
  **/
 {
@@ -248,7 +340,10 @@ bool ProjectList::ReadNode(wxXmlNode* node)
         wxLogError(_T("[penv::ProjectList::ReadNode] Node should be an element node with name 'projects'."));
         return (false);
     }
-    // Durch alle knoten unterhalb von 'projects' loopen
+    // Durch alle knoten unterhalb von 'projects' loopen, die
+    // Projektdateien werden danach geprueft und parallel geladen
+    Array<Project> projects(false);
+    PathChecker checker;
     wxXmlNode* projectnode = node->GetChildren();
     while (projectnode != NULL)
     {
@@ -256,19 +351,68 @@ bool ProjectList::ReadNode(wxXmlNode* node)
             projectnode->GetName() == _T("project"))
         {
             Project* project = new Project(this);
-            if (!project->ReadNode(projectnode))
+            if (!project->ReadReference(projectnode))
             {
+                delete project;
                 projectnode = projectnode->GetNext();
                 continue;
             }
-            m_array->Add(project);
+            projects.Add(project);
+            checker.AddFile(project->GetFileNameString());
         }
         projectnode = projectnode->GetNext();
     }
+    checker.Run();
+    ProjectLoader ownloader;
+    ProjectLoader* usedloader = (loader != NULL) ? loader : &ownloader;
+    for (size_t i=0; i<projects.Count(); ++i)
+    {
+        Project* project = projects.ItemUnchecked(i);
+        if (!checker.Exists(i))
+        {
+            wxLogError(_T("[penv::Project::ReadNode] Project filename '%s' does not exist."), checker.GetPath(i).c_str());
+            delete project;
+            continue;
+        }
+        usedloader->Add(project);
+    }
+    projects.Clear(false);
+    if (loader == NULL)
+    {
+        ownloader.Run();
+        AddLoadedProjects(&ownloader);
+    }
     return (true);
 }
 
 
+//----------------------------------------------------------------
+void ProjectList::AddLoadedProjects(ProjectLoader* loader)
+/**
+ * \brief Adds the projects of a loader, after ProjectLoader::Run()
+ * was called, to their project lists in the order they were added
+ * to the loader. Projects which could not be loaded are deleted.
+ * See ReadNode().
+ * \param loader The loader with the loaded projects.
+ **/
+{
+    // In der urspruenglichen Reihenfolge anhaengen
+    for (size_t i=0; i<loader->Count(); ++i)
+    {
+        Project* project = loader->GetProject(i);
+        if (project == NULL) continue;
+        loader->LogMessages(i);
+        if (!loader->GetResult(i))
+        {
+            wxLogError(_T("[penv::Project::ReadNode] Reading project filename '%s' failed."), project->GetFileNameString().c_str());
+            delete project;
+            continue;
+        }
+        project->GetParent()->m_array->Add(project);
+    }
+}
+
+
 //----------------------------------------------------------------
 wxXmlNode* ProjectList::WriteNode()
 /**
@@ -278,6 +422,7 @@ wxXmlNode* ProjectList::WriteNode()
  **/
 {
     wxXmlNode* node = PenvHelper::CreateXmlNode(_T("projects"));
+    XmlNodeBuilder builder(node);
     for (size_t i=0; i<m_array->Count(); i++)
     {
         Project* project = m_array->ItemPtr(i);
@@ -292,11 +437,51 @@ wxXmlNode* ProjectList::WriteNode()
             wxLogError(_T("[penv::ProjectList::WriteNode] Can not write project '%s' node, skipping project."), project->GetName().c_str());
             continue;
         }
-        PenvHelper::AddXmlChildNode(node, projectnode);
+        builder.Append(projectnode);
     }
     return (node);
 }
 
+//----------------------------------------------------------------
+bool ProjectList::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the projects from a snapshot, which was written by
+ * WriteSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    size_t count = reader->ReadUInt32();
+    for (size_t i=0; i<count && !reader->HasError(); ++i)
+    {
+        Project* project = new Project(this);
+        if (!project->ReadSnapshot(reader))
+        {
+            delete project;
+            return (false);
+        }
+        m_array->Add(project);
+    }
+    return (!reader->HasError());
+}
+
+
+//----------------------------------------------------------------
+void ProjectList::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the projects into a snapshot.
+ * See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteUInt32((wxUint32)m_array->Count());
+    for (size_t i=0; i<m_array->Count(); i++)
+    {
+        m_array->ItemUnchecked(i)->WriteSnapshot(writer);
+    }
+}
+
+
 //----------------------------------------------------------------
 ProjectList* ProjectList::Clone()
 /**
@@ -310,6 +495,7 @@ ProjectList* ProjectList::Clone()
     for(size_t i = 0; i < m_array->Count(); i++)
     {
         Project* project = (*m_array)[i]->Clone();
+        project->SetParent(list);
         list->m_array->Add(project);
     }
     return (list);
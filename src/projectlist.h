@@ -15,6 +15,8 @@
 
 namespace penv {
 
+class ProjectLoader;
+
 /**
  * \brief The ProjectList class is a container for projects. Main functionality is
  * adding, removing, copying and moving projects.<br>
@@ -47,9 +49,14 @@ class ProjectList
 
         bool MoveProject(size_t index, Workspace* dest);
         bool CopyProject(size_t index, Workspace* dest);
+        static size_t MoveProjects(Array<Project>* projects, Workspace* dest);
+        static size_t CopyProjects(Array<Project>* projects, Workspace* dest);
 
-        bool ReadNode(wxXmlNode* node);
+        bool ReadNode(wxXmlNode* node, ProjectLoader* loader = NULL);
+        static void AddLoadedProjects(ProjectLoader* loader);
         wxXmlNode* WriteNode();
+        bool ReadSnapshot(SnapshotReader* reader);
+        void WriteSnapshot(SnapshotWriter* writer);
         ProjectList* Clone();
 
     private:
@@ -0,0 +1,433 @@
+/*
+ * projectloader.cpp - Implementation of the ProjectLoader class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "projectloader.h"
+#include "expect.h"
+#include "workspace.h"
+
+
+namespace penv {
+
+
+/**
+ * \brief The ProjectLoaderThread class is a worker thread of the
+ * ProjectLoader. It loads projects until there are no more jobs left.
+ **/
+class ProjectLoaderThread : public wxThread
+{
+    public:
+        ProjectLoaderThread(ProjectLoader* loader);
+        virtual ExitCode Entry();
+        ProjectLoader::Job* GetJob() const;
+
+    private:
+        ProjectLoader* m_loader;
+        ProjectLoader::Job* m_job;
+};
+
+
+/**
+ * \brief The ProjectLoaderLog class is the active log target while
+ * the ProjectLoader is running. It collects the log messages for
+ * the project, which is currently loaded by the logging thread.
+ **/
+class ProjectLoaderLog : public wxLog
+{
+    public:
+        ProjectLoaderLog(ProjectLoader* loader);
+        void DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp);
+
+    private:
+        ProjectLoader* m_loader;
+};
+
+
+
+//----------------------------------------------------------------
+ProjectLoaderThread::ProjectLoaderThread(ProjectLoader* loader)
+    : wxThread(wxTHREAD_JOINABLE)
+/**
+ * \brief Constructor, initializes the ProjectLoaderThread object.
+ * \param loader The loader which contains the jobs.
+ **/
+{
+    m_loader = loader;
+    m_job = NULL;
+}
+
+
+//----------------------------------------------------------------
+wxThread::ExitCode ProjectLoaderThread::Entry()
+/**
+ * \brief Entry point of the worker thread. Loads projects until
+ * there are no more jobs left.
+ * \return Always 0.
+ **/
+{
+    while ((m_job = m_loader->NextJob()) != NULL)
+    {
+        m_loader->RunJob(m_job);
+    }
+    return (0);
+}
+
+
+//----------------------------------------------------------------
+ProjectLoader::Job* ProjectLoaderThread::GetJob() const
+/**
+ * \brief Returns the job, which is currently processed by this
+ * thread. Must only be called from this thread.
+ * \return The current job or NULL.
+ **/
+{
+    return (m_job);
+}
+
+
+
+//----------------------------------------------------------------
+ProjectLoaderLog::ProjectLoaderLog(ProjectLoader* loader)
+/**
+ * \brief Constructor, initializes the ProjectLoaderLog object.
+ * \param loader The loader which collects the messages.
+ **/
+{
+    m_loader = loader;
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoaderLog::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
+/**
+ * \brief Does the actual logging, the message is given to the
+ * loader, which stores it for the current project of the thread.
+ * \param level The log level (error, warning, message, ...)
+ * \param msg The actual message.
+ * \param timestamp The time when message is generated.
+ **/
+{
+    m_loader->AddMessage(level, msg, timestamp);
+}
+
+
+
+//----------------------------------------------------------------
+ProjectLoader::ProjectLoader(size_t threadcount)
+/**
+ * \brief Constructor, initializes the ProjectLoader object.
+ * \param threadcount Number of threads including the main thread,
+ * which load the projects. If 0 one thread per processor is used.
+ **/
+{
+    m_jobs = new Array<Job>(true);
+    m_threads = new Array<ProjectLoaderThread>(false);
+    m_othermessages = new Array<LogMessage>(true);
+    m_mainjob = NULL;
+    m_nextjob = 0;
+    m_threadcount = threadcount;
+    if (m_threadcount == 0)
+    {
+        int cpucount = wxThread::GetCPUCount();
+        m_threadcount = (cpucount > 0 ? (size_t)cpucount : 1);
+    }
+}
+
+
+//----------------------------------------------------------------
+ProjectLoader::~ProjectLoader()
+/**
+ * \brief Destructor. Does not delete the projects.
+ **/
+{
+    delete m_jobs;
+    delete m_threads;
+    delete m_othermessages;
+}
+
+
+//----------------------------------------------------------------
+ProjectLoader::ProjectLoader(const ProjectLoader& loader)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+ProjectLoader& ProjectLoader::operator=(const ProjectLoader& loader)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::Add(Project* project)
+/**
+ * \brief Adds a project to the loader. The filename of the project
+ * must be set. The project will be loaded with Project::Load(), when
+ * Run() is called.
+ * \param project The project to load.
+ **/
+{
+    Job* job = new Job();
+    job->project = project;
+    m_jobs->Add(job);
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::AddSave(Project* project)
+/**
+ * \brief Adds a project, which will be saved with Project::Save(),
+ * when Run() is called.
+ * \param project The project to save.
+ **/
+{
+    Job* job = new Job();
+    job->project = project;
+    job->save = true;
+    m_jobs->Add(job);
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::AddSave(Workspace* workspace)
+/**
+ * \brief Adds a workspace, which will be saved with Workspace::Save(),
+ * when Run() is called. The projects of the workspace are not saved.
+ * \param workspace The workspace to save.
+ **/
+{
+    Job* job = new Job();
+    job->workspace = workspace;
+    job->save = true;
+    m_jobs->Add(job);
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectLoader::Count() const
+/**
+ * \brief Returns the number of projects in the loader.
+ * \return Number of projects.
+ **/
+{
+    return (m_jobs->Count());
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectLoader::GetThreadCount() const
+/**
+ * \brief Returns the maximum number of threads including the main
+ * thread, which load the projects.
+ * \return Number of threads.
+ **/
+{
+    return (m_threadcount);
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::Run()
+/**
+ * \brief Loads (or saves) all projects. The worker threads and the
+ * main thread take the projects one after another from the list, so a
+ * big project does not block the others. Returns after all projects
+ * are loaded.
+ * Must be called from the main thread.
+ **/
+{
+    wxASSERT(wxIsMainThread());
+    m_nextjob = 0;
+    size_t threadcount = m_threadcount;
+    if (threadcount > m_jobs->Count()) threadcount = m_jobs->Count();
+    ProjectLoaderLog* log = new ProjectLoaderLog(this);
+    wxLog* oldlog = wxLog::SetActiveTarget(log);
+    // Alle Threads erzeugen, bevor der erste startet, damit
+    // AddMessage() die Liste ohne Lock lesen kann
+    for (size_t i=1; i<threadcount; ++i)
+    {
+        ProjectLoaderThread* thread = new ProjectLoaderThread(this);
+        if (thread->Create() != wxTHREAD_NO_ERROR)
+        {
+            delete thread;
+            break;
+        }
+        m_threads->Add(thread);
+    }
+    wxArrayInt running;
+    for (size_t i=0; i<m_threads->Count(); ++i)
+    {
+        running.Add(m_threads->ItemUnchecked(i)->Run() == wxTHREAD_NO_ERROR);
+    }
+    // Der Hauptthread arbeitet mit
+    while ((m_mainjob = NextJob()) != NULL)
+    {
+        RunJob(m_mainjob);
+    }
+    for (size_t i=0; i<m_threads->Count(); ++i)
+    {
+        if (running[i]) m_threads->ItemUnchecked(i)->Wait();
+        delete m_threads->ItemUnchecked(i);
+    }
+    m_threads->Clear(false);
+    wxLog::SetActiveTarget(oldlog);
+    delete log;
+    // Nachrichten, die keinem Projekt zugeordnet werden konnten
+    for (size_t i=0; i<m_othermessages->Count(); ++i)
+    {
+        LogMessage* msg = m_othermessages->ItemUnchecked(i);
+        wxLog::OnLog(msg->level, msg->message.c_str(), msg->timestamp);
+    }
+    m_othermessages->Clear();
+}
+
+
+//----------------------------------------------------------------
+Project* ProjectLoader::GetProject(size_t index)
+/**
+ * \brief Returns a project by its index.
+ * \param index Index of the project, in the order of Add().
+ * \return The project or NULL if a workspace was added at the index.
+ **/
+{
+    if (unlikely(index >= m_jobs->Count())) return (NULL);
+    return (m_jobs->ItemUnchecked(index)->project);
+}
+
+
+//----------------------------------------------------------------
+Workspace* ProjectLoader::GetWorkspace(size_t index)
+/**
+ * \brief Returns a workspace by its index.
+ * \param index Index of the workspace, in the order of AddSave().
+ * \return The workspace or NULL if a project was added at the index.
+ **/
+{
+    if (unlikely(index >= m_jobs->Count())) return (NULL);
+    return (m_jobs->ItemUnchecked(index)->workspace);
+}
+
+
+//----------------------------------------------------------------
+bool ProjectLoader::GetResult(size_t index) const
+/**
+ * \brief Returns the result of Project::Load() for a project, or
+ * the result of Save() if the project or workspace was added with
+ * AddSave().
+ * \param index Index of the project, in the order of Add().
+ * \return True if the project was loaded; false otherwise.
+ **/
+{
+    if (unlikely(index >= m_jobs->Count())) return (false);
+    return (m_jobs->ItemUnchecked(index)->result);
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::LogMessages(size_t index)
+/**
+ * \brief Logs the collected messages of a project to the active log
+ * target. Must be called from the main thread after Run().
+ * \param index Index of the project, in the order of Add().
+ **/
+{
+    wxASSERT(wxIsMainThread());
+    if (unlikely(index >= m_jobs->Count())) return;
+    Job* job = m_jobs->ItemUnchecked(index);
+    for (size_t i=0; i<job->messages.Count(); ++i)
+    {
+        LogMessage* msg = job->messages.ItemUnchecked(i);
+        wxLog::OnLog(msg->level, msg->message.c_str(), msg->timestamp);
+    }
+    job->messages.Clear();
+}
+
+
+//----------------------------------------------------------------
+ProjectLoader::Job* ProjectLoader::NextJob()
+/**
+ * \brief Takes the next job from the list. This method is
+ * thread safe.
+ * \return The next job or NULL if there are no jobs left.
+ **/
+{
+    wxMutexLocker lock(m_mutex);
+    if (m_nextjob >= m_jobs->Count()) return (NULL);
+    return (m_jobs->ItemUnchecked(m_nextjob++));
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::RunJob(Job* job)
+/**
+ * \brief Loads or saves the project or the workspace of a job.
+ * \param job The job to process.
+ **/
+{
+    if (job->workspace != NULL) {
+        job->result = job->workspace->Save();
+    } else if (job->save) {
+        job->result = job->project->Save();
+    } else {
+        job->result = job->project->Load();
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectLoader::AddMessage(wxLogLevel level, const wxChar* msg, time_t timestamp)
+/**
+ * \brief Stores a log message for the project, which is currently
+ * loaded by the calling thread. Messages from other threads are
+ * stored separately and logged at the end of Run().
+ * \param level The log level (error, warning, message, ...)
+ * \param msg The actual message.
+ * \param timestamp The time when message is generated.
+ **/
+{
+    LogMessage* message = new LogMessage();
+    message->level = level;
+    message->message = msg;
+    message->timestamp = timestamp;
+    // Job des aufrufenden Threads suchen, jeder Job wird nur von
+    // einem Thread bearbeitet, deshalb ist hier kein Lock noetig
+    Job* job = NULL;
+    if (wxIsMainThread())
+    {
+        job = m_mainjob;
+    }
+    else
+    {
+        wxThread* current = wxThread::This();
+        for (size_t i=0; i<m_threads->Count(); ++i)
+        {
+            if (m_threads->ItemUnchecked(i) == current)
+            {
+                job = m_threads->ItemUnchecked(i)->GetJob();
+                break;
+            }
+        }
+    }
+    if (job != NULL)
+    {
+        job->messages.Add(message);
+    }
+    else
+    {
+        wxMutexLocker lock(m_mutex);
+        m_othermessages->Add(message);
+    }
+}
+
+} // namespace penv
@@ -0,0 +1,115 @@
+/*
+ * projectloader.h - Declaration of the ProjectLoader class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_PROJECTLOADER_H_
+#define _PENV_PROJECTLOADER_H_
+
+#include "wxincludes.h"
+#include "globals.h"
+#include "project.h"
+#include "container/objarray.h"
+
+
+namespace penv {
+
+class ProjectLoaderThread;
+class ProjectLoaderLog;
+class Workspace;
+
+/**
+ * \brief The ProjectLoader class loads the project files of a workspace
+ * concurrently on a pool of worker threads. Every project is loaded
+ * with Project::Load() into its own detached object tree (every project
+ * has its own MemoryPool), so the workers do not share any data.<br>
+ * While Run() is working, the log messages of the workers are
+ * collected per project. After Run() the projects can be attached in
+ * the original order with GetProject() and the collected messages
+ * can be logged with LogMessages(), so the errors are reported in the
+ * same order as if the projects were loaded one after another.<br>
+ * Example:<br>
+ * <code>
+ * ProjectLoader loader;<br>
+ * loader.Add(project1); loader.Add(project2);<br>
+ * loader.Run();<br>
+ * for (size_t i=0; i&lt;loader.Count(); i++) {<br>
+ * &nbsp;&nbsp;loader.LogMessages(i);<br>
+ * &nbsp;&nbsp;if (loader.GetResult(i)) list->Add(loader.GetProject(i));<br>
+ * }<br>
+ * </code>
+ * The loader does not own the projects. Run() and LogMessages() must
+ * be called from the main thread.<br>
+ * The same way projects and workspaces can be saved in parallel, if
+ * they are added with AddSave() (see WorkspaceList::SaveModified()).
+ **/
+class ProjectLoader
+{
+    public:
+        friend class ProjectLoaderThread;
+        friend class ProjectLoaderLog;
+        ProjectLoader(size_t threadcount = penvCOMMON_PROJECTLOADERTHREADS);
+        ~ProjectLoader();
+    private:
+        ProjectLoader(const ProjectLoader& loader);
+        ProjectLoader& operator=(const ProjectLoader& loader);
+
+    public:
+        void Add(Project* project);
+        void AddSave(Project* project);
+        void AddSave(Workspace* workspace);
+        size_t Count() const;
+        size_t GetThreadCount() const;
+
+        void Run();
+
+        Project* GetProject(size_t index);
+        Workspace* GetWorkspace(size_t index);
+        bool GetResult(size_t index) const;
+        void LogMessages(size_t index);
+
+    private:
+        /**
+         * \brief A log message, which was generated by a worker thread.
+         **/
+        struct LogMessage
+        {
+            wxLogLevel level;
+            wxString message;
+            time_t timestamp;
+        };
+
+        /**
+         * \brief A project, which should be loaded by a worker thread,
+         * or a project or workspace, which should be saved.
+         **/
+        struct Job
+        {
+            Job() : project(NULL), workspace(NULL), save(false), result(false), messages(true) {}
+            Project* project;
+            Workspace* workspace;
+            bool save;
+            bool result;
+            Array<LogMessage> messages;
+        };
+
+        Job* NextJob();
+        void RunJob(Job* job);
+        void AddMessage(wxLogLevel level, const wxChar* msg, time_t timestamp);
+
+    private:
+        Array<Job>* m_jobs;
+        Array<ProjectLoaderThread>* m_threads;
+        Array<LogMessage>* m_othermessages;
+        Job* m_mainjob;
+        size_t m_threadcount;
+        size_t m_nextjob;
+        wxMutex m_mutex;
+};
+
+} // namespace penv
+
+#endif // _PENV_PROJECTLOADER_H_
@@ -11,6 +11,7 @@
 #include "propertylist.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 
 
 namespace penv {
@@ -23,7 +24,8 @@ Property::Property()
 {
     m_type = penvPT_None;
     m_name = wxEmptyString;
-    m_value.Integer = 0;
+    m_list = NULL;
+    memset(&m_value, 0, sizeof(m_value));
 }
 
 
@@ -35,6 +37,7 @@ Property::Property(const wxString& name, int value)
 {
     m_type = penvPT_Integer;
     m_name = name;
+    m_list = NULL;
     m_value.Integer = value;
 }
 
@@ -47,6 +50,7 @@ Property::Property(const wxString& name, bool value)
 {
     m_type = penvPT_Boolean;
     m_name = name;
+    m_list = NULL;
     m_value.Boolean = value;
 }
 
@@ -59,6 +63,7 @@ Property::Property(const wxString& name, const wxString& value)
 {
     m_type = penvPT_String;
     m_name = name;
+    m_list = NULL;
     m_value.String = new wxString(value);
 }
 
@@ -71,6 +76,7 @@ Property::Property(const wxString& name, PropertyList* value)
 {
     m_type = penvPT_Properties;
     m_name = name;
+    m_list = NULL;
     m_value.Props = value;
 }
 
@@ -81,14 +87,10 @@ Property::~Property()
  * \brief Destructor.
  **/
 {
-    if (m_type == penvPT_Properties)
-    {
-        if (m_value.Props != NULL) delete (m_value.Props);
-    }
-    else if (m_type == penvPT_String)
-    {
-        if (m_value.String != NULL) delete (m_value.String);
-    }
+    // Die Pfad-Caches werden nicht invalidiert, das Property wird nur
+    // mit seiner Liste geloescht und die Liste nur ueber SetType()
+    // oder den Destruktor ihres Properties
+    FreeValue();
 }
 
 
@@ -106,10 +108,18 @@ PropertyType Property::GetType() const
 //----------------------------------------------------------------
 void Property::SetType(PropertyType type)
 /**
- * \brief Sets the type of the property.
+ * \brief Sets the type of the property. If the type changes, the
+ * old value is freed and the value is empty.
  * \param type Type of the property.
  **/
 {
+    if (m_type == type) return;
+    // Die Properties unterhalb werden geloescht, Pfad-Caches der
+    // Liste und ihrer Elternlisten ungueltig machen
+    if (m_type == penvPT_Properties && m_list != NULL) {
+        m_list->InvalidatePathCache();
+    }
+    FreeValue();
     m_type = type;
 }
 
@@ -163,7 +173,7 @@ void Property::SetBoolean(bool value)
 {
     if (unlikely(m_type != penvPT_Boolean)) {
         wxLogWarning(_T("[penv::Property::SetBoolean] Writing Property %s who is not Type Boolean"), m_name.c_str());
-        m_type = penvPT_Boolean;
+        SetType(penvPT_Boolean);
     }
     m_value.Boolean = value;
 }
@@ -197,7 +207,7 @@ void Property::SetInteger(int value)
 {
     if (unlikely(m_type != penvPT_Integer)) {
         wxLogWarning(_T("[penv::Property::SetInteger] Writing Property %s who is not type integer."), m_name.c_str());
-        m_type = penvPT_Integer;
+        SetType(penvPT_Integer);
     }
     m_value.Integer = value;
 }
@@ -230,7 +240,7 @@ void Property::SetDouble(double value)
 {
     if (unlikely(m_type != penvPT_Double)) {
         wxLogWarning(_T("[penv::Property::SetDouble] Writing Property %s who is not type double."), m_name.c_str());
-        m_type = penvPT_Double;
+        SetType(penvPT_Double);
     }
     m_value.Double = value;
 }
@@ -249,6 +259,7 @@ const wxString& Property::GetString() const
         wxLogWarning(_T("[penv::Property::GetString] Reading Property %s who is not type string"), m_name.c_str());
         return (wxEmptyString);
     }
+    if (m_value.String == NULL) return (wxEmptyString);
     return (*(m_value.String));
 }
 
@@ -264,16 +275,12 @@ void Property::SetString(const wxString& value)
 {
     if (unlikely(m_type != penvPT_String)) {
         wxLogWarning(_T("[penv::Property::SetString] Writing Property %s who is not Type String"), m_name.c_str());
-        m_type = penvPT_String;
-
+        SetType(penvPT_String);
     }
-    else
-    {
-        if (m_value.String == NULL) {
-            m_value.String = new wxString(value);
-        } else {
-            (*(m_value.String)) = value;
-        }
+    if (m_value.String == NULL) {
+        m_value.String = new wxString(value);
+    } else {
+        (*(m_value.String)) = value;
     }
 }
 
@@ -306,17 +313,258 @@ void Property::SetPropertyList(PropertyList* value)
     if (unlikely(m_type != penvPT_Properties)) {
         wxLogWarning(_T("[penv::Property::SetPropertyList] Writing Property %s who is not Type PropertyList."), m_name.c_str());
     }
+    // Die Properties unterhalb werden ersetzt
+    if (m_value.Props != NULL && m_list != NULL) {
+        m_list->InvalidatePathCache();
+    }
+    if (value != NULL) value->m_parent = this;
     m_value.Props = value;
 }
 
 
 
 //----------------------------------------------------------------
-bool Property::ReadNode(wxXmlNode* node)
+size_t Property::GetArrayCount() const
+/**
+ * \brief Returns the number of values in an array property.
+ * \return Number of values or 0 if the property is not an array.
+ **/
+{
+    if (unlikely(!IsArray())) return (0);
+    return (m_value.Array.Count);
+}
+
+
+//----------------------------------------------------------------
+const bool* Property::GetBooleanArray(size_t* count) const
+/**
+ * \brief Returns the values of the property as a boolean array.
+ * The values are stored one after another and belong to the
+ * property, they are valid until the property changes. This method
+ * will generate a warning, when the property as a incorrect type.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of this property or NULL.
+ **/
+{
+    if (unlikely(m_type != penvPT_ArrayBoolean)) {
+        wxLogWarning(_T("[penv::Property::GetBooleanArray] Reading Property %s who is not type array boolean."), m_name.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    if (count != NULL) *count = m_value.Array.Count;
+    return ((const bool*)m_value.Array.Data);
+}
+
+
+//----------------------------------------------------------------
+void Property::SetBooleanArray(const bool* values, size_t count)
+/**
+ * \brief Sets the values of the property as boolean array. The values
+ * will be copied. The type of the property changes to array boolean.
+ * \param values Values of this property.
+ * \param count Number of values.
+ **/
+{
+    bool* data = (bool*)AllocateArray(penvPT_ArrayBoolean, count);
+    if (count > 0) memcpy(data, values, count*sizeof(bool));
+}
+
+
+//----------------------------------------------------------------
+const int* Property::GetIntegerArray(size_t* count) const
+/**
+ * \brief Returns the values of the property as a integer array.
+ * The values are stored one after another and belong to the
+ * property, they are valid until the property changes. This method
+ * will generate a warning, when the property as a incorrect type.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of this property or NULL.
+ **/
+{
+    if (unlikely(m_type != penvPT_ArrayInteger)) {
+        wxLogWarning(_T("[penv::Property::GetIntegerArray] Reading Property %s who is not type array integer."), m_name.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    if (count != NULL) *count = m_value.Array.Count;
+    return ((const int*)m_value.Array.Data);
+}
+
+
+//----------------------------------------------------------------
+void Property::SetIntegerArray(const int* values, size_t count)
+/**
+ * \brief Sets the values of the property as integer array. The values
+ * will be copied. The type of the property changes to array integer.
+ * \param values Values of this property.
+ * \param count Number of values.
+ **/
+{
+    int* data = (int*)AllocateArray(penvPT_ArrayInteger, count);
+    if (count > 0) memcpy(data, values, count*sizeof(int));
+}
+
+
+//----------------------------------------------------------------
+const double* Property::GetDoubleArray(size_t* count) const
+/**
+ * \brief Returns the values of the property as a double array.
+ * The values are stored one after another and belong to the
+ * property, they are valid until the property changes. This method
+ * will generate a warning, when the property as a incorrect type.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of this property or NULL.
+ **/
+{
+    if (unlikely(m_type != penvPT_ArrayDouble)) {
+        wxLogWarning(_T("[penv::Property::GetDoubleArray] Reading Property %s who is not type array double."), m_name.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    if (count != NULL) *count = m_value.Array.Count;
+    return ((const double*)m_value.Array.Data);
+}
+
+
+//----------------------------------------------------------------
+void Property::SetDoubleArray(const double* values, size_t count)
+/**
+ * \brief Sets the values of the property as double array. The values
+ * will be copied. The type of the property changes to array double.
+ * \param values Values of this property.
+ * \param count Number of values.
+ **/
+{
+    double* data = (double*)AllocateArray(penvPT_ArrayDouble, count);
+    if (count > 0) memcpy(data, values, count*sizeof(double));
+}
+
+
+//----------------------------------------------------------------
+const wxString* Property::GetStringArray(size_t* count) const
+/**
+ * \brief Returns the values of the property as a string array.
+ * The values are stored one after another and belong to the
+ * property, they are valid until the property changes. This method
+ * will generate a warning, when the property as a incorrect type.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of this property or NULL.
+ **/
+{
+    if (unlikely(m_type != penvPT_ArrayString)) {
+        wxLogWarning(_T("[penv::Property::GetStringArray] Reading Property %s who is not type array string."), m_name.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    if (count != NULL) *count = m_value.Array.Count;
+    return ((const wxString*)m_value.Array.Data);
+}
+
+
+//----------------------------------------------------------------
+void Property::SetStringArray(const wxString* values, size_t count)
+/**
+ * \brief Sets the values of the property as string array. The values
+ * will be copied. The type of the property changes to array string.
+ * \param values Values of this property.
+ * \param count Number of values.
+ **/
+{
+    wxString* data = (wxString*)AllocateArray(penvPT_ArrayString, count);
+    for (size_t i=0; i<count; ++i) data[i] = values[i];
+}
+
+
+//----------------------------------------------------------------
+void Property::SetStringArray(const wxArrayString& values)
+/**
+ * \brief Sets the values of the property as string array. The values
+ * will be copied. The type of the property changes to array string.
+ * \param values Values of this property.
+ **/
+{
+    wxString* data = (wxString*)AllocateArray(penvPT_ArrayString, values.Count());
+    for (size_t i=0; i<values.Count(); ++i) data[i] = values[i];
+}
+
+
+//----------------------------------------------------------------
+bool Property::IsArray() const
+/**
+ * \brief Checks if the type of the property is an array type.
+ * \return True if the property is an array; false otherwise.
+ **/
+{
+    return (m_type == penvPT_ArrayBoolean || m_type == penvPT_ArrayInteger ||
+        m_type == penvPT_ArrayDouble || m_type == penvPT_ArrayString);
+}
+
+
+//----------------------------------------------------------------
+void* Property::AllocateArray(PropertyType type, size_t count)
+/**
+ * \brief Frees the old array, changes the type of the property and
+ * allocates memory for the values of the new array.
+ * \param type Array type of the property.
+ * \param count Number of values.
+ * \return Memory for the values or NULL if count is 0.
+ **/
+{
+    if (!IsArray() && m_type != type && m_type != penvPT_None) {
+        wxLogWarning(_T("[penv::Property::AllocateArray] Writing Property %s who is not a array of this type."), m_name.c_str());
+    }
+    // Das alte Array oder den alten Wert freigeben
+    SetType(penvPT_None);
+    m_type = type;
+    void* data = NULL;
+    if (count > 0)
+    {
+        if (type == penvPT_ArrayBoolean) data = new bool[count];
+        else if (type == penvPT_ArrayInteger) data = new int[count];
+        else if (type == penvPT_ArrayDouble) data = new double[count];
+        else if (type == penvPT_ArrayString) data = new wxString[count];
+    }
+    m_value.Array.Data = data;
+    m_value.Array.Count = count;
+    return (data);
+}
+
+
+//----------------------------------------------------------------
+void Property::FreeValue()
+/**
+ * \brief Frees the value of the property according to its type
+ * (string, property list or array) and clears the value. The type
+ * is not changed.
+ **/
+{
+    if (m_type == penvPT_String)
+    {
+        if (m_value.String != NULL) delete (m_value.String);
+    }
+    else if (m_type == penvPT_Properties)
+    {
+        if (m_value.Props != NULL) delete (m_value.Props);
+    }
+    else if (IsArray() && m_value.Array.Data != NULL)
+    {
+        if (m_type == penvPT_ArrayBoolean) delete [] (bool*)m_value.Array.Data;
+        else if (m_type == penvPT_ArrayInteger) delete [] (int*)m_value.Array.Data;
+        else if (m_type == penvPT_ArrayDouble) delete [] (double*)m_value.Array.Data;
+        else if (m_type == penvPT_ArrayString) delete [] (wxString*)m_value.Array.Data;
+    }
+    memset(&m_value, 0, sizeof(m_value));
+}
+
+
+
+//----------------------------------------------------------------
+bool Property::ReadNode(wxXmlNode* node, MemoryPool* pool)
 /**
  * \brief Read out a 'propery' xml element node.
  * See PropertyList class description for structure of such an xml node.
  * \param node The 'property' xml element node.
+ * \param pool Memory pool for a inner PropertyList or NULL.
  * \return True on success; false otherwise.
  **/
 {
@@ -343,7 +591,78 @@ bool Property::ReadNode(wxXmlNode* node)
         wxLogError(_T("[penv::Property::ReadNode] Property node does not have the 'type' attribute."));
         return (false);
     }
-    // Resolve type
+    if (!ReadType(typestring)) return (false);
+    // Read out the value
+    if (m_type == penvPT_Properties) {
+        PropertyList* props = new (pool) PropertyList(this, pool);
+        props->ReadNode(node);
+        m_value.Props = props;
+    } else {
+        ReadValue(node->GetNodeContent(), node->GetPropVal(_T("count"), wxEmptyString));
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool Property::ReadNode(XmlReader* reader, MemoryPool* pool)
+/**
+ * \brief Read out a 'propery' xml element node from a XmlReader.
+ * The reader must be positioned on the start of the element, after
+ * this call it is positioned on the end of the element.
+ * See PropertyList class description for structure of such an xml node.
+ * \param reader The XmlReader positioned on the 'property' element.
+ * \param pool Memory pool for a inner PropertyList or NULL.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (reader == NULL)
+    {
+        wxLogError(_T("[penv::Property::ReadNode] Argument 'reader' is NULL."));
+        return (false);
+    }
+    if (reader->GetNodeType() != penvXR_StartElement || reader->GetName() != _T("property"))
+    {
+        wxLogError(_T("[penv::Property::ReadNode] Xml node must be an element node with name 'property'."));
+        return (false);
+    }
+    // Read out name and type
+    m_name = reader->GetAttribute(_T("name"), wxEmptyString);
+    if (m_name.IsEmpty())
+    {
+        wxLogError(_T("[penv::Property::ReadNode] Property node does not have the 'name' attribute."));
+        return (false);
+    }
+    wxString typestring = reader->GetAttribute(_T("type"), wxEmptyString);
+    if (typestring.IsEmpty())
+    {
+        wxLogError(_T("[penv::Property::ReadNode] Property node does not have the 'type' attribute."));
+        return (false);
+    }
+    if (!ReadType(typestring)) return (false);
+    // Read out the value, the attributes are gone after reading the content
+    if (m_type == penvPT_Properties) {
+        PropertyList* props = new (pool) PropertyList(this, pool);
+        props->ReadNode(reader);
+        m_value.Props = props;
+    } else {
+        wxString countattr = reader->GetAttribute(_T("count"), wxEmptyString);
+        ReadValue(reader->ReadElementContent(), countattr);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool Property::ReadType(const wxString& typestring)
+/**
+ * \brief Resolves the type attribute of a 'property' xml element node.
+ * The old value of the property is freed.
+ * \param typestring Value of the type attribute.
+ * \return True on success; false if the type is unknown.
+ **/
+{
+    SetType(penvPT_None);
     if (typestring == _T("boolean")) m_type = penvPT_Boolean;
     else if (typestring == _T("integer")) m_type = penvPT_Integer;
     else if (typestring == _T("double")) m_type = penvPT_Double;
@@ -355,54 +674,90 @@ bool Property::ReadNode(wxXmlNode* node)
     else if (typestring == _T("arraystring")) m_type = penvPT_ArrayString;
     else
     {
-        wxLogError(_T("[penv::Property::ReadNode] Propery XmlNode %s Type Attribute is unknown."), m_name.c_str());
+        wxLogError(_T("[penv::Property::ReadType] Propery XmlNode %s Type Attribute is unknown."), m_name.c_str());
         return (false);
     }
-    // Read out the value
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void Property::ReadValue(const wxString& content, const wxString& countattr)
+/**
+ * \brief Reads the value of a 'property' xml element node. The type
+ * must already be resolved with ReadType() and must not be
+ * penvPT_Properties.
+ * \param content Text content of the node.
+ * \param countattr Value of the count attribute, only used for arrays.
+ **/
+{
     if (m_type == penvPT_Boolean) {
-        wxString boolstring = node->GetNodeContent();
-        if (boolstring == _T("true")) m_value.Boolean = true;
+        if (content == _T("true")) m_value.Boolean = true;
         else m_value.Boolean = false;
     }
     else if (m_type == penvPT_Integer) {
-        wxString intstring = node->GetNodeContent();
         long value = 0;
-        if (!intstring.ToLong(&value)) {
-            wxLogWarning(_T("[penv::Property::ReadNode] On Property XmlNode %s convert to integer failed, default value 0 is set."), m_name.c_str());
+        if (!content.ToLong(&value)) {
+            wxLogWarning(_T("[penv::Property::ReadValue] On Property XmlNode %s convert to integer failed, default value 0 is set."), m_name.c_str());
             value = 0;
         }
         m_value.Integer = (int)value;
     }
     else if (m_type == penvPT_Double) {
-        wxString doublestring = node->GetNodeContent();
         double value = 0;
-        if (!doublestring.ToDouble(&value)) {
-            wxLogWarning(_T("[penv::Property::ReadNode] On Property XmlNode %s convert to double failed, default value 0 is set."), m_name.c_str());
+        if (!content.ToDouble(&value)) {
+            wxLogWarning(_T("[penv::Property::ReadValue] On Property XmlNode %s convert to double failed, default value 0 is set."), m_name.c_str());
             value = 0;
         }
         m_value.Double = value;
     }
     else if (m_type == penvPT_String) {
-        m_value.String = new wxString(node->GetNodeContent());
-    }
-    else if (m_type == penvPT_Properties) {
-        PropertyList* props = new PropertyList(this);
-        props->ReadNode(node);
-        m_value.Props = props;
-    }
-    else if (m_type == penvPT_ArrayBoolean) {
-        NOT_IMPLEMENTED_YET();
-    }
-    else if (m_type == penvPT_ArrayInteger) {
-        NOT_IMPLEMENTED_YET();
-    }
-    else if (m_type == penvPT_ArrayDouble) {
-        NOT_IMPLEMENTED_YET();
-    }
-    else if (m_type == penvPT_ArrayString) {
-        NOT_IMPLEMENTED_YET();
+        m_value.String = new wxString(content);
+    }
+    else if (IsArray()) {
+        // All values are in one text node, count them first
+        //  and then parse them in one pass
+        PropertyType type = m_type;
+        m_type = penvPT_None;
+        m_value.Array.Data = NULL;
+        const wxChar* strg = content.c_str();
+        if (type == penvPT_ArrayBoolean) {
+            size_t count = PenvHelper::ParseBooleans(strg, NULL, 0);
+            PenvHelper::ParseBooleans(strg, (bool*)AllocateArray(type, count), count);
+        }
+        else if (type == penvPT_ArrayInteger) {
+            size_t count = PenvHelper::ParseIntegers(strg, NULL, 0);
+            PenvHelper::ParseIntegers(strg, (int*)AllocateArray(type, count), count);
+        }
+        else if (type == penvPT_ArrayDouble) {
+            size_t count = PenvHelper::ParseDoubles(strg, NULL, 0);
+            PenvHelper::ParseDoubles(strg, (double*)AllocateArray(type, count), count);
+        }
+        else if (type == penvPT_ArrayString) {
+            // Strings are separated by newlines, newlines and
+            //  backslashes inside the strings are escaped
+            size_t count = 0;
+            if (!content.IsEmpty() || countattr == _T("1")) {
+                count = content.Freq(_T('\n')) + 1;
+            }
+            wxString* values = (wxString*)AllocateArray(type, count);
+            size_t index = 0;
+            for (const wxChar* p = strg; count > 0; ++p)
+            {
+                if (*p == 0) break;
+                if (*p == '\n') {
+                    index++;
+                } else if (*p == '\\' && *(p+1) != 0) {
+                    ++p;
+                    if (*p == 'n') values[index] += _T('\n');
+                    else if (*p == 'r') values[index] += _T('\r');
+                    else values[index] += *p;
+                } else {
+                    values[index] += *p;
+                }
+            }
+        }
     }
-    return (true);
 }
 
 
@@ -414,7 +769,91 @@ wxXmlNode* Property::WriteNode()
  * \return The 'property' xml element node; or NULL on error.
  **/
 {
-    // Predefine content
+    // Now create node, with predefinied content
+    wxXmlNode* node = PenvHelper::CreateXmlNode(_T("property"), WriteValue());
+    node->AddProperty(_T("name"), m_name);
+    node->AddProperty(_T("type"), GetTypeName());
+    // Set additional stuff, if needed
+    if (m_type == penvPT_Properties) {
+        // Nur lesend durchlaufen, damit geteilte Properties beim
+        // Speichern nicht kopiert werden
+        XmlNodeBuilder builder(node);
+        PropertyList::PropertiesHashMap::iterator itr;
+        for (itr = m_value.Props->m_hashmap->begin(); itr != m_value.Props->m_hashmap->end(); itr++)
+        {
+            Property* prop = itr->second;
+            wxXmlNode* child = prop->WriteNode();
+            if (child == NULL)
+            {
+                wxLogError(_T("[penv::Property::WriteNode] Failed to write property '%s', skipping."), prop->GetName().c_str());
+                continue;
+            }
+            builder.Append(child);
+        }
+    }
+    else if (IsArray()) {
+        node->AddProperty(_T("count"), wxString::Format(_T("%u"), (unsigned int)m_value.Array.Count));
+    }
+    return (node);
+}
+
+
+//----------------------------------------------------------------
+void Property::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'property' xml element directly into a XmlWriter.
+ * See class description for structure of such an xml node.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("property"));
+    writer->WriteAttribute(_T("name"), m_name);
+    writer->WriteAttribute(_T("type"), GetTypeName());
+    if (m_type == penvPT_Properties) {
+        PropertyList::PropertiesHashMap::iterator itr;
+        for (itr = m_value.Props->m_hashmap->begin(); itr != m_value.Props->m_hashmap->end(); itr++)
+        {
+            itr->second->WriteNode(writer);
+        }
+    }
+    else {
+        if (IsArray()) {
+            writer->WriteAttribute(_T("count"), wxString::Format(_T("%u"), (unsigned int)m_value.Array.Count));
+        }
+        writer->WriteText(WriteValue());
+    }
+    writer->WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+const wxChar* Property::GetTypeName() const
+/**
+ * \brief Returns the value of the type attribute of a 'property'
+ * xml element node.
+ * \return Name of the type.
+ **/
+{
+    if (m_type == penvPT_Boolean) return (_T("boolean"));
+    else if (m_type == penvPT_Integer) return (_T("integer"));
+    else if (m_type == penvPT_Double) return (_T("double"));
+    else if (m_type == penvPT_String) return (_T("string"));
+    else if (m_type == penvPT_Properties) return (_T("properties"));
+    else if (m_type == penvPT_ArrayBoolean) return (_T("arrayboolean"));
+    else if (m_type == penvPT_ArrayInteger) return (_T("arrayinteger"));
+    else if (m_type == penvPT_ArrayDouble) return (_T("arraydouble"));
+    else if (m_type == penvPT_ArrayString) return (_T("arraystring"));
+    return (wxEmptyString);
+}
+
+
+//----------------------------------------------------------------
+wxString Property::WriteValue() const
+/**
+ * \brief Returns the text content of a 'property' xml element node.
+ * \return The value as string; empty for penvPT_Properties.
+ **/
+{
     wxString content = wxEmptyString;
     if (m_type == penvPT_Boolean) {
         content = PenvHelper::CreateBoolean(m_value.Boolean);
@@ -428,58 +867,134 @@ wxXmlNode* Property::WriteNode()
     else if (m_type == penvPT_String) {
         content = *(m_value.String);
     }
-    // Now create node, with predefinied content
-    wxXmlNode* node = PenvHelper::CreateXmlNode(_T("property"), content);
-    node->AddProperty(_T("name"), m_name);
-    // Set type attribute and additional stuff, if needed
-    if (m_type == penvPT_Boolean) {
-        node->AddProperty(_T("type"), _T("boolean"));
-    }
-    else if (m_type == penvPT_Integer) {
-        node->AddProperty(_T("type"), _T("integer"));
-    }
-    else if (m_type == penvPT_Double) {
-        node->AddProperty(_T("type"), _T("double"));
-    }
-    else if (m_type == penvPT_String) {
-        node->AddProperty(_T("type"), _T("string"));
-    }
-    else if (m_type == penvPT_Properties) {
-        node->AddProperty(_T("type"), _T("properties"));
-        wxArrayString* array = m_value.Props->GetProperties(false);
-        for (size_t i=0; i<array->Count(); ++i)
-        {
-            Property* prop = m_value.Props->GetProperty((*array)[i]);
-            wxXmlNode* child = prop->WriteNode();
-            if (child == NULL)
-            {
-                wxLogError(_T("[penv::Property::WriteNode] Failed to write property '%s', skipping."), prop->GetName().c_str());
-                continue;
+    else if (IsArray()) {
+        // All values are written into one text node, separated
+        //  by spaces or by newlines for strings
+        size_t count = m_value.Array.Count;
+        wxChar buffer[64];
+        if (m_type == penvPT_ArrayBoolean) {
+            content.Alloc(count*6);
+            const bool* values = (const bool*)m_value.Array.Data;
+            for (size_t i=0; i<count; ++i) {
+                if (i != 0) content += _T(' ');
+                content += (values[i] ? _T("true") : _T("false"));
+            }
+        }
+        else if (m_type == penvPT_ArrayInteger) {
+            content.Alloc(count*8);
+            const int* values = (const int*)m_value.Array.Data;
+            for (size_t i=0; i<count; ++i) {
+                wxSnprintf(buffer, WXSIZEOF(buffer), (i == 0 ? _T("%i") : _T(" %i")), values[i]);
+                content += buffer;
+            }
+        }
+        else if (m_type == penvPT_ArrayDouble) {
+            content.Alloc(count*16);
+            const double* values = (const double*)m_value.Array.Data;
+            for (size_t i=0; i<count; ++i) {
+                wxSnprintf(buffer, WXSIZEOF(buffer), (i == 0 ? _T("%.17g") : _T(" %.17g")), values[i]);
+                content += buffer;
+            }
+        }
+        else if (m_type == penvPT_ArrayString) {
+            const wxString* values = (const wxString*)m_value.Array.Data;
+            for (size_t i=0; i<count; ++i) {
+                if (i != 0) content += _T('\n');
+                for (size_t j=0; j<values[i].Length(); ++j) {
+                    wxChar c = values[i][j];
+                    if (c == '\\') content += _T("\\\\");
+                    else if (c == '\n') content += _T("\\n");
+                    else if (c == '\r') content += _T("\\r");
+                    else content += c;
+                }
             }
-            PenvHelper::AddXmlChildNode(node, child);
         }
-        delete array;
-    }
-    else if (m_type == penvPT_ArrayBoolean) {
-        node->AddProperty(_T("type"), _T("arrayboolean"));
-        NOT_IMPLEMENTED_YET();
     }
-    else if (m_type == penvPT_ArrayInteger) {
-        node->AddProperty(_T("type"), _T("arrayinteger"));
-        NOT_IMPLEMENTED_YET();
+    return (content);
+}
+
+
+
+//----------------------------------------------------------------
+bool Property::ReadSnapshot(SnapshotReader* reader, MemoryPool* pool)
+/**
+ * \brief Reads the property from a snapshot, which was written by
+ * WriteSnapshot().
+ * \param reader The SnapshotReader.
+ * \param pool Memory pool for a inner PropertyList or NULL.
+ * \return True on success; false otherwise.
+ **/
+{
+    SetType(penvPT_None);
+    PropertyType type = (PropertyType)reader->ReadUInt32();
+    m_name = reader->ReadString();
+    if (type == penvPT_Properties)
+    {
+        m_type = type;
+        m_value.Props = new (pool) PropertyList(this, pool);
+        return (m_value.Props->ReadSnapshot(reader));
+    }
+    else if (type == penvPT_Boolean) { m_type = type; m_value.Boolean = reader->ReadBool(); }
+    else if (type == penvPT_Integer) { m_type = type; m_value.Integer = reader->ReadInt32(); }
+    else if (type == penvPT_Double) { m_type = type; m_value.Double = reader->ReadDouble(); }
+    else if (type == penvPT_String)
+    {
+        m_type = type;
+        m_value.String = new wxString(reader->ReadString());
     }
-    else if (m_type == penvPT_ArrayDouble) {
-        node->AddProperty(_T("type"), _T("arraydouble"));
-        NOT_IMPLEMENTED_YET();
+    else if (type == penvPT_ArrayBoolean || type == penvPT_ArrayInteger ||
+        type == penvPT_ArrayDouble || type == penvPT_ArrayString)
+    {
+        size_t count = reader->ReadUInt32();
+        if (reader->HasError()) return (false);
+        void* data = AllocateArray(type, count);
+        for (size_t i=0; i<count; ++i)
+        {
+            if (type == penvPT_ArrayBoolean) ((bool*)data)[i] = reader->ReadBool();
+            else if (type == penvPT_ArrayInteger) ((int*)data)[i] = reader->ReadInt32();
+            else if (type == penvPT_ArrayDouble) ((double*)data)[i] = reader->ReadDouble();
+            else ((wxString*)data)[i] = reader->ReadString();
+        }
     }
-    else if (m_type == penvPT_ArrayString) {
-        node->AddProperty(_T("type"), _T("arraystring"));
-        NOT_IMPLEMENTED_YET();
+    else
+    {
+        return (false);
     }
-    return (node);
+    return (!reader->HasError());
 }
 
 
+//----------------------------------------------------------------
+void Property::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the property into a snapshot, see
+ * WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteUInt32(m_type);
+    writer->WriteString(m_name);
+    if (m_type == penvPT_Properties) {
+        m_value.Props->WriteSnapshot(writer);
+    } else if (m_type == penvPT_Boolean) {
+        writer->WriteBool(m_value.Boolean);
+    } else if (m_type == penvPT_Integer) {
+        writer->WriteInt32(m_value.Integer);
+    } else if (m_type == penvPT_Double) {
+        writer->WriteDouble(m_value.Double);
+    } else if (m_type == penvPT_String) {
+        writer->WriteString(*m_value.String);
+    } else if (IsArray()) {
+        writer->WriteUInt32((wxUint32)m_value.Array.Count);
+        for (size_t i=0; i<m_value.Array.Count; ++i)
+        {
+            if (m_type == penvPT_ArrayBoolean) writer->WriteBool(((bool*)m_value.Array.Data)[i]);
+            else if (m_type == penvPT_ArrayInteger) writer->WriteInt32(((int*)m_value.Array.Data)[i]);
+            else if (m_type == penvPT_ArrayDouble) writer->WriteDouble(((double*)m_value.Array.Data)[i]);
+            else writer->WriteString(((wxString*)m_value.Array.Data)[i]);
+        }
+    }
+}
 
 } // namespace penv
 
@@ -12,6 +12,11 @@
 
 #include "wxincludes.h"
 #include "propertytype.h"
+#include "memorypool.h"
+#include "xmlreader.h"
+#include "xmlwriter.h"
+#include "snapshotreader.h"
+#include "snapshotwriter.h"
 
 namespace penv {
 
@@ -23,11 +28,15 @@ class PropertyList;
  * should not be used directly, instead use the methods in the
  * PropertyList class.<br>
  * A Property can contain 4 differnt types of values: Integer,
- * Boolean, Strings and Double.
+ * Boolean, Strings and Double. Also arrays of these types are
+ * possible, the values of an array are stored in one block of
+ * memory and can be accessed all at once.
  **/
 class Property
 {
+    DECLARE_MEMORYPOOL_OPERATORS()
     public:
+        friend class PropertyList;
         Property();
         Property(const wxString& name, int value);
         Property(const wxString& name, bool value);
@@ -56,8 +65,32 @@ class Property
         PropertyList* GetPropertyList() const;
         void SetPropertyList(PropertyList* value);
 
-        bool ReadNode(wxXmlNode* node);
+        size_t GetArrayCount() const;
+        const bool* GetBooleanArray(size_t* count = NULL) const;
+        void SetBooleanArray(const bool* values, size_t count);
+        const int* GetIntegerArray(size_t* count = NULL) const;
+        void SetIntegerArray(const int* values, size_t count);
+        const double* GetDoubleArray(size_t* count = NULL) const;
+        void SetDoubleArray(const double* values, size_t count);
+        const wxString* GetStringArray(size_t* count = NULL) const;
+        void SetStringArray(const wxString* values, size_t count);
+        void SetStringArray(const wxArrayString& values);
+
+        bool ReadNode(wxXmlNode* node, MemoryPool* pool = NULL);
+        bool ReadNode(XmlReader* reader, MemoryPool* pool = NULL);
         wxXmlNode* WriteNode();
+        void WriteNode(XmlWriter* writer);
+        bool ReadSnapshot(SnapshotReader* reader, MemoryPool* pool = NULL);
+        void WriteSnapshot(SnapshotWriter* writer);
+
+    private:
+        bool ReadType(const wxString& typestring);
+        void ReadValue(const wxString& content, const wxString& countattr);
+        const wxChar* GetTypeName() const;
+        wxString WriteValue() const;
+        bool IsArray() const;
+        void* AllocateArray(PropertyType type, size_t count);
+        void FreeValue();
 
     private:
         union {
@@ -66,9 +99,14 @@ class Property
             double        Double;
             wxString*     String;
             PropertyList* Props;
+            struct {
+                void*     Data;
+                size_t    Count;
+            } Array;
         } m_value;
         PropertyType m_type;
         wxString m_name;
+        PropertyList* m_list;
 };
 
 } // namespace penv
@@ -10,22 +10,38 @@
 
 #include "propertylist.h"
 #include "expect.h"
+#include "atomic.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 
 namespace penv {
 
 
+// Statische Variablen fr den Pfad-Cache
+bool PropertyList::s_pathcache = true;
+// Anzahl der Properties, die von mehreren Listen geteilt werden,
+// wird wie die Referenzzaehler auch von den Ladethreads geaendert
+volatile size_t PropertyList::s_sharedcount = 0;
+
+
 //----------------------------------------------------------------
-PropertyList::PropertyList(Property* parent)
+PropertyList::PropertyList(Property* parent, MemoryPool* pool)
 /**
  * \brief Constructor, initialize the PropertyList object.
  * The parent parameter spezifies if this PropertyList has
  * a parent list.
  * \param parent Parent PropertyList.
+ * \param pool Memory pool for the properties or NULL to
+ * allocate them from the heap.
  **/
 {
     m_parent = parent;
-    m_hashmap = new PropertiesHashMap();
+    m_pool = pool;
+    m_shared = new SharedProperties();
+    m_shared->refcount = 1;
+    m_shared->owner = this;
+    m_hashmap = &m_shared->hashmap;
+    m_pathcache = NULL;
     m_empty = wxEmptyString;
 }
 
@@ -34,12 +50,23 @@ PropertyList::PropertyList(Property* parent)
 PropertyList::PropertyList(const PropertyList& props)
 /**
  * \brief Copyconstructor, creates a new copy of the whole
- * propertylist from the given PropertyList.
+ * propertylist from the given PropertyList. The properties are
+ * shared until one of the lists is changed. The copy has no parent
+ * and creates its properties on the heap, because the memory pool
+ * of the given list may be destroyed before the copy.
  * \param props PropertyList which should be copied.
  **/
 {
-    // TODO SO:
-    NOT_IMPLEMENTED_YET();
+    m_parent = NULL;
+    m_pool = NULL;
+    m_shared = props.m_shared;
+    if (AtomicIncrement(&m_shared->refcount) == 2) AtomicIncrement(&s_sharedcount);
+    m_hashmap = &m_shared->hashmap;
+    m_pathcache = NULL;
+    m_empty = wxEmptyString;
+    // Die Properties der kopierten Liste sind jetzt geteilt und
+    // duerfen nicht mehr ueber den Cache geaendert werden
+    props.InvalidatePathCache();
 }
 
 
@@ -50,8 +77,23 @@ PropertyList::~PropertyList()
  * \brief Destructor.
  **/
 {
-    // TODO SO: Kill the hashmap
-    NOT_IMPLEMENTED_YET();
+    // Eine verbleibende Liste uebernimmt die Properties in Unshare()
+    if (m_shared->refcount > 1) ReleaseOwnership();
+    size_t refcount = AtomicDecrement(&m_shared->refcount);
+    if (refcount == 0)
+    {
+        PropertiesHashMap::iterator itr;
+        for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
+        {
+            delete itr->second;
+        }
+        delete m_shared;
+    }
+    else if (refcount == 1)
+    {
+        AtomicDecrement(&s_sharedcount);
+    }
+    if (m_pathcache != NULL) delete m_pathcache;
 }
 
 
@@ -120,7 +162,7 @@ bool PropertyList::ExistsProperty(const wxString& propname)
  * \return True if property exists; false otherwise.
  **/
 {
-    return (GetProperty(propname, false) == NULL);
+    return (LookupProperty(propname, false, false) != NULL);
 }
 
 
@@ -136,7 +178,7 @@ PropertyType PropertyList::GetType(const wxString& propname)
  * \return Type of the property (see PropertyType enumerator).
  **/
 {
-    Property* prop = GetProperty(propname, false);
+    Property* prop = LookupProperty(propname, false, false);
     if (unlikely(prop == NULL)) return (penvPT_None);
     return (prop->GetType());
 }
@@ -154,6 +196,19 @@ Property* PropertyList::GetParent()
 }
 
 
+//----------------------------------------------------------------
+MemoryPool* PropertyList::GetMemoryPool()
+/**
+ * \brief Returns the memory pool, where the properties of this
+ * PropertyList will be created. Can return NULL if the properties
+ * are created on the heap.
+ * \return Memory pool or NULL.
+ **/
+{
+    return (m_pool);
+}
+
+
 //----------------------------------------------------------------
 Property* PropertyList::GetProperty(const wxString& propname, bool create)
 /**
@@ -161,100 +216,308 @@ Property* PropertyList::GetProperty(const wxString& propname, bool create)
  * exists and create is false then NULL will be returned. If the property
  * does not exists and create is true, then the property will be created.
  * To differ from created and not created property, a created property has
- * the penvPT_None type.
+ * the penvPT_None type. Properties which are accessed with a path are
+ * cached, so the next access does not allocate any memory. Because the
+ * returned property can be changed, shared properties are copied first.
+ * \param propname The property name.
+ * \param create True if not existed property should be created.
+ * \return The found property or NULL.
+ **/
+{
+    return (LookupProperty(propname, create, true));
+}
+
+
+//----------------------------------------------------------------
+Property* PropertyList::LookupProperty(const wxString& propname, bool create, bool write)
+/**
+ * \brief Returns a property with the given name, see GetProperty().
+ * If write is false, the property is only read and the properties
+ * are not copied if they are shared with another list.
  * \param propname The property name.
  * \param create True if not existed property should be created.
+ * \param write True if the property may be changed.
  * \return The found property or NULL.
  **/
 {
-    // Propertyname aufsplitten (nach '/' parsen)
-    wxArrayString names;
-    PenvHelper::SplitString(propname, &names);
+    if (create) write = true;
+    if (write) Unshare();
+    // Property aus dieser Liste, kein Pfad
+    if (propname.Find(_T('/')) == wxNOT_FOUND)
+    {
+        PropertiesHashMap::iterator itr = m_hashmap->find(propname);
+        if (itr != m_hashmap->end()) return (itr->second);
+        if (!create) return (NULL);
+        Property* newprop = new (m_pool) Property();
+        newprop->SetName(propname);
+        newprop->m_list = this;
+        (*m_hashmap)[propname] = newprop;
+        return (newprop);
+    }
+
+    // Im Pfad-Cache suchen, zum Schreiben nur Eintraege, deren Listen
+    // beim Suchen nicht geteilt waren
+    if (likely(s_pathcache) && m_pathcache != NULL)
+    {
+        PathCacheHashMap::iterator itr = m_pathcache->find(propname);
+        if (likely(itr != m_pathcache->end()) && (!write || itr->second.write)) {
+            return (itr->second.prop);
+        }
+    }
+
+    // Property in der Hierarchie suchen und in den Cache aufnehmen
+    Property* prop = FindProperty(propname, create, write);
+    if (prop != NULL && s_pathcache)
+    {
+        if (m_pathcache == NULL) m_pathcache = new PathCacheHashMap();
+        PathCacheEntry& entry = (*m_pathcache)[propname];
+        entry.prop = prop;
+        entry.write = write;
+    }
+    return (prop);
+}
+
 
-    // String Array enthlt nur ein Element wenn das Property aus
-    //   dieser Liste bentigt wird
-    if (names.Count() == 1) {
-        // Testen ob das Property existiert
-        if (m_hashmap->find(propname) == m_hashmap->end())
+//----------------------------------------------------------------
+Property* PropertyList::FindProperty(const wxString& propname, bool create, bool write)
+/**
+ * \brief Searches a property with a path through the hierarchy of
+ * property lists, without using the path cache. Missing property
+ * lists and the property will be created, if create is true.
+ * \param propname The property name with a path.
+ * \param create True if not existed property should be created.
+ * \param write True if the property lists on the path must get
+ * their own copy of shared properties.
+ * \return The found property or NULL.
+ **/
+{
+    PropertyList* list = this;
+    Property* prop = NULL;
+    size_t start = 0;
+    while (true)
+    {
+        // Nchsten Namen aus dem Pfad holen
+        size_t end = propname.find(_T('/'), start);
+        bool last = (end == wxString::npos);
+        wxString name = (last ? propname.Mid(start) : propname.Mid(start, end-start));
+        if (write) list->Unshare();
+        PropertiesHashMap::iterator itr = list->m_hashmap->find(name);
+        if (itr != list->m_hashmap->end())
         {
-            // Property existiert nicht
-            if (create) {
-                Property* newprop = new Property();
-                newprop->SetName(propname);
-                (*m_hashmap)[propname] = newprop;
-                return (newprop);
-            } else {
+            // Property existiert
+            prop = itr->second;
+            if (last) break;
+            if (unlikely(prop->GetType() != penvPT_Properties || prop->GetPropertyList() == NULL)) {
+                if (create) {
+                    wxLogError(_T("[penv::PropertyList::GetProperty] Property '%s' in '%s' is not a property list."), name.c_str(), propname.c_str());
+                }
                 return (NULL);
             }
         }
         else
         {
-            // Property existiert
-            return ((*m_hashmap)[propname]);
+            // Property existiert nicht
+            if (!create) return (NULL);
+            prop = new (list->m_pool) Property();
+            prop->SetName(name);
+            prop->m_list = list;
+            (*(list->m_hashmap))[name] = prop;
+            if (last) break;
+            // Alle Properties vor dem letzten sind Property Listen
+            prop->SetType(penvPT_Properties);
+            prop->SetPropertyList(new (list->m_pool) PropertyList(prop, list->m_pool));
         }
+        list = prop->GetPropertyList();
+        start = end+1;
     }
+    return (prop);
+}
+
 
-    // Suchen des Properties (rekursiv)
-    // NOTE: Da Tiefe bekannt rekursion nicht ntig!
-    // Prfen ob das erste Property vorhanden ist
-    if (m_hashmap->find(names[0]) == m_hashmap->end())
+//----------------------------------------------------------------
+void PropertyList::EnablePathCache(bool enable)
+/**
+ * \brief Enables or disables the path cache of all property lists.
+ * The path cache is enabled by default.
+ * \param enable True to enable the path cache; false to disable it.
+ **/
+{
+    s_pathcache = enable;
+}
+
+
+//----------------------------------------------------------------
+bool PropertyList::IsPathCacheEnabled()
+/**
+ * \brief Checks if the path cache of the property lists is enabled.
+ * \return True if the path cache is enabled; false otherwise.
+ **/
+{
+    return (s_pathcache);
+}
+
+
+//----------------------------------------------------------------
+bool PropertyList::HasSharedProperties()
+/**
+ * \brief Returns true if properties are shared by more than one
+ * property list (see the copyconstructor). Shared lists contain the
+ * same wxStrings, so they must not be accessed from different threads.
+ * \return True if there are shared properties; false otherwise.
+ **/
+{
+    return (s_sharedcount > 0);
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::InvalidatePathCache() const
+/**
+ * \brief Invalidates the path cache of this list and of its parent
+ * lists (private). Only these caches can contain paths through this
+ * list. Called if the property list of a property is replaced, if
+ * the properties are copied (see Unshare()) or become shared.
+ * Deleting a property does not invalidate the caches, because
+ * properties are only deleted together with their list or by
+ * changing the type of the parent property.
+ **/
+{
+    const PropertyList* list = this;
+    while (list != NULL)
     {
-        // Property existiert nicht
-        if (create)
+        if (list->m_pathcache != NULL) list->m_pathcache->clear();
+        if (list->m_parent == NULL) break;
+        list = list->m_parent->m_list;
+    }
+}
+
+
+//----------------------------------------------------------------
+PropertyList* PropertyList::Clone()
+/**
+ * \brief Clones this class and returns it. The clone shares the
+ * properties with this list, they are only copied if one of the
+ * lists is changed. Parent will not be cloned, instead this
+ * variable will be NULL.
+ * \return Cloned instance of this class.
+ **/
+{
+    return (new PropertyList(*this));
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::Unshare()
+/**
+ * \brief Copies the properties if they are shared with another
+ * list (private). Property lists inside the properties are cloned
+ * and stay shared until they are changed themselves. If the list,
+ * which created the properties, was deleted and this list is the
+ * only one left, the properties are taken over by this list.
+ **/
+{
+    PropertiesHashMap::iterator itr;
+    if (likely(m_shared->refcount == 1))
+    {
+        if (unlikely(m_shared->owner != this))
         {
-            // First property which will be created, is always
-            //  of type propertylist
-            Property* firstprop = new Property();
-            firstprop->SetType(penvPT_Properties);
-            firstprop->SetName(names[0]);
-            PropertyList* firstproplist = new PropertyList(firstprop);
-            firstprop->SetPropertyList(firstproplist);
-            (*m_hashmap)[names[0]] = firstprop;
-            PropertyList* temp = firstproplist;
-            for (size_t i=1; i<names.Count(); ++i)
+            m_shared->owner = this;
+            for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
             {
-                // Only last property is not type propertylist
-                if (i < names.Count()-1)
-                {   // Not the last property
-                    Property* prop = new Property();
-                    prop->SetType(penvPT_Properties);
-                    prop->SetName(names[i]);
-                    PropertyList* proplist = new PropertyList(prop);
-                    prop->SetPropertyList(proplist);
-                    (*(temp->m_hashmap))[names[i]] = prop;
-                    temp = proplist;
-                }
-                else
-                {   // Here comes the last property
-                    Property* prop = new Property();
-                    prop->SetType(penvPT_None);
-                    prop->SetName(names[i]);
-                    (*(temp->m_hashmap))[names[i]] = prop;
-                    return (prop);
-                }
+                itr->second->m_list = this;
             }
-        } else {
-            return (NULL);
         }
+        return;
     }
-    else
+    SharedProperties* shared = new SharedProperties();
+    shared->refcount = 1;
+    shared->owner = this;
+    for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
     {
-        // Property existiert
-        // Neuer Name zusammensetzten und rekursiv aufrufen
-        wxString name = names[1];
-        for (size_t i=2; i<names.Count(); ++i)
-        {
-            name += '/';
-            name += names[i];
-        }
-        return ((*m_hashmap)[names[0]]->GetPropertyList()->GetProperty(name, create));
+        Property* copy = CopyProperty(itr->second);
+        copy->m_list = this;
+        shared->hashmap[itr->first] = copy;
+    }
+    ReleaseOwnership();
+    if (AtomicDecrement(&m_shared->refcount) == 1) AtomicDecrement(&s_sharedcount);
+    m_shared = shared;
+    m_hashmap = &m_shared->hashmap;
+    // Der Cache zeigt noch auf die geteilten Properties
+    InvalidatePathCache();
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::ReleaseOwnership()
+/**
+ * \brief Removes the pointers of the shared properties to this list
+ * (private). Called before this list stops using the properties, so
+ * the properties do not point to a deleted list. The remaining list
+ * takes over the properties in Unshare().
+ **/
+{
+    if (m_shared->owner != this) return;
+    m_shared->owner = NULL;
+    PropertiesHashMap::iterator itr;
+    for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
+    {
+        itr->second->m_list = NULL;
     }
+}
+
 
-    // Wenn er hier ankommt muss ein Fehler aufgetreten sein
-    wxLogError(_T("[penv::PropertyList::GetProperty] Unhandled error occured."));
-    return (NULL);
+//----------------------------------------------------------------
+Property* PropertyList::CopyProperty(const Property* prop)
+/**
+ * \brief Copies a property for this list (private).
+ * \param prop The property which should be copied.
+ * \return The new property.
+ **/
+{
+    Property* copy = new (m_pool) Property();
+    copy->SetName(prop->GetName());
+    copy->SetType(prop->GetType());
+    switch (prop->GetType())
+    {
+        case penvPT_Boolean:
+            copy->SetBoolean(prop->GetBoolean());
+        break;
+        case penvPT_Integer:
+            copy->SetInteger(prop->GetInteger());
+        break;
+        case penvPT_Double:
+            copy->SetDouble(prop->GetDouble());
+        break;
+        case penvPT_String:
+            copy->SetString(prop->GetString());
+        break;
+        case penvPT_Properties:
+            if (prop->GetPropertyList() != NULL)
+            {
+                PropertyList* list = prop->GetPropertyList()->Clone();
+                list->m_parent = copy;
+                copy->SetPropertyList(list);
+            }
+        break;
+        case penvPT_ArrayBoolean:
+            copy->SetBooleanArray(prop->GetBooleanArray(), prop->GetArrayCount());
+        break;
+        case penvPT_ArrayInteger:
+            copy->SetIntegerArray(prop->GetIntegerArray(), prop->GetArrayCount());
+        break;
+        case penvPT_ArrayDouble:
+            copy->SetDoubleArray(prop->GetDoubleArray(), prop->GetArrayCount());
+        break;
+        case penvPT_ArrayString:
+            copy->SetStringArray(prop->GetStringArray(), prop->GetArrayCount());
+        break;
+        default:
+        break;
+    }
+    return (copy);
 }
 
+
 //----------------------------------------------------------------
 void PropertyList::SetProperty(const wxString& propname, const Property& prop)
 /**
@@ -286,19 +549,19 @@ void PropertyList::SetProperty(const wxString& propname, const Property& prop)
             setprop->SetString(prop.GetString());
         break;
         case penvPT_Properties:
-            setprop->SetPropertyList(prop.GetPropertyList());
+            setprop->SetPropertyList(prop.GetPropertyList() != NULL ? prop.GetPropertyList()->Clone() : NULL);
         break;
         case penvPT_ArrayBoolean:
-            NOT_IMPLEMENTED_YET();
+            setprop->SetBooleanArray(prop.GetBooleanArray(), prop.GetArrayCount());
         break;
         case penvPT_ArrayInteger:
-            NOT_IMPLEMENTED_YET();
+            setprop->SetIntegerArray(prop.GetIntegerArray(), prop.GetArrayCount());
         break;
         case penvPT_ArrayDouble:
-            NOT_IMPLEMENTED_YET();
+            setprop->SetDoubleArray(prop.GetDoubleArray(), prop.GetArrayCount());
         break;
         case penvPT_ArrayString:
-            NOT_IMPLEMENTED_YET();
+            setprop->SetStringArray(prop.GetStringArray(), prop.GetArrayCount());
         break;
         default:
             wxString msg = wxString::Format(_T("Unknown type for property %s."), setprop->GetName().c_str());
@@ -317,7 +580,7 @@ int PropertyList::GetInteger(const wxString& propname)
  * \return Value of that property.
  **/
 {
-    Property* prop = GetProperty(propname, false);
+    Property* prop = LookupProperty(propname, false, false);
     if (prop == NULL) {
         wxLogError(_T("[penv::PropertyList::GetInteger] The property '%s' does not exists."), propname.c_str());
         return (-1);
@@ -337,7 +600,7 @@ double PropertyList::GetDouble(const wxString& propname)
  * \return Value of that property.
  **/
 {
-    Property* prop = GetProperty(propname, false);
+    Property* prop = LookupProperty(propname, false, false);
     if (prop == NULL) {
         wxLogError(_T("[penv::PropertyList::GetDouble] The property '%s' does not exists."), propname.c_str());
         return (-1);
@@ -358,7 +621,7 @@ bool PropertyList::GetBoolean(const wxString& propname)
  * \return Value of that property.
  **/
 {
-    Property* prop = GetProperty(propname, false);
+    Property* prop = LookupProperty(propname, false, false);
     if (prop == NULL) {
         wxLogError(_T("[penv::PropertyList::GetBoolean] The property '%s' does not exists."), propname.c_str());
         return (false);
@@ -377,7 +640,7 @@ const wxString& PropertyList::GetString(const wxString& propname)
  * \return Value of that property.
  **/
 {
-    Property* prop = GetProperty(propname, false);
+    Property* prop = LookupProperty(propname, false, false);
     if (prop == NULL) {
         wxLogError(_T("[penv::PropertyList::GetString] The property '%s' does not exists."), propname.c_str());
         return (m_empty);
@@ -391,7 +654,8 @@ PropertyList* PropertyList::GetPropertyList(const wxString& propname)
 /**
  * \brief Returns the propertylist from a known property.
  * The method returns NULL if the property does not exists and
- * a error will be generated.
+ * a error will be generated. Because the returned list can be
+ * changed, shared properties are copied first.
  * \param propname The property name.
  * \return Value of that property.
  **/
@@ -404,6 +668,94 @@ PropertyList* PropertyList::GetPropertyList(const wxString& propname)
     return (prop->GetPropertyList());
 }
 
+//----------------------------------------------------------------
+const bool* PropertyList::GetBooleanArray(const wxString& propname, size_t* count)
+/**
+ * \brief Returns the values from a known boolean array property. The
+ * values belong to the property and are valid until the property
+ * changes. The method returns NULL if the property does not exists
+ * and a error will be generated.
+ * \param propname The property name.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of that property.
+ **/
+{
+    Property* prop = LookupProperty(propname, false, false);
+    if (prop == NULL) {
+        wxLogError(_T("[penv::PropertyList::GetBooleanArray] The property '%s' does not exists."), propname.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    return (prop->GetBooleanArray(count));
+}
+
+
+//----------------------------------------------------------------
+const int* PropertyList::GetIntegerArray(const wxString& propname, size_t* count)
+/**
+ * \brief Returns the values from a known integer array property. The
+ * values belong to the property and are valid until the property
+ * changes. The method returns NULL if the property does not exists
+ * and a error will be generated.
+ * \param propname The property name.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of that property.
+ **/
+{
+    Property* prop = LookupProperty(propname, false, false);
+    if (prop == NULL) {
+        wxLogError(_T("[penv::PropertyList::GetIntegerArray] The property '%s' does not exists."), propname.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    return (prop->GetIntegerArray(count));
+}
+
+
+//----------------------------------------------------------------
+const double* PropertyList::GetDoubleArray(const wxString& propname, size_t* count)
+/**
+ * \brief Returns the values from a known double array property. The
+ * values belong to the property and are valid until the property
+ * changes. The method returns NULL if the property does not exists
+ * and a error will be generated.
+ * \param propname The property name.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of that property.
+ **/
+{
+    Property* prop = LookupProperty(propname, false, false);
+    if (prop == NULL) {
+        wxLogError(_T("[penv::PropertyList::GetDoubleArray] The property '%s' does not exists."), propname.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    return (prop->GetDoubleArray(count));
+}
+
+
+//----------------------------------------------------------------
+const wxString* PropertyList::GetStringArray(const wxString& propname, size_t* count)
+/**
+ * \brief Returns the values from a known string array property. The
+ * values belong to the property and are valid until the property
+ * changes. The method returns NULL if the property does not exists
+ * and a error will be generated.
+ * \param propname The property name.
+ * \param count Returns the number of values, can be NULL.
+ * \return Values of that property.
+ **/
+{
+    Property* prop = LookupProperty(propname, false, false);
+    if (prop == NULL) {
+        wxLogError(_T("[penv::PropertyList::GetStringArray] The property '%s' does not exists."), propname.c_str());
+        if (count != NULL) *count = 0;
+        return (NULL);
+    }
+    return (prop->GetStringArray(count));
+}
+
+
 //----------------------------------------------------------------
 void PropertyList::Set(const wxString& propname, int value)
 /**
@@ -507,6 +859,80 @@ void PropertyList::Set(const wxString& propname, const PropertyList& value)
 }
 
 
+//----------------------------------------------------------------
+void PropertyList::Set(const wxString& propname, const bool* values, size_t count)
+/**
+ * \brief Sets the values of a boolean array property. The values will be
+ * copied. If the property does not exists it will be created.
+ * \param propname The property name.
+ * \param values Values to set for the property.
+ * \param count Number of values.
+ **/
+{
+    Property* prop = GetProperty(propname, true);
+    prop->SetBooleanArray(values, count);
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::Set(const wxString& propname, const int* values, size_t count)
+/**
+ * \brief Sets the values of a integer array property. The values will be
+ * copied. If the property does not exists it will be created.
+ * \param propname The property name.
+ * \param values Values to set for the property.
+ * \param count Number of values.
+ **/
+{
+    Property* prop = GetProperty(propname, true);
+    prop->SetIntegerArray(values, count);
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::Set(const wxString& propname, const double* values, size_t count)
+/**
+ * \brief Sets the values of a double array property. The values will be
+ * copied. If the property does not exists it will be created.
+ * \param propname The property name.
+ * \param values Values to set for the property.
+ * \param count Number of values.
+ **/
+{
+    Property* prop = GetProperty(propname, true);
+    prop->SetDoubleArray(values, count);
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::Set(const wxString& propname, const wxString* values, size_t count)
+/**
+ * \brief Sets the values of a string array property. The values will be
+ * copied. If the property does not exists it will be created.
+ * \param propname The property name.
+ * \param values Values to set for the property.
+ * \param count Number of values.
+ **/
+{
+    Property* prop = GetProperty(propname, true);
+    prop->SetStringArray(values, count);
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::Set(const wxString& propname, const wxArrayString& values)
+/**
+ * \brief Sets the values of a string array property. The values will be
+ * copied. If the property does not exists it will be created.
+ * \param propname The property name.
+ * \param values Values to set for the property.
+ **/
+{
+    Property* prop = GetProperty(propname, true);
+    prop->SetStringArray(values);
+}
+
+
 
 
 //----------------------------------------------------------------
@@ -529,6 +955,7 @@ bool PropertyList::ReadNode(wxXmlNode* node)
         wxLogError(_T("[penv::PropertyList::ReadNode] Given properties node '%s' is not an element."), node->GetName().c_str());
         return (false);
     }
+    Unshare();
     if (node->GetName() != _T("properties") && (node->GetName() == _T("property") &&
         node->GetPropVal(_T("type"), wxEmptyString) != _T("properties")))
     {
@@ -545,8 +972,8 @@ bool PropertyList::ReadNode(wxXmlNode* node)
             continue;
         }
         // Property erstellen und auslesen
-        Property* prop = new Property();
-        if (unlikely(!prop->ReadNode(child))) {
+        Property* prop = new (m_pool) Property();
+        if (unlikely(!prop->ReadNode(child, m_pool))) {
             // Wenn ein Fehler aufgetreten ist, dann eine Warning ausgeben
             // und nicht hinzufgen
             wxLogWarning(_T("[penv::PropertyList::ReadNode] Could not read property \"%s\"."), child->GetName().c_str());
@@ -556,6 +983,7 @@ bool PropertyList::ReadNode(wxXmlNode* node)
             if (m_hashmap->find(prop->GetName()) != m_hashmap->end()) {
                 wxLogWarning(_T("[penv::PropertyList::ReadNode] Property with the name \"%s\" already exists."), prop->GetName().c_str());
             } else {
+                prop->m_list = this;
                 (*m_hashmap)[prop->GetName()] = prop;
             }
         }
@@ -565,6 +993,59 @@ bool PropertyList::ReadNode(wxXmlNode* node)
 }
 
 
+//----------------------------------------------------------------
+bool PropertyList::ReadNode(XmlReader* reader)
+/**
+ * \brief Read out a 'properties' xml element node or a 'property'
+ * xml element node where type attribute is 'properties' from a
+ * XmlReader. The reader must be positioned on the start of the
+ * element, after this call it is positioned on the end of the element.
+ * See class description for structure of such an xml node.
+ * \param reader The XmlReader positioned on the element.
+ * \return True on success; false otherwise.
+ **/
+{
+    // Fehler abfangen
+    if (unlikely(reader == NULL)) {
+        wxLogError(_T("[penv::PropertyList::ReadNode] Xml reader is NULL."));
+        return (false);
+    }
+    if (unlikely(reader->GetNodeType() != penvXR_StartElement)) {
+        wxLogError(_T("[penv::PropertyList::ReadNode] Given properties node '%s' is not an element."), reader->GetName().c_str());
+        return (false);
+    }
+    Unshare();
+    if (reader->GetName() != _T("properties") && (reader->GetName() == _T("property") &&
+        reader->GetAttribute(_T("type"), wxEmptyString) != _T("properties")))
+    {
+        wxLogError(_T("[penv::PropertyList::ReadNode] Node must have the name 'properties' or 'property' with type set to 'properties'."));
+        return (false);
+    }
+    // Alle Elemente in dem Node einlesen, nicht gelesene Elemente
+    // werden von NextChild() bersprungen
+    size_t depth = reader->GetDepth();
+    while (reader->NextChild(depth))
+    {
+        if (reader->GetName() != _T("property")) continue;
+        // Property erstellen und auslesen
+        Property* prop = new (m_pool) Property();
+        if (unlikely(!prop->ReadNode(reader, m_pool))) {
+            wxLogWarning(_T("[penv::PropertyList::ReadNode] Could not read property \"%s\"."), reader->GetName().c_str());
+            delete prop;
+        } else {
+            if (m_hashmap->find(prop->GetName()) != m_hashmap->end()) {
+                wxLogWarning(_T("[penv::PropertyList::ReadNode] Property with the name \"%s\" already exists."), prop->GetName().c_str());
+                delete prop;
+            } else {
+                prop->m_list = this;
+                (*m_hashmap)[prop->GetName()] = prop;
+            }
+        }
+    }
+    return (!reader->HasError());
+}
+
+
 //----------------------------------------------------------------
 wxXmlNode* PropertyList::WriteNode()
 /**
@@ -574,6 +1055,7 @@ wxXmlNode* PropertyList::WriteNode()
  **/
 {
     wxXmlNode* node = PenvHelper::CreateXmlNode(_T("properties"));
+    XmlNodeBuilder builder(node);
     PropertiesHashMap::iterator itr;
     for (itr = m_hashmap->begin(); itr != m_hashmap->end(); itr++)
     {
@@ -584,11 +1066,71 @@ wxXmlNode* PropertyList::WriteNode()
             wxLogError(_T("[penv::PropertyList::WriteNode] Failed to write property '%s', skipping."), prop->GetName().c_str());
             continue;
         }
-        PenvHelper::AddXmlChildNode(node, child);
+        builder.Append(child);
     }
     return (node);
 }
 
+
+//----------------------------------------------------------------
+void PropertyList::WriteNode(XmlWriter* writer)
+/**
+ * \brief Writes a 'properties' xml element directly into a XmlWriter.
+ * See class description for structure of such an xml node.
+ * \param writer The XmlWriter.
+ **/
+{
+    writer->WriteStartElement(_T("properties"));
+    PropertiesHashMap::iterator itr;
+    for (itr = m_hashmap->begin(); itr != m_hashmap->end(); itr++)
+    {
+        itr->second->WriteNode(writer);
+    }
+    writer->WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+bool PropertyList::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the properties from a snapshot, which was written
+ * by WriteSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    Unshare();
+    size_t count = reader->ReadUInt32();
+    for (size_t i=0; i<count && !reader->HasError(); ++i)
+    {
+        Property* prop = new (m_pool) Property();
+        if (unlikely(!prop->ReadSnapshot(reader, m_pool))) {
+            delete prop;
+            return (false);
+        }
+        prop->m_list = this;
+        (*m_hashmap)[prop->GetName()] = prop;
+    }
+    return (!reader->HasError());
+}
+
+
+//----------------------------------------------------------------
+void PropertyList::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the properties into a snapshot, see
+ * WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteUInt32((wxUint32)m_hashmap->size());
+    PropertiesHashMap::iterator itr;
+    for (itr = m_hashmap->begin(); itr != m_hashmap->end(); itr++)
+    {
+        itr->second->WriteSnapshot(writer);
+    }
+}
+
 } // namespace penv
 
 
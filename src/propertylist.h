@@ -12,6 +12,7 @@
 
 #include "wxincludes.h"
 #include "property.h"
+#include "memorypool.h"
 
 
 namespace penv {
@@ -31,6 +32,18 @@ namespace penv {
  * props->Set(_T("secondproplist/thirdproplist/boolprop"), true);<br>
  * wxString strg = props->GetString(_T("anothersecondproplist/stringprop"));<br>
  * </code><br>
+ * Every PropertyList caches the properties, which were accessed with
+ * a path. So accessing a deeper property again only needs one hash
+ * lookup and does not allocate any memory. If a property list is
+ * replaced or copied, only the caches of the list and its parent
+ * lists are invalidated.<br>
+ * Copies of a PropertyList (see Clone()) share the properties with
+ * the original list until one of them is changed (copy on write).
+ * The methods which return a changeable Property or PropertyList
+ * (GetProperty(), GetPropertyList()) and all Set() methods give the
+ * list its own copy of the properties first. Pointers to properties,
+ * which were returned before the list was copied, must not be used
+ * to change the properties.<br>
  * List of classes where PropertyList is used:<br>
  * <ul>
  *  <li><b>Environment:</b> For saving configurations of the main application.</li>
@@ -47,6 +60,7 @@ namespace penv {
  *  &nbsp;&nbsp;&lt;property name="boolprop" type="boolean"&gt;true&lt;/property&gt;<br>
  *  &nbsp;&nbsp;&lt;property name="intprop" type="integer"&gt;1000&lt;/property&gt;<br>
  *  &nbsp;&nbsp;&lt;property name="doubleprop" type="double"&gt;0.64372&lt;/property&gt;<br>
+ *  &nbsp;&nbsp;&lt;property name="widths" type="arrayinteger" count="3"&gt;120 80 200&lt;/property&gt;<br>
  *  &nbsp;&nbsp;&lt;property name="secondproplist" type="properties"&gt;<br>
  *  &nbsp;&nbsp;&nbsp;&nbsp;&lt;property name="boolprop" type="boolean"&gt;true&lt;/property&gt;<br>
  *  &nbsp;&nbsp;&nbsp;&nbsp;&lt;property name="intprop" type="integer"&gt;1000&lt;/property&gt;<br>
@@ -54,12 +68,13 @@ namespace penv {
  *  &nbsp;&nbsp;&lt;!-- other property elements should be here --&gt;<br>
  *  &lt;/properties&gt;<br>
  * </code>
- * \todo Implement the clone functionality.
  **/
 class PropertyList
 {
+    DECLARE_MEMORYPOOL_OPERATORS()
     public:
-        PropertyList(Property* parent = NULL);
+        friend class Property;
+        PropertyList(Property* parent = NULL, MemoryPool* pool = NULL);
         PropertyList(const PropertyList& props);
         ~PropertyList();
 
@@ -68,6 +83,7 @@ class PropertyList
         bool ExistsProperty(const wxString& propname);
         PropertyType GetType(const wxString& propname);
         Property* GetParent();
+        MemoryPool* GetMemoryPool();
         Property* GetProperty(const wxString& propname, bool create = false);
         void SetProperty(const wxString& propname, const Property& prop);
 
@@ -76,6 +92,10 @@ class PropertyList
         bool GetBoolean(const wxString& propname);
         const wxString& GetString(const wxString& propname);
         PropertyList* GetPropertyList(const wxString& propname);
+        const bool* GetBooleanArray(const wxString& propname, size_t* count);
+        const int* GetIntegerArray(const wxString& propname, size_t* count);
+        const double* GetDoubleArray(const wxString& propname, size_t* count);
+        const wxString* GetStringArray(const wxString& propname, size_t* count);
 
 
         void Set(const wxString& propname, int value);
@@ -84,16 +104,66 @@ class PropertyList
         void Set(const wxString& propname, const wxString& value);
         void Set(const wxString& propname, const wxChar* value);
         void Set(const wxString& propname, const PropertyList& value);
+        void Set(const wxString& propname, const bool* values, size_t count);
+        void Set(const wxString& propname, const int* values, size_t count);
+        void Set(const wxString& propname, const double* values, size_t count);
+        void Set(const wxString& propname, const wxString* values, size_t count);
+        void Set(const wxString& propname, const wxArrayString& values);
 
-        PropertyList* Clone(){return NULL;}
+        PropertyList* Clone();
         bool ReadNode(wxXmlNode* node);
+        bool ReadNode(XmlReader* reader);
         wxXmlNode* WriteNode();
+        void WriteNode(XmlWriter* writer);
+        bool ReadSnapshot(SnapshotReader* reader);
+        void WriteSnapshot(SnapshotWriter* writer);
+
+        static void EnablePathCache(bool enable = true);
+        static bool IsPathCacheEnabled();
+        static bool HasSharedProperties();
+
+    private:
+        Property* LookupProperty(const wxString& propname, bool create, bool write);
+        Property* FindProperty(const wxString& propname, bool create, bool write);
+        void Unshare();
+        void ReleaseOwnership();
+        Property* CopyProperty(const Property* prop);
+        void InvalidatePathCache() const;
 
     private:
         WX_DECLARE_STRING_HASH_MAP(Property*, PropertiesHashMap);
+        /**
+         * \brief The properties of one or more property lists.
+         * The refcount is changed with AtomicIncrement() and
+         * AtomicDecrement(), because the lists are also copied and
+         * destroyed by the threads of a ProjectLoader. The owner is
+         * the list, which the properties point to (see Unshare()).
+         **/
+        struct SharedProperties
+        {
+            PropertiesHashMap hashmap;
+            volatile size_t refcount;
+            PropertyList* owner;
+        };
+        /**
+         * \brief A property in the path cache. Write is true, if the
+         * lists on the path were not shared when the property was
+         * found, so the property can be changed.
+         **/
+        struct PathCacheEntry
+        {
+            Property* prop;
+            bool write;
+        };
+        WX_DECLARE_STRING_HASH_MAP(PathCacheEntry, PathCacheHashMap);
+        SharedProperties* m_shared;
         PropertiesHashMap* m_hashmap;
+        PathCacheHashMap* m_pathcache;
+        static volatile size_t s_sharedcount;
+        static bool s_pathcache;
         wxString m_empty;
         Property* m_parent;
+        MemoryPool* m_pool;
 };
 
 } // namespace penv
@@ -44,22 +44,18 @@ enum PropertyType
     penvPT_String,
     /**
      * \brief Spezifies that the Property is a Array of Booleans.
-     * \todo This feature is not implementet yet.
      **/
     penvPT_ArrayBoolean,
     /**
      * \brief Spezifies that the Property is a Array of Integers.
-     * \todo This feature is not implementet yet.
      **/
     penvPT_ArrayInteger,
     /**
      * \brief Spezifies that the Property is a Array of Doubles.
-     * \todo This feature is not implementet yet.
      **/
     penvPT_ArrayDouble,
     /**
      * \brief Spezifies that the Property is a Array of Strings.
-     * \todo This feature is not implementet yet.
      **/
     penvPT_ArrayString
 };
@@ -0,0 +1,248 @@
+/*
+ * snapshotreader.cpp - Implementation of the SnapshotReader class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "snapshotreader.h"
+#include "expect.h"
+#include <string.h> // for memcpy()
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+SnapshotReader::SnapshotReader()
+/**
+ * \brief Constructor, initializes the SnapshotReader object.
+ **/
+{
+    m_data = NULL;
+    m_size = 0;
+    m_pos = 0;
+    m_error = true;
+}
+
+
+//----------------------------------------------------------------
+SnapshotReader::~SnapshotReader()
+/**
+ * \brief Destructor, frees the data.
+ **/
+{
+    Close();
+}
+
+
+//----------------------------------------------------------------
+SnapshotReader::SnapshotReader(const SnapshotReader& reader)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+SnapshotReader& SnapshotReader::operator=(const SnapshotReader& reader)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotReader::Open(const wxString& filename)
+/**
+ * \brief Reads a snapshot file into memory and checks the header.
+ * A snapshot of another version or of another build (different
+ * character size) can not be read.
+ * \param filename The snapshot file.
+ * \return True on success; false if the file does not exist or
+ * can not be read.
+ **/
+{
+    Close();
+    if (!wxFile::Exists(filename)) return (false);
+    wxFile file(filename, wxFile::read);
+    wxFileOffset length = file.Length();
+    if (unlikely(!file.IsOpened() || length <= 0)) return (false);
+    m_size = (size_t)length;
+    m_data = new char[m_size];
+    if (unlikely(file.Read(m_data, m_size) != (ssize_t)m_size)) {
+        Close();
+        return (false);
+    }
+    m_pos = 0;
+    m_error = false;
+    if (ReadUInt32() != penvSNAPSHOT_MAGIC || ReadUInt32() != penvSNAPSHOT_VERSION ||
+        ReadUInt32() != sizeof(wxChar))
+    {
+        Close();
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void SnapshotReader::Close()
+/**
+ * \brief Frees the data of the snapshot.
+ **/
+{
+    if (m_data != NULL) delete [] m_data;
+    m_data = NULL;
+    m_size = 0;
+    m_pos = 0;
+    m_error = true;
+}
+
+
+//----------------------------------------------------------------
+wxUint32 SnapshotReader::ReadUInt32()
+/**
+ * \brief Reads a unsigned 32 bit integer.
+ * \return The value or 0 on error.
+ **/
+{
+    wxUint32 value = 0;
+    ReadRaw(&value, sizeof(value));
+    return (value);
+}
+
+
+//----------------------------------------------------------------
+wxInt32 SnapshotReader::ReadInt32()
+/**
+ * \brief Reads a signed 32 bit integer.
+ * \return The value or 0 on error.
+ **/
+{
+    wxInt32 value = 0;
+    ReadRaw(&value, sizeof(value));
+    return (value);
+}
+
+
+//----------------------------------------------------------------
+wxFileOffset SnapshotReader::ReadOffset()
+/**
+ * \brief Reads a file offset or file size.
+ * \return The value or 0 on error.
+ **/
+{
+    wxInt64 value = 0;
+    ReadRaw(&value, sizeof(value));
+    return ((wxFileOffset)value);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotReader::ReadBool()
+/**
+ * \brief Reads a boolean.
+ * \return The value or false on error.
+ **/
+{
+    char byte = 0;
+    ReadRaw(&byte, 1);
+    return (byte != 0);
+}
+
+
+//----------------------------------------------------------------
+double SnapshotReader::ReadDouble()
+/**
+ * \brief Reads a double.
+ * \return The value or 0.0 on error.
+ **/
+{
+    double value = 0.0;
+    ReadRaw(&value, sizeof(value));
+    return (value);
+}
+
+
+//----------------------------------------------------------------
+wxString SnapshotReader::ReadString()
+/**
+ * \brief Reads a string. The characters are copied directly into
+ * the string.
+ * \return The string or an empty string on error.
+ **/
+{
+    size_t length = ReadUInt32();
+    wxString value;
+    if (length == 0) return (value);
+    if (unlikely(m_error || length > (m_size-m_pos)/sizeof(wxChar))) {
+        m_error = true;
+        return (value);
+    }
+    {
+        wxStringBufferLength buffer(value, length);
+        memcpy((wxChar*)buffer, m_data+m_pos, length*sizeof(wxChar));
+        buffer.SetLength(length);
+    }
+    m_pos += length*sizeof(wxChar);
+    return (value);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotReader::ReadFileStamp()
+/**
+ * \brief Reads a file stamp, which was written with
+ * SnapshotWriter::WriteFileStamp() and compares it with the file.
+ * \return True if the file is unchanged; false if the file was
+ * changed, removed or created since the snapshot was written.
+ **/
+{
+    wxString filename = ReadString();
+    wxInt64 modified = 0;
+    wxInt64 size = 0;
+    ReadRaw(&modified, sizeof(modified));
+    ReadRaw(&size, sizeof(size));
+    if (m_error) return (false);
+    wxStructStat stat;
+    if (wxStat(filename.c_str(), &stat) != 0) return (modified == -1 && size == -1);
+    return (modified == (wxInt64)stat.st_mtime && size == (wxInt64)stat.st_size);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotReader::HasError() const
+/**
+ * \brief Returns true if the snapshot is not opened or it was read
+ * past the end of the data.
+ * \return True on error; false otherwise.
+ **/
+{
+    return (m_error);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotReader::ReadRaw(void* data, size_t length)
+/**
+ * \brief Copies bytes from the snapshot.
+ * \param data Destination of the bytes.
+ * \param length Number of bytes.
+ * \return True on success; false if there are not enough bytes.
+ **/
+{
+    if (unlikely(m_error || length > m_size-m_pos)) {
+        m_error = true;
+        return (false);
+    }
+    memcpy(data, m_data+m_pos, length);
+    m_pos += length;
+    return (true);
+}
+
+} // namespace penv
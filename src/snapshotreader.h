@@ -0,0 +1,62 @@
+/*
+ * snapshotreader.h - Declaration of the SnapshotReader class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_SNAPSHOTREADER_H_
+#define _PENV_SNAPSHOTREADER_H_
+
+#include "wxincludes.h"
+#include "snapshotwriter.h"
+
+
+namespace penv {
+
+/**
+ * \brief The SnapshotReader class reads a binary snapshot, which
+ * was written by a SnapshotWriter. The whole file is read into memory
+ * with one read call, the values are then taken directly from the
+ * memory without any parsing.<br>
+ * Reading past the end of the data sets the error flag and returns
+ * empty values, so the ReadSnapshot() methods only have to check
+ * HasError() at the end.
+ **/
+class SnapshotReader
+{
+    public:
+        SnapshotReader();
+        ~SnapshotReader();
+    private:
+        SnapshotReader(const SnapshotReader& reader);
+        SnapshotReader& operator=(const SnapshotReader& reader);
+
+    public:
+        bool Open(const wxString& filename);
+        void Close();
+
+        wxUint32 ReadUInt32();
+        wxInt32 ReadInt32();
+        wxFileOffset ReadOffset();
+        bool ReadBool();
+        double ReadDouble();
+        wxString ReadString();
+        bool ReadFileStamp();
+
+        bool HasError() const;
+
+    private:
+        bool ReadRaw(void* data, size_t length);
+
+    private:
+        char* m_data;
+        size_t m_size;
+        size_t m_pos;
+        bool m_error;
+};
+
+} // namespace penv
+
+#endif // _PENV_SNAPSHOTREADER_H_
@@ -0,0 +1,249 @@
+/*
+ * snapshotwriter.cpp - Implementation of the SnapshotWriter class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "snapshotwriter.h"
+#include "expect.h"
+#include <string.h> // for memcpy()
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+SnapshotWriter::SnapshotWriter()
+/**
+ * \brief Constructor, initializes the SnapshotWriter object.
+ **/
+{
+    m_buffer = new char[penvSNAPSHOTWRITER_BUFFERSIZE];
+    m_bufferpos = 0;
+    m_error = false;
+}
+
+
+//----------------------------------------------------------------
+SnapshotWriter::~SnapshotWriter()
+/**
+ * \brief Destructor. A not closed snapshot will be discarded.
+ **/
+{
+    if (m_file.IsOpened())
+    {
+        m_file.Close();
+        wxRemoveFile(m_tempfilename);
+    }
+    delete [] m_buffer;
+}
+
+
+//----------------------------------------------------------------
+SnapshotWriter::SnapshotWriter(const SnapshotWriter& writer)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+SnapshotWriter& SnapshotWriter::operator=(const SnapshotWriter& writer)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotWriter::Open(const wxString& filename)
+/**
+ * \brief Creates a temporary file next to the snapshot file and
+ * writes the header of the snapshot.
+ * \param filename The snapshot file.
+ * \return True on success; false otherwise.
+ **/
+{
+    m_filename = filename;
+    m_tempfilename = filename + _T(".tmp");
+    m_bufferpos = 0;
+    m_error = false;
+    if (unlikely(!m_file.Create(m_tempfilename, true))) {
+        wxLogError(_T("[penv::SnapshotWriter::Open] Could not create file '%s'."), m_tempfilename.c_str());
+        m_error = true;
+        return (false);
+    }
+    WriteUInt32(penvSNAPSHOT_MAGIC);
+    WriteUInt32(penvSNAPSHOT_VERSION);
+    WriteUInt32(sizeof(wxChar));
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotWriter::Close()
+/**
+ * \brief Writes the rest of the buffer and replaces the snapshot
+ * file with the temporary file. On error the temporary file is
+ * removed and the old snapshot file is left untouched.
+ * \return True if the snapshot was written; false otherwise.
+ **/
+{
+    if (!m_file.IsOpened()) return (false);
+    Flush();
+    m_file.Close();
+    if (unlikely(m_error || !wxRenameFile(m_tempfilename, m_filename))) {
+        wxRemoveFile(m_tempfilename);
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteUInt32(wxUint32 value)
+/**
+ * \brief Writes a unsigned 32 bit integer.
+ * \param value The value.
+ **/
+{
+    WriteRaw(&value, sizeof(value));
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteInt32(wxInt32 value)
+/**
+ * \brief Writes a signed 32 bit integer.
+ * \param value The value.
+ **/
+{
+    WriteRaw(&value, sizeof(value));
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteOffset(wxFileOffset value)
+/**
+ * \brief Writes a file offset or file size as 64 bit integer.
+ * \param value The value.
+ **/
+{
+    wxInt64 value64 = value;
+    WriteRaw(&value64, sizeof(value64));
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteBool(bool value)
+/**
+ * \brief Writes a boolean as one byte.
+ * \param value The value.
+ **/
+{
+    char byte = (value ? 1 : 0);
+    WriteRaw(&byte, 1);
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteDouble(double value)
+/**
+ * \brief Writes a double.
+ * \param value The value.
+ **/
+{
+    WriteRaw(&value, sizeof(value));
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteString(const wxString& value)
+/**
+ * \brief Writes a string, the length followed by the characters
+ * without conversion.
+ * \param value The string.
+ **/
+{
+    wxUint32 length = (wxUint32)value.Length();
+    WriteUInt32(length);
+    WriteRaw(value.c_str(), length*sizeof(wxChar));
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteFileStamp(const wxString& filename)
+/**
+ * \brief Writes the name, the modification time and the size of a
+ * file. The snapshot is only valid as long as the file is unchanged,
+ * see SnapshotReader::ReadFileStamp().
+ * \param filename The file, the snapshot depends on.
+ **/
+{
+    wxStructStat stat;
+    wxInt64 modified = -1;
+    wxInt64 size = -1;
+    if (wxStat(filename.c_str(), &stat) == 0)
+    {
+        modified = stat.st_mtime;
+        size = stat.st_size;
+    }
+    WriteString(filename);
+    WriteRaw(&modified, sizeof(modified));
+    WriteRaw(&size, sizeof(size));
+}
+
+
+//----------------------------------------------------------------
+bool SnapshotWriter::HasError() const
+/**
+ * \brief Returns true if an error occured while writing.
+ * \return True on error; false otherwise.
+ **/
+{
+    return (m_error);
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::WriteRaw(const void* data, size_t length)
+/**
+ * \brief Writes bytes into the buffer, the buffer is written into the
+ * file if it is full.
+ * \param data The bytes.
+ * \param length Number of bytes.
+ **/
+{
+    const char* bytes = (const char*)data;
+    while (length > 0)
+    {
+        if (m_bufferpos == penvSNAPSHOTWRITER_BUFFERSIZE) Flush();
+        size_t count = penvSNAPSHOTWRITER_BUFFERSIZE - m_bufferpos;
+        if (count > length) count = length;
+        memcpy(m_buffer+m_bufferpos, bytes, count);
+        m_bufferpos += count;
+        bytes += count;
+        length -= count;
+    }
+}
+
+
+//----------------------------------------------------------------
+void SnapshotWriter::Flush()
+/**
+ * \brief Writes the buffer into the file.
+ **/
+{
+    if (m_bufferpos == 0) return;
+    if (unlikely(!m_file.IsOpened() || m_file.Write(m_buffer, m_bufferpos) != m_bufferpos)) {
+        m_error = true;
+    }
+    m_bufferpos = 0;
+}
+
+} // namespace penv
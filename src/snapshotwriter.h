@@ -0,0 +1,85 @@
+/*
+ * snapshotwriter.h - Declaration of the SnapshotWriter class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_SNAPSHOTWRITER_H_
+#define _PENV_SNAPSHOTWRITER_H_
+
+#include "wxincludes.h"
+
+
+/**
+ * \brief Definition of the identification at the beginning of every
+ * snapshot file ('penv').
+ **/
+#define penvSNAPSHOT_MAGIC 0x766E6570
+
+/**
+ * \brief Definition of the version of the snapshot format. Must be
+ * increased if the data of any WriteSnapshot() method changes, so
+ * older snapshots will be ignored.
+ **/
+#define penvSNAPSHOT_VERSION 1
+
+/**
+ * \brief Definition of the size of the buffer in bytes, which is
+ * used by the SnapshotWriter to write the file.
+ **/
+#define penvSNAPSHOTWRITER_BUFFERSIZE 65536
+
+
+namespace penv {
+
+/**
+ * \brief The SnapshotWriter class writes a binary snapshot of loaded
+ * objects, see WorkspaceList::WriteSnapshot(). The values are written
+ * in the memory representation of the running application, so the
+ * snapshot can only be read by the same build (see SnapshotReader).
+ * A snapshot is only a cache and never replaces the xml files.<br>
+ * The file is first written into a temporary file, which replaces
+ * the snapshot file in Close(). So a incomplete snapshot will never
+ * be read.
+ **/
+class SnapshotWriter
+{
+    public:
+        SnapshotWriter();
+        ~SnapshotWriter();
+    private:
+        SnapshotWriter(const SnapshotWriter& writer);
+        SnapshotWriter& operator=(const SnapshotWriter& writer);
+
+    public:
+        bool Open(const wxString& filename);
+        bool Close();
+
+        void WriteUInt32(wxUint32 value);
+        void WriteInt32(wxInt32 value);
+        void WriteOffset(wxFileOffset value);
+        void WriteBool(bool value);
+        void WriteDouble(double value);
+        void WriteString(const wxString& value);
+        void WriteFileStamp(const wxString& filename);
+
+        bool HasError() const;
+
+    private:
+        void WriteRaw(const void* data, size_t length);
+        void Flush();
+
+    private:
+        wxFile m_file;
+        wxString m_filename;
+        wxString m_tempfilename;
+        char* m_buffer;
+        size_t m_bufferpos;
+        bool m_error;
+};
+
+} // namespace penv
+
+#endif // _PENV_SNAPSHOTWRITER_H_
@@ -11,6 +11,7 @@
 #include "toolbar.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "environment.h"
 
 namespace penv {
@@ -143,7 +144,6 @@ void ToolBar::Visible(bool visible)
         // Show toolbar
         manager->AddPane(m_toolbar, m_paneinfo);
         m_toolbar->Show();
-        manager->Update();
     }
     else
     {
@@ -151,6 +151,12 @@ void ToolBar::Visible(bool visible)
         m_paneinfo = manager->GetPane(m_toolbar);
         manager->DetachPane(m_toolbar);
         m_toolbar->Hide();
+    }
+    // Update the manager now or at the end of a command list update
+    CommandList* cmdlist = Environment::Get()->GetCommandList();
+    if (cmdlist != NULL && cmdlist->IsUpdating()) {
+        cmdlist->UpdateManagerLater();
+    } else {
         manager->Update();
     }
     m_visible = visible;
@@ -301,15 +307,22 @@ bool ToolBar::Update()
         // Because ClearTools does not remove events
         //  from event handler, remove them manually
         ClearToolEvents();
-        // Clear all tool items
+        // Clear all tool items and remove them from the index
         m_toolbar->ClearTools();
+        for (size_t i=0; i<m_array->Count(); ++i)
+        {
+            ToolBarItem* item = m_array->ItemUnchecked(i);
+            if (item->GetTool() == NULL) continue;
+            env->GetCommandList()->UnbindToolBarItem(item);
+            item->SetTool(NULL);
+        }
     }
     if (m_toolbarids != NULL) delete [] m_toolbarids;
     m_toolbarids = new int[m_array->Count()];
     m_counttoolbarids = m_array->Count();
     for (size_t i=0; i<m_array->Count(); ++i)
     {
-        ToolBarItem* item = m_array->ItemPtr(i);
+        ToolBarItem* item = m_array->ItemUnchecked(i);
         // berprfen ob ID schon aufgelst wurde
         if (item->GetCommand() == NULL && !item->GetId().IsEmpty()) {
             item->SetCommand(env->GetCommandList()->GetCommand(item->GetId()));
@@ -344,6 +357,7 @@ bool ToolBar::Update()
                 item->GetCommand()->GetHelp());
             item->SetTool(tool);
             tool->Enable(item->GetCommand()->IsEnabled());
+            env->GetCommandList()->BindToolBarItem(item);
             if (unlikely(!item->TryConnect())) {
                 wxLogWarning(_T("[penv::ToolBar::Update] Could not connect tool item, with wxWidgets Event."));
                 m_toolbarids[i] = -1;
@@ -462,13 +476,14 @@ wxXmlNode* ToolBar::WriteNode()
     wxAuiManager* mgr = Environment::Get()->GetFrame()->GetManager();
     wxString posinfo = mgr->SavePaneInfo(m_paneinfo);
     wxXmlNode* posnode = PenvHelper::CreateXmlNode(_T("position"), posinfo);
-    PenvHelper::AddXmlChildNode(node, posnode);
+    XmlNodeBuilder builder(node);
+    builder.Append(posnode);
     // ToolBar Itemes erstellen und hinzufgen
     for (size_t i=0; i<m_array->Count(); ++i)
     {
         ToolBarItem* item = (*m_array)[i];
         wxXmlNode* toolitemnode = item->WriteNode();
-        PenvHelper::AddXmlChildNode(node, toolitemnode);
+        builder.Append(toolitemnode);
     }
     return (node);
 }
@@ -48,6 +48,11 @@ ToolBarItem::~ToolBarItem()
  **/
 {
     // TEST: Event verbindung gelscht? Nach ToolBar::Update()
+    // Aus dem Index der CommandList entfernen
+    if (m_tool != NULL) {
+        CommandList* cmdlist = Environment::Get()->GetCommandList();
+        if (cmdlist != NULL) cmdlist->UnbindToolBarItem(this);
+    }
 }
 
 //----------------------------------------------------------------
@@ -9,6 +9,7 @@
 #include "toolbarlist.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "environment.h"
 
 
@@ -287,9 +288,16 @@ void ToolBarList::RefreshPaneInfos()
 //----------------------------------------------------------------
 void ToolBarList::RealizeAllToolBars()
 /**
- * \brief Realizes all toolbars in the toolbar list.
+ * \brief Realizes all toolbars in the toolbar list. During a update
+ * of the command list (CommandList::BeginUpdate()) this will be
+ * deferred until the update ends.
  **/
 {
+    CommandList* cmdlist = Environment::Get()->GetCommandList();
+    if (cmdlist != NULL && cmdlist->IsUpdating()) {
+        cmdlist->RealizeToolBarsLater();
+        return;
+    }
     ToolBarHashMap::iterator itr;
     for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
     {
@@ -358,12 +366,13 @@ wxXmlNode* ToolBarList::WriteNode()
  **/
 {
     wxXmlNode* node = PenvHelper::CreateXmlNode(_T("toolbars"));
+    XmlNodeBuilder builder(node);
     ToolBarHashMap::iterator itr;
     for (itr = m_hashmap->begin(); itr != m_hashmap->end(); ++itr)
     {
         ToolBar* tbar = itr->second;
         wxXmlNode* tbarnode = tbar->WriteNode();
-        PenvHelper::AddXmlChildNode(node, tbarnode);
+        builder.Append(tbarnode);
     }
     return (node);
 }
@@ -9,11 +9,43 @@
 
 #include "debugpagecommands.h"
 #include "../environment.h"
+#include <algorithm>
 
 
 namespace penv {
 
 
+/**
+ * \brief Compares two commands after a column of the list control
+ * in the DebugPageCommands, used to sort the list.
+ **/
+class DebugPageCommandsComparer
+{
+    public:
+        DebugPageCommandsComparer(int column, bool ascending)
+            : m_column(column), m_ascending(ascending) {}
+
+        bool operator()(Command* cmd1, Command* cmd2) const
+        {
+            if (!m_ascending) std::swap(cmd1, cmd2);
+            switch (m_column)
+            {
+                case 1: return (cmd1->GetName() < cmd2->GetName());
+                case 5: return (cmd1->GetCallbacksCount() < cmd2->GetCallbacksCount());
+                case 7: return (cmd1->GetProfileCount() < cmd2->GetProfileCount());
+                case 8: return (cmd1->GetProfileTotalTime() < cmd2->GetProfileTotalTime());
+                case 9: return (cmd1->GetProfileMaxTime() < cmd2->GetProfileMaxTime());
+                default: return (cmd1->GetId() < cmd2->GetId());
+            }
+        }
+
+    private:
+        int m_column;
+        bool m_ascending;
+};
+
+
+
 
 //----------------------------------------------------------------
 DebugPageCommands::DebugPageCommands(wxWindow* parent, int id)
@@ -24,6 +56,8 @@ DebugPageCommands::DebugPageCommands(wxWindow* parent, int id)
  * \param id Id for this panel, can be wxID_ANY.
  **/
 {
+    m_sortcolumn = 0;
+    m_sortascending = true;
     InitializeUI();
     DoLayout();
     ConnectEvents();
@@ -61,6 +95,10 @@ void DebugPageCommands::InitializeUI()
     m_contextmenu->Append(m_contextmenuids[1], _("Toogle enabled"), _(""), wxITEM_NORMAL);
     m_contextmenu->AppendSeparator();
     m_contextmenu->Append(m_contextmenuids[2], _("Refresh list"), _(""), wxITEM_NORMAL);
+    m_contextmenu->AppendSeparator();
+    m_contextmenu->Append(m_contextmenuids[3], _("Enable profiling"), _(""), wxITEM_CHECK);
+    m_contextmenu->Append(m_contextmenuids[4], _("Reset profiles"), _(""), wxITEM_NORMAL);
+    m_contextmenu->Append(m_contextmenuids[5], _("Export profiles ..."), _(""), wxITEM_NORMAL);
 
 
 }
@@ -92,12 +130,20 @@ void DebugPageCommands::ConnectEvents()
 {
 	m_listctrl->Connect(wxEVT_COMMAND_LIST_ITEM_RIGHT_CLICK,
         wxListEventHandler(DebugPageCommands::OnListItemRightClick), NULL, this);
+	m_listctrl->Connect(wxEVT_COMMAND_LIST_COL_CLICK,
+        wxListEventHandler(DebugPageCommands::OnListColumnClick), NULL, this);
     m_contextmenu->Connect(m_contextmenuids[0], wxEVT_COMMAND_MENU_SELECTED,
         wxCommandEventHandler(DebugPageCommands::OnContextMenuItemExecute), NULL, this);
     m_contextmenu->Connect(m_contextmenuids[1], wxEVT_COMMAND_MENU_SELECTED,
         wxCommandEventHandler(DebugPageCommands::OnContextMenuItemToogleEnabled), NULL, this);
     m_contextmenu->Connect(m_contextmenuids[2], wxEVT_COMMAND_MENU_SELECTED,
         wxCommandEventHandler(DebugPageCommands::OnContextMenuItemRefresh), NULL, this);
+    m_contextmenu->Connect(m_contextmenuids[3], wxEVT_COMMAND_MENU_SELECTED,
+        wxCommandEventHandler(DebugPageCommands::OnContextMenuItemProfiling), NULL, this);
+    m_contextmenu->Connect(m_contextmenuids[4], wxEVT_COMMAND_MENU_SELECTED,
+        wxCommandEventHandler(DebugPageCommands::OnContextMenuItemResetProfiles), NULL, this);
+    m_contextmenu->Connect(m_contextmenuids[5], wxEVT_COMMAND_MENU_SELECTED,
+        wxCommandEventHandler(DebugPageCommands::OnContextMenuItemExportProfiles), NULL, this);
 }
 
 
@@ -118,19 +164,30 @@ void DebugPageCommands::UpdateComponents()
     m_listctrl->InsertColumn(4, _T("Visible"), wxLIST_FORMAT_LEFT, 60);
     m_listctrl->InsertColumn(5, _T("CountCallbacks"), wxLIST_FORMAT_LEFT, 85);
     m_listctrl->InsertColumn(6, _T("wxEvtHandler Ptr"), wxLIST_FORMAT_LEFT, 85);
-    m_listctrl->InsertColumn(7, _T("Help"), wxLIST_FORMAT_LEFT, 200);
+    m_listctrl->InsertColumn(7, _T("Calls"), wxLIST_FORMAT_RIGHT, 50);
+    m_listctrl->InsertColumn(8, _T("Total ms"), wxLIST_FORMAT_RIGHT, 70);
+    m_listctrl->InsertColumn(9, _T("Max ms"), wxLIST_FORMAT_RIGHT, 70);
+    m_listctrl->InsertColumn(10, _T("Callbacks ms"), wxLIST_FORMAT_LEFT, 120);
+    m_listctrl->InsertColumn(11, _T("Help"), wxLIST_FORMAT_LEFT, 200);
 
     // Add items to the list
     Environment* env = Environment::Get();
     CommandList* list = env->GetCommandList();
     if (list == NULL) return;
     wxArrayString* array = list->GetCommands();
+    Array<Command> commands(false);
+    commands.Reserve(array->Count());
     for (size_t i=0; i<array->Count(); ++i)
     {
-        Command* cmd = list->GetCommand((*array)[i]);
-        AddItem(cmd);
+        commands.Add(list->GetCommand((*array)[i]));
     }
     delete array;
+    std::sort(commands.begin(), commands.end(),
+        DebugPageCommandsComparer(m_sortcolumn, m_sortascending));
+    for (size_t i=0; i<commands.Count(); ++i)
+    {
+        AddItem(commands.ItemUnchecked(i));
+    }
 }
 
 
@@ -156,7 +213,21 @@ void DebugPageCommands::AddItem(Command* cmd)
     else m_listctrl->SetItem(index, 4, _T("false"), -1);
     m_listctrl->SetItem(index, 5, wxString::Format(_T("%i"), cmd->GetCallbacksCount()), -1);
     m_listctrl->SetItem(index, 6, wxString::Format(_T("%p"), cmd), -1);
-    m_listctrl->SetItem(index, 7, cmd->GetHelp(), -1);
+    m_listctrl->SetItem(index, 7, wxString::Format(_T("%u"), (unsigned int)cmd->GetProfileCount()), -1);
+    m_listctrl->SetItem(index, 8, wxString::Format(_T("%.3f"),
+        cmd->GetProfileTotalTime().ToDouble()/1000.0), -1);
+    m_listctrl->SetItem(index, 9, wxString::Format(_T("%.3f"),
+        cmd->GetProfileMaxTime().ToDouble()/1000.0), -1);
+    // Gesamtzeit jedes Callbacks
+    wxString callbacks;
+    for (size_t i=0; i<cmd->GetCallbacksCount(); ++i)
+    {
+        if (i != 0) callbacks += _T("; ");
+        callbacks += wxString::Format(_T("%.3f"),
+            cmd->GetCallback(i)->GetProfileTotalTime().ToDouble()/1000.0);
+    }
+    m_listctrl->SetItem(index, 10, callbacks, -1);
+    m_listctrl->SetItem(index, 11, cmd->GetHelp(), -1);
 }
 
 
@@ -175,11 +246,33 @@ void DebugPageCommands::OnListItemRightClick(wxListEvent& event)
     item.SetMask(wxLIST_MASK_TEXT);
     m_listctrl->GetItem(item);
     m_commandid = item.GetText();
+    m_contextmenu->Check(m_contextmenuids[3], Command::IsProfilingEnabled());
     this->PopupMenu(m_contextmenu, event.GetPoint());
 }
 
 
 
+//----------------------------------------------------------------
+void DebugPageCommands::OnListColumnClick(wxListEvent& event)
+/**
+ * \brief Event that occurs when a column header is clicked.
+ * Sorts the list after this column, a second click on the
+ * same column reverses the order.
+ * \param event Just for event handling.
+ **/
+{
+    if (m_sortcolumn == event.GetColumn()) {
+        m_sortascending = !m_sortascending;
+    } else {
+        m_sortcolumn = event.GetColumn();
+        // Zeiten und Anzahl absteigend sortieren
+        m_sortascending = (m_sortcolumn < 7);
+    }
+    UpdateComponents();
+}
+
+
+
 //----------------------------------------------------------------
 void DebugPageCommands::OnContextMenuItemExecute(wxCommandEvent& event)
 /**
@@ -221,6 +314,51 @@ void DebugPageCommands::OnContextMenuItemRefresh(wxCommandEvent& event)
 }
 
 
+//----------------------------------------------------------------
+void DebugPageCommands::OnContextMenuItemProfiling(wxCommandEvent& event)
+/**
+ * \brief Occurs when the context menu item 'enable profiling' is
+ * clicked. Enables or disables the command profiler.
+ * \param event Event.
+ **/
+{
+    Command::EnableProfiling(!Command::IsProfilingEnabled());
+}
+
+
+//----------------------------------------------------------------
+void DebugPageCommands::OnContextMenuItemResetProfiles(wxCommandEvent& event)
+/**
+ * \brief Occurs when the context menu item 'reset profiles' is clicked.
+ * Resets the profiling information of all commands.
+ * \param event Event.
+ **/
+{
+    Environment::Get()->GetCommandList()->ResetProfiles();
+    UpdateComponents();
+}
+
+
+//----------------------------------------------------------------
+void DebugPageCommands::OnContextMenuItemExportProfiles(wxCommandEvent& event)
+/**
+ * \brief Occurs when the context menu item 'export profiles' is clicked.
+ * Opens a file dialog and writes the profiling information of all
+ * commands to a CSV or JSON file.
+ * \param event Event.
+ **/
+{
+    Environment* env = Environment::Get();
+    wxFileDialog dialog(env->GetFrame(), _T("Choose a file to export ..."),
+        _T(""), _T("profile.csv"), _T("CSV files (*.csv)|*.csv|JSON files (*.json)|*.json"),
+        wxFD_SAVE|wxFD_OVERWRITE_PROMPT, wxDefaultPosition, wxDefaultSize);
+    if (dialog.ShowModal() == wxID_OK)
+    {
+        env->GetCommandList()->ExportProfiles(dialog.GetPath());
+    }
+}
+
+
 
 } // namespace penv
 
@@ -22,13 +22,15 @@ namespace penv {
  * \brief Defines the number of context menu ids
  * for the DebugPageCommands window.
  **/
-#define penvDEBUGPAGECOMMANDS_MAXCONTEXTMENUIDS 3
+#define penvDEBUGPAGECOMMANDS_MAXCONTEXTMENUIDS 6
 
 /**
  * \brief The DebugPageCommands class is a panel with a
  * list control which displays the internally stored commands.
  * With a right click on a command or event you will be able
- * to execute or manipulate a command.
+ * to execute or manipulate a command. The context menu also
+ * enables the command profiler, resets or exports the profiling
+ * information. Click on a column header to sort the list.
  **/
 class DebugPageCommands : public wxPanel
 {
@@ -46,9 +48,13 @@ class DebugPageCommands : public wxPanel
 
     protected:
         void OnListItemRightClick(wxListEvent& event);
+        void OnListColumnClick(wxListEvent& event);
         void OnContextMenuItemExecute(wxCommandEvent& event);
         void OnContextMenuItemToogleEnabled(wxCommandEvent& event);
         void OnContextMenuItemRefresh(wxCommandEvent& event);
+        void OnContextMenuItemProfiling(wxCommandEvent& event);
+        void OnContextMenuItemResetProfiles(wxCommandEvent& event);
+        void OnContextMenuItemExportProfiles(wxCommandEvent& event);
 
 
     protected:
@@ -56,6 +62,8 @@ class DebugPageCommands : public wxPanel
         wxListCtrl* m_listctrl;
         wxMenu* m_contextmenu;
         int m_contextmenuids[penvDEBUGPAGECOMMANDS_MAXCONTEXTMENUIDS];
+        int m_sortcolumn;
+        bool m_sortascending;
 
 };
 
@@ -11,6 +11,7 @@
 
 #include "projecttreeaction.h"
 #include "projecttreectrl.h"
+#include "../environment.h"
 
 namespace penv {
 
@@ -288,9 +289,14 @@ void ProjectTreeAction::OnAdd(ProjectItemList* list, ProjectItemType type)
 //----------------------------------------------------------------
 void ProjectTreeAction::OnRemove(bool& cancel)
 /**
- * \brief
+ * \brief Removes the selected items of the tree. See
+ * OnRemove(bool&, ProjectTreeItemDataObject*).
+ * \param cancel Is set to true if nothing was removed.
  **/
 {
+    ProjectTreeItemDataObject items;
+    m_treectrl->GetSelectedItems(&items);
+    OnRemove(cancel, &items);
 }
 
 
@@ -632,6 +638,304 @@ void ProjectTreeAction::OnRename(bool& cancel, const wxString& name)
 
 
 
+//----------------------------------------------------------------
+void ProjectTreeAction::OnRemove(bool& cancel, ProjectTreeItemDataObject* items)
+/**
+ * \brief Removes all items of a multiple selection at once. The
+ * workspaces are removed from the workspace list, the projects from
+ * their workspaces and the project items from their containers. Files
+ * are not deleted from disk. Generates one PENV_EVT_PROJECTTREECTRL_DELETED
+ * event, which contains the number of removed items.
+ * \param cancel Is set to true if nothing was removed.
+ * \param items The items to remove.
+ **/
+{
+    cancel = true;
+    if (items == NULL)
+    {
+        wxLogError(_T("[penv::ProjectTreeAction::OnRemove] Argument 'items' is NULL."));
+        return;
+    }
+    Array<Workspace> workspaces(false);
+    Array<Project> projects(false);
+    Array<ProjectItem> projectitems(false);
+    GetItems(items, &workspaces, &projects, &projectitems);
+    // Baumelemente zuerst loeschen, solange die Elemente noch existieren
+    wxTreeCtrl* treectrl = m_treectrl->GetTreeCtrl();
+    treectrl->Freeze();
+    for (size_t i=0; i<projectitems.Count(); ++i)
+    {
+        DeleteTreeItem(m_treectrl->SearchItem(projectitems.ItemUnchecked(i)).GetId(), wxTreeItemId());
+    }
+    for (size_t i=0; i<projects.Count(); ++i)
+    {
+        DeleteTreeItem(m_treectrl->SearchItem(projects.ItemUnchecked(i)).GetId(), wxTreeItemId());
+    }
+    for (size_t i=0; i<workspaces.Count(); ++i)
+    {
+        DeleteTreeItem(m_treectrl->SearchItem(workspaces.ItemUnchecked(i)).GetId(), wxTreeItemId());
+    }
+    treectrl->Thaw();
+    // Von unten nach oben entfernen, ein Element unter einem anderen
+    // entfernten Element wird sonst doppelt geloescht
+    size_t count = ProjectItemList::RemoveProjectItems(&projectitems);
+    for (size_t i=0; i<projects.Count(); ++i)
+    {
+        ProjectList* list = projects.ItemUnchecked(i)->GetParent();
+        if (list == NULL) continue;
+        int index = list->GetItemIndex(projects.ItemUnchecked(i));
+        if (index != -1 && list->Remove(index)) count++;
+    }
+    WorkspaceList* list = Environment::Get()->GetWorkspaceList();
+    for (size_t i=0; i<workspaces.Count(); ++i)
+    {
+        int index = list->GetItemIndex(workspaces.ItemUnchecked(i));
+        if (index != -1 && list->Remove(index)) count++;
+    }
+    m_treectrl->ItemsChanged(true);
+    if (count == 0) return;
+    cancel = false;
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectTreeCtrlDeleted, wxVariant((long)count));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeAction::OnMove(bool& cancel, ProjectTreeItemDataObject* items,
+    ProjectTreeItemDataBase* destination)
+/**
+ * \brief Moves all items of a multiple selection at once. Projects are
+ * moved to a workspace, project items to a project or a project item
+ * with child items, all other items are skipped. Generates one
+ * PENV_EVT_PROJECTTREECTRL_MOVED event, which contains the number of
+ * moved items.
+ * \param cancel Is set to true if nothing was moved.
+ * \param items The items to move.
+ * \param destination The destination workspace, project or project item.
+ **/
+{
+    cancel = true;
+    if (items == NULL || destination == NULL)
+    {
+        wxLogError(_T("[penv::ProjectTreeAction::OnMove] Argument 'items' or 'destination' is NULL."));
+        return;
+    }
+    Array<Workspace> workspaces(false);
+    Array<Project> projects(false);
+    Array<ProjectItem> projectitems(false);
+    GetItems(items, &workspaces, &projects, &projectitems);
+    size_t first = 0;
+    size_t count = 0;
+    if (destination->GetType() == penvTI_Workspace)
+    {
+        first = destination->GetWorkspace()->GetProjectList()->Count();
+        count = ProjectList::MoveProjects(&projects, destination->GetWorkspace());
+    }
+    else
+    {
+        ProjectItemList* list = GetItemList(destination);
+        if (list == NULL)
+        {
+            wxLogWarning(_T("[penv::ProjectTreeAction::OnMove] Can not move project items to this project item."));
+            return;
+        }
+        first = list->Count();
+        count = ProjectItemList::MoveProjectItems(&projectitems, list);
+    }
+    if (count == 0) return;
+    cancel = false;
+    // Der Baum wird nur einmal aktualisiert
+    wxTreeItemId destid = GetTreeItemId(destination);
+    wxTreeCtrl* treectrl = m_treectrl->GetTreeCtrl();
+    treectrl->Freeze();
+    for (size_t i=0; i<projects.Count(); ++i)
+    {
+        DeleteTreeItem(m_treectrl->SearchItem(projects.ItemUnchecked(i)).GetId(), destid);
+    }
+    for (size_t i=0; i<projectitems.Count(); ++i)
+    {
+        DeleteTreeItem(m_treectrl->SearchItem(projectitems.ItemUnchecked(i)).GetId(), destid);
+    }
+    AddTreeItems(destid, destination, first);
+    treectrl->Thaw();
+    m_treectrl->ItemsChanged(false);
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectTreeCtrlMoved, wxVariant((long)count));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeAction::OnCopy(bool& cancel, ProjectTreeItemDataObject* items,
+    ProjectTreeItemDataBase* destination)
+/**
+ * \brief Copies all items of a multiple selection at once. Projects are
+ * copied to a workspace, project items to a project or a project item
+ * with child items, all other items are skipped. Generates one
+ * PENV_EVT_PROJECTTREECTRL_COPIED event, which contains the number of
+ * copied items.
+ * \param cancel Is set to true if nothing was copied.
+ * \param items The items to copy.
+ * \param destination The destination workspace, project or project item.
+ **/
+{
+    cancel = true;
+    if (items == NULL || destination == NULL)
+    {
+        wxLogError(_T("[penv::ProjectTreeAction::OnCopy] Argument 'items' or 'destination' is NULL."));
+        return;
+    }
+    Array<Workspace> workspaces(false);
+    Array<Project> projects(false);
+    Array<ProjectItem> projectitems(false);
+    GetItems(items, &workspaces, &projects, &projectitems);
+    size_t first = 0;
+    size_t count = 0;
+    if (destination->GetType() == penvTI_Workspace)
+    {
+        first = destination->GetWorkspace()->GetProjectList()->Count();
+        count = ProjectList::CopyProjects(&projects, destination->GetWorkspace());
+    }
+    else
+    {
+        ProjectItemList* list = GetItemList(destination);
+        if (list == NULL)
+        {
+            wxLogWarning(_T("[penv::ProjectTreeAction::OnCopy] Can not copy project items to this project item."));
+            return;
+        }
+        first = list->Count();
+        count = ProjectItemList::CopyProjectItems(&projectitems, list);
+    }
+    if (count == 0) return;
+    cancel = false;
+    wxTreeCtrl* treectrl = m_treectrl->GetTreeCtrl();
+    treectrl->Freeze();
+    AddTreeItems(GetTreeItemId(destination), destination, first);
+    treectrl->Thaw();
+    m_treectrl->ItemsChanged(false);
+    Environment::Get()->GetCommandList()->Execute(penvCE_ProjectTreeCtrlCopied, wxVariant((long)count));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeAction::GetItems(ProjectTreeItemDataObject* items, Array<Workspace>* workspaces,
+    Array<Project>* projects, Array<ProjectItem>* projectitems)
+/**
+ * \brief Sorts the items of a data object by their type.
+ * \param items The items.
+ * \param workspaces Array for the workspaces, must not own them.
+ * \param projects Array for the projects, must not own them.
+ * \param projectitems Array for the project items, must not own them.
+ **/
+{
+    for (size_t i=0; i<items->Count(); ++i)
+    {
+        ProjectTreeItemDataBase* data = items->GetItem(i);
+        if (data->GetType() == penvTI_Workspace && data->GetWorkspace() != NULL) {
+            workspaces->Add(data->GetWorkspace());
+        } else if (data->GetType() == penvTI_Project && data->GetProject() != NULL) {
+            projects->Add(data->GetProject());
+        } else if (data->GetType() == penvTI_ProjectItem && data->GetProjectItem() != NULL) {
+            projectitems->Add(data->GetProjectItem());
+        }
+    }
+}
+
+
+//----------------------------------------------------------------
+ProjectItemList* ProjectTreeAction::GetItemList(ProjectTreeItemDataBase* destination)
+/**
+ * \brief Returns the container of a project or project item, into
+ * which project items can be moved or copied.
+ * \param destination The project or project item.
+ * \return The container or NULL for workspaces, files and linked items.
+ **/
+{
+    if (destination->GetType() == penvTI_Project) {
+        return (destination->GetProject()->GetProjectItemList());
+    }
+    if (destination->GetType() != penvTI_ProjectItem) return (NULL);
+    ProjectItem* item = destination->GetProjectItem();
+    if (item->GetType() == penvPI_File || item->GetType() == penvPI_LinkedItems) return (NULL);
+    return (item->GetItemList());
+}
+
+
+//----------------------------------------------------------------
+wxTreeItemId ProjectTreeAction::GetTreeItemId(ProjectTreeItemDataBase* data)
+/**
+ * \brief Returns the tree item of a workspace, project or project item.
+ * \param data The workspace, project or project item.
+ * \return The tree item id or an invalid id if it is not in the tree.
+ **/
+{
+    if (data->GetType() == penvTI_Workspace) {
+        return (m_treectrl->SearchItem(data->GetWorkspace()).GetId());
+    } else if (data->GetType() == penvTI_Project) {
+        return (m_treectrl->SearchItem(data->GetProject()).GetId());
+    }
+    return (m_treectrl->SearchItem(data->GetProjectItem()).GetId());
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeAction::DeleteTreeItem(wxTreeItemId id, wxTreeItemId parent)
+/**
+ * \brief Deletes a tree item, if it is not below the given parent.
+ * A parent without child items loses its expand button.
+ * \param id The tree item, may be invalid.
+ * \param parent The parent, whose tree items are kept, or an invalid id.
+ **/
+{
+    if (!id.IsOk()) return;
+    wxTreeCtrl* treectrl = m_treectrl->GetTreeCtrl();
+    wxTreeItemId parentid = treectrl->GetItemParent(id);
+    if (parent.IsOk() && parentid == parent) return;
+    treectrl->Delete(id);
+    if (parentid.IsOk() && parentid != treectrl->GetRootItem() &&
+        treectrl->GetChildrenCount(parentid, false) == 0)
+    {
+        treectrl->SetItemHasChildren(parentid, false);
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeAction::AddTreeItems(wxTreeItemId id, ProjectTreeItemDataBase* destination, size_t first)
+/**
+ * \brief Adds the tree items of the new projects or project items of
+ * a destination. If the project items of the destination are not added
+ * to the tree yet, the tree item only gets an expand button.
+ * \param id The tree item of the destination, may be invalid.
+ * \param destination The workspace, project or project item.
+ * \param first Index of the first new project or project item.
+ **/
+{
+    if (!id.IsOk()) return;
+    wxTreeCtrl* treectrl = m_treectrl->GetTreeCtrl();
+    if (destination->GetType() == penvTI_Workspace)
+    {
+        ProjectList* list = destination->GetWorkspace()->GetProjectList();
+        for (size_t i=first; i<list->Count(); ++i)
+        {
+            Project* project = list->GetItem(i);
+            wxTreeItemId prjid = m_treectrl->AddProject(id, project);
+            m_treectrl->AddChildItems(prjid, project->GetProjectItemList(), false);
+        }
+        return;
+    }
+    // Nicht geladene Elemente werden beim Aufklappen hinzugefuegt
+    if (treectrl->GetChildrenCount(id, false) == 0)
+    {
+        treectrl->SetItemHasChildren(id, true);
+        return;
+    }
+    ProjectItemList* list = GetItemList(destination);
+    for (size_t i=first; i<list->Count(); ++i)
+    {
+        m_treectrl->AddProjectItem(id, list->GetItem(i), false);
+    }
+}
+
+
 } // namespace penv
 
 
@@ -19,6 +19,7 @@
 #include "../projectitemsubproject.h"
 #include "../projectitemlinkeditems.h"
 #include "projecttreeitemdata.h"
+#include "projecttreeitemdataobject.h"
 #include "../workspacelist.h"
 
 namespace penv {
@@ -31,7 +32,11 @@ class ProjectTreeCtrl;
  * to change the tree items.
  * There is a mismatch between UI and normal framework classes,
  * before this is not resolved, you should not use any of this
- * methods.
+ * methods.<br>
+ * The methods with a ProjectTreeItemDataObject change all items of a
+ * multiple selection at once. The model is changed in one step, the
+ * tree is updated once and only one PENV_EVT_PROJECTTREECTRL_MOVED,
+ * _COPIED or _DELETED event is generated.
  **/
 class ProjectTreeAction
 {
@@ -61,6 +66,18 @@ class ProjectTreeAction
         virtual void OnCopy(bool& cancel, ProjectItem* item, ProjectItem* destination, ProjectItemList* source);
         virtual void OnRename(bool& cancel, const wxString& name);
 
+        virtual void OnRemove(bool& cancel, ProjectTreeItemDataObject* items);
+        virtual void OnMove(bool& cancel, ProjectTreeItemDataObject* items, ProjectTreeItemDataBase* destination);
+        virtual void OnCopy(bool& cancel, ProjectTreeItemDataObject* items, ProjectTreeItemDataBase* destination);
+
+    protected:
+        void GetItems(ProjectTreeItemDataObject* items, Array<Workspace>* workspaces,
+            Array<Project>* projects, Array<ProjectItem>* projectitems);
+        ProjectItemList* GetItemList(ProjectTreeItemDataBase* destination);
+        wxTreeItemId GetTreeItemId(ProjectTreeItemDataBase* data);
+        void DeleteTreeItem(wxTreeItemId id, wxTreeItemId parent);
+        void AddTreeItems(wxTreeItemId id, ProjectTreeItemDataBase* destination, size_t first);
+
     protected:
         ProjectTreeCtrl* m_treectrl;
         ProjectTreeActionType m_type;
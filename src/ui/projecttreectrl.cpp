@@ -10,6 +10,7 @@
 #include "projecttreectrl.h"
 #include "../penvhelper.h"
 #include "../environment.h"
+#include "../commandcallback.h"
 #include "projecttreectrldroptarget.h"
 #include "projecttreeitemdatabase.h"
 #include "projecttreeitemdataobject.h"
@@ -49,9 +50,17 @@ ProjectTreeCtrl::ProjectTreeCtrl(wxWindow* parent, int id, wxPoint pos, wxSize s
     m_showtoolbar = false;
     m_apperance = new ProjectTreeCtrlApperance();
     m_actionhandler = new ProjectTreeAction(this);
+    m_pool = NULL;
+    if (penvCOMMON_USEMEMORYPOOL) m_pool = new MemoryPool();
+    m_treeitems = new TreeItemIdHashMap();
+    m_insert = false;
+    m_filter = new ProjectTreeFilter();
+    m_filtertext = NULL;
     m_showtooltip = false;
     m_contextmenu = NULL;
     m_contextmenuenabled = true;
+    m_clipboard = NULL;
+    m_clipboardcut = false;
 
     InitializeUI();
     DoLayout();
@@ -69,8 +78,30 @@ ProjectTreeCtrl::~ProjectTreeCtrl()
  * \brief Destructor.
  **/
 {
+    // Verbindungen zu den Events des DirectoryWatchers loesen
+    CommandList* commands = Environment::Get()->GetCommandList();
+    CommandObject* object = new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnProjectItemAdded);
+    commands->GetCommand(penvCE_ProjectItemAdded)->Disconnect(object);
+    delete object;
+    object = new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnProjectItemRemoved);
+    commands->GetCommand(penvCE_ProjectItemRemoved)->Disconnect(object);
+    delete object;
+    object = new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnProjectItemRenamed);
+    commands->GetCommand(penvCE_ProjectItemRenamed)->Disconnect(object);
+    delete object;
+    object = new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnFilterFinished);
+    commands->GetCommand(penvCE_ProjectTreeFilterFinished)->Disconnect(object);
+    delete object;
+    delete m_filter;
+    ClearClipboardItems();
     if (m_apperance != NULL) delete m_apperance;
-    // TODO : Tree Item Data lschen
+    // Das wxTreeCtrl wird erst danach geloescht, OnTreeDeleteItem()
+    // darf den Index dann nicht mehr benutzen
+    delete m_treeitems;
+    m_treeitems = NULL;
+    // Die Tree Item Datas werden vom wxTreeCtrl gelscht, danach
+    // zerstrt sich der Pool selbst
+    if (m_pool != NULL) m_pool->Release();
 }
 
 
@@ -146,14 +177,14 @@ void ProjectTreeCtrl::ConnectEvents()
         wxTreeEventHandler( ProjectTreeCtrl::OnTreeEndLabelEdit ), NULL, this );
 	m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_ACTIVATED,
         wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemActivated ), NULL, this );
-	//m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_COLLAPSED,
-    //    wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemCollapsed ), NULL, this );
+	m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_COLLAPSED,
+        wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemCollapsed ), NULL, this );
 	//m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_COLLAPSING,
     //    wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemCollapsing ), NULL, this );
 	//m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_EXPANDED,
     //    wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemExpanded ), NULL, this );
-	//m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_EXPANDING,
-    //    wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemExpanding ), NULL, this );
+	m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_EXPANDING,
+        wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemExpanding ), NULL, this );
 	m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_GETTOOLTIP,
         wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemGetTooltip ), NULL, this );
 	m_treectrl->Connect( wxEVT_COMMAND_TREE_ITEM_RIGHT_CLICK,
@@ -162,6 +193,16 @@ void ProjectTreeCtrl::ConnectEvents()
         wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemMenu), NULL, this );
 	m_treectrl->Connect( wxEVT_COMMAND_TREE_KEY_DOWN,
         wxTreeEventHandler( ProjectTreeCtrl::OnTreeItemKeyDown ), NULL, this );
+    // Aenderungen des DirectoryWatchers direkt im Baum nachziehen
+    CommandList* commands = Environment::Get()->GetCommandList();
+    commands->GetCommand(penvCE_ProjectItemAdded)->
+        Connect(new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnProjectItemAdded));
+    commands->GetCommand(penvCE_ProjectItemRemoved)->
+        Connect(new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnProjectItemRemoved));
+    commands->GetCommand(penvCE_ProjectItemRenamed)->
+        Connect(new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnProjectItemRenamed));
+    commands->GetCommand(penvCE_ProjectTreeFilterFinished)->
+        Connect(new CommandCallback<ProjectTreeCtrl>(this, &ProjectTreeCtrl::OnFilterFinished));
 }
 
 
@@ -171,11 +212,14 @@ void ProjectTreeCtrl::UpdateComponents()
  * \brief Updates the UI components with information.
  **/
 {
-    m_justclear = true;
-    m_treectrl->DeleteAllItems();
-    m_justclear = false;
+    SetFilter(wxEmptyString);
+    ItemsChanged(true);
+    wxSortedArrayString expanded;
+    GetExpandedTreeItems(&expanded);
+    ClearTreeItems();
     m_treectrl->SetImageList(m_apperance->GetImageList());
     AddTreeItems(true);
+    ExpandTreeItems(expanded);
 }
 
 
@@ -247,7 +291,7 @@ void ProjectTreeCtrl::SetDefaultToolBarItems()
 /**
  * \brief Sets a default set of toolbar items for the
  * ProjectTreeCtrl. The default set is an ADD, DELETE,
- * REFRESH and SHOW ALL item.
+ * REFRESH and SHOW ALL item and the filter box.
  **/
 {
     if(m_toolbar == NULL)
@@ -256,11 +300,14 @@ void ProjectTreeCtrl::SetDefaultToolBarItems()
         return;
     }
     m_toolbar->ClearTools();
+    m_filtertext = NULL;
     AddToolBarItem(_T("ADD"), true);
     AddToolBarItem(_T("DELETE"), true);
     AddToolBarItem(wxEmptyString, true);
     AddToolBarItem(_T("REFRESH"), true);
     AddToolBarItem(_T("SHOWALL"), true);
+    AddToolBarItem(wxEmptyString, true);
+    AddToolBarItem(_T("FILTER"), true);
 
 
 }
@@ -272,7 +319,8 @@ bool ProjectTreeCtrl::AddToolBarItem(const wxString& commandid, bool defaultitem
  * \brief Adds an item to the toolbar.
  * There are two possible items for this toolbar, a command where defaultitem must be
  * false (this is default). The other possibility is to use an already definied
- * command, where there are 4 of them: 'ADD', 'REMOVE', 'REFRESH' and 'SHOWALL'.<br>
+ * command, where there are 5 of them: 'ADD', 'REMOVE', 'REFRESH', 'SHOWALL' and
+ * 'FILTER', which is a text box to filter the tree, see SetFilter().<br>
  * However, you can also add an separator, when giving an wxEmptyString as an commandid.
  * Here is a small example for adding an default item:<br>
  * <code>
@@ -338,6 +386,17 @@ bool ProjectTreeCtrl::AddToolBarItem(const wxString& commandid, bool defaultitem
                 wxCommandEventHandler(ProjectTreeCtrl::OnToolBarItemShowAllClicked),
                 NULL, this);
         }
+        else if(commandid == _T("FILTER"))
+        {
+            // TODO SO: Put Text in ProjectTreeCtrlApperance
+            m_filtertext = new wxTextCtrl(m_toolbar, m_eventids[4], m_filterquery,
+                wxDefaultPosition, wxSize(150, -1));
+            m_filtertext->SetToolTip(_("Shows only the items, which match the name or path."));
+            m_toolbar->AddControl(m_filtertext);
+            m_toolbar->Connect(m_eventids[4], wxEVT_COMMAND_TEXT_UPDATED,
+                wxCommandEventHandler(ProjectTreeCtrl::OnToolBarFilterChanged),
+                NULL, this);
+        }
         else
         {
             wxLogWarning(_T("[penv::ProjectTreeCtrl::AddToolBarItem] Unknown default item."));
@@ -373,6 +432,7 @@ void ProjectTreeCtrl::ClearToolBarItems()
     // TODO SO: Mssen die Events deregistriert werden??
     m_toolbar->ClearTools();
     m_toolbar->Realize();
+    m_filtertext = NULL;
 }
 
 
@@ -763,33 +823,16 @@ ProjectTreeItemId ProjectTreeCtrl::SearchItem(const wxString& windowid)
  * \brief Searches the tree control for a item which is connected
  * to a spezified window. If the item does not exists this method
  * will return a invalid ProjectTreeItemId (can be tested with IsOk()).
+ * The window and its project item are taken from the WindowList, so
+ * the search does not depend on the size of the tree. Tree items which
+ * are not added yet are added, see ShowItem().
  * \param windowid The item with the given windowid to search for.
  * \return Valid project tree item id if found; invalid if not found.
  **/
 {
-    wxArrayTreeItemIds* array = GetAllTreeItemIds();
-    for (size_t i=0; i<array->Count(); ++i)
-    {
-        wxTreeItemId id = (*array)[i];
-        if (id.IsOk())
-        {
-            ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
-            if (data != NULL)
-            {
-                if (data->GetType() == penvTI_ProjectItem && data->GetProjectItem() != NULL)
-                {
-                    wxString prjitemwinid = data->GetProjectItem()->GetWindowId();
-                    if (prjitemwinid == windowid)
-                    {
-                        delete array;
-                        return (ProjectTreeItemId(id));
-                    }
-                }
-            }
-        }
-    }
-    delete array;
-    return (ProjectTreeItemId());
+    Window* window = Environment::Get()->GetWindowList()->GetWindow(windowid);
+    if (window == NULL || window->GetProjectItem() == NULL) return (ProjectTreeItemId());
+    return (ShowItem(window->GetProjectItem()));
 }
 
 
@@ -803,25 +846,7 @@ ProjectTreeItemId ProjectTreeCtrl::SearchItem(const Workspace* workspace)
  * \return Valid project tree item id if found; invalid if not found.
  **/
 {
-    wxArrayTreeItemIds* array = GetAllTreeItemIds();
-    for (size_t i=0; i<array->Count(); ++i)
-    {
-        wxTreeItemId id = (*array)[i];
-        if (id.IsOk())
-        {
-            ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
-            if (data != NULL)
-            {
-                if (data->GetType() == penvTI_Workspace && data->GetWorkspace() == workspace)
-                {
-                    delete array;
-                    return (ProjectTreeItemId(id));
-                }
-            }
-        }
-    }
-    delete array;
-    return (ProjectTreeItemId());
+    return (SearchIndex(workspace, penvTI_Workspace));
 }
 
 //----------------------------------------------------------------
@@ -834,25 +859,7 @@ ProjectTreeItemId ProjectTreeCtrl::SearchItem(const Project* project)
  * \return Valid project tree item id if found; invalid if not found.
  **/
 {
-    wxArrayTreeItemIds* array = GetAllTreeItemIds();
-    for (size_t i=0; i<array->Count(); ++i)
-    {
-        wxTreeItemId id = (*array)[i];
-        if (id.IsOk())
-        {
-            ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
-            if (data != NULL)
-            {
-                if (data->GetType() == penvTI_Project && data->GetProject() == project)
-                {
-                    delete array;
-                    return (ProjectTreeItemId(id));
-                }
-            }
-        }
-    }
-    delete array;
-    return (ProjectTreeItemId());
+    return (SearchIndex(project, penvTI_Project));
 }
 
 
@@ -867,25 +874,779 @@ ProjectTreeItemId ProjectTreeCtrl::SearchItem(const ProjectItem* item)
  * \return Valid project tree item id if found; invalid if not found.
  **/
 {
-    wxArrayTreeItemIds* array = GetAllTreeItemIds();
-    for (size_t i=0; i<array->Count(); ++i)
+    return (SearchIndex(item, penvTI_ProjectItem));
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeItemId ProjectTreeCtrl::SearchIndex(const PenvItem* item, ProjectTreeItemType type)
+/**
+ * \brief Searches the index for the tree item of a workspace,
+ * project or project item.
+ * \param item The workspace, project or project item.
+ * \param type The expected type of the tree item.
+ * \return Valid project tree item id if found; invalid if not found.
+ **/
+{
+    if (unlikely(item == NULL || m_treeitems == NULL)) return (ProjectTreeItemId());
+    TreeItemIdHashMap::iterator itr = m_treeitems->find(item);
+    if (itr == m_treeitems->end()) return (ProjectTreeItemId());
+    // Ein Unterprojekt ist Projekt und Projektelement zugleich, nur
+    // der passende Typ wird gefunden
+    ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(itr->second);
+    if (unlikely(data == NULL || data->GetType() != type)) return (ProjectTreeItemId());
+    return (ProjectTreeItemId(itr->second));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::IndexTreeItem(wxTreeItemId id)
+/**
+ * \brief Stores a tree item in the index of SearchItem(). Must be
+ * called for every tree item, which is added to the tree control.
+ * The tree item is removed from the index, when it is deleted.
+ * \param id The added tree item, with a ProjectTreeItemData.
+ **/
+{
+    ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
+    if (unlikely(data == NULL || data->GetPenvItem() == NULL)) return;
+    (*m_treeitems)[data->GetPenvItem()] = id;
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::ClearTreeItems()
+/**
+ * \brief Deletes all tree items and clears the index, without
+ * executing the behavior of OnTreeDeleteItem().
+ **/
+{
+    m_treeitems->clear();
+    m_justclear = true;
+    m_treectrl->DeleteAllItems();
+    m_justclear = false;
+}
+
+
+//----------------------------------------------------------------
+bool ProjectTreeCtrl::LoadTreeItem(wxTreeItemId id)
+/**
+ * \brief Adds the tree items below a project or project item, if
+ * they are not added yet. See AddChildItems().
+ * \param id Tree item id of the project or project item.
+ * \return True if the tree item has child items; false otherwise.
+ **/
+{
+    if (m_treectrl->GetChildrenCount(id, false) > 0) return (true);
+    ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
+    if (data == NULL) return (false);
+    ProjectItemList* list = NULL;
+    if (data->GetType() == penvTI_Project) {
+        list = data->GetProject()->GetProjectItemList();
+    } else if (data->GetType() == penvTI_ProjectItem) {
+        list = data->GetProjectItem()->GetItemList();
+    }
+    if (list != NULL) AddProjectItemList(id, list, false);
+    bool haschildren = m_treectrl->GetChildrenCount(id, false) > 0;
+    m_treectrl->SetItemHasChildren(id, haschildren);
+    return (haschildren);
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeItemId ProjectTreeCtrl::ShowItem(ProjectItem* item)
+/**
+ * \brief Searches the tree item of a project item like SearchItem(),
+ * but adds the tree items of the parents, if they are not added yet.
+ * The parents are not expanded.
+ * \param item The project item.
+ * \return Valid project tree item id if found; invalid if not found.
+ **/
+{
+    ProjectTreeItemId id = SearchItem(item);
+    if (id.IsOk() || item == NULL || item->GetParent() == NULL) return (id);
+    ProjectItemList* list = item->GetParent();
+    ProjectTreeItemId parentid;
+    if (list->GetProjectItemParent() != NULL) {
+        parentid = ShowItem(list->GetProjectItemParent());
+    } else {
+        parentid = SearchItem(list->GetProjectParent());
+    }
+    if (!parentid.IsOk()) return (ProjectTreeItemId());
+    LoadTreeItem(parentid.GetId());
+    return (SearchItem(item));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::SetFilter(const wxString& filter)
+/**
+ * \brief Filters the tree by the name or path of the items. The search
+ * runs on the thread of the ProjectTreeFilter, the tree shows the best
+ * matches and their parents, when the search is finished. Every call
+ * cancels the previous search. An empty filter shows the whole tree
+ * again with the tree items, which were expanded before the filter.
+ * \param filter The text to search for.
+ **/
+{
+    wxString query = filter;
+    query.Trim(true).Trim(false);
+    if (m_filtertext != NULL && m_filtertext->GetValue() != filter)
+    {
+        m_filtertext->ChangeValue(filter);
+    }
+    if (query.IsEmpty())
+    {
+        m_filter->Cancel();
+        if (m_filterquery.IsEmpty()) return;
+        m_filterquery = wxEmptyString;
+        m_treectrl->Freeze();
+        ClearTreeItems();
+        AddTreeItems(true);
+        ExpandTreeItems(m_filterexpanded);
+        m_treectrl->Thaw();
+        m_filterexpanded.Clear();
+        return;
+    }
+    if (m_filterquery.IsEmpty())
+    {
+        // Beim Start des Filters wird der Index neu aufgebaut
+        GetExpandedTreeItems(&m_filterexpanded);
+        m_filter->Build(Environment::Get()->GetWorkspaceList());
+    }
+    else if (!m_filter->IsValid())
+    {
+        m_filter->Build(Environment::Get()->GetWorkspaceList());
+    }
+    m_filterquery = query;
+    m_filter->Search(query);
+}
+
+
+//----------------------------------------------------------------
+const wxString& ProjectTreeCtrl::GetFilter() const
+/**
+ * \brief Returns the current filter of the tree.
+ * \return The filter or an empty string if the tree is not filtered.
+ **/
+{
+    return (m_filterquery);
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectTreeCtrl::GetSelectedItems(ProjectTreeItemDataObject* items)
+/**
+ * \brief Adds the workspaces, projects and project items of the
+ * selected tree items to a data object.
+ * \param items The data object.
+ * \return Number of added items.
+ **/
+{
+    wxArrayTreeItemIds ids;
+    if (penvPROJECTTREECTRL_SELECTIONMODE == wxTR_SINGLE) {
+        wxTreeItemId id = m_treectrl->GetSelection();
+        if (id.IsOk()) ids.Add(id);
+    } else {
+        m_treectrl->GetSelections(ids);
+    }
+    size_t count = 0;
+    for (size_t i=0; i<ids.Count(); ++i)
     {
-        wxTreeItemId id = (*array)[i];
-        if (id.IsOk())
+        if (ids[i] == m_rootid) continue;
+        ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(ids[i]);
+        if (data == NULL || data->GetPenvItem() == NULL) continue;
+        if (data->GetType() == penvTI_Workspace) {
+            items->Add(new ProjectTreeItemDataBase(data->GetWorkspace()));
+        } else if (data->GetType() == penvTI_Project) {
+            items->Add(new ProjectTreeItemDataBase(data->GetProject()));
+        } else {
+            items->Add(new ProjectTreeItemDataBase(data->GetProjectItem()));
+        }
+        count++;
+    }
+    return (count);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::ItemsChanged(bool removed)
+/**
+ * \brief Is called after workspaces, projects or project items were
+ * added, moved or removed. The index of the filter must be rebuilt. If
+ * items were removed, the items in the clipboard can not be pasted
+ * anymore, because they may be deleted.
+ * \param removed True if items were removed.
+ **/
+{
+    m_filter->Invalidate();
+    if (removed) ClearClipboardItems();
+}
+
+
+//----------------------------------------------------------------
+wxTreeItemId ProjectTreeCtrl::GetSelectedTreeItem()
+/**
+ * \brief Returns the selected tree item. If more than one tree item
+ * is selected, the first one is returned.
+ * \return The tree item or an invalid id if nothing is selected.
+ **/
+{
+    if (penvPROJECTTREECTRL_SELECTIONMODE == wxTR_SINGLE) {
+        return (m_treectrl->GetSelection());
+    }
+    wxArrayTreeItemIds ids;
+    if (m_treectrl->GetSelections(ids) == 0) return (wxTreeItemId());
+    return (ids[0]);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::RemoveSelectedItems()
+/**
+ * \brief Asks the user and removes the selected items with the
+ * action handler. Files are not deleted from disk.
+ **/
+{
+    ProjectTreeItemDataObject items;
+    if (GetSelectedItems(&items) == 0) return;
+    wxString message = _("Do you want to remove the selected item?");
+    if (items.Count() > 1) {
+        message = wxString::Format(_("Do you want to remove the %u selected items?"),
+            (unsigned int)items.Count());
+    }
+    int result = wxMessageBox(message, _("Question"), wxYES_NO | wxICON_QUESTION,
+        Environment::Get()->GetFrame());
+    if (result != wxYES) return;
+    bool cancel = false;
+    m_actionhandler->OnRemove(cancel, &items);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::CopySelectedItems(bool cut)
+/**
+ * \brief Puts the selected items into the clipboard. The items are
+ * moved or copied, when they are pasted. Workspaces can not be cut or
+ * copied and are skipped.
+ * \param cut True if the items should be moved on paste.
+ **/
+{
+    ProjectTreeItemDataObject selection;
+    GetSelectedItems(&selection);
+    ProjectTreeItemDataObject* items = new ProjectTreeItemDataObject();
+    for (size_t i=0; i<selection.Count(); ++i)
+    {
+        if (selection.GetItem(i)->GetType() == penvTI_Workspace) continue;
+        items->Add(selection.GetItem(i)->Clone());
+    }
+    if (items->Count() == 0)
+    {
+        delete items;
+        return;
+    }
+    if (!wxTheClipboard->Open())
+    {
+        wxLogError(_T("[penv::ProjectTreeCtrl::CopySelectedItems] Could not open the clipboard."));
+        delete items;
+        return;
+    }
+    ClearClipboardItems();
+    m_clipboard = (ProjectTreeItemDataObject*)items->Clone();
+    m_clipboardcut = cut;
+    // Die Zwischenablage uebernimmt das Objekt
+    wxTheClipboard->SetData(items);
+    wxTheClipboard->Close();
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::PasteItems()
+/**
+ * \brief Moves or copies the items of the clipboard to the selected
+ * tree item. The items are only pasted, if the clipboard still contains
+ * the items, which were cut or copied in this tree. Cut items can only
+ * be pasted once.
+ **/
+{
+    if (m_clipboard == NULL) return;
+    wxTreeItemId id = GetSelectedTreeItem();
+    if (!id.IsOk()) return;
+    ProjectTreeItemData* target = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
+    if (target == NULL) return;
+    ProjectTreeItemDataObject items;
+    bool valid = false;
+    if (wxTheClipboard->Open())
+    {
+        if (wxTheClipboard->IsSupported(wxDataFormat(penvProjectTreeItemDataFormat))) {
+            valid = wxTheClipboard->GetData(items);
+        }
+        wxTheClipboard->Close();
+    }
+    // Die Zeiger sind nur gueltig, wenn die Zwischenablage noch die
+    // Elemente enthaelt, die hier kopiert wurden
+    if (valid) valid = (items.Count() == m_clipboard->Count());
+    for (size_t i=0; valid && i<items.Count(); ++i)
+    {
+        valid = (items.GetItem(i)->GetType() == m_clipboard->GetItem(i)->GetType() &&
+            items.GetItem(i)->GetPenvItem() == m_clipboard->GetItem(i)->GetPenvItem());
+    }
+    if (!valid)
+    {
+        ClearClipboardItems();
+        return;
+    }
+    bool cancel = false;
+    if (m_clipboardcut)
+    {
+        m_actionhandler->OnMove(cancel, m_clipboard, target);
+        if (!cancel) ClearClipboardItems();
+    }
+    else
+    {
+        m_actionhandler->OnCopy(cancel, m_clipboard, target);
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::ClearClipboardItems()
+/**
+ * \brief Forgets the items, which were cut or copied. The clipboard
+ * itself is not changed, but its items can not be pasted anymore.
+ **/
+{
+    if (m_clipboard != NULL) delete m_clipboard;
+    m_clipboard = NULL;
+    m_clipboardcut = false;
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::ShowFilterResults(const wxArrayInt& results)
+/**
+ * \brief Shows only the results of the filter and their parents in
+ * the tree. The parents of the results are expanded.
+ * \param results Indexes of the entries of the ProjectTreeFilter.
+ **/
+{
+    m_treectrl->Freeze();
+    ClearTreeItems();
+    m_rootid = m_treectrl->AddRoot(_T("Workspaces"), -1, -1, NULL);
+    wxTreeItemId first;
+    for (size_t i=0; i<results.Count(); ++i)
+    {
+        wxTreeItemId id = ShowFilterEntry(results[i]);
+        if (!id.IsOk()) continue;
+        if (!first.IsOk()) first = id;
+        wxTreeItemId parentid = m_treectrl->GetItemParent(id);
+        while (parentid.IsOk() && parentid != m_rootid)
         {
-            ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
-            if (data != NULL)
-            {
-                if (data->GetType() == penvTI_ProjectItem && data->GetProjectItem() == item)
-                {
-                    delete array;
-                    return (ProjectTreeItemId(id));
-                }
-            }
+            if (m_treectrl->IsExpanded(parentid)) break;
+            m_treectrl->Expand(parentid);
+            parentid = m_treectrl->GetItemParent(parentid);
         }
     }
-    delete array;
-    return (ProjectTreeItemId());
+    if (first.IsOk()) m_treectrl->EnsureVisible(first);
+    m_treectrl->Thaw();
+}
+
+
+//----------------------------------------------------------------
+wxTreeItemId ProjectTreeCtrl::ShowFilterEntry(size_t index)
+/**
+ * \brief Adds the tree item of an entry of the ProjectTreeFilter and
+ * the tree items of its parents, if they are not added yet.
+ * \param index Index of the entry.
+ * \return The tree item id or an invalid id, if the entry is not valid.
+ **/
+{
+    int parent = -1;
+    ProjectTreeItemDataBase* data = m_filter->GetEntry(index, &parent);
+    if (unlikely(data == NULL)) return (wxTreeItemId());
+    wxTreeItemId id = SearchIndex(data->GetPenvItem(), data->GetType()).GetId();
+    if (id.IsOk()) return (id);
+    wxTreeItemId parentid = m_rootid;
+    if (parent >= 0) parentid = ShowFilterEntry((size_t)parent);
+    if (!parentid.IsOk()) return (wxTreeItemId());
+    if (data->GetType() == penvTI_Workspace)
+    {
+        id = AddWorkspace(data->GetWorkspace());
+    }
+    else if (data->GetType() == penvTI_Project)
+    {
+        id = AddProject(parentid, data->GetProject());
+        AddChildItems(id, data->GetProject()->GetProjectItemList(), false);
+    }
+    else
+    {
+        id = AddProjectItem(parentid, data->GetProjectItem(), false);
+    }
+    return (id);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::GetExpandedTreeItems(wxSortedArrayString* paths)
+/**
+ * \brief Returns the paths of all expanded tree items, to expand
+ * them again after a refresh with ExpandTreeItems(). The path of a
+ * tree item consists of the texts of the tree items above.
+ * \param paths Array for the paths of the expanded tree items.
+ **/
+{
+    wxTreeItemId rootid = m_treectrl->GetRootItem();
+    if (rootid.IsOk()) GetExpandedTreeItems(paths, rootid, wxEmptyString);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::GetExpandedTreeItems(wxSortedArrayString* paths,
+    wxTreeItemId id, const wxString& path)
+/**
+ * \brief Recursiv function for GetExpandedTreeItems(). Only the
+ * expanded tree items are visited.
+ * \param paths Array for the paths of the expanded tree items.
+ * \param id Id of the parent tree item.
+ * \param path Path of the parent tree item.
+ **/
+{
+    wxTreeItemIdValue cookie;
+    wxTreeItemId treeitemid = m_treectrl->GetFirstChild(id, cookie);
+    while (treeitemid.IsOk())
+    {
+        if (m_treectrl->IsExpanded(treeitemid))
+        {
+            wxString itempath = path + _T("\n") + m_treectrl->GetItemText(treeitemid);
+            paths->Add(itempath);
+            GetExpandedTreeItems(paths, treeitemid, itempath);
+        }
+        treeitemid = m_treectrl->GetNextChild(id, cookie);
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::ExpandTreeItems(const wxSortedArrayString& paths)
+/**
+ * \brief Expands the tree items, which were expanded before the
+ * refresh. See GetExpandedTreeItems().
+ * \param paths The paths of the expanded tree items.
+ **/
+{
+    wxTreeItemId rootid = m_treectrl->GetRootItem();
+    if (rootid.IsOk() && paths.Count() > 0) ExpandTreeItems(paths, rootid, wxEmptyString);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::ExpandTreeItems(const wxSortedArrayString& paths,
+    wxTreeItemId id, const wxString& path)
+/**
+ * \brief Recursiv function for ExpandTreeItems().
+ * \param paths The paths of the expanded tree items.
+ * \param id Id of the parent tree item.
+ * \param path Path of the parent tree item.
+ **/
+{
+    wxTreeItemIdValue cookie;
+    wxTreeItemId treeitemid = m_treectrl->GetFirstChild(id, cookie);
+    while (treeitemid.IsOk())
+    {
+        wxString itempath = path + _T("\n") + m_treectrl->GetItemText(treeitemid);
+        if (paths.Index(itempath) != wxNOT_FOUND)
+        {
+            // Erst die Elemente erzeugen, dann aufklappen
+            if (LoadTreeItem(treeitemid)) m_treectrl->Expand(treeitemid);
+            ExpandTreeItems(paths, treeitemid, itempath);
+        }
+        treeitemid = m_treectrl->GetNextChild(id, cookie);
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::GetTreeItemKeys(TreeItemKeyHashMap* keys, wxTreeItemId id)
+/**
+ * \brief Stores the keys of all tree items below the given tree item,
+ * which are needed by SyncTreeItems(). Must be called before the
+ * workspaces are reloaded, while the tree item datas are valid.
+ * \param keys Hash map for the keys of the tree items.
+ * \param id Id of the parent tree item.
+ **/
+{
+    wxTreeItemIdValue cookie;
+    wxTreeItemId treeitemid = m_treectrl->GetFirstChild(id, cookie);
+    while (treeitemid.IsOk())
+    {
+        ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(treeitemid);
+        if (data != NULL) (*keys)[treeitemid.GetID()] = GetTreeItemKey(data);
+        GetTreeItemKeys(keys, treeitemid);
+        treeitemid = m_treectrl->GetNextChild(id, cookie);
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::SyncTreeItems(wxTreeItemId id, ProjectTreeItemDataBase* parent,
+    const TreeItemKeyHashMap& keys)
+/**
+ * \brief Compares the child tree items of a tree item with the child
+ * items of its workspace, project or project item and applies only the
+ * differences. A tree item and an item are equal, if their keys (type
+ * and path or name) are equal. Equal tree items are kept with their
+ * expanded state and selection, only their data and text is updated.
+ * Tree items without an item are deleted, new items are inserted and
+ * moved items are inserted again at the new position.<br>
+ * The tree items below are compared recursively, if they are created.
+ * \param id Id of the tree item.
+ * \param parent The item of the tree item or NULL for the root item.
+ * \param keys The keys of the tree items, see GetTreeItemKeys().
+ **/
+{
+    Array<ProjectTreeItemDataBase> items(true);
+    GetChildItems(parent, &items);
+    KeyHashMap treeitems;
+    KeyHashMap itemkeys;
+    wxArrayString itemkeyarray;
+    for (size_t i=0; i<items.Count(); ++i)
+    {
+        wxString key = GetTreeItemKey(items.ItemUnchecked(i));
+        itemkeys[key] = wxTreeItemId();
+        itemkeyarray.Add(key);
+    }
+    // Baumelemente ohne Element loeschen, die uebrigen nach dem
+    // Schluessel merken
+    wxArrayTreeItemIds deleted;
+    wxTreeItemIdValue cookie;
+    wxTreeItemId treeitemid = m_treectrl->GetFirstChild(id, cookie);
+    while (treeitemid.IsOk())
+    {
+        TreeItemKeyHashMap::const_iterator itr = keys.find(treeitemid.GetID());
+        if (itr == keys.end() || itemkeys.find(itr->second) == itemkeys.end() ||
+            treeitems.find(itr->second) != treeitems.end())
+        {
+            deleted.Add(treeitemid);
+        }
+        else
+        {
+            treeitems[itr->second] = treeitemid;
+        }
+        treeitemid = m_treectrl->GetNextChild(id, cookie);
+    }
+    m_justclear = true;
+    for (size_t i=0; i<deleted.Count(); ++i) m_treectrl->Delete(deleted[i]);
+    m_justclear = false;
+    // Elemente in der Reihenfolge des Modells durchgehen
+    wxTreeItemId previous;
+    for (size_t i=0; i<items.Count(); ++i)
+    {
+        ProjectTreeItemDataBase* item = items.ItemUnchecked(i);
+        KeyHashMap::iterator itr = treeitems.find(itemkeyarray[i]);
+        if (itr == treeitems.end())
+        {
+            previous = InsertTreeItem(id, previous, item);
+            continue;
+        }
+        treeitemid = itr->second;
+        treeitems.erase(itr);
+        wxTreeItemId expected;
+        if (previous.IsOk()) {
+            expected = m_treectrl->GetNextSibling(previous);
+        } else {
+            expected = m_treectrl->GetFirstChild(id, cookie);
+        }
+        if (treeitemid != expected)
+        {
+            // Verschoben, an der neuen Position neu einfuegen
+            bool loaded = m_treectrl->GetChildrenCount(treeitemid, false) > 0;
+            bool expanded = m_treectrl->IsExpanded(treeitemid);
+            m_justclear = true;
+            m_treectrl->Delete(treeitemid);
+            m_justclear = false;
+            previous = InsertTreeItem(id, previous, item);
+            if (!previous.IsOk() || !loaded) continue;
+            if (LoadTreeItem(previous) && expanded) m_treectrl->Expand(previous);
+            continue;
+        }
+        // Gleiches Element, Daten und Text aktualisieren
+        ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(treeitemid);
+        if (item->GetType() == penvTI_Workspace) {
+            data->SetWorkspace(item->GetWorkspace());
+            item->GetWorkspace()->SetTreeItemId(treeitemid);
+        } else if (item->GetType() == penvTI_Project) {
+            data->SetProject(item->GetProject());
+            item->GetProject()->SetTreeItemId(treeitemid);
+        } else if (item->GetProjectItem()->GetType() == penvPI_SubProject) {
+            data->SetProjectItem(item->GetProjectItem());
+            ((Project*)(ProjectItemSubProject*)item->GetProjectItem())->SetTreeItemId(treeitemid);
+        } else {
+            data->SetProjectItem(item->GetProjectItem());
+            item->GetProjectItem()->SetTreeItemId(treeitemid);
+        }
+        IndexTreeItem(treeitemid);
+        wxString text = GetTreeItemText(item);
+        if (m_treectrl->GetItemText(treeitemid) != text) m_treectrl->SetItemText(treeitemid, text);
+        if (item->GetType() == penvTI_Workspace || m_treectrl->GetChildrenCount(treeitemid, false) > 0) {
+            SyncTreeItems(treeitemid, item, keys);
+        } else if (item->GetType() == penvTI_Project) {
+            AddChildItems(treeitemid, item->GetProject()->GetProjectItemList(), false);
+        } else {
+            AddChildItems(treeitemid, item->GetProjectItem()->GetItemList(), false);
+        }
+        previous = treeitemid;
+    }
+}
+
+
+//----------------------------------------------------------------
+wxString ProjectTreeCtrl::GetTreeItemKey(ProjectTreeItemDataBase* data)
+/**
+ * \brief Returns the key of a workspace, project or project item for
+ * SyncTreeItems(). The key consists of the type and the path of the
+ * item, or the name if the item has no path.
+ * \param data The item.
+ * \return The key.
+ **/
+{
+    wxString path;
+    wxString key;
+    if (data->GetType() == penvTI_Workspace) {
+        key = _T("w");
+        path = data->GetWorkspace()->GetFileNameString();
+    } else if (data->GetType() == penvTI_Project) {
+        key = _T("p");
+        path = data->GetProject()->GetFileNameString();
+    } else {
+        key = wxString::Format(_T("i%i"), (int)data->GetProjectItem()->GetType());
+        path = data->GetProjectItem()->GetPathString();
+    }
+    key << _T("\n") << path;
+    if (path.IsEmpty()) key << _T("\n") << GetTreeItemText(data);
+    return (key);
+}
+
+
+//----------------------------------------------------------------
+wxString ProjectTreeCtrl::GetTreeItemText(ProjectTreeItemDataBase* data)
+/**
+ * \brief Returns the text of the tree item for a workspace, project
+ * or project item, like the Add methods.
+ * \param data The item.
+ * \return The text of the tree item.
+ **/
+{
+    if (data->GetType() == penvTI_Workspace) return (data->GetWorkspace()->GetName());
+    if (data->GetType() == penvTI_Project) return (data->GetProject()->GetName());
+    ProjectItem* item = data->GetProjectItem();
+    if (item->GetType() == penvPI_SubProject) return (((Project*)(ProjectItemSubProject*)item)->GetName());
+    return (item->GetName());
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::GetChildItems(ProjectTreeItemDataBase* data, Array<ProjectTreeItemDataBase>* items)
+/**
+ * \brief Returns the child items of a workspace, project or project
+ * item, which are shown as child tree items.
+ * \param data The item or NULL for the workspaces of the root item.
+ * \param items Array for the child items.
+ **/
+{
+    if (data == NULL)
+    {
+        WorkspaceList* list = Environment::Get()->GetWorkspaceList();
+        for (size_t i=0; i<list->Count(); ++i)
+        {
+            if (list->GetItem(i) != NULL) items->Add(new ProjectTreeItemDataBase(list->GetItem(i)));
+        }
+        return;
+    }
+    if (data->GetType() == penvTI_Workspace)
+    {
+        ProjectList* list = data->GetWorkspace()->GetProjectList();
+        for (size_t i=0; i<list->Count(); ++i)
+        {
+            if (list->GetItem(i) != NULL) items->Add(new ProjectTreeItemDataBase(list->GetItem(i)));
+        }
+        return;
+    }
+    ProjectItemList* list = NULL;
+    if (data->GetType() == penvTI_Project) {
+        list = data->GetProject()->GetProjectItemList();
+    } else {
+        list = data->GetProjectItem()->GetItemList();
+    }
+    if (list == NULL) return;
+    items->Reserve(list->Count());
+    for (size_t i=0; i<list->Count(); ++i)
+    {
+        if (list->GetItem(i) != NULL) items->Add(new ProjectTreeItemDataBase(list->GetItem(i)));
+    }
+}
+
+
+//----------------------------------------------------------------
+wxTreeItemId ProjectTreeCtrl::InsertTreeItem(wxTreeItemId id, wxTreeItemId previous,
+    ProjectTreeItemDataBase* data)
+/**
+ * \brief Inserts the tree item of a workspace, project or project
+ * item with the Add methods after the given tree item.
+ * \param id Id of the parent tree item.
+ * \param previous The tree item before the new tree item or an
+ * invalid id to insert the tree item as the first child.
+ * \param data The item.
+ * \return The new tree item id.
+ **/
+{
+    m_insert = true;
+    m_insertafter = previous;
+    wxTreeItemId treeitemid;
+    if (data->GetType() == penvTI_Workspace)
+    {
+        Workspace* workspace = data->GetWorkspace();
+        treeitemid = AddWorkspace(workspace);
+        for (size_t j=0; j<workspace->GetProjectList()->Count(); ++j)
+        {
+            Project* project = workspace->GetProjectList()->GetItem(j);
+            if (project == NULL) continue;
+            wxTreeItemId prjid = AddProject(treeitemid, project);
+            AddChildItems(prjid, project->GetProjectItemList(), false);
+        }
+    }
+    else if (data->GetType() == penvTI_Project)
+    {
+        treeitemid = AddProject(id, data->GetProject());
+        AddChildItems(treeitemid, data->GetProject()->GetProjectItemList(), false);
+    }
+    else
+    {
+        treeitemid = AddProjectItem(id, data->GetProjectItem(), false);
+    }
+    m_insert = false;
+    return (treeitemid);
+}
+
+
+//----------------------------------------------------------------
+wxTreeItemId ProjectTreeCtrl::AppendTreeItem(wxTreeItemId parent, const wxString& text,
+    int image, int selimage, ProjectTreeItemData* data)
+/**
+ * \brief Appends a tree item, used by all Add methods. During
+ * InsertTreeItem() the first added tree item is inserted after the
+ * given tree item instead, the tree items below are appended.
+ * \param parent Id of the parent tree item.
+ * \param text Text of the tree item.
+ * \param image Image index of the tree item.
+ * \param selimage Image index of the selected tree item.
+ * \param data Data of the tree item.
+ * \return The new tree item id.
+ **/
+{
+    if (likely(!m_insert)) return (m_treectrl->AppendItem(parent, text, image, selimage, data));
+    m_insert = false;
+    if (!m_insertafter.IsOk()) return (m_treectrl->InsertItem(parent, (size_t)0, text, image, selimage, data));
+    return (m_treectrl->InsertItem(parent, m_insertafter, text, image, selimage, data));
 }
 
 
@@ -946,9 +1707,10 @@ void ProjectTreeCtrl::GetAllTreeItemIds(wxArrayTreeItemIds* ids,
 //----------------------------------------------------------------
 void ProjectTreeCtrl::AddTreeItems(bool projectitems)
 /**
- * \brief Adds everything recursivly. Exept projectitems is false, then
- * only workspaces and projects will be added.
- * \param projectitems True if all tree items should be filled.
+ * \brief Adds all workspaces and projects. The project items are added,
+ * when the project is expanded. If projectitems is false, then only
+ * workspaces and projects will be added.
+ * \param projectitems True if the project items should be shown.
  **/
 {
     m_rootid = m_treectrl->AddRoot(_T("Workspaces"), -1, -1, NULL);
@@ -971,7 +1733,7 @@ void ProjectTreeCtrl::AddTreeItems(bool projectitems)
                 continue;
             }
             wxTreeItemId prjid = AddProject(wsid, project);
-            if (projectitems) AddProjectItemList(prjid, project->GetProjectItemList(), true);
+            if (projectitems) AddChildItems(prjid, project->GetProjectItemList(), false);
         }
     }
 }
@@ -987,9 +1749,10 @@ wxTreeItemId ProjectTreeCtrl::AddWorkspace(Workspace* workspace)
  **/
 {
     int imageindex = m_apperance->GetImageIndexWorkspace();
-    wxTreeItemId id = m_treectrl->AppendItem(m_rootid,
-        workspace->GetName(), imageindex, -1, new ProjectTreeItemData(workspace));
+    wxTreeItemId id = AppendTreeItem(m_rootid,
+        workspace->GetName(), imageindex, -1, new (m_pool) ProjectTreeItemData(workspace));
     workspace->SetTreeItemId(id);
+    IndexTreeItem(id);
     return (id);
 }
 
@@ -1006,9 +1769,10 @@ wxTreeItemId ProjectTreeCtrl::AddProject(wxTreeItemId workspaceid, Project* proj
  **/
 {
     int imageindex = m_apperance->GetImageIndexProject();
-    wxTreeItemId id = m_treectrl->AppendItem(workspaceid,
-        project->GetName(), imageindex, -1, new ProjectTreeItemData(project));
+    wxTreeItemId id = AppendTreeItem(workspaceid,
+        project->GetName(), imageindex, -1, new (m_pool) ProjectTreeItemData(project));
     project->SetTreeItemId(id);
+    IndexTreeItem(id);
     return (id);
 }
 
@@ -1040,33 +1804,64 @@ void ProjectTreeCtrl::AddProjectItemList(wxTreeItemId id, ProjectItemList* list,
             wxLogWarning(_T("[penv::ProjectTreeCtrl::AddProjectItemList] ProjectItem is NULL."));
             continue;
         }
-        ProjectItemList* itemlist = NULL;
-        wxTreeItemId itemid;
-        if (item->GetType() == penvPI_File) {
-            itemid = AddFile(id, (ProjectItemFile*)item);
-        }
-        else if (item->GetType() == penvPI_Directory) {
-            itemid = AddDirectory(id, (ProjectItemDirectory*)item, recursiv);
-            itemlist = item->GetItemList();
-        }
-        else if (item->GetType() == penvPI_LinkedItems) {
-            itemid = AddLinkedItems(id,  (ProjectItemLinkedItems*)item);
-            // LinkedItems werden sowieso alle rekursiv eingefgt
-        }
-        else if (item->GetType() == penvPI_SubProject) {
-            itemid = AddSubProject(id,  (ProjectItemSubProject*)item, recursiv);
-            itemlist = item->GetItemList();
-        }
-        else
-        {
-            wxLogWarning(_T("[penv::ProjectTreeCtrl::AddProjectItemList] Unknown item type."));
-            continue;
-        }
+        AddProjectItem(id, item, recursiv);
+    }
+}
+
+
+//----------------------------------------------------------------
+wxTreeItemId ProjectTreeCtrl::AddProjectItem(wxTreeItemId id, ProjectItem* item, bool recursiv)
+/**
+ * \brief Adds a project item to the given tree node, with the Add
+ * method for its type.
+ * \param id Parent id of the project item.
+ * \param item The project item which should be added.
+ * \param recursiv True if all project items below should be added.
+ * \return Returns the newly added project tree item ID or an invalid
+ * ID, if the type of the project item is unknown.
+ **/
+{
+    if (item->GetType() == penvPI_File) {
+        return (AddFile(id, (ProjectItemFile*)item));
     }
+    else if (item->GetType() == penvPI_Directory) {
+        return (AddDirectory(id, (ProjectItemDirectory*)item, recursiv));
+    }
+    else if (item->GetType() == penvPI_LinkedItems) {
+        // LinkedItems werden sowieso alle rekursiv eingefgt
+        return (AddLinkedItems(id,  (ProjectItemLinkedItems*)item));
+    }
+    else if (item->GetType() == penvPI_SubProject) {
+        return (AddSubProject(id,  (ProjectItemSubProject*)item, recursiv));
+    }
+    wxLogWarning(_T("[penv::ProjectTreeCtrl::AddProjectItem] Unknown item type."));
+    return (wxTreeItemId());
 }
 
 
 
+//----------------------------------------------------------------
+void ProjectTreeCtrl::AddChildItems(wxTreeItemId id, ProjectItemList* list, bool recursiv)
+/**
+ * \brief Adds the project items of a project or project item below
+ * its tree item. If recursiv is false, the tree item only gets an
+ * expand button and the project items are added by LoadTreeItem(),
+ * when the tree item is expanded.
+ * \param id Tree item id of the project or project item.
+ * \param list ProjectItemList of the project or project item.
+ * \param recursiv True to add every item recursiv now.
+ **/
+{
+    if (list == NULL) return;
+    if (recursiv) {
+        AddProjectItemList(id, list, true);
+    } else {
+        // Eine noch nicht gelesene Liste wird hier nicht gelesen
+        m_treectrl->SetItemHasChildren(id, list->IsDeferred() || list->Count() > 0);
+    }
+}
+
+
 //----------------------------------------------------------------
 wxTreeItemId ProjectTreeCtrl::AddFile(wxTreeItemId id, ProjectItemFile* file)
 /**
@@ -1078,9 +1873,10 @@ wxTreeItemId ProjectTreeCtrl::AddFile(wxTreeItemId id, ProjectItemFile* file)
  **/
 {
     int imageindex = m_apperance->GetImageIndexFile();
-    wxTreeItemId fileid = m_treectrl->AppendItem(id,
-        file->GetName(), imageindex, -1, new ProjectTreeItemData(file));
+    wxTreeItemId fileid = AppendTreeItem(id,
+        file->GetName(), imageindex, -1, new (m_pool) ProjectTreeItemData(file));
     file->SetTreeItemId(fileid);
+    IndexTreeItem(fileid);
     return (fileid);
 }
 
@@ -1091,16 +1887,18 @@ wxTreeItemId ProjectTreeCtrl::AddDirectory(wxTreeItemId id, ProjectItemDirectory
  * a check if file is NULL will not be done.
  * \param id Parent id of the project item.
  * \param file The project item which should be added.
- * \param recursiv True if all project items should be recursively added.
+ * \param recursiv True if all project items should be recursively added;
+ * false if they are added when the directory is expanded.
  * \return Returns the newly added project tree item ID.
  **/
 {
     int imageindex = m_apperance->GetImageIndexDirectory();
-    wxTreeItemId dirid = m_treectrl->AppendItem(id,
-        directory->GetName(), imageindex, -1, new ProjectTreeItemData(directory));
+    wxTreeItemId dirid = AppendTreeItem(id,
+        directory->GetName(), imageindex, -1, new (m_pool) ProjectTreeItemData(directory));
     directory->SetTreeItemId(dirid);
+    IndexTreeItem(dirid);
     // Alle Element eine Ebene darunter einfgen
-    AddProjectItemList(dirid, directory->GetItemList(), recursiv);
+    AddChildItems(dirid, directory->GetItemList(), recursiv);
     return (dirid);
 }
 
@@ -1116,9 +1914,10 @@ wxTreeItemId ProjectTreeCtrl::AddLinkedItems(wxTreeItemId id, ProjectItemLinkedI
  **/
 {
     int imageindex = m_apperance->GetImageIndexLinkedItems();
-    wxTreeItemId liid = m_treectrl->AppendItem(id,
-        linkeditems->GetName(), imageindex, -1, new ProjectTreeItemData(linkeditems));
+    wxTreeItemId liid = AppendTreeItem(id,
+        linkeditems->GetName(), imageindex, -1, new (m_pool) ProjectTreeItemData(linkeditems));
     linkeditems->SetTreeItemId(liid);
+    IndexTreeItem(liid);
     // Alle linked Items recursiv hinzufgen
     AddProjectItemList(liid, linkeditems->GetItemList(), true);
     return (liid);
@@ -1133,17 +1932,19 @@ wxTreeItemId ProjectTreeCtrl::AddSubProject(wxTreeItemId id, ProjectItemSubProje
  * a check if file is NULL will not be done.
  * \param id Parent id of the project item.
  * \param file The project item which should be added.
- * \param recursiv True if all project items should be recursively added.
+ * \param recursiv True if all project items should be recursively added;
+ * false if they are added when the subproject is expanded.
  * \return Returns the newly added project tree item ID.
  **/
 {
     int imageindex = m_apperance->GetImageIndexSubProject();
     // TODO SO: Cast zu Project* entfernen
-    wxTreeItemId subid = m_treectrl->AppendItem(id,
-        ((Project*)subproject)->GetName(), imageindex, -1, new ProjectTreeItemData((ProjectItem*)subproject));
+    wxTreeItemId subid = AppendTreeItem(id,
+        ((Project*)subproject)->GetName(), imageindex, -1, new (m_pool) ProjectTreeItemData((ProjectItem*)subproject));
     ((Project*)subproject)->SetTreeItemId(subid);
+    IndexTreeItem(subid);
     // Alle Element eine Ebene darunter einfgen
-    AddProjectItemList(subid, subproject->GetItemList(), recursiv);
+    AddChildItems(subid, subproject->GetItemList(), recursiv);
     return (subid);
 }
 
@@ -1175,6 +1976,8 @@ void ProjectTreeCtrl::OnTreeBeginDrag(wxTreeEvent& event)
  * <b>ProjectItemDirectory:</b> Same as ProjectItemFile.<br>
  * <b>ProjectItemLinkedItems:</b> Same as ProjectItemFile.<br>
  * <b>ProjectItemSubProject:</b> Same as ProjectItemFile.<br>
+ * If the dragged tree item is selected, all selected items are dragged
+ * at once, otherwise only the dragged item.
  * \param event TreeEvent.
  **/
 {
@@ -1187,19 +1990,23 @@ void ProjectTreeCtrl::OnTreeBeginDrag(wxTreeEvent& event)
         return;
     }
 
-    ProjectTreeItemDataObject* objdata = NULL;
-    if (data->GetType() == penvTI_Project) {
-        objdata = new ProjectTreeItemDataObject(data->GetProject());
-    }
-    else if (data->GetType() == penvTI_ProjectItem) {
-        objdata = new ProjectTreeItemDataObject(data->GetProjectItem());
+    ProjectTreeItemDataObject selection;
+    if (m_treectrl->IsSelected(id)) {
+        GetSelectedItems(&selection);
+    } else if (data->GetType() == penvTI_Project) {
+        selection.Add(new ProjectTreeItemDataBase(data->GetProject()));
+    } else if (data->GetType() == penvTI_ProjectItem) {
+        selection.Add(new ProjectTreeItemDataBase(data->GetProjectItem()));
     }
-    else if (data->GetType() == penvTI_Workspace) {
+    ProjectTreeItemDataObject* objdata = new ProjectTreeItemDataObject();
+    for (size_t i=0; i<selection.Count(); ++i)
+    {
         // Workspaces drfen nicht verschoben werden!
-        return;
+        if (selection.GetItem(i)->GetType() == penvTI_Workspace) continue;
+        objdata->Add(selection.GetItem(i)->Clone());
     }
-    if (objdata == NULL) {
-        wxLogError(_T("[penv::ProjectTreeCtrl::OnTreeBeginDrag] Unknow ProjectTreeItemData type."));
+    if (objdata->Count() == 0) {
+        delete objdata;
         return;
     }
     m_treectrl->GetDropTarget()->SetDataObject(objdata);
@@ -1243,6 +2050,12 @@ void ProjectTreeCtrl::OnTreeDeleteItem(wxTreeEvent& event )
  * \param event Event.
  **/
 {
+    // Den Index immer nachziehen, auch wenn nur geleert wird
+    ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(event.GetItem());
+    if (m_treeitems != NULL && data != NULL && data->GetPenvItem() != NULL) {
+        TreeItemIdHashMap::iterator itr = m_treeitems->find(data->GetPenvItem());
+        if (itr != m_treeitems->end() && itr->second == event.GetItem()) m_treeitems->erase(itr);
+    }
     // If the tree control will just be cleared (for example on a refresh),
     //  then this method will skip.
     if (m_justclear) return;
@@ -1331,7 +2144,7 @@ void ProjectTreeCtrl::OnTreeItemActivated( wxTreeEvent& event )
     ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
     wxVariant variant = (void*)data;
     Environment::Get()->GetCommandList()
-        ->Execute(_T("PENV_EVT_PROJECTTREECTRL_ITEM_ACTIVATED"), variant);
+        ->Execute(penvCE_ProjectTreeCtrlItemActivated, variant);
 }
 
 
@@ -1339,11 +2152,21 @@ void ProjectTreeCtrl::OnTreeItemActivated( wxTreeEvent& event )
 void ProjectTreeCtrl::OnTreeItemCollapsed( wxTreeEvent& event )
 /**
  * \brief Occurs when a project tree branch has collapsed.
- * This callback is not registered and will not be used.
+ * If there are more than penvPROJECTTREECTRL_RELEASECOUNT tree items
+ * below the project or project item, they are deleted and added again
+ * on the next expand.
  * \param event Event.
  **/
 {
-    // Not used
+    wxTreeItemId id = event.GetItem();
+    ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
+    if (data == NULL || data->GetType() == penvTI_Workspace) return;
+    if (m_treectrl->GetChildrenCount(id, true) < penvPROJECTTREECTRL_RELEASECOUNT) return;
+    // Nur die Baumelemente loeschen, nicht die Projektelemente
+    m_justclear = true;
+    m_treectrl->DeleteChildren(id);
+    m_justclear = false;
+    m_treectrl->SetItemHasChildren(id, true);
 }
 
 
@@ -1375,12 +2198,12 @@ void ProjectTreeCtrl::OnTreeItemExpanded(wxTreeEvent& event)
 void ProjectTreeCtrl::OnTreeItemExpanding( wxTreeEvent& event )
 /**
  * \brief Occurs before a project tree branch is going to expand.
- * (Updates the underlying branch items.)
- * This callback is not registered and will not be used.
+ * Adds the tree items of the project or project item, if they are
+ * not added yet. See LoadTreeItem().
  * \param event Event.
  **/
 {
-    // Not used
+    LoadTreeItem(event.GetItem());
 }
 
 
@@ -1430,11 +2253,17 @@ void ProjectTreeCtrl::OnTreeItemGetTooltip( wxTreeEvent& event )
 void ProjectTreeCtrl::OnTreeItemRightClick( wxTreeEvent& event )
 /**
  * \brief Occurs when the right mouse button is clicked on a tree
- * item. Selects the right clicked item.
+ * item. Selects the right clicked item. If the item is already part
+ * of a multiple selection, the selection is kept.
  * \param event Event.
  **/
 {
     if (!event.GetItem().IsOk()) return;
+    if (penvPROJECTTREECTRL_SELECTIONMODE != wxTR_SINGLE)
+    {
+        if (m_treectrl->IsSelected(event.GetItem())) return;
+        m_treectrl->UnselectAll();
+    }
     m_treectrl->SelectItem(event.GetItem(), true);
 }
 
@@ -1453,8 +2282,10 @@ void ProjectTreeCtrl::OnTreeItemMenu( wxTreeEvent& event )
     {
         if(m_contextmenu != NULL)
         {
-            wxTreeItemId id = m_treectrl->GetSelection();
+            wxTreeItemId id = GetSelectedTreeItem();
+            if (!id.IsOk()) return;
             ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
+            if (data == NULL) return;
             CommandList* list = Environment::Get()->GetCommandList();
             // Enable or diable AddFile
             m_contextmenu->Enable(m_eventids[10], data->GetType() != penvTI_Workspace);
@@ -1465,37 +2296,43 @@ void ProjectTreeCtrl::OnTreeItemMenu( wxTreeEvent& event )
             m_contextmenu->Enable(m_eventids[15], false); // Open external
             // Checks for 'open' context menu item
             bool enabled = false;
-            if (list->GetCommand(_T("PENV_EVT_ACTIVATED_WORKSPACE"))->GetCallbacksCount() != 0 &&
+            if (list->GetCommand(penvCE_ActivatedWorkspace)->GetCallbacksCount() != 0 &&
                 data->GetType() == penvTI_Workspace) {
                 enabled = true;
             }
-            if (list->GetCommand(_T("PENV_EVT_ACTIVATED_PROJECT"))->GetCallbacksCount() != 0 &&
+            if (list->GetCommand(penvCE_ActivatedProject)->GetCallbacksCount() != 0 &&
                 data->GetType() == penvTI_Workspace) {
                 enabled = true;
             }
             if (data->GetType() == penvTI_ProjectItem) {
                 if (data->GetProjectItem()->GetType() == penvPI_File &&
-                    list->GetCommand(_T("PENV_EVT_ACTIVATED_PROJECTITEMFILE"))->GetCallbacksCount() != 0) {
+                    list->GetCommand(penvCE_ActivatedProjectItemFile)->GetCallbacksCount() != 0) {
                     enabled = true;
                 }
                 if (data->GetProjectItem()->GetType() == penvPI_Directory &&
-                    list->GetCommand(_T("PENV_EVT_ACTIVATED_PROJECTITEMDIRECTORY"))->GetCallbacksCount() != 0) {
+                    list->GetCommand(penvCE_ActivatedProjectItemDirectory)->GetCallbacksCount() != 0) {
                     enabled = true;
                 }
                 if (data->GetProjectItem()->GetType() == penvPI_LinkedItems &&
-                    list->GetCommand(_T("PENV_EVT_ACTIVATED_PROJECTITEMLINKEDITEMS"))->GetCallbacksCount() != 0) {
+                    list->GetCommand(penvCE_ActivatedProjectItemLinkedItems)->GetCallbacksCount() != 0) {
                     enabled = true;
                 }
                 if (data->GetProjectItem()->GetType() == penvPI_SubProject &&
-                    list->GetCommand(_T("PENV_EVT_ACTIVATED_PROJECTITEMSUBPROJECT"))->GetCallbacksCount() != 0) {
+                    list->GetCommand(penvCE_ActivatedProjectItemSubProject)->GetCallbacksCount() != 0) {
                     enabled = true;
                 }
             }
             m_contextmenu->Enable(m_eventids[16], enabled);
-            m_contextmenu->Enable(m_eventids[17], false); // Paste
-            m_contextmenu->Enable(m_eventids[18], false); // Cut
-            m_contextmenu->Enable(m_eventids[19], false); // Copy
-            m_contextmenu->Enable(m_eventids[20], false); // Delete
+            // Einfuegen nur in Elemente, die Elemente aufnehmen koennen
+            enabled = (m_clipboard != NULL);
+            if (enabled && data->GetType() == penvTI_ProjectItem) {
+                enabled = (data->GetProjectItem()->GetType() != penvPI_File &&
+                    data->GetProjectItem()->GetType() != penvPI_LinkedItems);
+            }
+            m_contextmenu->Enable(m_eventids[17], enabled); // Paste
+            m_contextmenu->Enable(m_eventids[18], data->GetType() != penvTI_Workspace); // Cut
+            m_contextmenu->Enable(m_eventids[19], data->GetType() != penvTI_Workspace); // Copy
+            m_contextmenu->Enable(m_eventids[20], true); // Delete
             m_contextmenu->Enable(m_eventids[22], false); // Properties
             m_treectrl->PopupMenu(m_contextmenu,wxDefaultPosition);
         }
@@ -1515,11 +2352,11 @@ void ProjectTreeCtrl::OnTreeItemKeyDown( wxTreeEvent& event )
     m_deletionyestoall = false;
     if(event.GetKeyCode() == WXK_F2)
     {
-        m_treectrl->EditLabel(m_treectrl->GetSelection());
+        m_treectrl->EditLabel(GetSelectedTreeItem());
     }
     else if (event.GetKeyCode() == WXK_DELETE)
     {
-        // TODO
+        RemoveSelectedItems();
     }
     else if (event.GetKeyCode() == WXK_RETURN)
     {
@@ -1536,11 +2373,10 @@ void ProjectTreeCtrl::OnToolBarItemAddClicked( wxCommandEvent& event )
  **/
 {
     m_deletionyestoall = false;
-    wxString cmdid = _T("PENV_EVT_PROJECTTREECTRL_ADDCLICKED");
-    Command* cmd = Environment::Get()->GetCommandList()->GetCommand(cmdid);
+    Command* cmd = Environment::Get()->GetCommandList()->GetCommand(penvCE_ProjectTreeCtrlAddClicked);
     if (cmd->GetCallbacksCount() == 0)
     {
-        wxLogWarning(_T("[penv::ProjectTreeCtrl::OnToolBarItemAddClicked] No Callback for command '%s' registered."), cmdid.c_str());
+        wxLogWarning(_T("[penv::ProjectTreeCtrl::OnToolBarItemAddClicked] No Callback for command '%s' registered."), cmd->GetId().c_str());
         return;
     }
     //TODO SO: Eigene Klasse zum verwalten von hinzuzufgenden items.
@@ -1558,7 +2394,7 @@ void ProjectTreeCtrl::OnToolBarItemDeleteClicked( wxCommandEvent& event )
  **/
 {
     m_deletionyestoall = false;
-    NOT_IMPLEMENTED_YET();
+    RemoveSelectedItems();
 }
 
 
@@ -1579,16 +2415,27 @@ void ProjectTreeCtrl::OnToolBarItemRefreshClicked( wxCommandEvent& event )
             _("Question"), wxYES_NO | wxICON_QUESTION , env->GetFrame());
         if (result == wxYES)
         {
-            NOT_IMPLEMENTED_YET();
-            //TODO MS: SaveProjectWorkspaces or/and -Projects.
+            env->GetWorkspaceList()->SaveModified();
         }
     }
+    SetFilter(wxEmptyString);
+    // Die Schluessel werden vor dem Neuladen gelesen, danach zeigen
+    // die Baumelemente auf geloeschte Elemente
+    TreeItemKeyHashMap keys;
+    if (m_rootid.IsOk()) GetTreeItemKeys(&keys, m_rootid);
     env->GetWorkspaceList()->ReloadWorkspaces();
-    m_justclear = true;
-    m_treectrl->DeleteAllItems();
-    m_justclear = false;
-    m_treectrl->SetImageList(m_apperance->GetImageList());
-    AddTreeItems(false);
+    ItemsChanged(true);
+    if (!m_rootid.IsOk())
+    {
+        ClearTreeItems();
+        m_treectrl->SetImageList(m_apperance->GetImageList());
+        AddTreeItems(true);
+        return;
+    }
+    m_treeitems->clear();
+    m_treectrl->Freeze();
+    SyncTreeItems(m_rootid, NULL, keys);
+    m_treectrl->Thaw();
 }
 
 
@@ -1617,6 +2464,18 @@ void ProjectTreeCtrl::OnToolBarItemShowAllClicked( wxCommandEvent& event )
 
 
 
+//----------------------------------------------------------------
+void ProjectTreeCtrl::OnToolBarFilterChanged(wxCommandEvent& event)
+/**
+ * \brief Occurs when the text of the filter box is changed.
+ * \param event Event.
+ **/
+{
+    SetFilter(event.GetString());
+}
+
+
+
 //----------------------------------------------------------------
 void ProjectTreeCtrl::OnContextMenuItemAddFileClicked(wxCommandEvent& event)
 /**
@@ -1625,7 +2484,7 @@ void ProjectTreeCtrl::OnContextMenuItemAddFileClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
-    wxTreeItemId id = m_treectrl->GetSelection();
+    wxTreeItemId id = GetSelectedTreeItem();
     ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
     ProjectItemList* list = NULL;
     if (data->GetType() == penvTI_Project) {
@@ -1660,7 +2519,7 @@ void ProjectTreeCtrl::OnContextMenuItemAddDirectoryClicked(wxCommandEvent& event
  * \param event Event.
  **/
 {
-    wxTreeItemId id = m_treectrl->GetSelection();
+    wxTreeItemId id = GetSelectedTreeItem();
     ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
     ProjectItemList* list = NULL;
     if (data->GetType() == penvTI_Project) {
@@ -1694,7 +2553,7 @@ void ProjectTreeCtrl::OnContextMenuItemAddProjectClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
-    wxTreeItemId id = m_treectrl->GetSelection();
+    wxTreeItemId id = GetSelectedTreeItem();
     ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
     ProjectList* list = NULL;
     if (data->GetType() == penvTI_Project) {
@@ -1751,12 +2610,12 @@ void ProjectTreeCtrl::OnContextMenuItemOpenClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
-    wxTreeItemId id = m_treectrl->GetSelection();
+    wxTreeItemId id = GetSelectedTreeItem();
     if (!id.IsOk()) return;
     ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
     wxVariant variant = (void*)data;
     Environment::Get()->GetCommandList()
-        ->Execute(_T("PENV_EVT_PROJECTTREECTRL_ITEM_ACTIVATED"), variant);
+        ->Execute(penvCE_ProjectTreeCtrlItemActivated, variant);
 
 }
 
@@ -1769,6 +2628,7 @@ void ProjectTreeCtrl::OnContextMenuItemPasteClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
+    PasteItems();
 }
 
 
@@ -1780,6 +2640,7 @@ void ProjectTreeCtrl::OnContextMenuItemCutClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
+    CopySelectedItems(true);
 }
 
 
@@ -1791,6 +2652,7 @@ void ProjectTreeCtrl::OnContextMenuItemCopyClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
+    CopySelectedItems(false);
 }
 
 
@@ -1802,6 +2664,7 @@ void ProjectTreeCtrl::OnContextMenuItemDeleteClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
+    RemoveSelectedItems();
 }
 
 
@@ -1813,7 +2676,7 @@ void ProjectTreeCtrl::OnContextMenuItemRenameClicked(wxCommandEvent& event)
  * \param event Event.
  **/
 {
-    m_treectrl->EditLabel(m_treectrl->GetSelection());
+    m_treectrl->EditLabel(GetSelectedTreeItem());
 }
 
 
@@ -1828,6 +2691,99 @@ void ProjectTreeCtrl::OnContextMenuItemPropertiesClicked(wxCommandEvent& event)
 }
 
 
+//----------------------------------------------------------------
+void ProjectTreeCtrl::OnProjectItemAdded(CommandEvent& event)
+/**
+ * \brief Occurs when the DirectoryWatcher has added a project item
+ * for a new file or directory. Adds the tree item below the tree item
+ * of the directory, without refreshing the whole tree.
+ * \param event Event, the variant contains the project item.
+ **/
+{
+    m_filter->Invalidate();
+    ProjectItem* item = (ProjectItem*)event.GetVariant().GetVoidPtr();
+    if (item == NULL || item->GetParent() == NULL) return;
+    ProjectItem* parent = item->GetParent()->GetProjectItemParent();
+    if (parent == NULL) return;
+    // Das Verzeichnis wird nicht angezeigt
+    ProjectTreeItemId parentid = SearchItem(parent);
+    if (!parentid.IsOk()) return;
+    // Sind die Elemente des Verzeichnisses noch nicht erzeugt, werden
+    // sie beim Aufklappen mit dem neuen Element erzeugt
+    if (m_treectrl->GetChildrenCount(parentid.GetId(), false) == 0 &&
+        !m_treectrl->IsExpanded(parentid.GetId()))
+    {
+        m_treectrl->SetItemHasChildren(parentid.GetId(), true);
+        return;
+    }
+    if (item->GetType() == penvPI_File) {
+        AddFile(parentid.GetId(), (ProjectItemFile*)item);
+    }
+    else if (item->GetType() == penvPI_Directory) {
+        AddDirectory(parentid.GetId(), (ProjectItemDirectory*)item, false);
+    }
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::OnProjectItemRemoved(CommandEvent& event)
+/**
+ * \brief Occurs before the DirectoryWatcher removes the project item
+ * of a deleted file or directory. Removes only the tree item.
+ * \param event Event, the variant contains the project item.
+ **/
+{
+    ItemsChanged(true);
+    ProjectItem* item = (ProjectItem*)event.GetVariant().GetVoidPtr();
+    if (item == NULL) return;
+    ProjectTreeItemId id = SearchItem(item);
+    if (!id.IsOk()) return;
+    // Die Datei ist schon geloescht, OnTreeDeleteItem() nicht ausfuehren
+    m_justclear = true;
+    m_treectrl->Delete(id.GetId());
+    m_justclear = false;
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::OnProjectItemRenamed(CommandEvent& event)
+/**
+ * \brief Occurs when the DirectoryWatcher has renamed the project
+ * item of a renamed file. Updates the label of the tree item.
+ * \param event Event, the variant contains the project item.
+ **/
+{
+    m_filter->Invalidate();
+    ProjectItem* item = (ProjectItem*)event.GetVariant().GetVoidPtr();
+    if (item == NULL) return;
+    ProjectTreeItemId id = SearchItem(item);
+    if (!id.IsOk()) return;
+    m_treectrl->SetItemText(id.GetId(), item->GetName());
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeCtrl::OnFilterFinished(CommandEvent& event)
+/**
+ * \brief Occurs when the ProjectTreeFilter has finished a search.
+ * Shows the results in the tree.
+ * \param event Event.
+ **/
+{
+    wxArrayInt results;
+    if (!m_filter->GetResults(&results)) return;
+    if (m_filterquery.IsEmpty()) return;
+    // Die Ergebnisse zeigen evtl. auf geloeschte Elemente
+    if (!m_filter->IsValid())
+    {
+        m_filter->Build(Environment::Get()->GetWorkspaceList());
+        m_filter->Search(m_filterquery);
+        return;
+    }
+    ShowFilterResults(results);
+}
+
+
 
 
 
@@ -22,6 +22,8 @@
 #include "projecttreectrlapperance.h"
 #include "projecttreeitemid.h"
 #include "projecttreeaction.h"
+#include "projecttreefilter.h"
+#include "../memorypool.h"
 
 
 namespace penv {
@@ -32,6 +34,13 @@ namespace penv {
  **/
 #define penvPROJECTTREECTRL_MAXEVENTCOUNT 30
 
+/**
+ * \brief Defines the number of tree items below a collapsed tree item,
+ * from which on the tree items are deleted and created again on the
+ * next expand.
+ **/
+#define penvPROJECTTREECTRL_RELEASECOUNT 1000
+
 
 /**
  * \brief The ProjectTreeCtrl class is a control for handling workspaces, projects
@@ -81,16 +90,37 @@ namespace penv {
  * with the information which item is activated.</li>
  * <li>TODO There are more undocumented events.</li>
  * </ul>
+ * The tree item of a workspace, project or project item is found with
+ * SearchItem() in constant time. Every added tree item is stored in a
+ * hash map, deleted tree items are removed in OnTreeDeleteItem(). Own
+ * Add methods must call IndexTreeItem() for their tree items.<br>
+ * The tree items of projects and directories are created when they are
+ * expanded the first time. Until then the tree item only shows the expand
+ * button. If more than penvPROJECTTREECTRL_RELEASECOUNT tree items are
+ * below a collapsed tree item, they are deleted again. The expanded tree
+ * items are restored after the tree is refreshed.<br>
+ * The refresh button does not rebuild the tree. The tree items are
+ * compared with the reloaded workspaces by the path and the type of
+ * their items, only the changed tree items are added, deleted, renamed
+ * or moved. See SyncTreeItems().<br>
+ * The default toolbar contains a filter box. While a filter is set, the
+ * tree shows only the best matches of the ProjectTreeFilter and their
+ * parents. The search runs on the thread of the filter, every change of
+ * the filter cancels the previous search. See SetFilter().<br>
+ * More than one tree item can be selected. Removing, moving (drag'n'drop
+ * or cut and paste) and copying the selected items is done by the
+ * ProjectTreeAction with one change of the model and one update of the
+ * tree. The clipboard only contains pointers to the items, so pasting
+ * is only allowed for items which were cut or copied in this tree and
+ * which were not removed in the meantime.<br>
  * \todo Activated Project should be marked bold.
  * \todo Additional BuildInCommand should be 'activate selected project'.
- * \todo Methods to return a selection in the TreeCtrl.
  * \todo Use penv::ContextMenu and penv::ToolBar internally if possible.
  * \todo Use internal BuildInCommands class for ProjectTreeCtrl, instead of
  * implementing them here.
  * \todo Check if a transparent icon will correct the wrong intendation in
  * the menu.
  * \todo Use for Properties the additional wxPropertyGrid class.
- * \todo Allow Multiselect, but only for one Level of a tree node.
  **/
 class ProjectTreeCtrl : public wxPanel
 {
@@ -141,12 +171,47 @@ class ProjectTreeCtrl : public wxPanel
         ProjectTreeItemId SearchItem(const Workspace* workspace);
         ProjectTreeItemId SearchItem(const Project* project);
         ProjectTreeItemId SearchItem(const ProjectItem* item);
+        ProjectTreeItemId ShowItem(ProjectItem* item);
+
+        void SetFilter(const wxString& filter);
+        const wxString& GetFilter() const;
+
+        size_t GetSelectedItems(ProjectTreeItemDataObject* items);
 
     protected:
+        void ItemsChanged(bool removed);
         wxArrayTreeItemIds* GetAllTreeItemIds() const;
+        void IndexTreeItem(wxTreeItemId id);
+        void ClearTreeItems();
+        bool LoadTreeItem(wxTreeItemId id);
+        void GetExpandedTreeItems(wxSortedArrayString* paths);
+        void ExpandTreeItems(const wxSortedArrayString& paths);
+
+        WX_DECLARE_HASH_MAP(void*, wxString, wxPointerHash, wxPointerEqual, TreeItemKeyHashMap);
+        void GetTreeItemKeys(TreeItemKeyHashMap* keys, wxTreeItemId id);
+        void SyncTreeItems(wxTreeItemId id, ProjectTreeItemDataBase* parent, const TreeItemKeyHashMap& keys);
+        wxTreeItemId AppendTreeItem(wxTreeItemId parent, const wxString& text, int image,
+            int selimage, ProjectTreeItemData* data);
 
     private:
+        WX_DECLARE_HASH_MAP(const PenvItem*, wxTreeItemId, wxPointerHash, wxPointerEqual, TreeItemIdHashMap);
+        WX_DECLARE_STRING_HASH_MAP(wxTreeItemId, KeyHashMap);
+
         void GetAllTreeItemIds(wxArrayTreeItemIds* ids, wxTreeItemId id, unsigned int lastcookie) const;
+        ProjectTreeItemId SearchIndex(const PenvItem* item, ProjectTreeItemType type);
+        void GetExpandedTreeItems(wxSortedArrayString* paths, wxTreeItemId id, const wxString& path);
+        void ExpandTreeItems(const wxSortedArrayString& paths, wxTreeItemId id, const wxString& path);
+        wxString GetTreeItemKey(ProjectTreeItemDataBase* data);
+        wxString GetTreeItemText(ProjectTreeItemDataBase* data);
+        void GetChildItems(ProjectTreeItemDataBase* data, Array<ProjectTreeItemDataBase>* items);
+        wxTreeItemId InsertTreeItem(wxTreeItemId id, wxTreeItemId previous, ProjectTreeItemDataBase* data);
+        void ShowFilterResults(const wxArrayInt& results);
+        wxTreeItemId ShowFilterEntry(size_t index);
+        wxTreeItemId GetSelectedTreeItem();
+        void RemoveSelectedItems();
+        void CopySelectedItems(bool cut);
+        void PasteItems();
+        void ClearClipboardItems();
 
 
 
@@ -155,6 +220,8 @@ class ProjectTreeCtrl : public wxPanel
         virtual wxTreeItemId AddWorkspace(Workspace* workspace);
         virtual wxTreeItemId AddProject(wxTreeItemId workspaceid, Project* project);
         virtual void AddProjectItemList(wxTreeItemId id, ProjectItemList* list, bool recursiv);
+        virtual void AddChildItems(wxTreeItemId id, ProjectItemList* list, bool recursiv);
+        virtual wxTreeItemId AddProjectItem(wxTreeItemId id, ProjectItem* item, bool recursiv);
         virtual wxTreeItemId AddFile(wxTreeItemId id, ProjectItemFile* file);
         virtual wxTreeItemId AddDirectory(wxTreeItemId id, ProjectItemDirectory* directory, bool recursiv);
         virtual wxTreeItemId AddLinkedItems(wxTreeItemId id, ProjectItemLinkedItems* linkeditems);
@@ -181,6 +248,7 @@ class ProjectTreeCtrl : public wxPanel
         virtual void OnToolBarItemDeleteClicked(wxCommandEvent& event);
         virtual void OnToolBarItemRefreshClicked(wxCommandEvent& event);
         virtual void OnToolBarItemShowAllClicked(wxCommandEvent& event);
+        virtual void OnToolBarFilterChanged(wxCommandEvent& event);
 
         virtual void OnContextMenuItemAddFileClicked(wxCommandEvent& event);
         virtual void OnContextMenuItemAddDirectoryClicked(wxCommandEvent& event);
@@ -196,6 +264,11 @@ class ProjectTreeCtrl : public wxPanel
         virtual void OnContextMenuItemRenameClicked(wxCommandEvent& event);
         virtual void OnContextMenuItemPropertiesClicked(wxCommandEvent& event);
 
+        virtual void OnProjectItemAdded(CommandEvent& event);
+        virtual void OnProjectItemRemoved(CommandEvent& event);
+        virtual void OnProjectItemRenamed(CommandEvent& event);
+        virtual void OnFilterFinished(CommandEvent& event);
+
 
     protected:
         wxToolBar* m_toolbar;
@@ -204,6 +277,16 @@ class ProjectTreeCtrl : public wxPanel
 		wxTreeItemId m_rootid;
         ProjectTreeCtrlApperance* m_apperance;
         ProjectTreeAction* m_actionhandler;
+        MemoryPool* m_pool;
+        TreeItemIdHashMap* m_treeitems;
+        bool m_insert;
+        wxTreeItemId m_insertafter;
+        ProjectTreeFilter* m_filter;
+        wxTextCtrl* m_filtertext;
+        wxString m_filterquery;
+        wxSortedArrayString m_filterexpanded;
+        ProjectTreeItemDataObject* m_clipboard;
+        bool m_clipboardcut;
         int m_eventids[penvPROJECTTREECTRL_MAXEVENTCOUNT];
         bool m_justclear;
         bool m_deletionyestoall;
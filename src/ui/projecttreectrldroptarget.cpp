@@ -75,71 +75,20 @@ bool ProjectTreeCtrlDropTarget::OnDrop(wxCoord x, wxCoord y)
     }
     ProjectTreeItemData* target = (ProjectTreeItemData*)m_treectrl->GetTreeCtrl()->GetItemData(id);
     ProjectTreeItemDataObject* source = (ProjectTreeItemDataObject*)m_dataObject;
-    if (source->GetType() == penvTI_Project && target->GetType() == penvTI_Workspace)
-    {
-        ProjectTreeAction* action = m_treectrl->GetActionHandler();
-        bool cancel = false;
-        if (m_dragresult == wxDragMove)
-        {
-            action->OnMove(cancel, source->GetProject(), target->GetWorkspace(), source->GetProject()->GetParent());
-        }
-        else if (m_dragresult == wxDragCopy)
-        {
-            action->OnCopy(cancel, source->GetProject(), target->GetWorkspace(), source->GetProject()->GetParent());
-        }
-        return (cancel);
-    }
-    else if(source->GetType() == penvTI_ProjectItem && target->GetType() == penvTI_Project)
-    {
-        ProjectTreeAction* action = m_treectrl->GetActionHandler();
-        bool cancel = false;
-        if (m_dragresult == wxDragMove)
-        {
-            action->OnMove(cancel, source->GetProjectItem(), target->GetProject(), source->GetProjectItem()->GetParent());
-        }
-        else if (m_dragresult == wxDragCopy)
-        {
-            action->OnCopy(cancel, source->GetProjectItem(), target->GetProject(), source->GetProjectItem()->GetParent());
-        }
-        return (cancel);
-    }
-    else if(source->GetType() == penvTI_ProjectItem && target->GetType() == penvTI_ProjectItem)
+    if (target == NULL || source->Count() == 0) return (false);
+    // Alle gezogenen Elemente werden auf einmal verschoben oder kopiert,
+    // nicht passende Elemente ueberspringt die ProjectTreeAction
+    ProjectTreeAction* action = m_treectrl->GetActionHandler();
+    bool cancel = true;
+    if (m_dragresult == wxDragMove)
     {
-        ProjectItem* item = target->GetProjectItem();
-        if (item->GetType() != penvPI_File && item->GetType() != penvPI_LinkedItems)
-        {
-            ProjectTreeAction* action = m_treectrl->GetActionHandler();
-            bool cancel = false;
-            if (m_dragresult == wxDragMove)
-            {
-                action->OnMove(cancel, source->GetProjectItem(), target->GetProjectItem(), source->GetProjectItem()->GetParent());
-            }
-            else if (m_dragresult == wxDragCopy)
-            {
-                action->OnCopy(cancel, source->GetProjectItem(), target->GetProjectItem(), source->GetProjectItem()->GetParent());
-            }
-            return (true);
-        }
+        action->OnMove(cancel, source, target);
     }
-    else if(source->GetType() == penvTI_ProjectItem && target->GetType() == penvTI_Workspace)
+    else if (m_dragresult == wxDragCopy)
     {
-        ProjectItem* item = source->GetProjectItem();
-        if (item->GetType() == penvPI_SubProject)
-        {
-            ProjectTreeAction* action = m_treectrl->GetActionHandler();
-            bool cancel = false;
-            if (m_dragresult == wxDragMove)
-            {
-                action->OnMove(cancel, (ProjectItemSubProject*)source->GetProjectItem(), target->GetWorkspace(), source->GetProjectItem()->GetParent());
-            }
-            else if (m_dragresult == wxDragCopy)
-            {
-                action->OnCopy(cancel, (ProjectItemSubProject*)source->GetProjectItem(), target->GetWorkspace(), source->GetProjectItem()->GetParent());
-            }
-            return (true);
-        }
+        action->OnCopy(cancel, source, target);
     }
-    return (false);
+    return (!cancel);
 }
 
 
@@ -179,6 +128,7 @@ wxDragResult ProjectTreeCtrlDropTarget::OnDragOver(wxCoord x, wxCoord y, wxDragR
     if(!id.IsOk()) return (wxDragNone);
     ProjectTreeItemData* target = (ProjectTreeItemData*)m_treectrl->GetTreeCtrl()->GetItemData(id);
     ProjectTreeItemDataObject* source = (ProjectTreeItemDataObject*)m_dataObject;
+    if (target == NULL || source->Count() == 0) return (wxDragNone);
     m_dragresult = def;
 
     if (source->GetType() == penvTI_Project && target->GetType() == penvTI_Workspace)
@@ -196,14 +146,6 @@ wxDragResult ProjectTreeCtrlDropTarget::OnDragOver(wxCoord x, wxCoord y, wxDragR
             return (def);
         }
     }
-    else if(source->GetType() == penvTI_ProjectItem && target->GetType() == penvTI_Workspace)
-    {
-        ProjectItem* item = source->GetProjectItem();
-        if (item->GetType() == penvPI_SubProject)
-        {
-            return (def);
-        }
-    }
     return (wxDragNone);
 }
 
@@ -0,0 +1,594 @@
+/*
+ * projecttreefilter.cpp - Implementation of the ProjectTreeFilter class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "projecttreefilter.h"
+#include "../expect.h"
+#include "../environment.h"
+#include "../commandlist.h"
+#include "../projectitemsubproject.h"
+#include <string.h> // for memcpy()
+
+
+namespace penv {
+
+
+/**
+ * \brief The ProjectTreeFilterThread class is the worker thread of
+ * the ProjectTreeFilter. It waits for a query, searches the index and
+ * hands the results over to the filter.
+ **/
+class ProjectTreeFilterThread : public wxThread
+{
+    public:
+        ProjectTreeFilterThread(ProjectTreeFilter* filter);
+        virtual ExitCode Entry();
+        void Wake();
+
+    private:
+        ProjectTreeFilter* m_filter;
+        wxSemaphore m_semaphore;
+};
+
+
+
+//----------------------------------------------------------------
+ProjectTreeFilterThread::ProjectTreeFilterThread(ProjectTreeFilter* filter)
+    : wxThread(wxTHREAD_JOINABLE)
+/**
+ * \brief Constructor, initializes the ProjectTreeFilterThread object.
+ * \param filter The filter, which owns this thread.
+ **/
+{
+    m_filter = filter;
+}
+
+
+//----------------------------------------------------------------
+wxThread::ExitCode ProjectTreeFilterThread::Entry()
+/**
+ * \brief Entry point of the worker thread. Searches the index for
+ * every new query, until the filter is stopped.
+ * \return Always 0.
+ **/
+{
+    int lastgeneration = -1;
+    while (true)
+    {
+        m_semaphore.Wait();
+        wxString query;
+        int generation;
+        {
+            wxMutexLocker lock(m_filter->m_mutex);
+            if (m_filter->m_stop) break;
+            // Tiefe Kopie, da wxString Referenzen nicht thread safe sind
+            query = wxString(m_filter->m_query.c_str());
+            generation = m_filter->m_generation;
+        }
+        if (query.IsEmpty() || generation == lastgeneration) continue;
+        wxArrayInt results;
+        bool found;
+        {
+            wxMutexLocker lock(m_filter->m_indexmutex);
+            found = m_filter->DoFind(query, &results, generation);
+        }
+        if (!found) continue;
+        lastgeneration = generation;
+        wxMutexLocker lock(m_filter->m_mutex);
+        if (m_filter->m_stop) break;
+        if (generation != m_filter->m_generation) continue;
+        m_filter->m_results = results;
+        m_filter->m_hasresults = true;
+        // Unter dem Lock, nach dem Stoppen gibt es die CommandList evtl. nicht mehr
+        Environment::Get()->GetCommandList()->Post(penvCE_ProjectTreeFilterFinished, wxVariant(), true);
+    }
+    return (0);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilterThread::Wake()
+/**
+ * \brief Wakes the thread up, to read the new query.
+ **/
+{
+    m_semaphore.Post();
+}
+
+
+
+//----------------------------------------------------------------
+ProjectTreeFilter::ProjectTreeFilter()
+/**
+ * \brief Constructor, initializes the ProjectTreeFilter object and
+ * starts the thread.
+ **/
+{
+    m_entries = NULL;
+    m_count = 0;
+    m_capacity = 0;
+    m_names = NULL;
+    m_namessize = 0;
+    m_namescapacity = 0;
+    m_items = new Array<ProjectTreeItemDataBase>(true);
+    m_valid = false;
+    m_generation = 0;
+    m_hasresults = false;
+    m_stop = false;
+    m_thread = new ProjectTreeFilterThread(this);
+    if (unlikely(m_thread->Create() != wxTHREAD_NO_ERROR || m_thread->Run() != wxTHREAD_NO_ERROR))
+    {
+        wxLogError(_T("[penv::ProjectTreeFilter::ProjectTreeFilter] Could not start the thread, the search runs in the main thread."));
+        delete m_thread;
+        m_thread = NULL;
+    }
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeFilter::~ProjectTreeFilter()
+/**
+ * \brief Destructor, stops the thread.
+ **/
+{
+    if (m_thread != NULL)
+    {
+        {
+            wxMutexLocker lock(m_mutex);
+            m_stop = true;
+            m_generation++;
+        }
+        m_thread->Wake();
+        m_thread->Wait();
+        delete m_thread;
+    }
+    Clear();
+    delete m_items;
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeFilter::ProjectTreeFilter(const ProjectTreeFilter& filter)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeFilter& ProjectTreeFilter::operator=(const ProjectTreeFilter& filter)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilter::Build(WorkspaceList* list)
+/**
+ * \brief Builds the index of all workspaces, projects and project
+ * items. Not yet read project items are read. A running search is
+ * cancelled. Must be called from the main thread.
+ * \param list The workspaces.
+ **/
+{
+    wxASSERT(wxIsMainThread());
+    Cancel();
+    wxMutexLocker lock(m_indexmutex);
+    Clear();
+    for (size_t i=0; i<list->Count(); ++i)
+    {
+        Workspace* workspace = list->GetItem(i);
+        if (workspace == NULL) continue;
+        int wsindex = AddEntry(new ProjectTreeItemDataBase(workspace), workspace->GetName(), -1);
+        ProjectList* projects = workspace->GetProjectList();
+        for (size_t j=0; j<projects->Count(); ++j)
+        {
+            Project* project = projects->GetItem(j);
+            if (project == NULL) continue;
+            int prjindex = AddEntry(new ProjectTreeItemDataBase(project), project->GetName(), wsindex);
+            AddEntries(project->GetProjectItemList(), prjindex);
+        }
+    }
+    m_valid = true;
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilter::Invalidate()
+/**
+ * \brief Marks the index as invalid, after the workspaces, projects
+ * or project items have changed. Results of a running search are
+ * dropped.
+ **/
+{
+    Cancel();
+    m_valid = false;
+}
+
+
+//----------------------------------------------------------------
+bool ProjectTreeFilter::IsValid() const
+/**
+ * \brief Returns true if the index is built and not invalidated.
+ * \return True if the index is valid; false otherwise.
+ **/
+{
+    return (m_valid);
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectTreeFilter::Count() const
+/**
+ * \brief Returns the number of entries in the index.
+ * \return Number of entries.
+ **/
+{
+    return (m_count);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilter::Search(const wxString& query)
+/**
+ * \brief Starts a search on the thread and cancels the previous
+ * search. The results are read with GetResults(), after
+ * penvCE_ProjectTreeFilterFinished is executed. Without thread the
+ * search runs in the calling thread.
+ * \param query The text to search for.
+ **/
+{
+    wxString normalized = GetQuery(query);
+    if (unlikely(m_thread == NULL))
+    {
+        wxArrayInt results;
+        {
+            wxMutexLocker indexlock(m_indexmutex);
+            DoFind(normalized, &results, -1);
+        }
+        wxMutexLocker lock(m_mutex);
+        m_generation++;
+        m_results = results;
+        m_hasresults = true;
+        Environment::Get()->GetCommandList()->Post(penvCE_ProjectTreeFilterFinished, wxVariant(), true);
+        return;
+    }
+    {
+        wxMutexLocker lock(m_mutex);
+        m_query = wxString(normalized.c_str());
+        m_generation++;
+        m_hasresults = false;
+    }
+    m_thread->Wake();
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilter::Cancel()
+/**
+ * \brief Cancels the running search, its results are dropped.
+ **/
+{
+    wxMutexLocker lock(m_mutex);
+    m_query.Clear();
+    m_generation++;
+    m_hasresults = false;
+}
+
+
+//----------------------------------------------------------------
+bool ProjectTreeFilter::GetResults(wxArrayInt* results)
+/**
+ * \brief Returns the results of the last search, ordered by their
+ * score. The results are indexes of entries, see GetEntry(). Every
+ * result is only returned once.
+ * \param results Array for the results.
+ * \return True if there are new results; false otherwise.
+ **/
+{
+    wxMutexLocker lock(m_mutex);
+    if (!m_hasresults) return (false);
+    *results = m_results;
+    m_results.Clear();
+    m_hasresults = false;
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+size_t ProjectTreeFilter::Find(const wxString& query, wxArrayInt* results)
+/**
+ * \brief Searches the index in the calling thread.
+ * \param query The text to search for.
+ * \param results Array for the results, ordered by their score.
+ * \return Number of results.
+ **/
+{
+    wxMutexLocker lock(m_indexmutex);
+    DoFind(GetQuery(query), results, -1);
+    return (results->Count());
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeItemDataBase* ProjectTreeFilter::GetEntry(size_t index, int* parent)
+/**
+ * \brief Returns the workspace, project or project item of an entry.
+ * Must be called from the main thread, while the index is valid.
+ * \param index Index of the entry.
+ * \param parent Receives the index of the parent entry or -1.
+ * \return The item of the entry or NULL if the index is out of range.
+ **/
+{
+    if (unlikely(index >= m_count)) return (NULL);
+    if (parent != NULL) *parent = m_entries[index].parent;
+    return (m_items->ItemUnchecked(index));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilter::Clear()
+/**
+ * \brief Removes all entries from the index.
+ **/
+{
+    if (m_entries != NULL) delete [] m_entries;
+    if (m_names != NULL) delete [] m_names;
+    m_entries = NULL;
+    m_count = 0;
+    m_capacity = 0;
+    m_names = NULL;
+    m_namessize = 0;
+    m_namescapacity = 0;
+    m_items->Clear();
+}
+
+
+//----------------------------------------------------------------
+int ProjectTreeFilter::AddEntry(ProjectTreeItemDataBase* data, const wxString& name, int parent)
+/**
+ * \brief Adds an entry to the index. The name is stored lower case.
+ * \param data The item of the entry, the filter takes the ownership.
+ * \param name The name of the item.
+ * \param parent Index of the parent entry or -1.
+ * \return Index of the new entry.
+ **/
+{
+    if (m_count == m_capacity)
+    {
+        size_t capacity = (m_capacity < 1024 ? 1024 : m_capacity*2);
+        Entry* entries = new Entry[capacity];
+        if (m_count > 0) memcpy(entries, m_entries, m_count*sizeof(Entry));
+        if (m_entries != NULL) delete [] m_entries;
+        m_entries = entries;
+        m_capacity = capacity;
+    }
+    wxString lower = name.Lower();
+    if (m_namessize + lower.Length() > m_namescapacity)
+    {
+        size_t capacity = (m_namescapacity < 16384 ? 16384 : m_namescapacity*2);
+        if (capacity < m_namessize + lower.Length()) capacity = m_namessize + lower.Length();
+        wxChar* names = new wxChar[capacity];
+        if (m_namessize > 0) memcpy(names, m_names, m_namessize*sizeof(wxChar));
+        if (m_names != NULL) delete [] m_names;
+        m_names = names;
+        m_namescapacity = capacity;
+    }
+    Entry* entry = &m_entries[m_count];
+    entry->offset = m_namessize;
+    entry->length = lower.Length();
+    entry->parent = parent;
+    memcpy(m_names+m_namessize, lower.c_str(), lower.Length()*sizeof(wxChar));
+    m_namessize += lower.Length();
+    entry->mask = GetMask(lower.c_str(), lower.Length());
+    entry->pathmask = entry->mask;
+    if (parent >= 0) entry->pathmask |= m_entries[parent].pathmask | GetMask(_T("/"), 1);
+    m_items->Add(data);
+    return ((int)m_count++);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeFilter::AddEntries(ProjectItemList* list, int parent)
+/**
+ * \brief Adds the project items of a list and all project items
+ * below to the index.
+ * \param list The project items.
+ * \param parent Index of the parent entry.
+ **/
+{
+    if (list == NULL) return;
+    for (size_t i=0; i<list->Count(); ++i)
+    {
+        ProjectItem* item = list->GetItem(i);
+        if (item == NULL) continue;
+        wxString name = item->GetName();
+        if (item->GetType() == penvPI_SubProject) name = ((Project*)(ProjectItemSubProject*)item)->GetName();
+        int index = AddEntry(new ProjectTreeItemDataBase(item), name, parent);
+        AddEntries(item->GetItemList(), index);
+    }
+}
+
+
+//----------------------------------------------------------------
+bool ProjectTreeFilter::DoFind(const wxString& query, wxArrayInt* results, int generation)
+/**
+ * \brief Searches the index and keeps the best results. The lock of
+ * the index must be held by the caller.
+ * \param query The normalized query, see GetQuery().
+ * \param results Array for the results, ordered by their score.
+ * \param generation The generation of the search, the search is
+ * cancelled if it changes. -1 if the search can not be cancelled.
+ * \return True if the search is finished; false if it was cancelled.
+ **/
+{
+    results->Clear();
+    size_t length = query.Length();
+    if (length == 0) return (true);
+    const wxChar* text = query.c_str();
+    wxUint32 mask = GetMask(text, length);
+    int scores[penvPROJECTTREEFILTER_MAXRESULTS];
+    int indexes[penvPROJECTTREEFILTER_MAXRESULTS];
+    size_t count = 0;
+    for (size_t i=0; i<m_count; ++i)
+    {
+        if (generation >= 0 && (i % penvPROJECTTREEFILTER_CHECKCOUNT) == 0 && i > 0)
+        {
+            wxMutexLocker lock(m_mutex);
+            if (m_generation != generation) return (false);
+        }
+        // Eintraege ohne alle Zeichen der Suche ueberspringen
+        if ((m_entries[i].pathmask & mask) != mask) continue;
+        int score = ScoreEntry(text, length, mask, i);
+        if (score <= 0) continue;
+        if (count == penvPROJECTTREEFILTER_MAXRESULTS && score <= scores[count-1]) continue;
+        // Nach Punkten sortiert einfuegen, bei gleichen Punkten zuerst
+        // das Element, das zuerst gefunden wurde
+        size_t pos = (count < penvPROJECTTREEFILTER_MAXRESULTS ? count++ : count-1);
+        while (pos > 0 && scores[pos-1] < score)
+        {
+            scores[pos] = scores[pos-1];
+            indexes[pos] = indexes[pos-1];
+            pos--;
+        }
+        scores[pos] = score;
+        indexes[pos] = (int)i;
+    }
+    results->Alloc(count);
+    for (size_t i=0; i<count; ++i) results->Add(indexes[i]);
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+int ProjectTreeFilter::ScoreEntry(const wxChar* query, size_t length, wxUint32 mask, size_t index) const
+/**
+ * \brief Compares the query with the name of an entry. Every found
+ * character counts, a character at the start of the name or of a word
+ * and consecutive characters count more. Shorter names are better.
+ * If the name does not match, the path is compared.
+ * \param query The normalized query.
+ * \param length Length of the query.
+ * \param mask The characters of the query, see GetMask().
+ * \param index Index of the entry.
+ * \return The score or 0 if the entry does not match.
+ **/
+{
+    const Entry& entry = m_entries[index];
+    const wxChar* name = m_names + entry.offset;
+    if ((entry.mask & mask) == mask && length <= entry.length)
+    {
+        int score = 0;
+        size_t found = 0;
+        bool consecutive = false;
+        for (size_t i=0; i<entry.length && found<length; ++i)
+        {
+            if (name[i] != query[found]) {
+                consecutive = false;
+                continue;
+            }
+            score += 4;
+            if (consecutive) score += 4;
+            if (i == 0) score += 8;
+            else if (!wxIsalnum(name[i-1])) score += 6;
+            consecutive = true;
+            found++;
+        }
+        if (found == length)
+        {
+            if (length == entry.length) score += 16;
+            int penalty = (int)(entry.length < 255 ? entry.length : 255);
+            return (1000 + score*16 - penalty);
+        }
+    }
+    if (MatchPath(query, length, index)) return (100);
+    return (0);
+}
+
+
+//----------------------------------------------------------------
+bool ProjectTreeFilter::MatchPath(const wxChar* query, size_t length, size_t index) const
+/**
+ * \brief Checks if the characters of the query appear in the path of
+ * an entry. The path consists of the names of the parents and the
+ * name of the entry, separated by '/'. The path is compared backwards,
+ * so it does not have to be built.
+ * \param query The normalized query.
+ * \param length Length of the query.
+ * \param index Index of the entry.
+ * \return True if the path matches; false otherwise.
+ **/
+{
+    size_t left = length;
+    int current = (int)index;
+    while (current >= 0 && left > 0)
+    {
+        const Entry& entry = m_entries[current];
+        const wxChar* name = m_names + entry.offset;
+        for (size_t i=entry.length; i>0 && left>0; --i)
+        {
+            if (name[i-1] == query[left-1]) left--;
+        }
+        if (left > 0 && entry.parent >= 0 && query[left-1] == _T('/')) left--;
+        current = entry.parent;
+    }
+    return (left == 0);
+}
+
+
+//----------------------------------------------------------------
+wxString ProjectTreeFilter::GetQuery(const wxString& query)
+/**
+ * \brief Normalizes a query, the query is lower case, backslashes
+ * are replaced by slashes and whitespaces are removed.
+ * \param query The query as entered.
+ * \return The normalized query.
+ **/
+{
+    wxString result;
+    result.Alloc(query.Length());
+    for (size_t i=0; i<query.Length(); ++i)
+    {
+        wxChar ch = query[i];
+        if (wxIsspace(ch)) continue;
+        if (ch == _T('\\')) ch = _T('/');
+        result.Append((wxChar)wxTolower(ch));
+    }
+    return (result);
+}
+
+
+//----------------------------------------------------------------
+wxUint32 ProjectTreeFilter::GetMask(const wxChar* text, size_t length)
+/**
+ * \brief Returns a bit mask of the characters in a lower case text.
+ * Every letter has its own bit, digits, separators and all other
+ * characters share a bit.
+ * \param text The text.
+ * \param length Length of the text.
+ * \return The bit mask.
+ **/
+{
+    wxUint32 mask = 0;
+    for (size_t i=0; i<length; ++i)
+    {
+        wxChar ch = text[i];
+        if (ch >= _T('a') && ch <= _T('z')) mask |= 1u << (ch - _T('a'));
+        else if (ch >= _T('0') && ch <= _T('9')) mask |= 1u << 26;
+        else if (ch == _T('.')) mask |= 1u << 27;
+        else if (ch == _T('_') || ch == _T('-')) mask |= 1u << 28;
+        else if (ch == _T('/')) mask |= 1u << 29;
+        else mask |= 1u << 30;
+    }
+    return (mask);
+}
+
+} // namespace penv
@@ -0,0 +1,121 @@
+/*
+ * projecttreefilter.h - Declaration of the ProjectTreeFilter class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_UI_PROJECTTREEFILTER_H_
+#define _PENV_UI_PROJECTTREEFILTER_H_
+
+#include "../wxincludes.h"
+#include "../workspacelist.h"
+#include "../projectitemlist.h"
+#include "../container/objarray.h"
+#include "projecttreeitemdatabase.h"
+
+
+/**
+ * \brief Definition of the maximum number of results of a search.
+ **/
+#define penvPROJECTTREEFILTER_MAXRESULTS 100
+
+/**
+ * \brief Definition of the number of entries, which are compared
+ * before the thread checks if the search is cancelled.
+ **/
+#define penvPROJECTTREEFILTER_CHECKCOUNT 1024
+
+
+namespace penv {
+
+class ProjectTreeFilterThread;
+
+/**
+ * \brief The ProjectTreeFilter class searches the workspaces, projects
+ * and project items by their name or path for the filter of the
+ * ProjectTreeCtrl. The characters of the query must appear in the same
+ * order in the name, but not necessarily one after another (fuzzy
+ * search), so 'ptc' finds 'projecttreectrl.cpp'. Matches at the start
+ * of the name or a word and consecutive matches get a better score. If
+ * the name does not match, the path (the names of the parents separated
+ * by '/') is searched.<br>
+ * The names are stored lower case one after another in one buffer, with
+ * a bit mask of the contained characters for every entry. Entries which
+ * do not contain all characters of the query are skipped by comparing
+ * the masks. The index is built with Build() on the main thread and must
+ * be rebuilt after the items have changed.<br>
+ * Search() starts a search on the worker thread and cancels the previous
+ * search. The thread posts penvCE_ProjectTreeFilterFinished, when the
+ * best penvPROJECTTREEFILTER_MAXRESULTS results can be read with
+ * GetResults().
+ **/
+class ProjectTreeFilter
+{
+    public:
+        friend class ProjectTreeFilterThread;
+        ProjectTreeFilter();
+        ~ProjectTreeFilter();
+    private:
+        ProjectTreeFilter(const ProjectTreeFilter& filter);
+        ProjectTreeFilter& operator=(const ProjectTreeFilter& filter);
+
+    public:
+        void Build(WorkspaceList* list);
+        void Invalidate();
+        bool IsValid() const;
+        size_t Count() const;
+
+        void Search(const wxString& query);
+        void Cancel();
+        bool GetResults(wxArrayInt* results);
+        size_t Find(const wxString& query, wxArrayInt* results);
+
+        ProjectTreeItemDataBase* GetEntry(size_t index, int* parent);
+
+    private:
+        /**
+         * \brief A searchable item, the name is stored in the buffer
+         * of the filter.
+         **/
+        struct Entry
+        {
+            size_t offset;
+            size_t length;
+            int parent;
+            wxUint32 mask;
+            wxUint32 pathmask;
+        };
+
+        void Clear();
+        int AddEntry(ProjectTreeItemDataBase* data, const wxString& name, int parent);
+        void AddEntries(ProjectItemList* list, int parent);
+        bool DoFind(const wxString& query, wxArrayInt* results, int generation);
+        int ScoreEntry(const wxChar* query, size_t length, wxUint32 mask, size_t index) const;
+        bool MatchPath(const wxChar* query, size_t length, size_t index) const;
+        static wxString GetQuery(const wxString& query);
+        static wxUint32 GetMask(const wxChar* text, size_t length);
+
+    private:
+        wxMutex m_mutex;
+        wxMutex m_indexmutex;
+        Entry* m_entries;
+        size_t m_count;
+        size_t m_capacity;
+        wxChar* m_names;
+        size_t m_namessize;
+        size_t m_namescapacity;
+        Array<ProjectTreeItemDataBase>* m_items;
+        bool m_valid;
+        wxString m_query;
+        int m_generation;
+        wxArrayInt m_results;
+        bool m_hasresults;
+        ProjectTreeFilterThread* m_thread;
+        bool m_stop;
+};
+
+} // namespace penv
+
+#endif // _PENV_UI_PROJECTTREEFILTER_H_
@@ -17,6 +17,7 @@
 #include "../projectitem.h"
 #include "projecttreeitemtype.h"
 #include "projecttreeitemdatabase.h"
+#include "../memorypool.h"
 
 namespace penv {
 
@@ -29,6 +30,7 @@ namespace penv {
  **/
 class ProjectTreeItemData : public ProjectTreeItemDataBase, public wxTreeItemData
 {
+    DECLARE_MEMORYPOOL_OPERATORS()
     public:
         ProjectTreeItemData();
         ProjectTreeItemData(Project* project);
@@ -26,6 +26,7 @@ ProjectTreeItemDataObject::ProjectTreeItemDataObject()
  **/
 {
     m_treeitemformat.SetId(penvProjectTreeItemDataFormat);
+    m_items = new Array<ProjectTreeItemDataBase>(true);
 }
 
 
@@ -41,6 +42,8 @@ ProjectTreeItemDataObject::ProjectTreeItemDataObject(Project* project)
  **/
 {
     m_treeitemformat.SetId(penvProjectTreeItemDataFormat);
+    m_items = new Array<ProjectTreeItemDataBase>(true);
+    m_items->Add(new ProjectTreeItemDataBase(project));
 }
 
 
@@ -56,6 +59,8 @@ ProjectTreeItemDataObject::ProjectTreeItemDataObject(Workspace* workspace)
  **/
 {
     m_treeitemformat.SetId(penvProjectTreeItemDataFormat);
+    m_items = new Array<ProjectTreeItemDataBase>(true);
+    m_items->Add(new ProjectTreeItemDataBase(workspace));
 }
 
 
@@ -71,6 +76,8 @@ ProjectTreeItemDataObject::ProjectTreeItemDataObject(ProjectItem* item)
  **/
 {
     m_treeitemformat.SetId(penvProjectTreeItemDataFormat);
+    m_items = new Array<ProjectTreeItemDataBase>(true);
+    m_items->Add(new ProjectTreeItemDataBase(item));
 }
 
 
@@ -81,7 +88,7 @@ ProjectTreeItemDataObject::~ProjectTreeItemDataObject()
  * \brief Destructor.
  **/
 {
-    // Nothing to do.
+    delete m_items;
 }
 
 
@@ -89,37 +96,98 @@ ProjectTreeItemDataObject::~ProjectTreeItemDataObject()
 ProjectTreeItemDataBase* ProjectTreeItemDataObject::Clone() const
 /**
  * \brief Clones this object into the returning object.
- * Only the pointer for the spezial type will be cloned,
- * all others are initialized with NULL.
+ * Only the pointers for the spezial types of the items will be
+ * cloned, all others are initialized with NULL.
  * \return Cloned object of this class.
  **/
 {
-    if (m_type == penvTI_Project) {
-        return (new ProjectTreeItemDataObject(m_project));
+    ProjectTreeItemDataObject* object = new ProjectTreeItemDataObject();
+    for (size_t i=0; i<m_items->Count(); ++i)
+    {
+        ProjectTreeItemDataBase* data = m_items->ItemUnchecked(i)->Clone();
+        if (data != NULL) object->Add(data);
     }
-    else if (m_type == penvTI_ProjectItem) {
-        return (new ProjectTreeItemDataObject(m_item));
+    return (object);
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeItemDataObject::Add(ProjectTreeItemDataBase* data)
+/**
+ * \brief Adds an item to this object. The first item is also
+ * returned by the methods of ProjectTreeItemDataBase.
+ * \param data The item, this object takes the ownership.
+ **/
+{
+    if (data == NULL)
+    {
+        wxLogError(_T("[penv::ProjectTreeItemDataObject::Add] Argument 'data' is NULL."));
+        return;
     }
-    else if (m_type == penvTI_Workspace) {
-        return (new ProjectTreeItemDataObject(m_workspace));
+    if (m_items->Count() == 0)
+    {
+        m_project = data->GetProject();
+        m_workspace = data->GetWorkspace();
+        m_item = data->GetProjectItem();
+        m_type = data->GetType();
     }
-    return (NULL);
+    m_items->Add(data);
 }
 
 
+//----------------------------------------------------------------
+size_t ProjectTreeItemDataObject::Count() const
+/**
+ * \brief Returns the number of items in this object.
+ * \return Number of items.
+ **/
+{
+    return (m_items->Count());
+}
+
+
+//----------------------------------------------------------------
+ProjectTreeItemDataBase* ProjectTreeItemDataObject::GetItem(size_t index)
+/**
+ * \brief Returns an item by its index.
+ * \param index Index of the item.
+ * \return The item or NULL if the index is out of range.
+ **/
+{
+    if (index >= m_items->Count())
+    {
+        wxLogError(_T("[penv::ProjectTreeItemDataObject::GetItem] Index is out of range."));
+        return (NULL);
+    }
+    return (m_items->ItemUnchecked(index));
+}
+
+
+//----------------------------------------------------------------
+void ProjectTreeItemDataObject::Clear()
+/**
+ * \brief Removes all items from this object.
+ **/
+{
+    m_items->Clear();
+    m_project = NULL;
+    m_workspace = NULL;
+    m_item = NULL;
+    m_type = penvTI_ProjectItem;
+}
 
 
 //----------------------------------------------------------------
 size_t ProjectTreeItemDataObject::GetDataSize() const
 /**
  * \brief Returns the data size for the serialized data
- * in this class.
+ * in this class. The data contains the number of items and the
+ * pointers and the type of every item.
  * \return Data size of this class.
  **/
 {
-    int size = 0;
-    size += (sizeof(m_project)*3);
-    size += sizeof(m_type);
+    size_t size = sizeof(wxUint32);
+    size += m_items->Count()*(sizeof(m_project)*3 + sizeof(m_type));
     return (size);
 }
 
@@ -135,10 +203,22 @@ bool ProjectTreeItemDataObject::GetDataHere(void* buffer) const
 {
     int ptrsize = sizeof(m_project);
     unsigned char* bytebuffer = (unsigned char*)buffer;
-    memcpy((void*)(bytebuffer),             (void*)(&m_project),     ptrsize);
-    memcpy((void*)(bytebuffer + ptrsize),   (void*)(&m_workspace),   ptrsize);
-    memcpy((void*)(bytebuffer + ptrsize*2), (void*)(&m_item),        ptrsize);
-    memcpy((void*)(bytebuffer + ptrsize*3), (void*)(&m_type),        sizeof(m_type));
+    wxUint32 count = (wxUint32)m_items->Count();
+    memcpy((void*)(bytebuffer), (void*)(&count), sizeof(count));
+    bytebuffer += sizeof(count);
+    for (size_t i=0; i<m_items->Count(); ++i)
+    {
+        ProjectTreeItemDataBase* data = m_items->ItemUnchecked(i);
+        Project* project = data->GetProject();
+        Workspace* workspace = data->GetWorkspace();
+        ProjectItem* item = data->GetProjectItem();
+        ProjectTreeItemType type = data->GetType();
+        memcpy((void*)(bytebuffer),             (void*)(&project),     ptrsize);
+        memcpy((void*)(bytebuffer + ptrsize),   (void*)(&workspace),   ptrsize);
+        memcpy((void*)(bytebuffer + ptrsize*2), (void*)(&item),        ptrsize);
+        memcpy((void*)(bytebuffer + ptrsize*3), (void*)(&type),        sizeof(type));
+        bytebuffer += ptrsize*3 + sizeof(type);
+    }
     return (true);
 }
 
@@ -148,18 +228,41 @@ bool ProjectTreeItemDataObject::GetDataHere(void* buffer) const
 bool ProjectTreeItemDataObject::SetData(size_t len, const void *buf)
 /**
  * \brief Copy the data from the buffer, return true on success.
+ * The previous items of this object are removed.
  * \param len Length of the buffer.
  * \param buffer The buffer to read from.
  * \return True on success; false otherwise.
  **/
 {
     int ptrsize = sizeof(m_project);
-    if (GetDataSize() != len) return (false);
+    size_t itemsize = ptrsize*3 + sizeof(m_type);
+    if (len < sizeof(wxUint32)) return (false);
     unsigned char* bytebuffer = (unsigned char*)buf;
-    memcpy((void*)(&m_project),  (void*)(bytebuffer),               ptrsize);
-    memcpy((void*)(&m_workspace),(void*)(bytebuffer + ptrsize),     ptrsize);
-    memcpy((void*)(&m_item),     (void*)(bytebuffer + ptrsize*2),   ptrsize);
-    memcpy((void*)(&m_type),     (void*)(bytebuffer + ptrsize*3),   sizeof(m_type));
+    wxUint32 count;
+    memcpy((void*)(&count), (void*)(bytebuffer), sizeof(count));
+    if (len != sizeof(count) + count*itemsize) return (false);
+    bytebuffer += sizeof(count);
+    Clear();
+    m_items->Reserve(count);
+    for (size_t i=0; i<count; ++i)
+    {
+        Project* project;
+        Workspace* workspace;
+        ProjectItem* item;
+        ProjectTreeItemType type;
+        memcpy((void*)(&project),  (void*)(bytebuffer),               ptrsize);
+        memcpy((void*)(&workspace),(void*)(bytebuffer + ptrsize),     ptrsize);
+        memcpy((void*)(&item),     (void*)(bytebuffer + ptrsize*2),   ptrsize);
+        memcpy((void*)(&type),     (void*)(bytebuffer + ptrsize*3),   sizeof(type));
+        bytebuffer += itemsize;
+        if (type == penvTI_Project) {
+            Add(new ProjectTreeItemDataBase(project));
+        } else if (type == penvTI_Workspace) {
+            Add(new ProjectTreeItemDataBase(workspace));
+        } else {
+            Add(new ProjectTreeItemDataBase(item));
+        }
+    }
     return (true);
 }
 
@@ -16,6 +16,7 @@
 #include "../projectitem.h"
 #include "projecttreeitemtype.h"
 #include "projecttreeitemdatabase.h"
+#include "../container/objarray.h"
 
 
 namespace penv {
@@ -33,7 +34,11 @@ extern const wxChar* penvProjectTreeItemDataFormat;
  * \brief The ProjectTreeItemDataObject class holds information for a treeitem
  * and implements this information for a data object. The data object will
  * be used to do drag and drop operations on the tree ctrl. The information
- * for the tree item is the appropriate item connected to the tree item.
+ * for the tree item is the appropriate item connected to the tree item.<br>
+ * The data object carries a list of items, so a multiple selection can
+ * be moved, copied or removed at once. The ProjectTreeItemDataBase part
+ * of this object is the first item of the list. The items are serialized
+ * as raw pointers and are only valid in this process.
  **/
 class ProjectTreeItemDataObject : public ProjectTreeItemDataBase, public wxDataObjectSimple
 {
@@ -46,6 +51,11 @@ class ProjectTreeItemDataObject : public ProjectTreeItemDataBase, public wxDataO
 
         virtual ProjectTreeItemDataBase* Clone() const;
 
+        void Add(ProjectTreeItemDataBase* data);
+        size_t Count() const;
+        ProjectTreeItemDataBase* GetItem(size_t index);
+        void Clear();
+
         virtual size_t GetDataSize() const;
         virtual bool GetDataHere(void *buf) const;
         virtual bool SetData(size_t len, const void *buf);
@@ -59,6 +69,7 @@ class ProjectTreeItemDataObject : public ProjectTreeItemDataBase, public wxDataO
 
     protected:
         wxDataFormat m_treeitemformat;
+        Array<ProjectTreeItemDataBase>* m_items;
 };
 
 } // namespace penv
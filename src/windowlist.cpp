@@ -10,6 +10,7 @@
 #include "windowlist.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "environment.h"
 
 namespace penv {
@@ -435,7 +436,7 @@ bool WindowList::CloseAll(bool documentsonly, bool canveto)
         {
             wxLogError(_T("[penv::WindowList::CloseAll] The given window type cannot be closed."));
         }
-        Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_WINDOW_CLOSED"), variant);
+        Environment::Get()->GetCommandList()->Execute(penvCE_WindowClosed, variant);
     }
     m_manager->Update();
     return (result);
@@ -521,7 +522,7 @@ bool WindowList::Close(const wxString& id, bool canveto)
     {
         wxLogError(_T("[penv::WindowList::Close] The given window type cannot be closed."));
     }
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_WINDOW_CLOSED"), variant);
+    Environment::Get()->GetCommandList()->Execute(penvCE_WindowClosed, variant);
     return (true);
 }
 
@@ -590,7 +591,7 @@ bool WindowList::Register(Window* window)
     }
     (*m_registered)[window->GetClassId()] = window;
     wxVariant variant(window->GetClassId());
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_WINDOW_REGISTERED"), variant);
+    Environment::Get()->GetCommandList()->Execute(penvCE_WindowRegistered, variant);
     return (true);
 }
 
@@ -617,7 +618,7 @@ bool WindowList::Unregister(const wxString& classid)
         return (false);
     }
     wxVariant variant(classid);
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_WINDOW_UNREGISTERED"), variant);
+    Environment::Get()->GetCommandList()->Execute(penvCE_WindowUnregistered, variant);
     return (true);
 }
 
@@ -692,6 +693,9 @@ void WindowList::CallPageChanged(wxWindow* newwin, wxWindow* oldwin)
  * \param oldwin The old window from which the notebook changed.
  **/
 {
+    // Documents change the state of their commands, so update
+    //  the toolbars only once after both documents are called
+    CommandUpdateLocker locker(Environment::Get()->GetCommandList());
     Window* newwindow = NULL;
     Window* oldwindow = NULL;
     WindowsHashMap::iterator itr;
@@ -783,6 +787,7 @@ wxXmlNode* WindowList::WriteNode(bool registered)
  **/
 {
     wxXmlNode* node = PenvHelper::CreateXmlNode(_T("windows"));
+    XmlNodeBuilder builder(node);
     if (registered)
     {
         node->AddProperty(_T("listtype"), _T("registered"));
@@ -803,7 +808,7 @@ wxXmlNode* WindowList::WriteNode(bool registered)
             wxXmlNode* destroyonclosenode = PenvHelper::CreateXmlNode(_T("destroyonclose"),
                 PenvHelper::CreateBoolean(pane->IsDestroyOnClose()));
             PenvHelper::AddXmlChildNode(winnode, destroyonclosenode);
-            PenvHelper::AddXmlChildNode(node, winnode);
+            builder.Append(winnode);
         }
     }
     else
@@ -864,7 +869,7 @@ bool WindowList::AddDocument(WindowDocument* window, bool show)
         return (false);
     }
     wxVariant variant(window->GetId());
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_WINDOW_ADDED"), variant);
+    Environment::Get()->GetCommandList()->Execute(penvCE_WindowAdded, variant);
     return (true);
 }
 
@@ -901,7 +906,7 @@ bool WindowList::AddPane(WindowPane* window, bool show)
     // Manager must be updated after adding pane
     m_manager->Update();
     wxVariant variant(window->GetId());
-    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_WINDOW_ADDED"), variant);
+    Environment::Get()->GetCommandList()->Execute(penvCE_WindowAdded, variant);
     return (true);
 }
 
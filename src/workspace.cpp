@@ -25,6 +25,8 @@ Workspace::Workspace()
 {
     m_name = wxEmptyString;
     m_modified = false;
+    m_modifiedprojects = 0;
+    m_parent = NULL;
     m_projects = new ProjectList(this);
     m_properties = new PropertyList();
 }
@@ -36,6 +38,9 @@ Workspace::~Workspace()
  * \brief Destructor.
  **/
 {
+    // Zuerst aus der Liste loesen, damit die Projekte beim Loeschen
+    // die Zaehler der Liste nicht mehr veraendern
+    SetParent(NULL);
     if (m_projects != NULL) delete m_projects;
     if (m_properties != NULL) delete m_properties;
 }
@@ -61,7 +66,7 @@ void Workspace::SetName(const wxString& name)
  **/
 {
     m_name = name;
-    m_modified = true;
+    Modified(true);
 }
 
 
@@ -80,11 +85,57 @@ bool Workspace::IsModified() const
 //----------------------------------------------------------------
 void Workspace::Modified(bool modified)
 /**
- * \brief Sets if workspace was changed.
+ * \brief Sets if workspace was changed. The modified counter of the
+ * WorkspaceList is only updated if the state changes.
  * \param modified True if workspace modified; false otherwise.
  **/
 {
+    if (m_modified == modified) return;
     m_modified = modified;
+    if (m_parent != NULL) m_parent->AddModified(modified ? 1 : -1);
+}
+
+
+//----------------------------------------------------------------
+size_t Workspace::GetModifiedProjectCount() const
+/**
+ * \brief Returns the number of modified projects in this workspace.
+ * The number is counted while the projects are marked as modified,
+ * so this method does not iterate over the projects.
+ * \return Number of modified projects.
+ **/
+{
+    return (m_modifiedprojects);
+}
+
+
+//----------------------------------------------------------------
+void Workspace::SetParent(WorkspaceList* parent)
+/**
+ * \brief Sets the WorkspaceList which contains this workspace (private).
+ * The modified workspace and projects are moved from the counter
+ * of the old list to the counter of the new list.
+ * \param parent The list or NULL.
+ **/
+{
+    int count = (int)m_modifiedprojects + (m_modified ? 1 : 0);
+    if (m_parent != NULL) m_parent->AddModified(-count);
+    m_parent = parent;
+    if (m_parent != NULL) m_parent->AddModified(count);
+}
+
+
+//----------------------------------------------------------------
+void Workspace::AddModifiedProjects(int count)
+/**
+ * \brief Changes the number of modified projects in this workspace
+ * (private). Called by the projects, when their modified state changes.
+ * \param count Number of projects, which are now modified (positive)
+ * or are no longer modified (negative).
+ **/
+{
+    m_modifiedprojects += count;
+    if (m_parent != NULL) m_parent->AddModified(count);
 }
 
 
@@ -120,7 +171,7 @@ void Workspace::SetFileName(const wxFileName& filename)
  **/
 {
     m_filename = filename;
-    m_modified = true;
+    Modified(true);
 }
 
 
@@ -133,7 +184,7 @@ void Workspace::SetFileName(const wxString& filename)
  **/
 {
     m_filename.SetPath(filename);
-    m_modified = true;
+    Modified(true);
 }
 
 
@@ -196,7 +247,10 @@ Workspace* Workspace::Clone()
     Workspace* workspace = new Workspace();
     workspace->m_name = m_name;
     workspace->m_modified = false;
+    delete workspace->m_projects;
     workspace->m_projects = m_projects->Clone();
+    workspace->m_projects->SetParent(workspace);
+    delete workspace->m_properties;
     workspace->m_properties = m_properties->Clone();
     return (workspace);
 }
@@ -209,6 +263,33 @@ bool Workspace::ReadNode(wxXmlNode* node)
  * \param node The 'workspace' xml element node.
  * \return True on success; false otherwise.
  **/
+{
+    if (!ReadReference(node)) return (false);
+    wxString path = m_filename.GetPath();
+    if (!wxFile::Exists(path))
+    {
+        wxLogError(_T("[penv::Workspace::ReadNode] Workspace filename '%s' does not exist."), path.c_str());
+        return (false);
+    }
+    if (!Load())
+    {
+        wxLogError(_T("[penv::Workspace::ReadNode] Reading workspace filename '%s' failed."), path.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool Workspace::ReadReference(wxXmlNode* node)
+/**
+ * \brief Reads out the name and the filename from a 'workspace' xml
+ * element node, without loading the workspace file and without checking
+ * if the file exists. Used by ReadNode() and by WorkspaceList::ReadNode(),
+ * which checks all workspace files at once with a PathChecker.
+ * \param node The 'workspace' xml element node.
+ * \return True on success; false otherwise.
+ **/
 {
     if (node == NULL)
     {
@@ -220,26 +301,15 @@ bool Workspace::ReadNode(wxXmlNode* node)
         wxLogError(_T("[penv::Workspace::ReadNode] Node should be an element node with name 'workspace'."));
         return (false);
     }
-    wxString path;
     if (!node->GetPropVal(_T("name"), &m_name))
     {
         wxLogWarning(_T("[penv::Workspace::ReadNode] Name for workspace not spezified, using empty string."));
         m_name = wxEmptyString;
     }
-    path = node->GetNodeContent();
+    wxString path = node->GetNodeContent();
     wxString workspacepath = Path::RemoveLastEntry(Environment::Get()->GetWorkspacesFile(false));
     path = Path::Combine(workspacepath, path);
-    if (!wxFile::Exists(path))
-    {
-        wxLogError(_T("[penv::Workspace::ReadNode] Workspace filename '%s' does not exist."), path.c_str());
-        return (false);
-    }
     m_filename.SetPath(path);
-    if (!Load())
-    {
-        wxLogError(_T("[penv::Workspace::ReadNode] Reading workspace filename '%s' failed."), path.c_str());
-        return (false);
-    }
     return (true);
 }
 
@@ -260,6 +330,38 @@ wxXmlNode* Workspace::WriteNode()
 
 
 
+//----------------------------------------------------------------
+bool Workspace::ReadSnapshot(SnapshotReader* reader)
+/**
+ * \brief Reads the workspace with all its projects from a snapshot
+ * instead of the workspace file. See WorkspaceList::ReadSnapshot().
+ * \param reader The SnapshotReader.
+ * \return True on success; false otherwise.
+ **/
+{
+    m_name = reader->ReadString();
+    m_filename.SetPath(reader->ReadString());
+    if (!m_properties->ReadSnapshot(reader)) return (false);
+    return (m_projects->ReadSnapshot(reader));
+}
+
+
+//----------------------------------------------------------------
+void Workspace::WriteSnapshot(SnapshotWriter* writer)
+/**
+ * \brief Writes the workspace with all its projects into a snapshot.
+ * See WorkspaceList::WriteSnapshot().
+ * \param writer The SnapshotWriter.
+ **/
+{
+    writer->WriteString(m_name);
+    writer->WriteString(m_filename.GetPath());
+    m_properties->WriteSnapshot(writer);
+    m_projects->WriteSnapshot(writer);
+}
+
+
+
 //----------------------------------------------------------------
 bool Workspace::Save()
 /**
@@ -268,86 +370,91 @@ bool Workspace::Save()
  * \return True on success, otherwise false.
  **/
 {
-    wxXmlDocument doc;
-    doc.SetFileEncoding(_T("UTF-8"));
-    wxXmlNode* rootnode = PenvHelper::CreateXmlNode(_T("workspace"));
-    doc.SetRoot(rootnode);
-    wxXmlNode * nodename = PenvHelper::CreateXmlNode(_T("name"), m_name);
-    PenvHelper::AddXmlChildNode(rootnode, nodename);
-
+    wxString filename = m_filename.GetPath();
     wxXmlNode* projects = m_projects->WriteNode();
     if(projects == NULL)
     {
-        wxLogError(_T("[penv::Workspace::Save] Could not save workspace file '%s'."), m_filename.GetPath().c_str());
+        wxLogError(_T("[penv::Workspace::Save] Could not save workspace file '%s'."), filename.c_str());
         return (false);
     }
-    PenvHelper::AddXmlChildNode(rootnode, projects);
-
-    wxXmlNode* properties = m_properties->WriteNode();
-    if(properties == NULL)
+    XmlWriter writer;
+    if (!writer.Open(filename))
     {
-        wxLogError(_T("[penv::Workspace::Save] Could not save workspace file '%s'."), m_filename.GetPath().c_str());
+        wxLogError(_T("[penv::Workspace::Save] Could not create workspace file '%s'."), filename.c_str());
+        delete projects;
+        return (false);
+    }
+    writer.WriteStartElement(_T("workspace"));
+    writer.WriteElement(_T("name"), m_name);
+    writer.WriteNode(projects);
+    delete projects;
+    m_properties->WriteNode(&writer);
+    writer.WriteEndElement();
+    if (!writer.Close())
+    {
+        wxLogError(_T("[penv::Workspace::Save] Could not write workspace file '%s'."), filename.c_str());
         return (false);
     }
-    PenvHelper::AddXmlChildNode(rootnode, properties);
     return (true);
 }
 
 
 //----------------------------------------------------------------
-bool Workspace::Load()
+bool Workspace::Load(ProjectLoader* loader)
 /**
  * \brief Reads out the appropriate workspace file.
  * The structure of workspace file is defined in class destription.
+ * The file is read with a XmlReader, only the small 'projects' node
+ * is read into a xml node.
+ * \param loader If not NULL, the projects are only added to this
+ * loader and not loaded. See ProjectList::ReadNode().
  * \return True on success, otherwise false.
  **/
 {
     wxString filename = m_filename.GetPath();
-    wxXmlDocument doc(filename, _T("UTF-8"));
-    if (!doc.IsOk())
+    XmlReader reader;
+    if (!reader.Open(filename) || !reader.ReadRootElement())
     {
-        wxLogError(_T("[penv::Workspace::ReadXmlDocument] Could not read file '%s'."), filename.c_str());
+        wxLogError(_T("[penv::Workspace::Load] Could not read file '%s'. %s"), filename.c_str(), reader.GetError().c_str());
         return (false);
     }
-    wxXmlNode* root = doc.GetRoot();
-    if (root->GetType() != wxXML_ELEMENT_NODE || root->GetName() != _T("workspace"))
+    if (reader.GetName() != _T("workspace"))
     {
-        wxLogError(_T("[penv::Workspace::ReadXmlDocument] Node should be an element node with name 'workspace'."));
+        wxLogError(_T("[penv::Workspace::Load] Node should be an element node with name 'workspace'."));
         return (false);
     }
-    wxXmlNode* node = root->GetChildren();
-    while (node != NULL)
+    size_t depth = reader.GetDepth();
+    while (reader.NextChild(depth))
     {
-        if (node->GetType() ==  wxXML_ELEMENT_NODE)
+        if (reader.GetName() == _T("name"))
         {
-            if (node->GetName() == _T("name"))
+            wxString name = reader.ReadElementContent();
+            if (!name.IsEmpty())
             {
-                wxString name = node->GetNodeContent();
-                if (!name.IsEmpty())
-                {
-                    m_name = name;
-                }
+                m_name = name;
             }
-            else if (node->GetName() == _T("projects"))
+        }
+        else if (reader.GetName() == _T("projects"))
+        {
+            wxXmlNode* node = reader.ReadSubtree();
+            if (!m_projects->ReadNode(node, loader))
             {
-                if (!m_projects->ReadNode(node))
-                {
-                    wxLogError(_T("[penv::Workspace::ReadXmlDocument] Failed reading 'projects' node from workspace file '%s'."), filename.c_str());
-                    node = node->GetNext();
-                    continue;
-                }
+                wxLogError(_T("[penv::Workspace::Load] Failed reading 'projects' node from workspace file '%s'."), filename.c_str());
             }
-            else if (node->GetName() == _T("properties"))
+            delete node;
+        }
+        else if (reader.GetName() == _T("properties"))
+        {
+            if (!m_properties->ReadNode(&reader))
             {
-                if (!m_properties->ReadNode(node))
-                {
-                    wxLogError(_T("[penv::Workspace::ReadXmlDocument] Failed reading 'properties' node from workspace file '%s'."), filename.c_str());
-                    node = node->GetNext();
-                    continue;
-                }
+                wxLogError(_T("[penv::Workspace::Load] Failed reading 'properties' node from workspace file '%s'."), filename.c_str());
             }
         }
-        node = node->GetNext();
+    }
+    if (reader.HasError())
+    {
+        wxLogError(_T("[penv::Workspace::Load] Error in file '%s': %s"), filename.c_str(), reader.GetError().c_str());
+        return (false);
     }
     return (true);
 }
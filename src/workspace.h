@@ -15,6 +15,8 @@
 
 namespace penv {
 
+class WorkspaceList;
+class ProjectLoader;
 
 /**
  * \brief The Workspace class holds every information about a workspace.
@@ -43,6 +45,9 @@ namespace penv {
 class Workspace : public PenvItem
 {
     public:
+        friend class WorkspaceList;
+        friend class ProjectList;
+        friend class Project;
         Workspace();
         ~Workspace();
 
@@ -51,6 +56,7 @@ class Workspace : public PenvItem
 
         bool IsModified() const;
         void Modified(bool modified=true);
+        size_t GetModifiedProjectCount() const;
 
         const wxFileName& GetFileName() const;
         wxString GetFileNameString() const;
@@ -67,14 +73,23 @@ class Workspace : public PenvItem
 
         bool ReadNode(wxXmlNode* node);
         wxXmlNode* WriteNode();
+        bool ReadSnapshot(SnapshotReader* reader);
+        void WriteSnapshot(SnapshotWriter* writer);
 
         bool Save();
-        bool Load();
+        bool Load(ProjectLoader* loader = NULL);
+
+    private:
+        bool ReadReference(wxXmlNode* node);
+        void SetParent(WorkspaceList* parent);
+        void AddModifiedProjects(int count);
 
     protected:
         wxString m_name;
         wxFileName m_filename;
         bool m_modified;
+        size_t m_modifiedprojects;
+        WorkspaceList* m_parent;
         ProjectList* m_projects;
         PropertyList* m_properties;
         wxTreeItemId m_treeitem;
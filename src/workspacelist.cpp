@@ -10,9 +10,14 @@
 #include "workspacelist.h"
 #include "expect.h"
 #include "penvhelper.h"
+#include "xmlnodebuilder.h"
 #include "environment.h"
 #include "commandlist.h"
+#include "pathchecker.h"
+#include "projectloader.h"
+#include "directorywatcher.h"
 #include "ui/projecttreeitemdata.h"
+#include <algorithm>
 
 
 
@@ -26,9 +31,11 @@ WorkspaceList::WorkspaceList()
  **/
 {
     m_array = new Array<Workspace>();
+    m_modifiedcount = 0;
+    m_watcher = new DirectoryWatcher();
     // Connect the WorkspaceList command to the workspace
     CommandList* list = Environment::Get()->GetCommandList();
-    Command* cmd = list->GetCommand(_T("PENV_EVT_PROJECTTREECTRL_ITEM_ACTIVATED"));
+    Command* cmd = list->GetCommand(penvCE_ProjectTreeCtrlItemActivated);
     if (cmd != NULL) {
         cmd->Connect(new CommandCallback<WorkspaceList>(this,&WorkspaceList::OnItemActivated));
     }
@@ -41,6 +48,8 @@ WorkspaceList::~WorkspaceList()
  **/
 {
     if (m_array != NULL) delete m_array;
+    // Erst nach den Verzeichnissen loeschen, die sich hier abmelden
+    if (m_watcher != NULL) delete m_watcher;
 }
 
 
@@ -69,16 +78,9 @@ int WorkspaceList::GetItemIndex(Workspace* workspace)
  * \return Index of the workspace on success; -1 if not found.
  **/
 {
-    int index = -1;
-
-    for(size_t i = 0; i < m_array->Count(); i++)
-    {
-        if (workspace == m_array->ItemPtr(i)) {
-            index = i;
-            break;
-        }
-    }
-    return index;
+    Array<Workspace>::iterator itr = std::find(m_array->begin(), m_array->end(), workspace);
+    if (itr == m_array->end()) return (-1);
+    return (int)(itr - m_array->begin());
 }
 
 
@@ -95,6 +97,7 @@ bool WorkspaceList::Add(Workspace* workspace)
         return (false);
     }
     m_array->Add(workspace);
+    workspace->SetParent(this);
     return (true);
 }
 
@@ -160,36 +163,116 @@ bool WorkspaceList::CopyWorkspace(size_t index)
 //----------------------------------------------------------------
 bool WorkspaceList::IsWorkspaceOrProjectModified()
 /**
- * \brief Returns true if a workspace or project is modified.
+ * \brief Returns true if a workspace or project is modified. The
+ * workspaces and projects update a counter in this container when
+ * their modified state changes, so nothing is iterated here.
  * \return True if workspace or project is modified.
  **/
 {
-    bool modified = false;
-    for (size_t i=0; i<m_array->Count(); i++)
+    return (m_modifiedcount > 0);
+}
+
+
+//----------------------------------------------------------------
+void WorkspaceList::GetModified(Array<Workspace>* workspaces, Array<Project>* projects)
+/**
+ * \brief Collects the modified workspaces and projects. Only the
+ * projects of workspaces, which contain modified projects, are
+ * visited. The arrays should not free their items.
+ * \param workspaces The modified workspaces are added to this array.
+ * \param projects The modified projects are added to this array.
+ **/
+{
+    if (m_modifiedcount <= 0) return;
+    for (size_t i=0; i<m_array->Count(); ++i)
     {
-        Workspace* workspace = (*m_array)[i];
-        if (workspace == NULL) {
-            wxLogWarning(_T("[penv::WorkspaceList::IsWorkspaceOrProjectModified] Workspace is NULL."));
-            continue;
-        }
-        if (workspace->IsModified()) {
-            modified = true;
-            break;
+        Workspace* workspace = m_array->ItemUnchecked(i);
+        if (workspace->IsModified()) workspaces->Add(workspace);
+        size_t count = workspace->GetModifiedProjectCount();
+        ProjectList* list = workspace->GetProjectList();
+        for (size_t j=0; count > 0 && j<list->Count(); ++j)
+        {
+            Project* project = list->GetItem(j);
+            if (!project->IsModified()) continue;
+            projects->Add(project);
+            count--;
         }
-        for (size_t j=0; j<workspace->GetProjectList()->Count(); j++)
+    }
+}
+
+
+//----------------------------------------------------------------
+void WorkspaceList::AddModified(int count)
+/**
+ * \brief Changes the number of modified workspaces and projects
+ * (private). Called by the workspaces, see Workspace::Modified().
+ * \param count Positive if workspaces or projects are now modified;
+ * negative if they are no longer modified.
+ **/
+{
+    m_modifiedcount += count;
+    wxASSERT(m_modifiedcount >= 0);
+}
+
+
+//----------------------------------------------------------------
+bool WorkspaceList::SaveModified()
+/**
+ * \brief Saves only the modified workspaces and projects.
+ * The projects are saved in parallel by a ProjectLoader, the
+ * workspaces afterwards on the main thread, because they read the
+ * names of the projects. Saved items are no longer marked as
+ * modified. At the end the snapshot is written and one
+ * 'PENV_EVT_WORKSPACES_SAVED' event with the number of saved files
+ * is generated.
+ * \return True if all modified workspaces and projects were saved;
+ * false otherwise.
+ **/
+{
+    Array<Workspace> workspaces(false);
+    Array<Project> projects(false);
+    GetModified(&workspaces, &projects);
+    // Klone lesen beim Speichern aus dem geklonten Projekt und geteilte
+    // Properties enthalten dieselben Strings, dann nur im Hauptthread
+    // speichern
+    bool single = ProjectItemList::HasPendingClones() || PropertyList::HasSharedProperties();
+    ProjectLoader projectsaver(single ? 1 : penvCOMMON_PROJECTLOADERTHREADS);
+    for (size_t i=0; i<projects.Count(); ++i) projectsaver.AddSave(projects.ItemUnchecked(i));
+    // Workspaces lesen beim Speichern die Projekte, daher erst nach
+    // den Projekten im Hauptthread speichern
+    ProjectLoader workspacesaver(1);
+    for (size_t i=0; i<workspaces.Count(); ++i) workspacesaver.AddSave(workspaces.ItemUnchecked(i));
+    workspaces.Clear(false);
+    projects.Clear(false);
+    if (projectsaver.Count() == 0 && workspacesaver.Count() == 0) return (true);
+    projectsaver.Run();
+    workspacesaver.Run();
+    bool result = true;
+    long saved = 0;
+    ProjectLoader* savers[2] = {&projectsaver, &workspacesaver};
+    for (size_t j=0; j<2; ++j)
+    {
+        ProjectLoader* saver = savers[j];
+        for (size_t i=0; i<saver->Count(); ++i)
         {
-            Project* project = workspace->GetProjectList()->GetItem(j);
-            if (project == NULL) {
-                wxLogWarning(_T("[penv::WorkspaceList::IsWorkspaceOrProjectModified] Project is NULL."));
+            saver->LogMessages(i);
+            if (!saver->GetResult(i))
+            {
+                result = false;
                 continue;
             }
-            if (project->IsModified()) {
-                modified = true;
-                break;
+            if (saver->GetWorkspace(i) != NULL) {
+                saver->GetWorkspace(i)->Modified(false);
+            } else {
+                saver->GetProject(i)->Modified(false);
             }
+            saved++;
         }
     }
-    return (modified);
+    WriteSnapshot(Environment::Get()->GetWorkspacesSnapshotFile());
+    wxVariant variant(saved);
+    Environment::Get()->GetCommandList()->Execute(penvCE_WorkspacesSaved, variant);
+    return (result);
 }
 
 
@@ -225,7 +308,9 @@ bool WorkspaceList::ReloadWorkspaces()
 bool WorkspaceList::ReadNode(wxXmlNode* node)
 /**
  * \brief Reads a 'workspaces' xml element node.
- * See class description for more informations.
+ * See class description for more informations. The existence of
+ * all workspace files is checked at once by a PathChecker, before
+ * the workspaces are loaded.
  * \param node The 'workspaces' xml element node.
  * \return True on success; false otherwise.
  **/
@@ -240,7 +325,10 @@ bool WorkspaceList::ReadNode(wxXmlNode* node)
         wxLogError(_T("[penv::WorkspaceList::ReadNode] Node is not an element node with name 'workspaces'."));
         return (false);
     }
-    // Durch alle knoten unterhalb von 'workspaces' loopen
+    // Durch alle knoten unterhalb von 'workspaces' loopen, die
+    // Dateien werden danach zusammen geprueft
+    Array<Workspace> workspaces(false);
+    PathChecker checker;
     wxXmlNode* workspacenode = node->GetChildren();
     while (workspacenode != NULL)
     {
@@ -248,15 +336,50 @@ bool WorkspaceList::ReadNode(wxXmlNode* node)
             workspacenode->GetName() == _T("workspace"))
         {
             Workspace* workspace = new Workspace();
-            if (!workspace->ReadNode(workspacenode))
+            if (!workspace->ReadReference(workspacenode))
             {
+                delete workspace;
                 workspacenode = workspacenode->GetNext();
                 continue;
             }
-            m_array->Add(workspace);
+            workspaces.Add(workspace);
+            checker.AddFile(workspace->GetFileNameString());
         }
         workspacenode = workspacenode->GetNext();
     }
+    checker.Run();
+    // Die Projekte aller Workspaces werden zusammen von einem
+    // ProjectLoader geladen
+    ProjectLoader loader;
+    Array<Workspace> failed(false);
+    for (size_t i=0; i<workspaces.Count(); ++i)
+    {
+        Workspace* workspace = workspaces.ItemUnchecked(i);
+        if (!checker.Exists(i))
+        {
+            wxLogError(_T("[penv::Workspace::ReadNode] Workspace filename '%s' does not exist."), checker.GetPath(i).c_str());
+            delete workspace;
+            continue;
+        }
+        if (!workspace->Load(&loader))
+        {
+            wxLogError(_T("[penv::Workspace::ReadNode] Reading workspace filename '%s' failed."), checker.GetPath(i).c_str());
+            // Erst nach dem Laden loeschen, der Loader kann schon
+            // Projekte dieses Workspaces enthalten
+            failed.Add(workspace);
+            continue;
+        }
+        m_array->Add(workspace);
+        workspace->SetParent(this);
+    }
+    workspaces.Clear(false);
+    loader.Run();
+    ProjectList::AddLoadedProjects(&loader);
+    for (size_t i=0; i<failed.Count(); ++i)
+    {
+        delete failed.ItemUnchecked(i);
+    }
+    failed.Clear(false);
     return (true);
 }
 
@@ -271,6 +394,7 @@ wxXmlNode* WorkspaceList::WriteNode()
  **/
 {
     wxXmlNode* node = PenvHelper::CreateXmlNode(_T("workspaces"));
+    XmlNodeBuilder builder(node);
     for (size_t i=0; i<m_array->Count(); i++)
     {
         Workspace* workspace = m_array->ItemPtr(i);
@@ -285,13 +409,110 @@ wxXmlNode* WorkspaceList::WriteNode()
             wxLogError(_T("[penv::WorkspaceList::WriteNode] Can not write workspace '%s' node, skipping workspace."), workspace->GetName().c_str());
             continue;
         }
-        PenvHelper::AddXmlChildNode(node, workspacenode);
+        builder.Append(workspacenode);
     }
     return (node);
 }
 
 
 
+//----------------------------------------------------------------
+bool WorkspaceList::ReadSnapshot(const wxString& filename)
+/**
+ * \brief Reads all workspaces and projects from a snapshot, which was
+ * written by WriteSnapshot(). The snapshot is only used if the
+ * workspaces file, the workspace files and the project files are
+ * unchanged since it was written. Otherwise the files must be read
+ * with ReadNode().
+ * \param filename The snapshot file.
+ * \return True if the workspaces were read from the snapshot; false
+ * if the snapshot is missing, outdated or damaged.
+ **/
+{
+    SnapshotReader reader;
+    if (!reader.Open(filename)) return (false);
+    // Zuerst alle Dateien pruefen, bevor etwas erzeugt wird
+    size_t count = reader.ReadUInt32();
+    for (size_t i=0; i<count; ++i)
+    {
+        if (!reader.ReadFileStamp()) return (false);
+    }
+    Clear();
+    count = reader.ReadUInt32();
+    for (size_t i=0; i<count && !reader.HasError(); ++i)
+    {
+        Workspace* workspace = new Workspace();
+        if (!workspace->ReadSnapshot(&reader))
+        {
+            delete workspace;
+            break;
+        }
+        m_array->Add(workspace);
+        workspace->SetParent(this);
+    }
+    if (unlikely(reader.HasError() || m_array->Count() != count))
+    {
+        wxLogWarning(_T("[penv::WorkspaceList::ReadSnapshot] Snapshot '%s' is damaged."), filename.c_str());
+        Clear();
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool WorkspaceList::WriteSnapshot(const wxString& filename)
+/**
+ * \brief Writes all workspaces and projects into a binary snapshot,
+ * which can be read by ReadSnapshot() on the next start much faster
+ * than the xml files. The snapshot is only a cache, changes must
+ * still be saved into the xml files. If a workspace or project is
+ * modified, the snapshot would differ from the files, in this case
+ * a existing snapshot is removed and nothing is written.
+ * \param filename The snapshot file.
+ * \return True if the snapshot was written; false otherwise.
+ **/
+{
+    if (IsWorkspaceOrProjectModified())
+    {
+        if (wxFile::Exists(filename)) wxRemoveFile(filename);
+        return (false);
+    }
+    SnapshotWriter writer;
+    if (!writer.Open(filename)) return (false);
+    // Dateien, von denen der Snapshot abhaengt
+    size_t count = 1 + m_array->Count();
+    for (size_t i=0; i<m_array->Count(); ++i)
+    {
+        count += m_array->ItemUnchecked(i)->GetProjectList()->Count();
+    }
+    writer.WriteUInt32((wxUint32)count);
+    writer.WriteFileStamp(Environment::Get()->GetWorkspacesFile(false));
+    for (size_t i=0; i<m_array->Count(); ++i)
+    {
+        Workspace* workspace = m_array->ItemUnchecked(i);
+        writer.WriteFileStamp(workspace->GetFileNameString());
+        ProjectList* projects = workspace->GetProjectList();
+        for (size_t j=0; j<projects->Count(); ++j)
+        {
+            writer.WriteFileStamp(projects->GetItem(j)->GetFileNameString());
+        }
+    }
+    writer.WriteUInt32((wxUint32)m_array->Count());
+    for (size_t i=0; i<m_array->Count(); ++i)
+    {
+        m_array->ItemUnchecked(i)->WriteSnapshot(&writer);
+    }
+    if (unlikely(!writer.Close()))
+    {
+        wxLogWarning(_T("[penv::WorkspaceList::WriteSnapshot] Could not write snapshot '%s'."), filename.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+
+
 //----------------------------------------------------------------
 void WorkspaceList::PrintHierarchy()
 /**
@@ -311,6 +532,18 @@ void WorkspaceList::PrintHierarchy()
     }
 }
 
+
+//----------------------------------------------------------------
+DirectoryWatcher* WorkspaceList::GetDirectoryWatcher()
+/**
+ * \brief Returns the DirectoryWatcher, which keeps the project items
+ * of the directories in sync with the file system.
+ * \return The directory watcher.
+ **/
+{
+    return (m_watcher);
+}
+
 //----------------------------------------------------------------
 void WorkspaceList::PrintHierarchy(ProjectItemList* list, int depth)
 /**
@@ -368,34 +601,34 @@ void WorkspaceList::OnItemActivated(CommandEvent& event)
                 if (item->GetType() == penvPI_File)
                 {
                     wxVariant variant = (void*)item;
-                    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_ACTIVATED_PROJECTITEMFILE"), variant);
+                    Environment::Get()->GetCommandList()->Execute(penvCE_ActivatedProjectItemFile, variant);
                 }
                 else if (item->GetType() == penvPI_Directory)
                 {
                     wxVariant variant = (void*)item;
-                    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_ACTIVATED_PROJECTITEMDIRECTORY"), variant);
+                    Environment::Get()->GetCommandList()->Execute(penvCE_ActivatedProjectItemDirectory, variant);
                 }
                 else if (item->GetType() == penvPI_LinkedItems)
                 {
                     wxVariant variant = (void*)item;
-                    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_ACTIVATED_PROJECTITEMLINKEDITEMS"), variant);
+                    Environment::Get()->GetCommandList()->Execute(penvCE_ActivatedProjectItemLinkedItems, variant);
                 }
                 else if (item->GetType() == penvPI_SubProject)
                 {
                     wxVariant variant = (void*)item;
-                    Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_ACTIVATED_PROJECTITEMSUBPROJECT"), variant);
+                    Environment::Get()->GetCommandList()->Execute(penvCE_ActivatedProjectItemSubProject, variant);
                 }
             }
         }
         else if (data->GetType() == penvTI_Project)
         {
             wxVariant variant = (void*)data->GetProject();
-            Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_ACTIVATED_PROJECT"), variant);
+            Environment::Get()->GetCommandList()->Execute(penvCE_ActivatedProject, variant);
         }
         else if (data->GetType() == penvTI_Workspace)
         {
             wxVariant variant = (void*)data->GetWorkspace();
-            Environment::Get()->GetCommandList()->Execute(_T("PENV_EVT_ACTIVATED_WORKSPACE"), variant);
+            Environment::Get()->GetCommandList()->Execute(penvCE_ActivatedWorkspace, variant);
         }
     }
 }
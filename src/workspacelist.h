@@ -17,6 +17,8 @@
 
 namespace penv {
 
+class DirectoryWatcher;
+
 /**
  * \brief The WorkspaceList class is a container for workspaces. The main
  * function of this class are adding, removing and copying workspaces. The
@@ -35,6 +37,7 @@ class WorkspaceList
 {
     private:
         friend class Environment;
+        friend class Workspace;
         WorkspaceList();
         ~WorkspaceList();
 
@@ -48,14 +51,22 @@ class WorkspaceList
 
         bool CopyWorkspace(size_t index);
         bool IsWorkspaceOrProjectModified();
+        void GetModified(Array<Workspace>* workspaces, Array<Project>* projects);
+        bool SaveModified();
         bool ReloadWorkspaces();
 
         bool ReadNode(wxXmlNode* node);
         wxXmlNode* WriteNode();
 
+        bool ReadSnapshot(const wxString& filename);
+        bool WriteSnapshot(const wxString& filename);
+
         void PrintHierarchy();
+
+        DirectoryWatcher* GetDirectoryWatcher();
     private:
         void PrintHierarchy(ProjectItemList* list, int depth);
+        void AddModified(int count);
 
     public:
         void OnItemActivated(CommandEvent& event);
@@ -63,6 +74,8 @@ class WorkspaceList
 
     private:
         Array<Workspace>* m_array;
+        int m_modifiedcount;
+        DirectoryWatcher* m_watcher;
 };
 
 } // namespace penv
@@ -29,7 +29,9 @@
     #include <wx/treectrl.h>
     #include <wx/html/htmlwin.h>
     #include <wx/dnd.h>
+    #include <wx/clipbrd.h>
     #include <wx/cmdline.h>
+    #include <wx/thread.h>  // wxMutex
 #endif
 
 
@@ -0,0 +1,79 @@
+/*
+ * xmlnodebuilder.cpp - Implementation of the XmlNodeBuilder class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "xmlnodebuilder.h"
+#include "expect.h"
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+XmlNodeBuilder::XmlNodeBuilder(wxXmlNode* parent)
+/**
+ * \brief Constructor, initializes the XmlNodeBuilder object. If the
+ * parent already has child nodes, the last child node is searched once.
+ * \param parent The node where the child nodes will be appended.
+ **/
+{
+    m_parent = parent;
+    m_last = NULL;
+    if (m_parent != NULL)
+    {
+        m_last = m_parent->GetChildren();
+        while (m_last != NULL && m_last->GetNext() != NULL)
+        {
+            m_last = m_last->GetNext();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------
+XmlNodeBuilder::~XmlNodeBuilder()
+/**
+ * \brief Destructor.
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+wxXmlNode* XmlNodeBuilder::GetParent() const
+/**
+ * \brief Returns the node where the child nodes will be appended.
+ * \return Parent node.
+ **/
+{
+    return (m_parent);
+}
+
+
+//----------------------------------------------------------------
+bool XmlNodeBuilder::Append(wxXmlNode* node)
+/**
+ * \brief Appends a node at the end of the child node list of the
+ * parent node.
+ * \param node The node which should be appended.
+ * \return True on success; false if the parent or node is NULL.
+ **/
+{
+    if (unlikely(m_parent == NULL || node == NULL)) return (false);
+    node->SetParent(m_parent);
+    node->SetNext(NULL);
+    if (m_last == NULL) {
+        m_parent->SetChildren(node);
+    } else {
+        m_last->SetNext(node);
+    }
+    m_last = node;
+    return (true);
+}
+
+
+} // namespace penv
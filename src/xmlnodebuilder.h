@@ -0,0 +1,48 @@
+/*
+ * xmlnodebuilder.h - Declaration of the XmlNodeBuilder class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_XMLNODEBUILDER_H_
+#define _PENV_XMLNODEBUILDER_H_
+
+#include "wxincludes.h"
+
+
+namespace penv {
+
+/**
+ * \brief The XmlNodeBuilder class appends child nodes to a xml node.
+ * Unlike PenvHelper::AddXmlChildNode() the last child node is
+ * remembered, so every append is O(1) instead of walking the whole
+ * child node list. Use it in WriteNode() methods, which add many
+ * child nodes.<br>
+ * Example:<br>
+ * <code>
+ * wxXmlNode* node = PenvHelper::CreateXmlNode(_T("projectitems"));<br>
+ * XmlNodeBuilder builder(node);<br>
+ * for (...) builder.Append(item->WriteNode());<br>
+ * </code>
+ * Do not add child nodes to the parent in another way, while the
+ * builder is used.
+ **/
+class XmlNodeBuilder
+{
+    public:
+        XmlNodeBuilder(wxXmlNode* parent);
+        ~XmlNodeBuilder();
+
+        wxXmlNode* GetParent() const;
+        bool Append(wxXmlNode* node);
+
+    private:
+        wxXmlNode* m_parent;
+        wxXmlNode* m_last;
+};
+
+} // namespace penv
+
+#endif // _PENV_XMLNODEBUILDER_H_
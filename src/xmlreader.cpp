@@ -0,0 +1,1010 @@
+/*
+ * xmlreader.cpp - Implementation of the XmlReader class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "xmlreader.h"
+#include "expect.h"
+#include <string.h> // for strncmp(), memcmp()
+#include <stdlib.h> // for strtoul()
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+XmlReader::XmlReader()
+/**
+ * \brief Constructor, initializes the XmlReader object.
+ **/
+{
+    m_buffer = new char[penvXMLREADER_BUFFERSIZE];
+    m_bufferoffset = 0;
+    m_nodeoffset = 0;
+    m_bufferpos = 0;
+    m_bufferend = 0;
+    m_eof = true;
+    m_tokencapacity = 256;
+    m_token = new char[m_tokencapacity];
+    m_tokenlength = 0;
+    m_conv = &wxConvUTF8;
+    m_ownconv = false;
+    m_nodetype = penvXR_None;
+    m_depth = 0;
+    m_nodedepth = 0;
+    m_emptyelement = false;
+    m_pendingend = false;
+    m_line = 1;
+}
+
+
+//----------------------------------------------------------------
+XmlReader::~XmlReader()
+/**
+ * \brief Destructor, closes the file.
+ **/
+{
+    Close();
+    delete [] m_buffer;
+    delete [] m_token;
+}
+
+
+//----------------------------------------------------------------
+XmlReader::XmlReader(const XmlReader& reader)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+XmlReader& XmlReader::operator=(const XmlReader& reader)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::Open(const wxString& filename)
+/**
+ * \brief Opens a xml file for reading. The encoding of the file
+ * is taken from the xml declaration, default is UTF-8.
+ * \param filename The xml file.
+ * \return True on success; false otherwise.
+ **/
+{
+    Close();
+    if (unlikely(!m_file.Open(filename, wxFile::read))) {
+        m_error = wxString::Format(_T("Could not open file '%s'."), filename.c_str());
+        return (false);
+    }
+    m_filename = filename;
+    m_eof = false;
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::Open(const wxString& filename, wxFileOffset offset, const wxString& encoding)
+/**
+ * \brief Opens a xml file for reading at the given position. This is
+ * used to read an element again, which was found before with the help
+ * of GetOffset(). The element will be the root element for this reader.
+ * \param filename The xml file.
+ * \param offset Position of the element in the file, see GetOffset().
+ * \param encoding Encoding of the file, see GetEncoding().
+ * \return True on success; false otherwise.
+ **/
+{
+    if (!Open(filename)) return (false);
+    if (unlikely(m_file.Seek(offset) != offset)) {
+        m_error = wxString::Format(_T("Could not seek to position %li in file '%s'."), (long)offset, filename.c_str());
+        return (false);
+    }
+    m_bufferoffset = offset;
+    if (!encoding.IsEmpty())
+    {
+        m_conv = new wxCSConv(encoding);
+        m_ownconv = true;
+        m_encoding = encoding;
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void XmlReader::Close()
+/**
+ * \brief Closes the file and resets the reader.
+ **/
+{
+    if (m_file.IsOpened()) m_file.Close();
+    m_filename = wxEmptyString;
+    m_encoding = wxEmptyString;
+    m_bufferoffset = 0;
+    m_nodeoffset = 0;
+    if (m_ownconv) delete m_conv;
+    m_conv = &wxConvUTF8;
+    m_ownconv = false;
+    m_bufferpos = 0;
+    m_bufferend = 0;
+    m_eof = true;
+    m_tokenlength = 0;
+    m_nodetype = penvXR_None;
+    m_name = wxEmptyString;
+    m_value = wxEmptyString;
+    m_depth = 0;
+    m_nodedepth = 0;
+    m_emptyelement = false;
+    m_pendingend = false;
+    m_attrnames.Empty();
+    m_attrvalues.Empty();
+    m_elements.Empty();
+    m_error = wxEmptyString;
+    m_line = 1;
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::Read()
+/**
+ * \brief Reads the next node from the file.
+ * \return True if a node was read; false if the end of the file
+ * is reached or an error occured.
+ **/
+{
+    if (unlikely(!m_error.IsEmpty())) return (false);
+    // Ende eines leeren Elements
+    if (m_pendingend)
+    {
+        m_pendingend = false;
+        m_attrnames.Empty();
+        m_attrvalues.Empty();
+        m_nodetype = penvXR_EndElement;
+        m_nodedepth = m_depth;
+        m_depth--;
+        return (true);
+    }
+    while (true)
+    {
+        int c = PeekChar();
+        if (c == -1)
+        {
+            if (unlikely(!m_elements.IsEmpty())) {
+                SetError(wxString::Format(_T("Unexpected end of file, element '%s' is not closed."), m_elements.Last().c_str()));
+            }
+            m_nodetype = penvXR_None;
+            return (false);
+        }
+        // Text einlesen, Leerzeichen zwischen Elementen berspringen
+        if (c != '<')
+        {
+            bool whitespace = true;
+            if (unlikely(!ReadText(&whitespace))) return (false);
+            if (whitespace || m_depth == 0) continue;
+            m_nodetype = penvXR_Text;
+            m_value = TokenToString();
+            m_nodedepth = m_depth+1;
+            m_emptyelement = false;
+            return (true);
+        }
+        m_nodeoffset = m_bufferoffset + (wxFileOffset)m_bufferpos;
+        NextChar();
+        c = PeekChar();
+        if (c == '?')
+        {
+            // Processing instruction, die XML Deklaration enthlt das Encoding
+            NextChar();
+            m_tokenlength = 0;
+            if (unlikely(!ReadTextUntil("?>"))) return (false);
+            m_token[m_tokenlength] = 0;
+            if (strncmp(m_token, "xml", 3) == 0)
+            {
+                const char* encoding = strstr(m_token, "encoding");
+                if (encoding != NULL) encoding = strpbrk(encoding, "\"'");
+                if (encoding != NULL)
+                {
+                    wxString name = wxString::FromAscii(encoding+1);
+                    name = name.BeforeFirst(encoding[0]);
+                    if (name.Lower() != _T("utf-8") && name.Lower() != _T("utf8") &&
+                        name.Lower() != _T("us-ascii"))
+                    {
+                        if (m_ownconv) delete m_conv;
+                        m_conv = new wxCSConv(name);
+                        m_ownconv = true;
+                        m_encoding = name;
+                    }
+                }
+            }
+            continue;
+        }
+        if (c == '!')
+        {
+            NextChar();
+            if (PeekChar() == '-')
+            {
+                // Kommentar
+                NextChar();
+                if (unlikely(NextChar() != '-')) {
+                    SetError(_T("Invalid comment."));
+                    return (false);
+                }
+                if (unlikely(!SkipUntil("-->"))) return (false);
+                continue;
+            }
+            if (PeekChar() == '[')
+            {
+                // CDATA Abschnitt
+                const char* cdata = "[CDATA[";
+                for (size_t i=0; cdata[i] != 0; ++i)
+                {
+                    if (unlikely(NextChar() != cdata[i])) {
+                        SetError(_T("Invalid CDATA section."));
+                        return (false);
+                    }
+                }
+                m_tokenlength = 0;
+                if (unlikely(!ReadTextUntil("]]>"))) return (false);
+                m_nodetype = penvXR_Text;
+                m_value = TokenToString();
+                m_nodedepth = m_depth+1;
+                m_emptyelement = false;
+                return (true);
+            }
+            // Dokumenttyp Deklaration berspringen
+            int level = 0;
+            while ((c = NextChar()) != -1)
+            {
+                if (c == '[') level++;
+                else if (c == ']') level--;
+                else if (c == '>' && level <= 0) break;
+            }
+            continue;
+        }
+        if (c == '/')
+        {
+            // Ende eines Elements
+            NextChar();
+            if (unlikely(!ReadName())) return (false);
+            m_name = TokenToString();
+            while ((c = PeekChar()) == ' ' || c == '\t' || c == '\n' || c == '\r') NextChar();
+            if (unlikely(NextChar() != '>')) {
+                SetError(wxString::Format(_T("Missing '>' after end of element '%s'."), m_name.c_str()));
+                return (false);
+            }
+            if (unlikely(m_elements.IsEmpty() || m_elements.Last() != m_name)) {
+                SetError(wxString::Format(_T("Unexpected end of element '%s'."), m_name.c_str()));
+                return (false);
+            }
+            m_elements.RemoveAt(m_elements.Count()-1);
+            m_attrnames.Empty();
+            m_attrvalues.Empty();
+            m_nodetype = penvXR_EndElement;
+            m_emptyelement = false;
+            m_nodedepth = m_depth;
+            m_depth--;
+            return (true);
+        }
+        // Anfang eines Elements
+        if (unlikely(!ReadName())) return (false);
+        m_name = TokenToString();
+        m_attrnames.Empty();
+        m_attrvalues.Empty();
+        if (unlikely(!ReadAttributes())) return (false);
+        m_depth++;
+        m_nodedepth = m_depth;
+        m_nodetype = penvXR_StartElement;
+        if (m_emptyelement) m_pendingend = true;
+        else m_elements.Add(m_name);
+        return (true);
+    }
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::ReadRootElement()
+/**
+ * \brief Reads until the start of the root element.
+ * \return True if the root element was found; false otherwise.
+ **/
+{
+    while (Read())
+    {
+        if (m_nodetype == penvXR_StartElement) return (true);
+    }
+    if (m_error.IsEmpty()) SetError(_T("Root element not found."));
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::NextChild(size_t depth)
+/**
+ * \brief Reads until the start of the next child element of the
+ * element with the given depth. Child elements, which are not read
+ * completely, will be skipped.
+ * \param depth Depth of the parent element, see GetDepth().
+ * \return True if the start of a child element was read; false at
+ * the end of the parent element or on error.
+ **/
+{
+    while (Read())
+    {
+        if (m_nodetype == penvXR_StartElement && m_nodedepth == depth+1) return (true);
+        if (m_nodetype == penvXR_EndElement && m_nodedepth == depth) return (false);
+    }
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::Skip()
+/**
+ * \brief Skips the current element with all its children. After
+ * this call the current node is the end of the element. The children
+ * are not parsed, only the bytes are scanned for the end of the
+ * element, so skipping is much faster than reading.
+ * \return True on success; false on error.
+ **/
+{
+    if (m_nodetype != penvXR_StartElement) return (m_nodetype != penvXR_None);
+    if (!m_pendingend) return (SkipElement());
+    return (Read());
+}
+
+
+//----------------------------------------------------------------
+wxString XmlReader::ReadElementContent()
+/**
+ * \brief Reads the text content of the current element, like
+ * wxXmlNode::GetNodeContent(). Child elements will be skipped.
+ * After this call the current node is the end of the element.
+ * \return Text content of the element.
+ **/
+{
+    wxString content;
+    if (m_nodetype != penvXR_StartElement) return (content);
+    size_t depth = m_nodedepth;
+    while (Read())
+    {
+        if (m_nodetype == penvXR_Text && m_nodedepth == depth+1) content += m_value;
+        else if (m_nodetype == penvXR_EndElement && m_nodedepth == depth) break;
+    }
+    return (content);
+}
+
+
+//----------------------------------------------------------------
+wxXmlNode* XmlReader::ReadSubtree()
+/**
+ * \brief Reads the current element with all its children into a
+ * wxXmlNode. Use this for small elements, which should be read with
+ * a ReadNode(wxXmlNode*) method. After this call the current node
+ * is the end of the element.
+ * \return The element node, must be deleted by the caller; or NULL
+ * if the current node is not the start of an element.
+ **/
+{
+    if (m_nodetype != penvXR_StartElement) return (NULL);
+    wxXmlNode* node = new wxXmlNode(NULL, wxXML_ELEMENT_NODE, m_name);
+    for (size_t i=0; i<m_attrnames.Count(); ++i)
+    {
+        node->AddProperty(m_attrnames[i], m_attrvalues[i]);
+    }
+    size_t depth = m_nodedepth;
+    wxXmlNode* last = NULL;
+    while (Read())
+    {
+        if (m_nodetype == penvXR_EndElement && m_nodedepth == depth) break;
+        wxXmlNode* child = NULL;
+        if (m_nodetype == penvXR_Text) {
+            child = new wxXmlNode(NULL, wxXML_TEXT_NODE, wxEmptyString, m_value);
+        } else if (m_nodetype == penvXR_StartElement) {
+            child = ReadSubtree();
+        }
+        if (child == NULL) continue;
+        // Am Ende anhngen ohne die Liste zu durchlaufen
+        child->SetParent(node);
+        if (last == NULL) node->SetChildren(child);
+        else last->SetNext(child);
+        last = child;
+    }
+    return (node);
+}
+
+
+//----------------------------------------------------------------
+XmlReaderNodeType XmlReader::GetNodeType() const
+/**
+ * \brief Returns the type of the current node.
+ * \return Type of the current node.
+ **/
+{
+    return (m_nodetype);
+}
+
+
+//----------------------------------------------------------------
+const wxString& XmlReader::GetName() const
+/**
+ * \brief Returns the name of the current element. Only valid for
+ * penvXR_StartElement and penvXR_EndElement nodes.
+ * \return Name of the element.
+ **/
+{
+    return (m_name);
+}
+
+
+//----------------------------------------------------------------
+const wxString& XmlReader::GetValue() const
+/**
+ * \brief Returns the text of the current node. Only valid for
+ * penvXR_Text nodes.
+ * \return Text of the node.
+ **/
+{
+    return (m_value);
+}
+
+
+//----------------------------------------------------------------
+size_t XmlReader::GetDepth() const
+/**
+ * \brief Returns the depth of the current node. The root element
+ * has the depth 1, its children the depth 2 and so on.
+ * \return Depth of the current node.
+ **/
+{
+    return (m_nodedepth);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::IsEmptyElement() const
+/**
+ * \brief Checks if the current element is empty, like
+ * <code>&lt;element /&gt;</code>. The penvXR_EndElement node
+ * will be created anyway.
+ * \return True if the element is empty; false otherwise.
+ **/
+{
+    return (m_emptyelement);
+}
+
+
+//----------------------------------------------------------------
+size_t XmlReader::GetAttributeCount() const
+/**
+ * \brief Returns the number of attributes of the current element.
+ * \return Number of attributes.
+ **/
+{
+    return (m_attrnames.Count());
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::GetAttribute(const wxString& name, wxString* value) const
+/**
+ * \brief Returns the value of an attribute of the current element.
+ * \param name Name of the attribute.
+ * \param value Returns the value of the attribute.
+ * \return True if the attribute exists; false otherwise.
+ **/
+{
+    for (size_t i=0; i<m_attrnames.Count(); ++i)
+    {
+        if (m_attrnames[i] == name) {
+            if (value != NULL) *value = m_attrvalues[i];
+            return (true);
+        }
+    }
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+wxString XmlReader::GetAttribute(const wxString& name, const wxString& defaultvalue) const
+/**
+ * \brief Returns the value of an attribute of the current element.
+ * \param name Name of the attribute.
+ * \param defaultvalue Value if the attribute does not exist.
+ * \return Value of the attribute or the default value.
+ **/
+{
+    wxString value;
+    if (!GetAttribute(name, &value)) return (defaultvalue);
+    return (value);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::HasError() const
+/**
+ * \brief Checks if an error occured while reading the file.
+ * \return True if an error occured; false otherwise.
+ **/
+{
+    return (!m_error.IsEmpty());
+}
+
+
+//----------------------------------------------------------------
+const wxString& XmlReader::GetError() const
+/**
+ * \brief Returns the description of the error.
+ * \return Error description or an empty string.
+ **/
+{
+    return (m_error);
+}
+
+
+//----------------------------------------------------------------
+size_t XmlReader::GetLine() const
+/**
+ * \brief Returns the current line in the file.
+ * \return Current line, the first line is 1.
+ **/
+{
+    return (m_line);
+}
+
+
+//----------------------------------------------------------------
+const wxString& XmlReader::GetFileName() const
+/**
+ * \brief Returns the name of the opened file.
+ * \return Name of the file.
+ **/
+{
+    return (m_filename);
+}
+
+
+//----------------------------------------------------------------
+const wxString& XmlReader::GetEncoding() const
+/**
+ * \brief Returns the encoding of the file, which is taken from the
+ * xml declaration. An empty string means UTF-8.
+ * \return Encoding of the file.
+ **/
+{
+    return (m_encoding);
+}
+
+
+//----------------------------------------------------------------
+wxFileOffset XmlReader::GetOffset() const
+/**
+ * \brief Returns the position of the current node in the file. The
+ * position is only valid for penvXR_StartElement nodes. It can be
+ * used with Open(filename, offset, encoding) to read the element
+ * again later.
+ * \return Position of the current element in bytes.
+ **/
+{
+    return (m_nodeoffset);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::FillBuffer()
+/**
+ * \brief Reads the next block of the file into the buffer.
+ * \return True if data was read; false at the end of the file.
+ **/
+{
+    if (m_eof) return (false);
+    m_bufferoffset += (wxFileOffset)m_bufferend;
+    ssize_t count = m_file.Read(m_buffer, penvXMLREADER_BUFFERSIZE);
+    if (count <= 0 || count == wxInvalidOffset) {
+        m_eof = true;
+        return (false);
+    }
+    m_bufferpos = 0;
+    m_bufferend = (size_t)count;
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+int XmlReader::PeekChar()
+/**
+ * \brief Returns the next byte without reading it.
+ * \return The next byte or -1 at the end of the file.
+ **/
+{
+    if (unlikely(m_bufferpos >= m_bufferend)) {
+        if (!FillBuffer()) return (-1);
+    }
+    return ((unsigned char)m_buffer[m_bufferpos]);
+}
+
+
+//----------------------------------------------------------------
+int XmlReader::NextChar()
+/**
+ * \brief Reads the next byte. Line breaks are normalized to '\\n'.
+ * \return The next byte or -1 at the end of the file.
+ **/
+{
+    int c = PeekChar();
+    if (unlikely(c == -1)) return (-1);
+    m_bufferpos++;
+    if (unlikely(c == '\r')) {
+        if (PeekChar() == '\n') m_bufferpos++;
+        c = '\n';
+    }
+    if (c == '\n') m_line++;
+    return (c);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::SkipUntil(const char* end)
+/**
+ * \brief Skips all bytes until and including the given end string.
+ * \param end End string, maximal 7 characters.
+ * \return True on success; false at the end of the file.
+ **/
+{
+    size_t length = strlen(end);
+    char window[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    int c;
+    while ((c = NextChar()) != -1)
+    {
+        memmove(window, window+1, length-1);
+        window[length-1] = (char)c;
+        if (memcmp(window, end, length) == 0) return (true);
+    }
+    SetError(wxString::Format(_T("Missing '%s'."), wxString::FromAscii(end).c_str()));
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::SkipElement()
+/**
+ * \brief Skips the content of the current start element until and
+ * including its end tag, without creating any nodes. The end tag is
+ * not checked against the name of the start element.
+ * \return True on success; false on error.
+ **/
+{
+    size_t level = 1;
+    int c;
+    while ((c = NextChar()) != -1)
+    {
+        if (c != '<') continue;
+        c = NextChar();
+        if (c == '/')
+        {
+            // Ende eines Elements
+            while ((c = NextChar()) != -1 && c != '>');
+            if (unlikely(c == -1)) break;
+            if (--level == 0)
+            {
+                m_name = m_elements.Last();
+                m_elements.RemoveAt(m_elements.Count()-1);
+                m_attrnames.Empty();
+                m_attrvalues.Empty();
+                m_nodetype = penvXR_EndElement;
+                m_emptyelement = false;
+                m_nodedepth = m_depth;
+                m_depth--;
+                return (true);
+            }
+        }
+        else if (c == '?')
+        {
+            if (unlikely(!SkipUntil("?>"))) return (false);
+        }
+        else if (c == '!')
+        {
+            // Kommentar oder CDATA Abschnitt
+            if (PeekChar() == '-') {
+                if (unlikely(!SkipUntil("-->"))) return (false);
+            } else {
+                if (unlikely(!SkipUntil("]]>"))) return (false);
+            }
+        }
+        else
+        {
+            // Anfang eines Elements, '>' in Attributwerten beachten
+            int last = c;
+            while (c != -1 && c != '>')
+            {
+                if (c == '"' || c == '\'')
+                {
+                    int quote = c;
+                    while ((c = NextChar()) != -1 && c != quote);
+                    if (unlikely(c == -1)) break;
+                }
+                last = c;
+                c = NextChar();
+            }
+            if (unlikely(c == -1)) break;
+            if (last != '/') level++;
+        }
+    }
+    SetError(wxString::Format(_T("Unexpected end of file, element '%s' is not closed."), m_elements.Last().c_str()));
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::ReadName()
+/**
+ * \brief Reads the name of an element or attribute into the token.
+ * \return True on success; false on error.
+ **/
+{
+    m_tokenlength = 0;
+    int c;
+    while ((c = PeekChar()) != -1 && c != ' ' && c != '\t' && c != '\n' &&
+        c != '\r' && c != '>' && c != '/' && c != '=')
+    {
+        AppendToken((char)NextChar());
+    }
+    if (unlikely(m_tokenlength == 0)) {
+        SetError(_T("Name expected."));
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::ReadAttributes()
+/**
+ * \brief Reads the attributes of an element until the end of the
+ * start tag.
+ * \return True on success; false on error.
+ **/
+{
+    while (true)
+    {
+        int c;
+        while ((c = PeekChar()) == ' ' || c == '\t' || c == '\n' || c == '\r') NextChar();
+        if (unlikely(c == -1)) {
+            SetError(wxString::Format(_T("Unexpected end of file in element '%s'."), m_name.c_str()));
+            return (false);
+        }
+        if (c == '>')
+        {
+            NextChar();
+            m_emptyelement = false;
+            return (true);
+        }
+        if (c == '/')
+        {
+            NextChar();
+            if (unlikely(NextChar() != '>')) {
+                SetError(wxString::Format(_T("Missing '>' in element '%s'."), m_name.c_str()));
+                return (false);
+            }
+            m_emptyelement = true;
+            return (true);
+        }
+        if (unlikely(!ReadName())) return (false);
+        wxString name = TokenToString();
+        while ((c = PeekChar()) == ' ' || c == '\t' || c == '\n' || c == '\r') NextChar();
+        if (unlikely(NextChar() != '=')) {
+            SetError(wxString::Format(_T("Missing '=' after attribute '%s'."), name.c_str()));
+            return (false);
+        }
+        while ((c = PeekChar()) == ' ' || c == '\t' || c == '\n' || c == '\r') NextChar();
+        int quote = NextChar();
+        if (unlikely(quote != '"' && quote != '\'')) {
+            SetError(wxString::Format(_T("Missing quote for attribute '%s'."), name.c_str()));
+            return (false);
+        }
+        m_tokenlength = 0;
+        while ((c = NextChar()) != quote)
+        {
+            if (unlikely(c == -1)) {
+                SetError(wxString::Format(_T("Unexpected end of file in attribute '%s'."), name.c_str()));
+                return (false);
+            }
+            if (c == '&') {
+                if (unlikely(!ReadEntity())) return (false);
+            } else {
+                AppendToken((char)c);
+            }
+        }
+        m_attrnames.Add(name);
+        m_attrvalues.Add(TokenToString());
+    }
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::ReadText(bool* whitespace)
+/**
+ * \brief Reads text until the next '&lt;' into the token. Entities
+ * will be resolved.
+ * \param whitespace Returns true if the text only contains whitespaces.
+ * \return True on success; false on error.
+ **/
+{
+    m_tokenlength = 0;
+    *whitespace = true;
+    int c;
+    while ((c = PeekChar()) != -1 && c != '<')
+    {
+        c = NextChar();
+        if (c == '&') {
+            if (unlikely(!ReadEntity())) return (false);
+            *whitespace = false;
+        } else {
+            if (c != ' ' && c != '\t' && c != '\n') *whitespace = false;
+            AppendToken((char)c);
+        }
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::ReadTextUntil(const char* end)
+/**
+ * \brief Reads text without resolving entities into the token,
+ * until the given end string. The end string is not part of the token.
+ * \param end End string.
+ * \return True on success; false at the end of the file.
+ **/
+{
+    size_t length = strlen(end);
+    int c;
+    while ((c = NextChar()) != -1)
+    {
+        AppendToken((char)c);
+        if (m_tokenlength >= length &&
+            memcmp(m_token+m_tokenlength-length, end, length) == 0)
+        {
+            m_tokenlength -= length;
+            return (true);
+        }
+    }
+    SetError(wxString::Format(_T("Missing '%s'."), wxString::FromAscii(end).c_str()));
+    return (false);
+}
+
+
+//----------------------------------------------------------------
+bool XmlReader::ReadEntity()
+/**
+ * \brief Reads an entity after the '&amp;' and appends the character
+ * to the token.
+ * \return True on success; false on error.
+ **/
+{
+    char name[16];
+    size_t length = 0;
+    int c;
+    while ((c = NextChar()) != ';')
+    {
+        if (unlikely(c == -1 || length >= sizeof(name)-1)) {
+            SetError(_T("Invalid entity."));
+            return (false);
+        }
+        name[length++] = (char)c;
+    }
+    name[length] = 0;
+    if (strcmp(name, "lt") == 0) AppendToken('<');
+    else if (strcmp(name, "gt") == 0) AppendToken('>');
+    else if (strcmp(name, "amp") == 0) AppendToken('&');
+    else if (strcmp(name, "quot") == 0) AppendToken('"');
+    else if (strcmp(name, "apos") == 0) AppendToken('\'');
+    else if (name[0] == '#' && (name[1] == 'x' || name[1] == 'X')) AppendCodePoint(strtoul(name+2, NULL, 16));
+    else if (name[0] == '#') AppendCodePoint(strtoul(name+1, NULL, 10));
+    else {
+        SetError(wxString::Format(_T("Unknown entity '&%s;'."), wxString::FromAscii(name).c_str()));
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void XmlReader::AppendToken(char c)
+/**
+ * \brief Appends a byte to the token, the token grows if needed.
+ * \param c The byte.
+ **/
+{
+    // Ein Byte fr die Null am Ende frei lassen
+    if (unlikely(m_tokenlength+1 >= m_tokencapacity))
+    {
+        char* token = new char[m_tokencapacity*2];
+        memcpy(token, m_token, m_tokenlength);
+        delete [] m_token;
+        m_token = token;
+        m_tokencapacity *= 2;
+    }
+    m_token[m_tokenlength++] = c;
+}
+
+
+//----------------------------------------------------------------
+void XmlReader::AppendCodePoint(unsigned long codepoint)
+/**
+ * \brief Appends a unicode character in the encoding of the file
+ * to the token.
+ * \param codepoint The unicode character.
+ **/
+{
+    if (codepoint < 0x80) {
+        AppendToken((char)codepoint);
+    }
+    else if (m_ownconv) {
+        wchar_t wide[2] = {(wchar_t)codepoint, 0};
+        char multibyte[16];
+        size_t length = m_conv->WC2MB(multibyte, wide, sizeof(multibyte));
+        if (length == (size_t)-1 || length >= sizeof(multibyte)) return;
+        for (size_t i=0; i<length; ++i) AppendToken(multibyte[i]);
+    }
+    else if (codepoint < 0x800) {
+        AppendToken((char)(0xC0 | (codepoint >> 6)));
+        AppendToken((char)(0x80 | (codepoint & 0x3F)));
+    }
+    else if (codepoint < 0x10000) {
+        AppendToken((char)(0xE0 | (codepoint >> 12)));
+        AppendToken((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+        AppendToken((char)(0x80 | (codepoint & 0x3F)));
+    }
+    else {
+        AppendToken((char)(0xF0 | (codepoint >> 18)));
+        AppendToken((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+        AppendToken((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+        AppendToken((char)(0x80 | (codepoint & 0x3F)));
+    }
+}
+
+
+//----------------------------------------------------------------
+wxString XmlReader::TokenToString()
+/**
+ * \brief Converts the token from the encoding of the file into a
+ * string.
+ * \return The token as string.
+ **/
+{
+    if (m_tokenlength == 0) return (wxEmptyString);
+    m_token[m_tokenlength] = 0;
+#if wxUSE_UNICODE
+    return (wxString(m_token, *m_conv, m_tokenlength));
+#else
+    wxWCharBuffer wide = m_conv->cMB2WC(m_token);
+    if (!wide) return (wxEmptyString);
+    return (wxString(wide, wxConvLocal));
+#endif
+}
+
+
+//----------------------------------------------------------------
+void XmlReader::SetError(const wxString& error)
+/**
+ * \brief Sets the error description and stops reading the file.
+ * \param error Error description.
+ **/
+{
+    m_error = wxString::Format(_T("%s (line %u)"), error.c_str(), (unsigned int)m_line);
+    m_nodetype = penvXR_None;
+    m_pendingend = false;
+    m_eof = true;
+    m_bufferpos = m_bufferend;
+}
+
+
+} // namespace penv
@@ -0,0 +1,136 @@
+/*
+ * xmlreader.h - Declaration of the XmlReader class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_XMLREADER_H_
+#define _PENV_XMLREADER_H_
+
+#include "wxincludes.h"
+#include "xmlreadernodetype.h"
+
+
+/**
+ * \brief Definition of the size of the buffer in bytes, which is
+ * used by the XmlReader to read the file.
+ **/
+#define penvXMLREADER_BUFFERSIZE 65536
+
+
+namespace penv {
+
+/**
+ * \brief The XmlReader class reads a xml file node by node, without
+ * building the whole document in memory like wxXmlDocument. It is
+ * used to load big workspace and project files, the objects will be
+ * created directly while the file is read. Therefor the memory needed
+ * to load a file is only the size of the buffer and the current node.<br>
+ * Every element creates a penvXR_StartElement and a penvXR_EndElement
+ * node, also empty elements. Text nodes which only contain whitespaces,
+ * comments, processing instructions and the document type declaration
+ * are skipped.<br>
+ * Example, reading all children of the current element:<br>
+ * <code>
+ * size_t depth = reader->GetDepth();<br>
+ * while (reader->NextChild(depth))<br>
+ * {<br>
+ * &nbsp;&nbsp;if (reader->GetName() == _T("name")) name = reader->ReadElementContent();<br>
+ * &nbsp;&nbsp;else reader->Skip();<br>
+ * }<br>
+ * </code>
+ * To use the existing ReadNode(wxXmlNode*) methods for a small part of
+ * the file, use ReadSubtree().<br>
+ * GetOffset() returns the position of an element in the file. The
+ * element can be read again later, by opening the file at this
+ * position with Open(filename, offset, encoding).
+ **/
+class XmlReader
+{
+    public:
+        XmlReader();
+        ~XmlReader();
+    private:
+        XmlReader(const XmlReader& reader);
+        XmlReader& operator=(const XmlReader& reader);
+
+    public:
+        bool Open(const wxString& filename);
+        bool Open(const wxString& filename, wxFileOffset offset, const wxString& encoding);
+        void Close();
+
+        bool Read();
+        bool ReadRootElement();
+        bool NextChild(size_t depth);
+        bool Skip();
+        wxString ReadElementContent();
+        wxXmlNode* ReadSubtree();
+
+        XmlReaderNodeType GetNodeType() const;
+        const wxString& GetName() const;
+        const wxString& GetValue() const;
+        size_t GetDepth() const;
+        bool IsEmptyElement() const;
+
+        size_t GetAttributeCount() const;
+        bool GetAttribute(const wxString& name, wxString* value) const;
+        wxString GetAttribute(const wxString& name, const wxString& defaultvalue) const;
+
+        bool HasError() const;
+        const wxString& GetError() const;
+        size_t GetLine() const;
+
+        const wxString& GetFileName() const;
+        const wxString& GetEncoding() const;
+        wxFileOffset GetOffset() const;
+
+    private:
+        bool FillBuffer();
+        int PeekChar();
+        int NextChar();
+        bool SkipUntil(const char* end);
+        bool SkipElement();
+        bool ReadName();
+        bool ReadAttributes();
+        bool ReadText(bool* whitespace);
+        bool ReadTextUntil(const char* end);
+        bool ReadEntity();
+        void AppendToken(char c);
+        void AppendCodePoint(unsigned long codepoint);
+        wxString TokenToString();
+        void SetError(const wxString& error);
+
+    private:
+        wxFile m_file;
+        wxString m_filename;
+        wxString m_encoding;
+        wxFileOffset m_bufferoffset;
+        wxFileOffset m_nodeoffset;
+        char* m_buffer;
+        size_t m_bufferpos;
+        size_t m_bufferend;
+        bool m_eof;
+        char* m_token;
+        size_t m_tokenlength;
+        size_t m_tokencapacity;
+        wxMBConv* m_conv;
+        bool m_ownconv;
+        XmlReaderNodeType m_nodetype;
+        wxString m_name;
+        wxString m_value;
+        size_t m_depth;
+        size_t m_nodedepth;
+        bool m_emptyelement;
+        bool m_pendingend;
+        wxArrayString m_attrnames;
+        wxArrayString m_attrvalues;
+        wxArrayString m_elements;
+        wxString m_error;
+        size_t m_line;
+};
+
+} // namespace penv
+
+#endif // _PENV_XMLREADER_H_
@@ -0,0 +1,43 @@
+/*
+ * xmlreadernodetype.h - Declaration of the XmlReaderNodeType enumerator
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_XMLREADERNODETYPE_H_
+#define _PENV_XMLREADERNODETYPE_H_
+
+namespace penv {
+
+
+/**
+ * \brief The XmlReaderNodeType enumerator spezifies the type of
+ * the current node in a XmlReader.
+ **/
+enum XmlReaderNodeType
+{
+    /**
+     * \brief Spezifies that there is no node, because nothing is read
+     * yet, the end of the file is reached or an error occured.
+     **/
+    penvXR_None,
+    /**
+     * \brief Spezifies that the node is the start of an element.
+     **/
+    penvXR_StartElement,
+    /**
+     * \brief Spezifies that the node is the end of an element.
+     **/
+    penvXR_EndElement,
+    /**
+     * \brief Spezifies that the node is text or a CDATA section.
+     **/
+    penvXR_Text
+};
+
+
+} // namespace penv
+
+#endif // _PENV_XMLREADERNODETYPE_H_
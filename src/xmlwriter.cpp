@@ -0,0 +1,384 @@
+/*
+ * xmlwriter.cpp - Implementation of the XmlWriter class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#include "xmlwriter.h"
+#include "expect.h"
+#include <string.h> // for memcpy()
+
+
+namespace penv {
+
+
+//----------------------------------------------------------------
+XmlWriter::XmlWriter(size_t indentstep)
+/**
+ * \brief Constructor, initializes the XmlWriter object.
+ * \param indentstep Number of spaces for every level of indentation.
+ **/
+{
+    m_buffer = new char[penvXMLWRITER_BUFFERSIZE];
+    m_bufferpos = 0;
+    m_indentstep = indentstep;
+    m_starttagopen = false;
+    m_error = false;
+}
+
+
+//----------------------------------------------------------------
+XmlWriter::~XmlWriter()
+/**
+ * \brief Destructor, closes the file if it is still open.
+ **/
+{
+    if (m_file.IsOpened()) Close();
+    delete [] m_buffer;
+}
+
+
+//----------------------------------------------------------------
+XmlWriter::XmlWriter(const XmlWriter& writer)
+/**
+ * \brief Copyconstructor (private).
+ **/
+{
+}
+
+
+//----------------------------------------------------------------
+XmlWriter& XmlWriter::operator=(const XmlWriter& writer)
+/**
+ * \brief Assignment operator (private).
+ **/
+{
+    return (*this);
+}
+
+
+//----------------------------------------------------------------
+bool XmlWriter::Open(const wxString& filename)
+/**
+ * \brief Creates the xml file and writes the xml declaration. The
+ * content is written into a temporary file next to the xml file, which
+ * replaces an existing file not before Close(). So the old file stays
+ * intact if writing fails.
+ * \param filename The xml file.
+ * \return True on success; false otherwise.
+ **/
+{
+    if (m_file.IsOpened()) Close();
+    m_bufferpos = 0;
+    m_starttagopen = false;
+    m_error = false;
+    m_elements.Empty();
+    m_childelements.Empty();
+    m_filename = filename;
+    m_tempfilename = filename + _T(".tmp");
+    if (unlikely(!m_file.Create(m_tempfilename, true))) {
+        wxLogError(_T("[penv::XmlWriter::Open] Could not create file '%s'."), m_tempfilename.c_str());
+        m_error = true;
+        return (false);
+    }
+    const char* declaration = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    WriteRaw(declaration, strlen(declaration));
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+bool XmlWriter::Close()
+/**
+ * \brief Closes all open elements, writes the rest of the buffer
+ * and closes the file. The temporary file replaces the xml file
+ * only if the whole file was written; otherwise it is removed.
+ * \return True if the whole file was written; false otherwise.
+ **/
+{
+    if (!m_file.IsOpened()) return (false);
+    while (!m_elements.IsEmpty()) WriteEndElement();
+    WriteRaw("\n", 1);
+    Flush();
+    m_file.Close();
+    if (unlikely(m_error || !wxRenameFile(m_tempfilename, m_filename))) {
+        wxRemoveFile(m_tempfilename);
+        return (false);
+    }
+    return (true);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteStartElement(const wxString& name)
+/**
+ * \brief Writes the start of an element. Attributes can be written
+ * with WriteAttribute() until other content is written.
+ * \param name Name of the element.
+ **/
+{
+    CloseStartTag();
+    if (!m_elements.IsEmpty())
+    {
+        m_childelements.Last() = 1;
+        WriteIndent(m_elements.Count());
+    }
+    WriteRaw("<", 1);
+    WriteEscaped(name, false);
+    m_elements.Add(name);
+    m_childelements.Add(0);
+    m_starttagopen = true;
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteAttribute(const wxString& name, const wxString& value)
+/**
+ * \brief Writes an attribute of the current element. Must be called
+ * directly after WriteStartElement() or WriteAttribute().
+ * \param name Name of the attribute.
+ * \param value Value of the attribute.
+ **/
+{
+    if (unlikely(!m_starttagopen)) {
+        wxLogError(_T("[penv::XmlWriter::WriteAttribute] Attribute '%s' must be written after the start of an element."), name.c_str());
+        return;
+    }
+    WriteRaw(" ", 1);
+    WriteEscaped(name, false);
+    WriteRaw("=\"", 2);
+    WriteEscaped(value, true);
+    WriteRaw("\"", 1);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteText(const wxString& text)
+/**
+ * \brief Writes text into the current element.
+ * \param text The text, will be escaped.
+ **/
+{
+    if (text.IsEmpty()) return;
+    CloseStartTag();
+    WriteEscaped(text, false);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteEndElement()
+/**
+ * \brief Writes the end of the current element. An element without
+ * content is written as empty element.
+ **/
+{
+    if (unlikely(m_elements.IsEmpty())) return;
+    size_t last = m_elements.Count()-1;
+    if (m_starttagopen)
+    {
+        WriteRaw("/>", 2);
+        m_starttagopen = false;
+    }
+    else
+    {
+        if (m_childelements[last] != 0) WriteIndent(last);
+        WriteRaw("</", 2);
+        WriteEscaped(m_elements[last], false);
+        WriteRaw(">", 1);
+    }
+    m_elements.RemoveAt(last);
+    m_childelements.RemoveAt(last);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteElement(const wxString& name, const wxString& content)
+/**
+ * \brief Writes an element, which only contains text.
+ * \param name Name of the element.
+ * \param content Text of the element.
+ **/
+{
+    WriteStartElement(name);
+    WriteText(content);
+    WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteNode(const wxXmlNode* node)
+/**
+ * \brief Writes a xml node with all its attributes and children.
+ * \param node The xml node.
+ **/
+{
+    if (unlikely(node == NULL)) return;
+    if (node->GetType() == wxXML_TEXT_NODE || node->GetType() == wxXML_CDATA_SECTION_NODE)
+    {
+        WriteText(node->GetContent());
+        return;
+    }
+    if (node->GetType() != wxXML_ELEMENT_NODE) return;
+    WriteStartElement(node->GetName());
+    wxXmlProperty* prop = node->GetProperties();
+    while (prop != NULL)
+    {
+        WriteAttribute(prop->GetName(), prop->GetValue());
+        prop = prop->GetNext();
+    }
+    wxXmlNode* child = node->GetChildren();
+    while (child != NULL)
+    {
+        WriteNode(child);
+        child = child->GetNext();
+    }
+    WriteEndElement();
+}
+
+
+//----------------------------------------------------------------
+size_t XmlWriter::GetDepth() const
+/**
+ * \brief Returns the number of open elements.
+ * \return Number of open elements.
+ **/
+{
+    return (m_elements.Count());
+}
+
+
+//----------------------------------------------------------------
+bool XmlWriter::HasError() const
+/**
+ * \brief Checks if an error occured while writing the file.
+ * \return True if an error occured; false otherwise.
+ **/
+{
+    return (m_error);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::CloseStartTag()
+/**
+ * \brief Writes the '&gt;' of the start tag, if it is still open.
+ **/
+{
+    if (m_starttagopen)
+    {
+        WriteRaw(">", 1);
+        m_starttagopen = false;
+    }
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteIndent(size_t depth)
+/**
+ * \brief Writes a new line and the indentation for the given depth.
+ * \param depth The depth.
+ **/
+{
+    WriteRaw("\n", 1);
+    for (size_t i=0; i<depth*m_indentstep; ++i) WriteRaw(" ", 1);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteEscaped(const wxString& text, bool attribute)
+/**
+ * \brief Writes a string encoded in UTF-8 and escapes the special
+ * characters. Strings, which only contain ASCII characters, are
+ * written without conversion.
+ * \param text The string.
+ * \param attribute True if the string is an attribute value.
+ **/
+{
+    size_t length = text.Length();
+    const wxChar* chars = text.c_str();
+    bool ascii = true;
+    for (size_t i=0; i<length; ++i)
+    {
+        if ((unsigned)chars[i] >= 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+    if (likely(ascii))
+    {
+        for (size_t i=0; i<length; ++i) WriteEscapedChar((char)chars[i], attribute);
+        return;
+    }
+    // UTF-8 Bytes >= 0x80 kollidieren nicht mit den Sonderzeichen
+#if wxUSE_UNICODE
+    wxCharBuffer utf8 = wxConvUTF8.cWC2MB(chars);
+#else
+    wxCharBuffer utf8 = wxConvUTF8.cWC2MB(text.wc_str(wxConvLocal));
+#endif
+    if (unlikely(!utf8)) {
+        wxLogWarning(_T("[penv::XmlWriter::WriteEscaped] Could not convert string to UTF-8."));
+        return;
+    }
+    for (const char* p = utf8.data(); *p != 0; ++p) WriteEscapedChar(*p, attribute);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteEscapedChar(char c, bool attribute)
+/**
+ * \brief Writes a byte and escapes the special characters.
+ * \param c The byte.
+ * \param attribute True if the byte is part of an attribute value.
+ **/
+{
+    if (c == '&') WriteRaw("&amp;", 5);
+    else if (c == '<') WriteRaw("&lt;", 4);
+    else if (c == '>') WriteRaw("&gt;", 4);
+    else if (attribute && c == '"') WriteRaw("&quot;", 6);
+    else if (attribute && c == '\n') WriteRaw("&#10;", 5);
+    else if (attribute && c == '\r') WriteRaw("&#13;", 5);
+    else if (attribute && c == '\t') WriteRaw("&#9;", 4);
+    else if (likely(m_bufferpos < penvXMLWRITER_BUFFERSIZE)) m_buffer[m_bufferpos++] = c;
+    else WriteRaw(&c, 1);
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::WriteRaw(const char* data, size_t length)
+/**
+ * \brief Writes bytes into the buffer, the buffer is written into the
+ * file if it is full.
+ * \param data The bytes.
+ * \param length Number of bytes.
+ **/
+{
+    while (length > 0)
+    {
+        if (m_bufferpos == penvXMLWRITER_BUFFERSIZE) Flush();
+        size_t count = penvXMLWRITER_BUFFERSIZE - m_bufferpos;
+        if (count > length) count = length;
+        memcpy(m_buffer+m_bufferpos, data, count);
+        m_bufferpos += count;
+        data += count;
+        length -= count;
+    }
+}
+
+
+//----------------------------------------------------------------
+void XmlWriter::Flush()
+/**
+ * \brief Writes the buffer into the file.
+ **/
+{
+    if (m_bufferpos == 0) return;
+    if (unlikely(!m_file.IsOpened() || m_file.Write(m_buffer, m_bufferpos) != m_bufferpos)) {
+        m_error = true;
+    }
+    m_bufferpos = 0;
+}
+
+
+} // namespace penv
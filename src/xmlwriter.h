@@ -0,0 +1,91 @@
+/*
+ * xmlwriter.h - Declaration of the XmlWriter class
+ *
+ * Author: agent
+ * Date: 10/18/2026
+ *
+ */
+
+#ifndef _PENV_XMLWRITER_H_
+#define _PENV_XMLWRITER_H_
+
+#include "wxincludes.h"
+
+
+/**
+ * \brief Definition of the size of the buffer in bytes, which is
+ * used by the XmlWriter to write the file.
+ **/
+#define penvXMLWRITER_BUFFERSIZE 65536
+
+
+namespace penv {
+
+/**
+ * \brief The XmlWriter class writes a xml file element by element,
+ * without building the whole document in memory like wxXmlDocument.
+ * The output is buffered and always encoded in UTF-8. Text and
+ * attribute values are escaped.<br>
+ * Example:<br>
+ * <code>
+ * XmlWriter writer;<br>
+ * writer.Open(filename);<br>
+ * writer.WriteStartElement(_T("project"));<br>
+ * writer.WriteAttribute(_T("name"), name);<br>
+ * writer.WriteElement(_T("name"), name);<br>
+ * writer.WriteEndElement();<br>
+ * if (!writer.Close()) error...<br>
+ * </code>
+ * Existing WriteNode() methods, which return a wxXmlNode, can be
+ * written with WriteNode(wxXmlNode*).<br>
+ * The file is written into a temporary file, which is renamed to the
+ * xml file in Close(), so a failed write never leaves a half written
+ * file behind.
+ **/
+class XmlWriter
+{
+    public:
+        XmlWriter(size_t indentstep = 1);
+        ~XmlWriter();
+    private:
+        XmlWriter(const XmlWriter& writer);
+        XmlWriter& operator=(const XmlWriter& writer);
+
+    public:
+        bool Open(const wxString& filename);
+        bool Close();
+
+        void WriteStartElement(const wxString& name);
+        void WriteAttribute(const wxString& name, const wxString& value);
+        void WriteText(const wxString& text);
+        void WriteEndElement();
+        void WriteElement(const wxString& name, const wxString& content);
+        void WriteNode(const wxXmlNode* node);
+
+        size_t GetDepth() const;
+        bool HasError() const;
+
+    private:
+        void CloseStartTag();
+        void WriteIndent(size_t depth);
+        void WriteEscaped(const wxString& text, bool attribute);
+        void WriteEscapedChar(char c, bool attribute);
+        void WriteRaw(const char* data, size_t length);
+        void Flush();
+
+    private:
+        wxFile m_file;
+        wxString m_filename;
+        wxString m_tempfilename;
+        char* m_buffer;
+        size_t m_bufferpos;
+        size_t m_indentstep;
+        bool m_starttagopen;
+        bool m_error;
+        wxArrayString m_elements;
+        wxArrayInt m_childelements;
+};
+
+} // namespace penv
+
+#endif // _PENV_XMLWRITER_H_
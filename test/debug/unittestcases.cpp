@@ -8,6 +8,10 @@
 
 
 #include "unittestdocument.h"
+#include <algorithm>
+#include <stdio.h>  // for fopen()
+#include <stdlib.h> // for atol()
+#include <string.h> // for strncmp()
 
 
 using namespace penv;
@@ -20,8 +24,32 @@ void UnitTestDocument::SetupTestCases()
 {
     AddTest(_T("Path Class"), &UnitTestDocument::TestPathClass);
     AddTest(_T("Array Class"), &UnitTestDocument::TestArrayClass);
+    AddTest(_T("Array Benchmark"), &UnitTestDocument::TestArrayBenchmark);
+    AddTest(_T("Memory Pool Benchmark"), &UnitTestDocument::TestMemoryPoolBenchmark);
+    AddTest(_T("Command Handles"), &UnitTestDocument::TestCommandHandles);
+    AddTest(_T("Command Post"), &UnitTestDocument::TestCommandPost);
+    AddTest(_T("Command Profiler"), &UnitTestDocument::TestCommandProfiler);
+    AddTest(_T("Command Item Index"), &UnitTestDocument::TestCommandItemIndex);
+    AddTest(_T("Command Update"), &UnitTestDocument::TestCommandUpdate);
     AddTest(_T("Version Class"), &UnitTestDocument::TestVersionClass);
     AddTest(_T("Property and PropertyList Classes"), &UnitTestDocument::TestPropertyClass);
+    AddTest(_T("PropertyList Path Cache"), &UnitTestDocument::TestPropertyListPathCache);
+    AddTest(_T("Property Arrays"), &UnitTestDocument::TestPropertyArrays);
+    AddTest(_T("Streaming Xml Loader"), &UnitTestDocument::TestStreamingXmlLoader);
+    AddTest(_T("Streaming Xml Writer"), &UnitTestDocument::TestStreamingXmlWriter);
+    AddTest(_T("Parallel Project Loader"), &UnitTestDocument::TestParallelProjectLoader);
+    AddTest(_T("Lazy Project Items"), &UnitTestDocument::TestLazyProjectItems);
+    AddTest(_T("Workspace Snapshot"), &UnitTestDocument::TestWorkspaceSnapshot);
+    AddTest(_T("Path Checker"), &UnitTestDocument::TestPathChecker);
+    AddTest(_T("Parallel Project Saver"), &UnitTestDocument::TestParallelProjectSaver);
+    AddTest(_T("Modified Counters"), &UnitTestDocument::TestModifiedCounters);
+    AddTest(_T("Copy On Write Clone"), &UnitTestDocument::TestCopyOnWriteClone);
+    AddTest(_T("Directory Watcher"), &UnitTestDocument::TestDirectoryWatcher);
+    AddTest(_T("Project Tree Search"), &UnitTestDocument::TestProjectTreeSearch);
+    AddTest(_T("Lazy Project Tree"), &UnitTestDocument::TestLazyProjectTree);
+    AddTest(_T("Project Tree Refresh"), &UnitTestDocument::TestProjectTreeRefresh);
+    AddTest(_T("Project Tree Filter"), &UnitTestDocument::TestProjectTreeFilter);
+    AddTest(_T("Project Tree Batch"), &UnitTestDocument::TestProjectTreeBatch);
     AddTest(_T("ProjectTreeItemData"), &UnitTestDocument::TestProjectTreeItemData);
 }
 
@@ -194,6 +222,442 @@ void UnitTestDocument::TestArrayClass()
     array.Insert(5, new CommandToolBarTreeData(_T("Insert at 5")));
     //array.Print(true);
     AppendHtml(_T("array test"));
+
+    wxString call, result;
+
+    call   = _T("Array::Insert(0), Array::Insert(10), Array::Insert(5) -> Count() = '13'");
+    result = wxString::Format(_T("%u"), (unsigned int)array.Count());
+    AppendHtml(call, result);
+    AppendHtml(array.Count() == 13);
+
+    call   = _T("Array::Remove(0) -> array[0] = '0'");
+    array.Remove((size_t)0);
+    result = array[0]->GetCommandId();
+    AppendHtml(call, result);
+    AppendHtml(result == _T("0"));
+
+    call   = _T("Array::Reserve(100) -> Capacity() = '100'");
+    array.Reserve(100);
+    result = wxString::Format(_T("%u"), (unsigned int)array.Capacity());
+    AppendHtml(call, result);
+    AppendHtml(array.Capacity() == 100 && array.Count() == 12);
+
+    call   = _T("std::find(array.begin(), array.end(), array[7]) - array.begin() = '7'");
+    CommandToolBarTreeData* element = array[7];
+    Array<CommandToolBarTreeData>::iterator itr = std::find(array.begin(), array.end(), element);
+    result = wxString::Format(_T("%i"), (int)(itr - array.begin()));
+    AppendHtml(call, result);
+    AppendHtml(itr - array.begin() == 7 && array.data()[7] == array.ItemUnchecked(7));
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestArrayBenchmark()
+{
+    // Simulates the loading of a project item list with 100k items,
+    //   the array does not own the elements, so one dummy is enough
+    const size_t count = 100000;
+    CommandToolBarTreeData dummy(_T("dummy"));
+    ArrayGrowth policies[2] = {penvAG_Fixed, penvAG_Geometric};
+    const wxChar* names[2] = {_T("penvAG_Fixed"), _T("penvAG_Geometric")};
+
+    for (size_t p=0; p<2; ++p)
+    {
+        wxStopWatch watch;
+        Array<CommandToolBarTreeData> array(false, policies[p]);
+        for (size_t i=0; i<count; ++i)
+        {
+            array.Add(&dummy);
+        }
+        long addtime = watch.Time();
+        watch.Start();
+        for (size_t i=0; i<1000; ++i)
+        {
+            array.Insert(count/2, &dummy);
+        }
+        long inserttime = watch.Time();
+
+        wxString call = wxString::Format(_T("%s: Add() x %u, Insert() x 1000"), names[p], (unsigned int)count);
+        wxString result = wxString::Format(_T("Add %li ms, Insert %li ms, Capacity %u"),
+            addtime, inserttime, (unsigned int)array.Capacity());
+        AppendHtml(call, result);
+        AppendHtml(array.Count() == count+1000);
+    }
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestMemoryPoolBenchmark()
+{
+    // Simulates a workspace with 200k files, once allocated on
+    //   the heap and once inside the memory pool of a project
+    const size_t count = 200000;
+
+    wxStopWatch watch;
+    ProjectItemList* heaplist = new ProjectItemList((ProjectItem*)NULL);
+    for (size_t i=0; i<count; ++i)
+    {
+        ProjectItem* item = heaplist->CreateProjectItem(penvPI_File);
+        item->SetName(wxString::Format(_T("file%u.cpp"), (unsigned int)i));
+        item->GetPropertyList()->Set(_T("size"), (int)i);
+        heaplist->Add(item);
+    }
+    long heapcreatetime = watch.Time();
+    watch.Start();
+    delete heaplist;
+    long heapdeletetime = watch.Time();
+
+    watch.Start();
+    Project* project = new Project(NULL);
+    ProjectItemList* poollist = project->GetProjectItemList();
+    for (size_t i=0; i<count; ++i)
+    {
+        ProjectItem* item = poollist->CreateProjectItem(penvPI_File);
+        item->SetName(wxString::Format(_T("file%u.cpp"), (unsigned int)i));
+        item->GetPropertyList()->Set(_T("size"), (int)i);
+        poollist->Add(item);
+    }
+    long poolcreatetime = watch.Time();
+    MemoryPool* pool = project->GetMemoryPool();
+    if (pool == NULL) {
+        AppendHtml(_T("penvCOMMON_USEMEMORYPOOL is false"), _T("no pool"));
+        AppendHtml(false);
+        delete project;
+        return;
+    }
+    size_t allocations = pool->GetAllocationCount();
+    size_t slabs = pool->GetSlabCount();
+    size_t memory = pool->GetMemorySize();
+    watch.Start();
+    delete project;
+    long pooldeletetime = watch.Time();
+
+    wxString call = wxString::Format(_T("Heap: CreateProjectItem() x %u"), (unsigned int)count);
+    wxString result = wxString::Format(_T("Create %li ms, Delete %li ms, Allocations %u"),
+        heapcreatetime, heapdeletetime, (unsigned int)allocations);
+    AppendHtml(call, result);
+    AppendHtml(true);
+
+    call = wxString::Format(_T("Pool: CreateProjectItem() x %u"), (unsigned int)count);
+    result = wxString::Format(_T("Create %li ms, Delete %li ms, Slabs %u, Memory %u KB"),
+        poolcreatetime, pooldeletetime, (unsigned int)slabs, (unsigned int)(memory/1024));
+    AppendHtml(call, result);
+    AppendHtml(allocations >= 3*count && slabs < allocations/100);
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestCommandHandles()
+{
+    CommandList* list = Environment::Get()->GetCommandList();
+
+    // Framework events are resolved by their enumerator
+    wxString call = _T("GetCommand(penvCE_ProjectItemMoved)->GetId()");
+    wxString result = list->GetCommand(penvCE_ProjectItemMoved)->GetId();
+    AppendHtml(call, result);
+    AppendHtml(result == _T("PENV_EVT_PROJECTITEM_MOVED"));
+
+    // Handle can be resolved before the command exists
+    CommandHandle handle = list->GetHandle(_T("PENV_TEST_COMMANDHANDLE"));
+    call = _T("GetCommand(handle) before Add()");
+    result = wxString::Format(_T("%p"), list->GetCommand(handle));
+    AppendHtml(call, result);
+    AppendHtml(list->GetCommand(handle) == NULL);
+
+    list->Add(new Command(_T("PENV_TEST_COMMANDHANDLE"), _T("test"), _T("test"), true));
+    call = _T("GetCommand(handle) after Add()");
+    result = list->GetCommand(handle)->GetId();
+    AppendHtml(call, result);
+    AppendHtml(list->GetCommand(handle) == list->GetCommand(_T("PENV_TEST_COMMANDHANDLE")) &&
+        list->GetHandle(_T("PENV_TEST_COMMANDHANDLE")) == handle);
+
+    // Compare string lookups with handles
+    const size_t count = 100000;
+    wxStopWatch watch;
+    for (size_t i=0; i<count; ++i)
+    {
+        list->Execute(_T("PENV_TEST_COMMANDHANDLE"));
+    }
+    long stringtime = watch.Time();
+    watch.Start();
+    for (size_t i=0; i<count; ++i)
+    {
+        list->Execute(handle);
+    }
+    long handletime = watch.Time();
+    call = wxString::Format(_T("Execute() x %u"), (unsigned int)count);
+    result = wxString::Format(_T("String %li ms, Handle %li ms"), stringtime, handletime);
+    AppendHtml(call, result);
+    AppendHtml(true);
+
+    Command* cmd = list->GetCommand(handle);
+    list->Remove(_T("PENV_TEST_COMMANDHANDLE"), false);
+    delete cmd;
+    call = _T("GetCommand(handle) after Remove()");
+    result = wxString::Format(_T("%p"), list->GetCommand(handle));
+    AppendHtml(call, result);
+    AppendHtml(list->GetCommand(handle) == NULL);
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestCommandItemIndex()
+{
+    CommandList* list = Environment::Get()->GetCommandList();
+
+    // The index must contain the same items as a search
+    wxArrayString* ids = list->GetCommands();
+    bool equal = true;
+    Command* testcmd = NULL;
+    for (size_t i=0; i<ids->Count(); ++i)
+    {
+        Array<MenuItem>* indexed = list->GetMenuItems(ids->Item(i));
+        Array<MenuItem>* found = list->GetMenuBar()->FindMenuItems(ids->Item(i));
+        size_t count = (indexed == NULL ? 0 : indexed->Count());
+        if (count != found->Count()) equal = false;
+        if (count > 0 && testcmd == NULL) testcmd = list->GetCommand(ids->Item(i));
+        delete found;
+        Array<ToolBarItem>* tbindexed = list->GetToolBarItems(ids->Item(i));
+        Array<ToolBarItem>* tbfound = list->GetToolBarList()->FindToolBarItems(ids->Item(i));
+        size_t tbcount = (tbindexed == NULL ? 0 : tbindexed->Count());
+        if (tbcount > tbfound->Count()) equal = false;
+        delete tbfound;
+    }
+    delete ids;
+    wxString call = _T("GetMenuItems() and GetToolBarItems() compared with search");
+    wxString result = (equal ? _T("equal") : _T("not equal"));
+    AppendHtml(call, result);
+    AppendHtml(equal);
+
+    if (testcmd == NULL) return;
+
+    // Enable() changes the indexed menu items
+    bool enabled = testcmd->IsEnabled();
+    testcmd->Enable(!enabled);
+    wxMenuItem* menuitem = list->GetMenuItems(testcmd->GetId())->ItemUnchecked(0)->GetMenuItem();
+    call = wxString::Format(_T("Enable(%s) for '%s'"),
+        (!enabled ? _T("true") : _T("false")), testcmd->GetId().c_str());
+    result = (menuitem->IsEnabled() ? _T("enabled") : _T("disabled"));
+    AppendHtml(call, result);
+    AppendHtml(menuitem->IsEnabled() == !enabled);
+
+    const size_t count = 10000;
+    wxStopWatch watch;
+    for (size_t i=0; i<count; ++i)
+    {
+        testcmd->Enable((i % 2) == 0);
+    }
+    call = wxString::Format(_T("Enable() x %u"), (unsigned int)count);
+    result = wxString::Format(_T("%li ms"), watch.Time());
+    AppendHtml(call, result);
+    AppendHtml(true);
+    testcmd->Enable(enabled);
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestCommandUpdate()
+{
+    CommandList* list = Environment::Get()->GetCommandList();
+
+    // Toolbar with 50 buttons, like a editor with many commands
+    const size_t count = 50;
+    ToolBar* toolbar = new ToolBar();
+    toolbar->SetName(_T("Command Update Test"));
+    Command* commands[count];
+    for (size_t i=0; i<count; ++i)
+    {
+        commands[i] = new Command(wxString::Format(_T("PENV_TEST_COMMANDUPDATE_%u"), (unsigned int)i),
+            _T("test"), _T("test"));
+        commands[i]->SetIcon(wxBitmap(16, 16));
+        list->Add(commands[i]);
+        toolbar->Add(new ToolBarItem(commands[i]));
+    }
+    list->GetToolBarList()->Add(toolbar);
+    list->GetToolBarList()->Update();
+
+    // Tab switch: all commands disabled and enabled again
+    const size_t switches = 20;
+    wxStopWatch watch;
+    for (size_t j=0; j<switches; ++j)
+    {
+        for (size_t i=0; i<count; ++i) commands[i]->Enable(false);
+        for (size_t i=0; i<count; ++i) commands[i]->Enable(true);
+    }
+    long singletime = watch.Time();
+    watch.Start();
+    for (size_t j=0; j<switches; ++j)
+    {
+        CommandUpdateLocker locker(list);
+        for (size_t i=0; i<count; ++i) commands[i]->Enable(false);
+        for (size_t i=0; i<count; ++i) commands[i]->Enable(true);
+    }
+    long lockertime = watch.Time();
+    wxString call = wxString::Format(_T("%u tab switches with %u toolbar buttons"), (unsigned int)switches, (unsigned int)count);
+    wxString result = wxString::Format(_T("Without locker %li ms, with locker %li ms"), singletime, lockertime);
+    AppendHtml(call, result);
+    AppendHtml(true);
+
+    // Realize is deferred until the last EndUpdate()
+    list->BeginUpdate();
+    list->BeginUpdate();
+    list->GetToolBarList()->RealizeAllToolBars();
+    list->EndUpdate();
+    call = _T("IsUpdating() after nested EndUpdate()");
+    result = (list->IsUpdating() ? _T("true") : _T("false"));
+    AppendHtml(call, result);
+    AppendHtml(list->IsUpdating());
+    list->EndUpdate();
+    call = _T("IsUpdating() after last EndUpdate()");
+    result = (list->IsUpdating() ? _T("true") : _T("false"));
+    AppendHtml(call, result);
+    AppendHtml(!list->IsUpdating());
+
+    list->GetToolBarList()->Remove(toolbar->GetId());
+    Environment::Get()->GetFrame()->GetManager()->Update();
+    for (size_t i=0; i<count; ++i)
+    {
+        list->Remove(commands[i]->GetId());
+    }
+}
+
+
+
+/**
+ * \brief Thread for the tests, which posts a command with a string
+ * variant a number of times.
+ **/
+class UnitTestPostThread : public wxThread
+{
+    public:
+        UnitTestPostThread(size_t count) : wxThread(wxTHREAD_JOINABLE) { m_count = count; }
+        virtual ExitCode Entry()
+        {
+            CommandList* list = Environment::Get()->GetCommandList();
+            for (size_t i=0; i<m_count; ++i)
+            {
+                list->Post(_T("PENV_TEST_COMMANDPOST"), wxVariant(wxString::Format(_T("thread %u"), (unsigned int)i)));
+            }
+            return (0);
+        }
+    private:
+        size_t m_count;
+};
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestCommandPost()
+{
+    CommandList* list = Environment::Get()->GetCommandList();
+    Command* cmd = new Command(_T("PENV_TEST_COMMANDPOST"), _T("test"), _T("test"), true);
+    list->Add(cmd);
+    size_t connectid = cmd->Connect(new CommandCallback<UnitTestDocument>(this, &UnitTestDocument::OnTestCommandPosted));
+    // Execute all commands, which are posted from elsewhere
+    while (list->ProcessPostedCommands()) {}
+
+    m_postedcount = 0;
+    list->Post(_T("PENV_TEST_COMMANDPOST"));
+    list->Post(_T("PENV_TEST_COMMANDPOST"));
+    size_t before = m_postedcount;
+    while (list->ProcessPostedCommands()) {}
+    wxString call = _T("Post() x 2, no coalescing");
+    wxString result = wxString::Format(_T("executed %u before and %u after processing"), (unsigned int)before, (unsigned int)m_postedcount);
+    AppendHtml(call, result);
+    AppendHtml(before == 0 && m_postedcount == 2);
+
+    m_postedcount = 0;
+    CommandHandle handle = list->GetHandle(_T("PENV_TEST_COMMANDPOST"));
+    for (size_t i=0; i<1000; ++i)
+    {
+        list->Post(handle, wxVariant(), true);
+    }
+    list->Post(handle, wxVariant((long)1), true);
+    call = _T("Post() x 1000 + 1 with other variant, coalescing");
+    while (list->ProcessPostedCommands(10)) {}
+    result = wxString::Format(_T("executed %u"), (unsigned int)m_postedcount);
+    AppendHtml(call, result);
+    AppendHtml(m_postedcount == 2);
+
+    // Posts from a worker thread, the callbacks are only executed by
+    //   ProcessPostedCommands() on the main thread
+    m_postedcount = 0;
+    m_postedstring = wxEmptyString;
+    const size_t threadcount = 1000;
+    UnitTestPostThread* thread = new UnitTestPostThread(threadcount);
+    bool ok = thread->Create() == wxTHREAD_NO_ERROR && thread->Run() == wxTHREAD_NO_ERROR;
+    if (ok) thread->Wait();
+    delete thread;
+    before = m_postedcount;
+    while (list->ProcessPostedCommands()) {}
+    call = wxString::Format(_T("Post() x %u from a worker thread"), (unsigned int)threadcount);
+    result = wxString::Format(_T("executed %u before and %u after processing, last '%s'"),
+        (unsigned int)before, (unsigned int)m_postedcount, m_postedstring.c_str());
+    AppendHtml(call, result);
+    AppendHtml(ok && before == 0 && m_postedcount == threadcount &&
+        m_postedstring == wxString::Format(_T("thread %u"), (unsigned int)(threadcount-1)));
+
+    cmd->Disconnect(connectid);
+    list->Remove(_T("PENV_TEST_COMMANDPOST"), false);
+    delete cmd;
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestCommandProfiler()
+{
+    CommandList* list = Environment::Get()->GetCommandList();
+    Command* cmd = new Command(_T("PENV_TEST_COMMANDPROFILER"), _T("test"), _T("test"), true);
+    list->Add(cmd);
+    size_t connectid = cmd->Connect(new CommandCallback<UnitTestDocument>(this, &UnitTestDocument::OnTestCommandPosted));
+
+    bool enabled = Command::IsProfilingEnabled();
+    Command::EnableProfiling(true);
+    for (size_t i=0; i<100; ++i)
+    {
+        cmd->Execute();
+    }
+    Command::EnableProfiling(enabled);
+    wxString call = _T("Execute() x 100 with profiler");
+    wxString result = wxString::Format(_T("count %u, callback count %u, total %s us"),
+        (unsigned int)cmd->GetProfileCount(), (unsigned int)cmd->GetCallback(connectid)->GetProfileCount(),
+        cmd->GetProfileTotalTime().ToString().c_str());
+    AppendHtml(call, result);
+    AppendHtml(cmd->GetProfileCount() == 100 && cmd->GetCallback(connectid)->GetProfileCount() == 100 &&
+        cmd->GetProfileMaxTime() <= cmd->GetProfileTotalTime());
+
+    wxString filename = wxFileName::CreateTempFileName(_T("penv"));
+    call = _T("ExportProfiles()");
+    result = filename;
+    AppendHtml(call, result);
+    AppendHtml(list->ExportProfiles(filename) && wxFileName::GetSize(filename) > 0);
+    wxRemoveFile(filename);
+
+    cmd->ResetProfile();
+    call = _T("ResetProfile()");
+    result = wxString::Format(_T("count %u"), (unsigned int)cmd->GetProfileCount());
+    AppendHtml(call, result);
+    AppendHtml(cmd->GetProfileCount() == 0 && cmd->GetCallback(connectid)->GetProfileCount() == 0);
+
+    cmd->Disconnect(connectid);
+    list->Remove(_T("PENV_TEST_COMMANDPROFILER"), false);
+    delete cmd;
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::OnTestCommandPosted(CommandEvent& event)
+{
+    m_postedcount++;
+    if (event.GetVariant().GetType() == _T("string")) {
+        m_postedstring = event.GetVariant().GetString();
+    }
 }
 
 
@@ -281,6 +745,422 @@ void UnitTestDocument::TestPropertyClass()
 
 
 
+//----------------------------------------------------------------
+void UnitTestDocument::TestPropertyListPathCache()
+{
+    PropertyList* props = new PropertyList();
+    props->Set(_T("editor/font/size"), 10);
+    props->Set(_T("editor/font/name"), _T("Courier New"));
+    props->Set(_T("editor/tabs/usespaces"), true);
+    props->Set(_T("editor/tabs/width"), 4);
+
+    // Cache is invalidated when the property list is replaced
+    props->GetInteger(_T("editor/font/size"));
+    PropertyList* font = props->GetPropertyList(_T("editor/font"));
+    Property* fontprop = font->GetParent();
+    PropertyList* newfont = new PropertyList(fontprop);
+    newfont->Set(_T("size"), 12);
+    fontprop->SetPropertyList(newfont);
+    delete font;
+    wxString call = _T("GetInteger(\"editor/font/size\") after replacing 'font'");
+    wxString result = wxString::Format(_T("%i"), props->GetInteger(_T("editor/font/size")));
+    AppendHtml(call, result);
+    AppendHtml(props->GetInteger(_T("editor/font/size")) == 12);
+    props->Set(_T("editor/font/name"), _T("Courier New"));
+
+    // 1M mixed get and set calls without and with path cache
+    const size_t count = 1000000;
+    long times[2];
+    for (size_t j=0; j<2; ++j)
+    {
+        PropertyList::EnablePathCache(j == 1);
+        wxStopWatch watch;
+        int sum = 0;
+        for (size_t i=0; i<count; ++i)
+        {
+            switch (i % 4)
+            {
+                case 0: sum += props->GetInteger(_T("editor/font/size")); break;
+                case 1: props->Set(_T("editor/tabs/width"), (int)(i % 8)); break;
+                case 2: sum += props->GetString(_T("editor/font/name")).Length(); break;
+                case 3: sum += (props->GetBoolean(_T("editor/tabs/usespaces")) ? 1 : 0); break;
+            }
+        }
+        times[j] = watch.Time();
+    }
+    PropertyList::EnablePathCache(true);
+    call = wxString::Format(_T("%u mixed GetInteger/GetString/GetBoolean/Set calls"), (unsigned int)count);
+    result = wxString::Format(_T("Without cache %li ms, with cache %li ms"), times[0], times[1]);
+    AppendHtml(call, result);
+    AppendHtml(true);
+
+    // Xml format stays the same
+    wxXmlNode* node = props->WriteNode();
+    PropertyList* readprops = new PropertyList();
+    bool ok = readprops->ReadNode(node);
+    delete node;
+    call = _T("WriteNode() and ReadNode()");
+    result = readprops->GetString(_T("editor/font/name"));
+    AppendHtml(call, result);
+    AppendHtml(ok && readprops->GetString(_T("editor/font/name")) == _T("Courier New") &&
+        readprops->GetInteger(_T("editor/font/size")) == 12 &&
+        readprops->GetBoolean(_T("editor/tabs/usespaces")) &&
+        readprops->ExistsProperty(_T("editor/tabs/width")));
+    delete readprops;
+
+    // Cached paths of a copied list are not changed through the copy
+    props->Set(_T("editor/tabs/width"), 4);
+    PropertyList* copy = props->Clone();
+    copy->GetInteger(_T("editor/tabs/width"));
+    copy->Set(_T("editor/tabs/width"), 8);
+    props->Set(_T("editor/font/size"), 14);
+    call = _T("Set(\"editor/tabs/width\") on a copy");
+    result = wxString::Format(_T("original %i, copy %i"), props->GetInteger(_T("editor/tabs/width")),
+        copy->GetInteger(_T("editor/tabs/width")));
+    AppendHtml(call, result);
+    AppendHtml(props->GetInteger(_T("editor/tabs/width")) == 4 &&
+        copy->GetInteger(_T("editor/tabs/width")) == 8 &&
+        copy->GetInteger(_T("editor/font/size")) == 12);
+    delete copy;
+    delete props;
+}
+
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestPropertyArrays()
+{
+    PropertyList* props = new PropertyList();
+    bool bools[] = {true, false, true};
+    int ints[] = {120, -80, 200, 0};
+    double doubles[] = {0.5, -1.25, 3.0e10};
+    wxString strings[] = {_T("C:\\temp\\file.txt"), wxEmptyString, _T("line1\nline2")};
+    props->Set(_T("arrays/bools"), bools, WXSIZEOF(bools));
+    props->Set(_T("arrays/ints"), ints, WXSIZEOF(ints));
+    props->Set(_T("arrays/doubles"), doubles, WXSIZEOF(doubles));
+    props->Set(_T("arrays/strings"), strings, WXSIZEOF(strings));
+    props->Set(_T("arrays/onestring"), strings+1, 1);
+
+    // Xml round trip
+    wxXmlNode* node = props->WriteNode();
+    PropertyList* readprops = new PropertyList();
+    readprops->ReadNode(node);
+    delete node;
+    size_t count = 0;
+    const int* readints = readprops->GetIntegerArray(_T("arrays/ints"), &count);
+    bool ok = (count == WXSIZEOF(ints) && memcmp(readints, ints, sizeof(ints)) == 0);
+    const bool* readbools = readprops->GetBooleanArray(_T("arrays/bools"), &count);
+    ok = ok && (count == WXSIZEOF(bools) && memcmp(readbools, bools, sizeof(bools)) == 0);
+    const double* readdoubles = readprops->GetDoubleArray(_T("arrays/doubles"), &count);
+    ok = ok && (count == WXSIZEOF(doubles) && memcmp(readdoubles, doubles, sizeof(doubles)) == 0);
+    const wxString* readstrings = readprops->GetStringArray(_T("arrays/strings"), &count);
+    ok = ok && (count == WXSIZEOF(strings));
+    for (size_t i=0; ok && i<count; ++i) ok = (readstrings[i] == strings[i]);
+    readprops->GetStringArray(_T("arrays/onestring"), &count);
+    ok = ok && (count == 1);
+    wxString call = _T("WriteNode() and ReadNode() with arrays");
+    wxString result = (ok ? _T("equal") : _T("not equal"));
+    AppendHtml(call, result);
+    AppendHtml(ok);
+    delete readprops;
+
+    // Bulk write and parse of 100000 values
+    const size_t bulkcount = 100000;
+    int* bulk = new int[bulkcount];
+    for (size_t i=0; i<bulkcount; ++i) bulk[i] = (int)(i*7) - 1000;
+    props->Set(_T("bulk"), bulk, bulkcount);
+    wxStopWatch watch;
+    node = props->GetProperty(_T("bulk"))->WriteNode();
+    long writetime = watch.Time();
+    watch.Start();
+    Property* bulkprop = new Property();
+    bulkprop->ReadNode(node);
+    long readtime = watch.Time();
+    delete node;
+    ok = (bulkprop->GetArrayCount() == bulkcount &&
+        memcmp(bulkprop->GetIntegerArray(), bulk, bulkcount*sizeof(int)) == 0);
+    delete bulkprop;
+    delete [] bulk;
+    call = wxString::Format(_T("WriteNode() and ReadNode() with %u integers"), (unsigned int)bulkcount);
+    result = wxString::Format(_T("Write %li ms, read %li ms"), writetime, readtime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // Changes a string property into an array property and back, the
+    //   old value must be freed
+    Property stringprop(_T("changing"), wxString(_T("text")));
+    Property arrayprop;
+    arrayprop.SetName(_T("changing"));
+    arrayprop.SetStringArray(strings, WXSIZEOF(strings));
+    Property listprop(_T("changing"), new PropertyList());
+    {
+        wxLogNull nolog;
+        props->SetProperty(_T("changing"), stringprop);
+        props->SetProperty(_T("changing"), arrayprop);
+        readstrings = props->GetStringArray(_T("changing"), &count);
+        ok = (props->GetType(_T("changing")) == penvPT_ArrayString && count == WXSIZEOF(strings));
+        for (size_t i=0; ok && i<count; ++i) ok = (readstrings[i] == strings[i]);
+        props->SetProperty(_T("changing"), stringprop);
+        ok = ok && props->GetString(_T("changing")) == _T("text");
+        props->Set(_T("changing"), strings, WXSIZEOF(strings));
+        props->Set(_T("changing"), _T("again"));
+        ok = ok && props->GetString(_T("changing")) == _T("again");
+        props->SetProperty(_T("changing"), listprop);
+        props->SetProperty(_T("changing"), arrayprop);
+        props->GetStringArray(_T("changing"), &count);
+        ok = ok && props->GetType(_T("changing")) == penvPT_ArrayString && count == WXSIZEOF(strings);
+    }
+    call = _T("SetProperty() string -> array -> string -> properties -> array");
+    result = (ok ? _T("equal") : _T("not equal"));
+    AppendHtml(call, result);
+    AppendHtml(ok);
+    delete props;
+}
+
+
+
+//----------------------------------------------------------------
+static long GetProcessMemory(const char* key, bool resetpeak = false)
+/**
+ * \brief Reads a memory value in KB from /proc/self/status, like
+ * "VmRSS:" or "VmHWM:" (peak). Only available on linux.
+ * \return Memory in KB or -1 if not available.
+ **/
+{
+    if (resetpeak) {
+        FILE* refs = fopen("/proc/self/clear_refs", "w");
+        if (refs != NULL) {
+            fputs("5", refs);
+            fclose(refs);
+        }
+    }
+    FILE* status = fopen("/proc/self/status", "r");
+    if (status == NULL) return (-1);
+    long value = -1;
+    char line[256];
+    size_t length = strlen(key);
+    while (fgets(line, sizeof(line), status) != NULL)
+    {
+        if (strncmp(line, key, length) == 0) {
+            value = atol(line+length);
+            break;
+        }
+    }
+    fclose(status);
+    return (value);
+}
+
+
+//----------------------------------------------------------------
+static size_t CreateTestProjectFile(const wxString& filename, size_t count)
+/**
+ * \brief Writes a project file with the given number of file items,
+ * every item has two properties.
+ * \return Size of the file in bytes.
+ **/
+{
+    wxFile file(filename, wxFile::write);
+    const char* header = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<project>\n<name>Streaming &amp; Test</name>\n<projectitems>\n";
+    file.Write(header, strlen(header));
+    char buffer[512];
+    for (size_t i=0; i<count; ++i)
+    {
+        int length = sprintf(buffer, "<projectitem type=\"file\" name=\"file%u.cpp\" virtual=\"true\">"
+            "<filename>/tmp/penv/streaming/directory%u/file%u.cpp</filename>"
+            "<properties><property name=\"size\" type=\"integer\">%u</property>"
+            "<property name=\"description\" type=\"string\">File number %u in the streaming test</property>"
+            "</properties></projectitem>\n", (unsigned)i, (unsigned)(i/100), (unsigned)i, (unsigned)i, (unsigned)i);
+        file.Write(buffer, length);
+    }
+    int length = sprintf(buffer, "</projectitems>\n<properties><property name=\"count\" type=\"integer\">%u</property>"
+        "</properties>\n</project>\n", (unsigned)count);
+    file.Write(buffer, length);
+    size_t filesize = (size_t)file.Length();
+    file.Close();
+    return (filesize);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestStreamingXmlLoader()
+{
+    // Creates a project file with about 50 MB and loads it once with
+    //   wxXmlDocument and once with the XmlReader
+    const size_t count = 160000;
+    wxString filename = wxFileName::CreateTempFileName(_T("penv"));
+    size_t filesize = CreateTestProjectFile(filename, count);
+
+    // Streaming with XmlReader
+    long streambase = GetProcessMemory("VmRSS:", true);
+    wxStopWatch watch;
+    Project* project = new Project(NULL);
+    project->SetFileName(filename);
+    bool ok = project->Load();
+    long streamtime = watch.Time();
+    long streampeak = GetProcessMemory("VmHWM:") - streambase;
+    ok = ok && project->GetProjectItemList()->Count() == count;
+    ok = ok && project->GetName() == _T("Streaming & Test");
+    ok = ok && project->GetPropertyList()->GetInteger(_T("count")) == (int)count;
+    ProjectItem* last = project->GetProjectItemList()->GetItem(count-1);
+    ok = ok && last->GetPropertyList()->GetInteger(_T("size")) == (int)(count-1);
+    delete project;
+    wxString call = wxString::Format(_T("Project::Load() with XmlReader, %u items, %u MB"), (unsigned int)count, (unsigned int)(filesize/(1024*1024)));
+    wxString result = wxString::Format(_T("%li ms, peak %li KB"), streamtime, streampeak);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // Compatibility path with wxXmlDocument
+    long dombase = GetProcessMemory("VmRSS:", true);
+    watch.Start();
+    project = new Project(NULL);
+    wxXmlDocument doc(filename);
+    wxXmlNode* node = (doc.IsOk() ? doc.GetRoot()->GetChildren() : NULL);
+    while (node != NULL && node->GetName() != _T("projectitems")) node = node->GetNext();
+    bool domok = project->GetProjectItemList()->ReadNode(node);
+    long domtime = watch.Time();
+    long dompeak = GetProcessMemory("VmHWM:") - dombase;
+    domok = domok && project->GetProjectItemList()->Count() == count;
+    delete project;
+    call = _T("ProjectItemList::ReadNode() with wxXmlDocument");
+    result = wxString::Format(_T("%li ms, peak %li KB"), domtime, dompeak);
+    AppendHtml(call, result);
+    AppendHtml(domok);
+
+    // Peak memory is only available on linux
+    call = _T("Peak memory XmlReader < wxXmlDocument");
+    bool available = (streambase >= 0);
+    result = (!available ? wxString(_T("not available")) :
+        wxString::Format(_T("%li KB < %li KB"), streampeak, dompeak));
+    AppendHtml(call, result);
+    AppendHtml(!available || streampeak < dompeak);
+    wxRemoveFile(filename);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestStreamingXmlWriter()
+{
+    // Appending child nodes, walking the list against the builder
+    const size_t nodecount = 20000;
+    wxStopWatch watch;
+    wxXmlNode* walknode = PenvHelper::CreateXmlNode(_T("items"));
+    for (size_t i=0; i<nodecount; ++i) {
+        PenvHelper::AddXmlChildNode(walknode, PenvHelper::CreateXmlNode(_T("item")));
+    }
+    long walktime = watch.Time();
+    watch.Start();
+    wxXmlNode* buildnode = PenvHelper::CreateXmlNode(_T("items"));
+    XmlNodeBuilder builder(buildnode);
+    for (size_t i=0; i<nodecount; ++i) {
+        builder.Append(PenvHelper::CreateXmlNode(_T("item")));
+    }
+    long buildtime = watch.Time();
+    size_t built = 0;
+    for (wxXmlNode* child = buildnode->GetChildren(); child != NULL; child = child->GetNext()) built++;
+    delete walknode;
+    delete buildnode;
+    wxString call = wxString::Format(_T("AddXmlChildNode() against XmlNodeBuilder, %u nodes"), (unsigned int)nodecount);
+    wxString result = wxString::Format(_T("%li ms against %li ms"), walktime, buildtime);
+    AppendHtml(call, result);
+    AppendHtml(built == nodecount);
+
+    // Saving a project with 100000 items
+    const size_t count = 100000;
+    wxString filename = wxFileName::CreateTempFileName(_T("penv"));
+    CreateTestProjectFile(filename, count);
+    Project* project = new Project(NULL);
+    project->SetFileName(filename);
+    bool ok = project->Load();
+    watch.Start();
+    wxXmlNode* node = project->GetProjectItemList()->WriteNode();
+    long domtime = watch.Time();
+    delete node;
+    watch.Start();
+    ok = ok && project->Save();
+    long savetime = watch.Time();
+    delete project;
+    project = new Project(NULL);
+    project->SetFileName(filename);
+    ok = ok && project->Load();
+    ok = ok && project->GetProjectItemList()->Count() == count;
+    ok = ok && project->GetName() == _T("Streaming & Test");
+    ProjectItem* last = project->GetProjectItemList()->GetItem(count-1);
+    ok = ok && last->GetPropertyList()->GetString(_T("description")) ==
+        wxString::Format(_T("File number %u in the streaming test"), (unsigned int)(count-1));
+    delete project;
+    wxRemoveFile(filename);
+    call = wxString::Format(_T("ProjectItemList::WriteNode() and Project::Save(), %u items"), (unsigned int)count);
+    result = wxString::Format(_T("WriteNode %li ms, Save %li ms"), domtime, savetime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestParallelProjectLoader()
+{
+    // Creates 64 project files, one of them is broken, and loads
+    //   them with one thread and with one thread per processor
+    const size_t projectcount = 64;
+    const size_t itemcount = 5000;
+    const size_t broken = 5;
+    wxArrayString filenames;
+    for (size_t i=0; i<projectcount; ++i)
+    {
+        filenames.Add(wxFileName::CreateTempFileName(_T("penv")));
+        CreateTestProjectFile(filenames[i], itemcount);
+    }
+    wxFile file(filenames[broken], wxFile::write);
+    file.Write("<project><projectitems>", 23);
+    file.Close();
+
+    long times[2];
+    size_t threads[2] = { 1, 0 };
+    bool ok = true;
+    for (size_t run=0; run<2; ++run)
+    {
+        ProjectLoader loader(threads[run]);
+        threads[run] = loader.GetThreadCount();
+        for (size_t i=0; i<projectcount; ++i)
+        {
+            Project* project = new Project(NULL);
+            project->SetFileName(filenames[i]);
+            loader.Add(project);
+        }
+        wxStopWatch watch;
+        loader.Run();
+        times[run] = watch.Time();
+        for (size_t i=0; i<projectcount; ++i)
+        {
+            Project* project = loader.GetProject(i);
+            ok = ok && project->GetFileNameString() == filenames[i];
+            if (i == broken) {
+                // Error of the broken project must be collected
+                wxLogBuffer* buffer = new wxLogBuffer();
+                wxLog* oldlog = wxLog::SetActiveTarget(buffer);
+                loader.LogMessages(i);
+                wxLog::SetActiveTarget(oldlog);
+                ok = ok && !loader.GetResult(i);
+                ok = ok && buffer->GetBuffer().Find(filenames[i]) != wxNOT_FOUND;
+                delete buffer;
+            } else {
+                loader.LogMessages(i);
+                ok = ok && loader.GetResult(i);
+                ok = ok && project->GetProjectItemList()->Count() == itemcount;
+            }
+            delete project;
+        }
+    }
+    for (size_t i=0; i<projectcount; ++i) wxRemoveFile(filenames[i]);
+    wxString call = wxString::Format(_T("ProjectLoader::Run(), %u projects with %u items"), (unsigned int)projectcount, (unsigned int)itemcount);
+    wxString result = wxString::Format(_T("%u thread %li ms, %u threads %li ms"), (unsigned int)threads[0], times[0], (unsigned int)threads[1], times[1]);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+
 
 
 ////----------------------------------------------------------------
@@ -396,3 +1276,900 @@ void UnitTestDocument::TestProjectTreeItemData()
     delete data;
 
 }
+
+
+//----------------------------------------------------------------
+static void CreateTestDirectoryProjectFile(const wxString& filename, size_t dircount, size_t filecount)
+/**
+ * \brief Writes a project file with the given number of virtual
+ * directory items, every directory contains filecount file items.
+ **/
+{
+    wxFile file(filename, wxFile::write);
+    const char* header = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<project>\n<name>Lazy Test</name>\n<projectitems>\n";
+    file.Write(header, strlen(header));
+    char buffer[512];
+    for (size_t i=0; i<dircount; ++i)
+    {
+        int length = sprintf(buffer, "<projectitem type=\"directory\" name=\"directory%u\" virtual=\"true\">"
+            "<path>directory%u</path>\n", (unsigned)i, (unsigned)i);
+        file.Write(buffer, length);
+        for (size_t j=0; j<filecount; ++j)
+        {
+            length = sprintf(buffer, "<projectitem type=\"file\" name=\"file%u.cpp\" virtual=\"true\">"
+                "<filename>file%u.cpp</filename>"
+                "<properties><property name=\"size\" type=\"integer\">%u</property></properties>"
+                "</projectitem>\n", (unsigned)j, (unsigned)j, (unsigned)j);
+            file.Write(buffer, length);
+        }
+        length = sprintf(buffer, "<properties><property name=\"index\" type=\"integer\">%u</property>"
+            "</properties></projectitem>\n", (unsigned)i);
+        file.Write(buffer, length);
+    }
+    const char* footer = "</projectitems>\n</project>\n";
+    file.Write(footer, strlen(footer));
+    file.Close();
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestLazyProjectItems()
+{
+    // Creates a project with 400 directories and 250 files in every
+    //   directory, the files are only read on demand
+    const size_t dircount = 400;
+    const size_t filecount = 250;
+    wxString filename = wxFileName::CreateTempFileName(_T("penv"));
+    CreateTestDirectoryProjectFile(filename, dircount, filecount);
+
+    wxStopWatch watch;
+    Project* project = new Project(NULL);
+    project->SetFileName(filename);
+    bool ok = project->Load();
+    long loadtime = watch.Time();
+    ProjectItemList* list = project->GetProjectItemList();
+    ok = ok && list->Count() == dircount;
+    ProjectItem* directory = list->GetItem(dircount-1);
+    ok = ok && directory->GetPropertyList()->GetInteger(_T("index")) == (int)(dircount-1);
+    ok = ok && directory->GetItemList()->IsDeferred();
+    // Reading one directory on demand
+    watch.Start();
+    ok = ok && directory->GetItemList()->Count() == filecount;
+    long expandtime = watch.Time();
+    ok = ok && !directory->GetItemList()->IsDeferred();
+    ProjectItem* last = directory->GetItemList()->GetItem(filecount-1);
+    ok = ok && last->GetName() == wxString::Format(_T("file%u.cpp"), (unsigned int)(filecount-1));
+    ok = ok && last->GetPropertyList()->GetInteger(_T("size")) == (int)(filecount-1);
+    ok = ok && list->GetItem(0)->GetItemList()->IsDeferred();
+    // Reading all project items
+    watch.Start();
+    ok = ok && list->LoadItems(true);
+    long alltime = watch.Time();
+    ok = ok && !list->GetItem(0)->GetItemList()->IsDeferred();
+    ok = ok && list->GetItem(0)->GetItemList()->Count() == filecount;
+    wxString call = wxString::Format(_T("Project::Load(), %u directories with %u files"), (unsigned int)dircount, (unsigned int)filecount);
+    wxString result = wxString::Format(_T("Load %li ms, one directory %li ms, all directories %li ms"), loadtime, expandtime, alltime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // Saving into the same file reads the deferred items before
+    delete project;
+    project = new Project(NULL);
+    project->SetFileName(filename);
+    ok = project->Load();
+    ok = ok && project->Save();
+    delete project;
+    project = new Project(NULL);
+    project->SetFileName(filename);
+    ok = ok && project->Load();
+    list = project->GetProjectItemList();
+    ok = ok && list->Count() == dircount;
+    ok = ok && list->GetItem(dircount/2)->GetItemList()->Count() == filecount;
+    delete project;
+    wxRemoveFile(filename);
+    AppendHtml(_T("Project::Save() with deferred project items"), _T("saved and reloaded"));
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestWorkspaceSnapshot()
+{
+    // Creates a project with 100000 items and compares loading the
+    //   project file with reading a snapshot of the project
+    const size_t count = 100000;
+    wxString filename = wxFileName::CreateTempFileName(_T("penv"));
+    wxString snapshot = wxFileName::CreateTempFileName(_T("penv"));
+    CreateTestProjectFile(filename, count);
+
+    wxStopWatch watch;
+    Project* project = new Project(NULL);
+    project->SetFileName(filename);
+    bool ok = project->Load();
+    long xmltime = watch.Time();
+    SnapshotWriter writer;
+    ok = ok && writer.Open(snapshot);
+    writer.WriteFileStamp(filename);
+    project->WriteSnapshot(&writer);
+    ok = ok && writer.Close();
+    delete project;
+
+    watch.Start();
+    SnapshotReader reader;
+    ok = ok && reader.Open(snapshot);
+    ok = ok && reader.ReadFileStamp();
+    project = new Project(NULL);
+    ok = ok && project->ReadSnapshot(&reader);
+    long snapshottime = watch.Time();
+    reader.Close();
+    ProjectItemList* list = project->GetProjectItemList();
+    ok = ok && !project->IsModified();
+    ok = ok && project->GetName() == _T("Streaming & Test");
+    ok = ok && project->GetFileNameString() == filename;
+    ok = ok && project->GetPropertyList()->GetInteger(_T("count")) == (int)count;
+    ok = ok && list->Count() == count;
+    ProjectItem* last = list->GetItem(count-1);
+    ok = ok && last->GetName() == wxString::Format(_T("file%u.cpp"), (unsigned int)(count-1));
+    ok = ok && last->IsVirtual();
+    ok = ok && last->GetPropertyList()->GetInteger(_T("size")) == (int)(count-1);
+    ok = ok && last->GetPathString() == wxString::Format(_T("/tmp/penv/streaming/directory%u/file%u.cpp"), (unsigned int)((count-1)/100), (unsigned int)(count-1));
+    delete project;
+    wxString call = wxString::Format(_T("Project::ReadSnapshot(), %u items"), (unsigned int)count);
+    wxString result = wxString::Format(_T("Project file %li ms, snapshot %li ms"), xmltime, snapshottime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // A changed project file makes the snapshot invalid
+    CreateTestProjectFile(filename, count/2);
+    ok = reader.Open(snapshot);
+    ok = ok && !reader.ReadFileStamp();
+    reader.Close();
+    // A damaged snapshot is not read
+    wxFile file(snapshot, wxFile::write);
+    file.Write("penv", 4);
+    file.Close();
+    ok = ok && !reader.Open(snapshot);
+    AppendHtml(_T("SnapshotReader::ReadFileStamp() after changing the file"), _T("snapshot rejected"));
+    AppendHtml(ok);
+
+    // Deferred project items stay deferred in the snapshot
+    CreateTestDirectoryProjectFile(filename, 20, 50);
+    project = new Project(NULL);
+    project->SetFileName(filename);
+    ok = project->Load();
+    ok = ok && project->GetProjectItemList()->GetItem(0)->GetItemList()->Count() == 50;
+    ok = ok && writer.Open(snapshot);
+    project->WriteSnapshot(&writer);
+    ok = ok && writer.Close();
+    delete project;
+    ok = ok && reader.Open(snapshot);
+    project = new Project(NULL);
+    ok = ok && project->ReadSnapshot(&reader);
+    list = project->GetProjectItemList();
+    ok = ok && list->Count() == 20;
+    ok = ok && !list->GetItem(0)->GetItemList()->IsDeferred();
+    ok = ok && list->GetItem(1)->GetItemList()->IsDeferred();
+    ok = ok && list->GetItem(19)->GetItemList()->Count() == 50;
+    delete project;
+    wxRemoveFile(filename);
+    wxRemoveFile(snapshot);
+    AppendHtml(_T("Project::ReadSnapshot() with deferred project items"), _T("read on demand"));
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestPathChecker()
+{
+    // Checks 2000 paths, every third path does not exist, once in
+    //   the calling thread and once with the default thread count
+    const size_t count = 2000;
+    wxString directory = wxFileName::CreateTempFileName(_T("penv"));
+    wxRemoveFile(directory);
+    wxMkdir(directory);
+    for (size_t i=0; i<count; i+=3)
+    {
+        wxFile file(Path::Combine(directory, wxString::Format(_T("file%u.txt"), (unsigned int)i)), wxFile::write);
+    }
+    long times[2];
+    size_t threads[2] = { 1, penvCOMMON_PATHCHECKERTHREADS };
+    bool ok = true;
+    for (size_t run=0; run<2; ++run)
+    {
+        PathChecker checker(threads[run]);
+        for (size_t i=0; i<count; ++i)
+        {
+            size_t index = checker.AddFile(Path::Combine(directory, wxString::Format(_T("file%u.txt"), (unsigned int)i)));
+            ok = ok && index == i;
+        }
+        size_t dirindex = checker.AddDirectory(directory);
+        size_t fileindex = checker.AddDirectory(Path::Combine(directory, _T("file0.txt")));
+        wxStopWatch watch;
+        checker.Run();
+        times[run] = watch.Time();
+        for (size_t i=0; i<count; ++i)
+        {
+            ok = ok && checker.Exists(i) == (i % 3 == 0);
+        }
+        ok = ok && checker.Exists(dirindex);
+        ok = ok && !checker.Exists(fileindex);
+    }
+    for (size_t i=0; i<count; i+=3)
+    {
+        wxRemoveFile(Path::Combine(directory, wxString::Format(_T("file%u.txt"), (unsigned int)i)));
+    }
+    wxRmdir(directory);
+    wxString call = wxString::Format(_T("PathChecker::Run(), %u paths"), (unsigned int)(count+2));
+    wxString result = wxString::Format(_T("%u thread %li ms, %u threads %li ms"), (unsigned int)threads[0], times[0], (unsigned int)threads[1], times[1]);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestParallelProjectSaver()
+{
+    // Loads 16 project files, changes them and saves them in parallel,
+    //   one project can not be saved and must keep its old file
+    const size_t projectcount = 16;
+    const size_t itemcount = 2000;
+    const size_t broken = 3;
+    wxArrayString filenames;
+    Array<Project> projects(true);
+    ProjectLoader loader;
+    for (size_t i=0; i<projectcount; ++i)
+    {
+        filenames.Add(wxFileName::CreateTempFileName(_T("penv")));
+        CreateTestProjectFile(filenames[i], itemcount);
+        Project* project = new Project(NULL);
+        project->SetFileName(filenames[i]);
+        projects.Add(project);
+        loader.Add(project);
+    }
+    loader.Run();
+    // The temporary file of the broken project can not be created
+    wxMkdir(filenames[broken] + _T(".tmp"));
+    ProjectLoader saver;
+    for (size_t i=0; i<projectcount; ++i)
+    {
+        Project* project = projects.ItemUnchecked(i);
+        project->SetName(wxString::Format(_T("Saved %u"), (unsigned int)i));
+        saver.AddSave(project);
+    }
+    wxStopWatch watch;
+    saver.Run();
+    long savetime = watch.Time();
+    bool ok = true;
+    for (size_t i=0; i<projectcount; ++i)
+    {
+        wxLogBuffer* buffer = new wxLogBuffer();
+        wxLog* oldlog = wxLog::SetActiveTarget(buffer);
+        saver.LogMessages(i);
+        wxLog::SetActiveTarget(oldlog);
+        ok = ok && saver.GetResult(i) == (i != broken);
+        ok = ok && saver.GetProject(i) == projects.ItemUnchecked(i);
+        ok = ok && (buffer->GetBuffer().IsEmpty() == (i != broken));
+        delete buffer;
+        // Reload the file and check the name
+        Project* project = new Project(NULL);
+        project->SetFileName(filenames[i]);
+        ok = ok && project->Load();
+        ok = ok && project->GetProjectItemList()->Count() == itemcount;
+        if (i == broken) {
+            ok = ok && project->GetName() == _T("Streaming & Test");
+        } else {
+            ok = ok && project->GetName() == wxString::Format(_T("Saved %u"), (unsigned int)i);
+            ok = ok && !wxFile::Exists(filenames[i] + _T(".tmp"));
+        }
+        delete project;
+    }
+    wxRmdir(filenames[broken] + _T(".tmp"));
+    for (size_t i=0; i<projectcount; ++i) wxRemoveFile(filenames[i]);
+    wxString call = wxString::Format(_T("ProjectLoader::AddSave(), %u projects with %u items"), (unsigned int)projectcount, (unsigned int)itemcount);
+    wxString result = wxString::Format(_T("%u threads %li ms"), (unsigned int)saver.GetThreadCount(), savetime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestModifiedCounters()
+{
+    // Builds project > subproject > directory > file, a change of the
+    //   file must reach the workspace list without a full scan
+    WorkspaceList* list = Environment::Get()->GetWorkspaceList();
+    bool before = list->IsWorkspaceOrProjectModified();
+    Workspace* workspace = new Workspace();
+    Project* project = new Project(NULL);
+    workspace->GetProjectList()->Add(project);
+    ProjectItemList* items = project->GetProjectItemList();
+    ProjectItemSubProject* subproject = (ProjectItemSubProject*)items->CreateProjectItem(penvPI_SubProject);
+    items->Add(subproject);
+    ProjectItemList* subitems = subproject->Project::GetProjectItemList();
+    ProjectItem* directory = subitems->CreateProjectItem(penvPI_Directory);
+    subitems->Add(directory);
+    project->Modified(false);
+    workspace->Modified(false);
+    list->Add(workspace);
+    bool ok = !subproject->Project::IsModified();
+    ok = ok && workspace->GetModifiedProjectCount() == 0;
+    ok = ok && list->IsWorkspaceOrProjectModified() == before;
+    // Change deep in the hierarchy
+    directory->GetItemList()->Add(directory->GetItemList()->CreateProjectItem(penvPI_File));
+    ok = ok && subproject->Project::IsModified() && project->IsModified();
+    ok = ok && workspace->GetModifiedProjectCount() == 1;
+    ok = ok && list->IsWorkspaceOrProjectModified();
+    Array<Workspace> workspaces(false);
+    Array<Project> projects(false);
+    list->GetModified(&workspaces, &projects);
+    ok = ok && std::find(projects.begin(), projects.end(), project) != projects.end();
+    ok = ok && std::find(workspaces.begin(), workspaces.end(), workspace) == workspaces.end();
+    workspaces.Clear(false);
+    projects.Clear(false);
+    // Repeated changes do not count twice
+    directory->GetItemList()->Add(directory->GetItemList()->CreateProjectItem(penvPI_File));
+    ok = ok && workspace->GetModifiedProjectCount() == 1;
+    wxStopWatch watch;
+    const size_t calls = 1000000;
+    size_t modified = 0;
+    for (size_t i=0; i<calls; ++i)
+    {
+        if (list->IsWorkspaceOrProjectModified()) modified++;
+    }
+    long checktime = watch.Time();
+    ok = ok && modified == calls;
+    // Saving resets the project and its subprojects
+    project->Modified(false);
+    ok = ok && !subproject->Project::IsModified();
+    ok = ok && workspace->GetModifiedProjectCount() == 0;
+    ok = ok && list->IsWorkspaceOrProjectModified() == before;
+    project->SetName(_T("Modified"));
+    ok = ok && list->IsWorkspaceOrProjectModified();
+    list->Remove(list->GetItemIndex(workspace));
+    ok = ok && list->IsWorkspaceOrProjectModified() == before;
+    wxString call = wxString::Format(_T("WorkspaceList::IsWorkspaceOrProjectModified(), %u calls"), (unsigned int)calls);
+    wxString result = wxString::Format(_T("%li ms"), checktime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // Loading a project and reading all its items marks nothing
+    //   as modified
+    wxString filename = wxFileName::CreateTempFileName(_T("penv"));
+    CreateTestDirectoryProjectFile(filename, 10, 10);
+    Workspace* loadworkspace = new Workspace();
+    Project* loadproject = new Project(NULL);
+    loadproject->SetFileName(filename);
+    loadworkspace->GetProjectList()->Add(loadproject);
+    loadproject->Modified(false);
+    loadworkspace->Modified(false);
+    list->Add(loadworkspace);
+    ok = loadproject->Load();
+    ok = ok && loadproject->GetProjectItemList()->LoadItems(true);
+    ok = ok && loadproject->GetProjectItemList()->GetItem(0)->GetItemList()->Count() == 10;
+    ok = ok && !loadproject->IsModified();
+    ok = ok && loadworkspace->GetModifiedProjectCount() == 0;
+    ok = ok && list->IsWorkspaceOrProjectModified() == before;
+    list->Remove(list->GetItemIndex(loadworkspace));
+    wxRemoveFile(filename);
+    AppendHtml(_T("Project::Load(), modified counters after loading"), _T("no project modified"));
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestCopyOnWriteClone()
+{
+    // Clones a subproject with 50 directories of 1000 files and changes
+    //   one file, only the lists on the path to the file are copied
+    const size_t dircount = 50;
+    const size_t filecount = 1000;
+    Project* project = new Project(NULL);
+    ProjectItemList* items = project->GetProjectItemList();
+    ProjectItemSubProject* subproject = (ProjectItemSubProject*)items->CreateProjectItem(penvPI_SubProject);
+    items->Add(subproject);
+    ProjectItemList* subitems = subproject->Project::GetProjectItemList();
+    for (size_t i=0; i<dircount; ++i)
+    {
+        ProjectItem* directory = subitems->CreateProjectItem(penvPI_Directory);
+        directory->SetName(wxString::Format(_T("dir%u"), (unsigned int)i));
+        subitems->Add(directory);
+        ProjectItemList* files = directory->GetItemList();
+        for (size_t j=0; j<filecount; ++j)
+        {
+            ProjectItem* file = files->CreateProjectItem(penvPI_File);
+            file->SetName(wxString::Format(_T("file%u.cpp"), (unsigned int)j));
+            file->GetPropertyList()->Set(_T("size"), (int)j);
+            files->Add(file);
+        }
+    }
+    wxStopWatch watch;
+    ProjectItem* clone = subproject->Clone();
+    items->Add(clone);
+    long clonetime = watch.Time();
+    watch.Start();
+    ProjectItem* leaf = clone->GetItemList()->GetItem(7)->GetItemList()->GetItem(42);
+    leaf->SetName(_T("changed.cpp"));
+    leaf->GetPropertyList()->Set(_T("size"), -1);
+    long changetime = watch.Time();
+    // The original is unchanged, the other directories are not copied
+    ProjectItem* original = subitems->GetItem(7)->GetItemList()->GetItem(42);
+    bool ok = original->GetName() == _T("file42.cpp");
+    ok = ok && original->GetPropertyList()->GetInteger(_T("size")) == 42;
+    ok = ok && leaf->GetPropertyList()->GetInteger(_T("size")) == -1;
+    ok = ok && clone->GetItemList()->GetItem(8)->GetItemList()->IsDeferred();
+    ok = ok && ProjectItemList::HasPendingClones();
+    // Changing the original copies the directory into the clone first
+    subitems->GetItem(8)->GetItemList()->GetItem(3)->SetName(_T("renamed.cpp"));
+    ok = ok && !clone->GetItemList()->GetItem(8)->GetItemList()->IsDeferred();
+    ok = ok && clone->GetItemList()->GetItem(8)->GetItemList()->GetItem(3)->GetName() == _T("file3.cpp");
+    // Copy the rest of the clone
+    watch.Start();
+    clone->GetItemList()->LoadItems(true);
+    long copytime = watch.Time();
+    size_t count = 0;
+    for (size_t i=0; i<clone->GetItemList()->Count(); ++i)
+    {
+        count += clone->GetItemList()->GetItem(i)->GetItemList()->Count();
+    }
+    ok = ok && count == dircount*filecount;
+    ok = ok && !ProjectItemList::HasPendingClones();
+    delete project;
+    wxString call = wxString::Format(_T("ProjectItemSubProject::Clone(), %u items, change one item"), (unsigned int)(dircount*filecount));
+    wxString result = wxString::Format(_T("clone %li ms, change %li ms, copy rest %li ms"), clonetime, changetime, copytime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestDirectoryWatcher()
+{
+    // Watches a directory with 3 files, creates 50 files at once,
+    //   removes one file and renames another
+    const size_t count = 50;
+    wxString directory = wxFileName::CreateTempFileName(_T("penv"));
+    wxRemoveFile(directory);
+    wxMkdir(directory);
+    Project* project = new Project(NULL);
+    ProjectItemList* items = project->GetProjectItemList();
+    ProjectItemDirectory* dir = (ProjectItemDirectory*)items->CreateProjectItem(penvPI_Directory);
+    dir->SetName(_T("watched"));
+    items->Add(dir);
+    ProjectItemList* files = dir->GetItemList();
+    for (size_t i=0; i<3; ++i)
+    {
+        wxString filename = Path::Combine(directory, wxString::Format(_T("old%u.txt"), (unsigned int)i));
+        wxFile file(filename, wxFile::write);
+        ProjectItemFile* item = (ProjectItemFile*)files->CreateProjectItem(penvPI_File);
+        item->SetName(wxString::Format(_T("old%u.txt"), (unsigned int)i));
+        item->SetPath(filename);
+        files->Add(item);
+    }
+    DirectoryWatcher* watcher = Environment::Get()->GetWorkspaceList()->GetDirectoryWatcher();
+    size_t watched = watcher->Count();
+    dir->SetPath(directory);
+    wxStopWatch watch;
+    for (size_t i=0; i<count; ++i)
+    {
+        wxFile file(Path::Combine(directory, wxString::Format(_T("new%u.txt"), (unsigned int)i)), wxFile::write);
+    }
+    wxRemoveFile(Path::Combine(directory, _T("old0.txt")));
+    wxRenameFile(Path::Combine(directory, _T("old1.txt")), Path::Combine(directory, _T("renamed.txt")));
+    // Wait until the thread has posted the changes after the delay
+    bool renamed = false;
+    while (watch.Time() < 10000)
+    {
+        wxMilliSleep(50);
+        watcher->ProcessChanges();
+        renamed = false;
+        for (size_t i=0; i<files->Count(); ++i)
+        {
+            if (files->GetItem(i)->GetName() == _T("renamed.txt")) renamed = true;
+        }
+        if (renamed && files->Count() == count+2) break;
+    }
+    long time = watch.Time();
+    bool ok = renamed && files->Count() == count+2;
+    for (size_t i=0; i<files->Count(); ++i)
+    {
+        ok = ok && files->GetItem(i)->GetName() != _T("old0.txt");
+        ok = ok && files->GetItem(i)->GetName() != _T("old1.txt");
+    }
+    bool polling = watcher->IsPolling();
+    delete project;
+    ok = ok && watcher->Count() == watched;
+    for (size_t i=0; i<count; ++i)
+    {
+        wxRemoveFile(Path::Combine(directory, wxString::Format(_T("new%u.txt"), (unsigned int)i)));
+    }
+    wxRemoveFile(Path::Combine(directory, _T("old2.txt")));
+    wxRemoveFile(Path::Combine(directory, _T("renamed.txt")));
+    wxRmdir(directory);
+    wxString call = wxString::Format(_T("DirectoryWatcher, %u files created, 1 removed, 1 renamed"), (unsigned int)count);
+    wxString result = wxString::Format(_T("%s, applied after %li ms"), (polling ? _T("polling") : _T("inotify")), time);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+/**
+ * \brief Project tree control for the tests, which shows a single
+ * project without a workspace list.
+ **/
+class UnitTestProjectTreeCtrl : public ProjectTreeCtrl
+{
+    public:
+        UnitTestProjectTreeCtrl(wxWindow* parent) : ProjectTreeCtrl(parent) {}
+        wxTreeItemId ShowProject(Project* project, bool recursiv)
+        {
+            ClearTreeItems();
+            m_rootid = m_treectrl->AddRoot(_T("Workspaces"), -1, -1, NULL);
+            wxTreeItemId id = AddProject(m_rootid, project);
+            AddChildItems(id, project->GetProjectItemList(), recursiv);
+            return (id);
+        }
+        void StoreKeys()
+        {
+            m_keys.clear();
+            GetTreeItemKeys(&m_keys, m_rootid);
+        }
+        void SyncProject(wxTreeItemId id, Project* project)
+        {
+            ProjectTreeItemData* data = (ProjectTreeItemData*)m_treectrl->GetItemData(id);
+            data->SetProject(project);
+            m_treeitems->clear();
+            m_treectrl->Freeze();
+            SyncTreeItems(id, data, m_keys);
+            m_treectrl->Thaw();
+        }
+    private:
+        TreeItemKeyHashMap m_keys;
+};
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestProjectTreeSearch()
+{
+    // Shows 100 directories of 1000 files and searches 10000 tree
+    //   items, then deletes a directory from the tree
+    const size_t dircount = 100;
+    const size_t filecount = 1000;
+    const size_t searchcount = 10000;
+    Project* project = new Project(NULL);
+    ProjectItemList* items = project->GetProjectItemList();
+    for (size_t i=0; i<dircount; ++i)
+    {
+        ProjectItem* directory = items->CreateProjectItem(penvPI_Directory);
+        directory->SetName(wxString::Format(_T("dir%u"), (unsigned int)i));
+        items->Add(directory);
+        ProjectItemList* files = directory->GetItemList();
+        for (size_t j=0; j<filecount; ++j)
+        {
+            ProjectItem* file = files->CreateProjectItem(penvPI_File);
+            file->SetName(wxString::Format(_T("file%u.cpp"), (unsigned int)j));
+            files->Add(file);
+        }
+    }
+    UnitTestProjectTreeCtrl* tree = new UnitTestProjectTreeCtrl(Environment::Get()->GetFrame());
+    tree->Hide();
+    wxStopWatch watch;
+    tree->ShowProject(project, true);
+    long filltime = watch.Time();
+    bool ok = tree->SearchItem(project).IsOk();
+    watch.Start();
+    for (size_t i=0; i<searchcount; ++i)
+    {
+        ProjectItem* item = items->GetItem((i*7) % dircount)->GetItemList()->GetItem((i*13) % filecount);
+        ProjectTreeItemId id = tree->SearchItem(item);
+        ok = ok && id.IsOk() && tree->GetTreeCtrl()->GetItemText(id.GetId()) == item->GetName();
+    }
+    long searchtime = watch.Time();
+    // Deleted tree items are not found anymore
+    ProjectItem* directory = items->GetItem(3);
+    ProjectTreeItemId dirid = tree->SearchItem(directory);
+    ok = ok && dirid.IsOk();
+    tree->GetTreeCtrl()->Delete(dirid.GetId());
+    ok = ok && !tree->SearchItem(directory).IsOk();
+    ok = ok && !tree->SearchItem(directory->GetItemList()->GetItem(0)).IsOk();
+    ok = ok && tree->SearchItem(items->GetItem(4)->GetItemList()->GetItem(0)).IsOk();
+    tree->Destroy();
+    delete project;
+    wxString call = wxString::Format(_T("ProjectTreeCtrl::SearchItem(), %u searches in %u tree items"), (unsigned int)searchcount, (unsigned int)(dircount*(filecount+1)+1));
+    wxString result = wxString::Format(_T("fill %li ms, search %li ms"), filltime, searchtime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestLazyProjectTree()
+{
+    // Shows 200 directories of 1000 files, only the tree items of
+    //   the expanded project and the shown directory are created
+    const size_t dircount = 200;
+    const size_t filecount = 1000;
+    Project* project = new Project(NULL);
+    ProjectItemList* items = project->GetProjectItemList();
+    for (size_t i=0; i<dircount; ++i)
+    {
+        ProjectItem* directory = items->CreateProjectItem(penvPI_Directory);
+        directory->SetName(wxString::Format(_T("dir%u"), (unsigned int)i));
+        items->Add(directory);
+        ProjectItemList* files = directory->GetItemList();
+        for (size_t j=0; j<filecount; ++j)
+        {
+            ProjectItem* file = files->CreateProjectItem(penvPI_File);
+            file->SetName(wxString::Format(_T("file%u.cpp"), (unsigned int)j));
+            files->Add(file);
+        }
+    }
+    UnitTestProjectTreeCtrl* tree = new UnitTestProjectTreeCtrl(Environment::Get()->GetFrame());
+    tree->Hide();
+    wxTreeCtrl* treectrl = tree->GetTreeCtrl();
+    wxStopWatch watch;
+    wxTreeItemId projectid = tree->ShowProject(project, false);
+    long filltime = watch.Time();
+    bool ok = treectrl->GetCount() == 2;
+    ok = ok && treectrl->ItemHasChildren(projectid);
+    watch.Start();
+    treectrl->Expand(projectid);
+    long expandtime = watch.Time();
+    ok = ok && treectrl->GetCount() == 2+dircount;
+    // Showing a file adds the tree items of its directory
+    ProjectItem* file = items->GetItem(5)->GetItemList()->GetItem(42);
+    ok = ok && !tree->SearchItem(file).IsOk();
+    ok = ok && tree->ShowItem(file).IsOk();
+    ok = ok && treectrl->GetCount() == 2+dircount+filecount;
+    // Collapsing the directory releases the tree items again
+    wxTreeItemId dirid = tree->SearchItem(items->GetItem(5)).GetId();
+    treectrl->Expand(dirid);
+    treectrl->Collapse(dirid);
+    ok = ok && treectrl->GetCount() == 2+dircount;
+    ok = ok && !tree->SearchItem(file).IsOk();
+    ok = ok && treectrl->ItemHasChildren(dirid);
+    tree->Destroy();
+    delete project;
+    wxString call = wxString::Format(_T("ProjectTreeCtrl, %u project items, expand project"), (unsigned int)(dircount*(filecount+1)));
+    wxString result = wxString::Format(_T("fill %li ms, expand %li ms"), filltime, expandtime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+static Project* CreateTreeTestProject(size_t dircount, size_t filecount, bool changed)
+{
+    // Creates a project with directories of files, if changed is true
+    //   with 10 changes: 4 files renamed, 3 removed, 2 added and two
+    //   directories swapped
+    Project* project = new Project(NULL);
+    ProjectItemList* items = project->GetProjectItemList();
+    for (size_t i=0; i<dircount; ++i)
+    {
+        size_t dir = i;
+        if (changed && i == 60) dir = 61;
+        if (changed && i == 61) dir = 60;
+        ProjectItem* directory = items->CreateProjectItem(penvPI_Directory);
+        directory->SetName(wxString::Format(_T("dir%u"), (unsigned int)dir));
+        items->Add(directory);
+        ProjectItemList* files = directory->GetItemList();
+        for (size_t j=0; j<filecount; ++j)
+        {
+            if (changed && dir == 20 && j < 3) continue;
+            ProjectItem* file = files->CreateProjectItem(penvPI_File);
+            if (changed && dir == 10 && j >= 1 && j <= 4) {
+                file->SetName(wxString::Format(_T("renamed%u.cpp"), (unsigned int)j));
+            } else {
+                file->SetName(wxString::Format(_T("file%u.cpp"), (unsigned int)j));
+            }
+            files->Add(file);
+        }
+        for (size_t j=0; changed && dir == 30 && j<2; ++j)
+        {
+            ProjectItem* file = files->CreateProjectItem(penvPI_File);
+            file->SetName(wxString::Format(_T("new%u.cpp"), (unsigned int)j));
+            files->Add(file);
+        }
+    }
+    return (project);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestProjectTreeRefresh()
+{
+    // Refreshes a tree of 100 directories of 1000 files after 10
+    //   changes, compared with a rebuild of the tree
+    const size_t dircount = 100;
+    const size_t filecount = 1000;
+    Project* project = CreateTreeTestProject(dircount, filecount, false);
+    Project* changed = CreateTreeTestProject(dircount, filecount, true);
+    UnitTestProjectTreeCtrl* tree = new UnitTestProjectTreeCtrl(Environment::Get()->GetFrame());
+    tree->Hide();
+    wxTreeCtrl* treectrl = tree->GetTreeCtrl();
+    wxTreeItemId projectid = tree->ShowProject(project, true);
+    wxTreeItemId dirid = tree->SearchItem(project->GetProjectItemList()->GetItem(50)).GetId();
+    // The old project is deleted before the refresh, like on a reload
+    tree->StoreKeys();
+    delete project;
+    wxStopWatch watch;
+    tree->SyncProject(projectid, changed);
+    long synctime = watch.Time();
+    ProjectItemList* items = changed->GetProjectItemList();
+    bool ok = treectrl->GetCount() == 2+dircount+dircount*filecount-3+2;
+    ok = ok && tree->SearchItem(items->GetItem(50)).GetId() == dirid;
+    ok = ok && tree->SearchItem(items->GetItem(10)->GetItemList()->GetItem(2)).IsOk();
+    ok = ok && tree->SearchItem(items->GetItem(30)->GetItemList()->GetItem(filecount+1)).IsOk();
+    ok = ok && treectrl->GetItemText(tree->SearchItem(items->GetItem(60)).GetId()) == _T("dir61");
+    ok = ok && treectrl->GetNextSibling(tree->SearchItem(items->GetItem(60)).GetId()) ==
+        tree->SearchItem(items->GetItem(61)).GetId();
+    for (size_t i=0; i<dircount; ++i)
+    {
+        ok = ok && treectrl->GetChildrenCount(tree->SearchItem(items->GetItem(i)).GetId(), false) ==
+            items->GetItem(i)->GetItemList()->Count();
+    }
+    watch.Start();
+    tree->ShowProject(changed, true);
+    long rebuildtime = watch.Time();
+    tree->Destroy();
+    delete changed;
+    wxString call = wxString::Format(_T("ProjectTreeCtrl::SyncTreeItems(), %u tree items, 10 changes"), (unsigned int)(dircount*(filecount+1)+2));
+    wxString result = wxString::Format(_T("refresh %li ms, rebuild %li ms"), synctime, rebuildtime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestProjectTreeFilter()
+{
+    // Searches a workspace of 100 directories of 1000 files by name
+    //   and by path
+    const size_t dircount = 100;
+    const size_t filecount = 1000;
+    WorkspaceList* list = Environment::Get()->GetWorkspaceList();
+    Workspace* workspace = new Workspace();
+    workspace->SetName(_T("FilterWorkspace"));
+    Project* project = CreateTreeTestProject(dircount, filecount, false);
+    project->SetName(_T("FilterProject"));
+    workspace->GetProjectList()->Add(project);
+    list->Add(workspace);
+    ProjectItemList* items = project->GetProjectItemList();
+    ProjectTreeFilter* filter = new ProjectTreeFilter();
+    wxStopWatch watch;
+    filter->Build(list);
+    long buildtime = watch.Time();
+    size_t before = filter->Count();
+    bool ok = filter->IsValid() && before >= 2+dircount*(filecount+1);
+    wxArrayInt results;
+    // Exact names are found first, then the best fuzzy matches
+    ok = ok && filter->Find(_T("dir42"), &results) > 0;
+    ok = ok && filter->GetEntry(results[0], NULL)->GetProjectItem() == items->GetItem(42);
+    ok = ok && filter->Find(_T("File42.cpp"), &results) == penvPROJECTTREEFILTER_MAXRESULTS;
+    ok = ok && filter->GetEntry(results[0], NULL)->GetProjectItem()->GetName() == _T("file42.cpp");
+    ok = ok && filter->Find(_T("flprj"), &results) > 0;
+    ok = ok && filter->GetEntry(results[0], NULL)->GetProject() == project;
+    // Paths are separated by slashes or backslashes
+    ok = ok && filter->Find(_T("dir42\\file7.cpp"), &results) > 0;
+    ok = ok && filter->GetEntry(results[0], NULL)->GetProjectItem() ==
+        items->GetItem(42)->GetItemList()->GetItem(7);
+    int parent = -1;
+    ok = ok && filter->GetEntry(results[0], &parent) != NULL && parent >= 0;
+    ok = ok && filter->GetEntry(parent, NULL)->GetProjectItem() == items->GetItem(42);
+    ok = ok && filter->Find(_T("xyz"), &results) == 0;
+    const size_t searches = 100;
+    watch.Start();
+    for (size_t i=0; i<searches; ++i)
+    {
+        filter->Find(wxString::Format(_T("f%u"), (unsigned int)i), &results);
+    }
+    long searchtime = watch.Time();
+    filter->Invalidate();
+    ok = ok && !filter->IsValid();
+    delete filter;
+    list->Remove(list->GetItemIndex(workspace));
+    wxString call = wxString::Format(_T("ProjectTreeFilter::Find(), %u entries, %u searches"), (unsigned int)before, (unsigned int)searches);
+    wxString result = wxString::Format(_T("build %li ms, search %li ms"), buildtime, searchtime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
+
+
+//----------------------------------------------------------------
+void UnitTestDocument::TestProjectTreeBatch()
+{
+    // Moves 500 files from 10 directories into one directory with one
+    //   event, then copies, removes and serializes a selection
+    const size_t dircount = 10;
+    const size_t filecount = 100;
+    WorkspaceList* list = Environment::Get()->GetWorkspaceList();
+    Workspace* workspace = new Workspace();
+    workspace->SetName(_T("BatchWorkspace"));
+    Project* project = CreateTreeTestProject(dircount, filecount, false);
+    project->SetName(_T("BatchProject"));
+    workspace->GetProjectList()->Add(project);
+    list->Add(workspace);
+    ProjectItemList* items = project->GetProjectItemList();
+    ProjectItem* target = items->CreateProjectItem(penvPI_Directory);
+    target->SetName(_T("target"));
+    items->Add(target);
+    ProjectItemList* targetitems = target->GetItemList();
+
+    Array<ProjectItem> moved(false);
+    for (size_t i=0; i<dircount; ++i)
+    {
+        for (size_t j=0; j<filecount/2; ++j)
+        {
+            moved.Add(items->GetItem(i)->GetItemList()->GetItem(j));
+        }
+    }
+    Command* cmd = Environment::Get()->GetCommandList()->GetCommand(penvCE_ProjectItemMoved);
+    size_t connectid = cmd->Connect(new CommandCallback<UnitTestDocument>(this, &UnitTestDocument::OnTestCommandPosted));
+    m_postedcount = 0;
+    wxStopWatch watch;
+    size_t count = ProjectItemList::MoveProjectItems(&moved, targetitems);
+    long movetime = watch.Time();
+    size_t events = m_postedcount;
+    cmd->Disconnect(connectid);
+    bool ok = count == moved.Count() && events == 1 && targetitems->Count() == moved.Count();
+    ok = ok && items->GetItem(0)->GetItemList()->Count() == filecount/2;
+    ok = ok && moved.ItemUnchecked(0)->GetParent() == targetitems;
+    ok = ok && items->GetItem(9)->GetItemList()->GetItem(0)->GetName() == _T("file50.cpp");
+    // A directory can not be moved or copied below itself
+    Array<ProjectItem> self(false);
+    self.Add(target);
+    {
+        wxLogNull nolog;
+        ok = ok && ProjectItemList::MoveProjectItems(&self, targetitems) == 0;
+        ok = ok && ProjectItemList::CopyProjectItems(&self, targetitems) == 0;
+    }
+    wxString call = wxString::Format(_T("ProjectItemList::MoveProjectItems(), %u files from %u directories"),
+        (unsigned int)moved.Count(), (unsigned int)dircount);
+    wxString result = wxString::Format(_T("moved %u, %u event, %li ms"), (unsigned int)count, (unsigned int)events, movetime);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // Copies two directories, then removes a directory together with
+    //   one of its files, the file is only removed once
+    Array<ProjectItem> copied(false);
+    copied.Add(items->GetItem(1));
+    copied.Add(items->GetItem(2));
+    ok = ProjectItemList::CopyProjectItems(&copied, targetitems) == 2;
+    ok = ok && targetitems->Count() == moved.Count()+2 && items->Count() == dircount+1;
+    ok = ok && targetitems->GetItem(moved.Count())->GetItemList()->Count() == filecount/2;
+    Array<ProjectItem> removed(false);
+    removed.Add(items->GetItem(3));
+    removed.Add(items->GetItem(3)->GetItemList()->GetItem(0));
+    removed.Add(targetitems->GetItem(0));
+    ok = ok && ProjectItemList::RemoveProjectItems(&removed) == 2;
+    ok = ok && items->Count() == dircount && targetitems->Count() == moved.Count()+1;
+    call = _T("ProjectItemList::CopyProjectItems(), RemoveProjectItems()");
+    result = wxString::Format(_T("%u items in target"), (unsigned int)targetitems->Count());
+    AppendHtml(call, result);
+    AppendHtml(ok);
+
+    // Serializes all items of the target directory
+    ProjectTreeItemDataObject object;
+    for (size_t i=0; i<targetitems->Count(); ++i)
+    {
+        object.Add(new ProjectTreeItemDataBase(targetitems->GetItem(i)));
+    }
+    size_t size = object.GetDataSize();
+    char* buffer = new char[size];
+    ok = object.GetDataHere(buffer);
+    ProjectTreeItemDataObject copy;
+    ok = ok && copy.SetData(size, buffer) && copy.Count() == object.Count();
+    for (size_t i=0; ok && i<copy.Count(); ++i)
+    {
+        ok = copy.GetItem(i)->GetType() == penvTI_ProjectItem &&
+            copy.GetItem(i)->GetProjectItem() == targetitems->GetItem(i);
+    }
+    ok = ok && copy.GetProjectItem() == targetitems->GetItem(0);
+    delete [] buffer;
+    list->Remove(list->GetItemIndex(workspace));
+    call = wxString::Format(_T("ProjectTreeItemDataObject::SetData(), %u items"), (unsigned int)object.Count());
+    result = wxString::Format(_T("%u bytes"), (unsigned int)size);
+    AppendHtml(call, result);
+    AppendHtml(ok);
+}
@@ -19,6 +19,7 @@ UnitTestDocument::UnitTestDocument()
  **/
 {
     m_unittests = NULL;
+    m_postedcount = 0;
 }
 
 
@@ -49,8 +49,33 @@ class UnitTestDocument : public penv::WindowDocument
 
 		void TestPathClass();
 		void TestArrayClass();
+		void TestArrayBenchmark();
+		void TestMemoryPoolBenchmark();
+		void TestCommandHandles();
+		void TestCommandPost();
+		void TestCommandProfiler();
+		void TestCommandItemIndex();
+		void TestCommandUpdate();
+		void OnTestCommandPosted(penv::CommandEvent& event);
 		void TestVersionClass();
 		void TestPropertyClass();
+		void TestPropertyListPathCache();
+		void TestPropertyArrays();
+		void TestStreamingXmlLoader();
+		void TestStreamingXmlWriter();
+		void TestParallelProjectLoader();
+		void TestLazyProjectItems();
+		void TestWorkspaceSnapshot();
+		void TestPathChecker();
+		void TestParallelProjectSaver();
+		void TestModifiedCounters();
+		void TestCopyOnWriteClone();
+		void TestDirectoryWatcher();
+		void TestProjectTreeSearch();
+		void TestLazyProjectTree();
+		void TestProjectTreeRefresh();
+		void TestProjectTreeFilter();
+		void TestProjectTreeBatch();
 		void TestProjectTreeItemData();
 
 
@@ -63,6 +88,8 @@ class UnitTestDocument : public penv::WindowDocument
 		wxString m_htmltext;
         WX_DECLARE_STRING_HASH_MAP(UnitTestFunction, UnitTestHashMap);
         UnitTestHashMap* m_unittests;
+        size_t m_postedcount;
+        wxString m_postedstring;
 };
 
 
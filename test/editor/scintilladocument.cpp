@@ -17,6 +17,13 @@ ScintillaDocument::ScintillaDocument()
  * \brief
  **/
 {
+    // Resolve the command ids once, they are used on every page change
+    penv::CommandList* list = penv::Environment::Get()->GetCommandList();
+    m_commands[0] = list->GetHandle(_T("EDITOR_FILE_SAVE"));
+    m_commands[1] = list->GetHandle(_T("EDITOR_FILE_SAVEAS"));
+    m_commands[2] = list->GetHandle(_T("EDITOR_FILE_CLOSE"));
+    m_commands[3] = list->GetHandle(_T("EDITOR_ZOOM_OUT"));
+    m_commands[4] = list->GetHandle(_T("EDITOR_ZOOM_IN"));
 }
 
 
@@ -129,12 +136,7 @@ void ScintillaDocument::OnPageAfterChange()
  **/
 {
     // Enable Commands
-    penv::CommandList* list = penv::Environment::Get()->GetCommandList();
-    list->GetCommand(_T("EDITOR_FILE_SAVE"))->Enable(true);
-    list->GetCommand(_T("EDITOR_FILE_SAVEAS"))->Enable(true);
-    list->GetCommand(_T("EDITOR_FILE_CLOSE"))->Enable(true);
-    list->GetCommand(_T("EDITOR_ZOOM_OUT"))->Enable(true);
-    list->GetCommand(_T("EDITOR_ZOOM_IN"))->Enable(true);
+    EnableCommands(true);
     // Update Window
     Update();
 }
@@ -148,12 +150,23 @@ void ScintillaDocument::OnPageBeforeHidden()
  **/
 {
     // Disable Commands
+    EnableCommands(false);
+}
+
+
+//----------------------------------------------------------------
+void ScintillaDocument::EnableCommands(bool enable)
+/**
+ * \brief Enables or disables the editor commands.
+ * \param enable True to enable the commands.
+ **/
+{
     penv::CommandList* list = penv::Environment::Get()->GetCommandList();
-    list->GetCommand(_T("EDITOR_FILE_SAVE"))->Enable(false);
-    list->GetCommand(_T("EDITOR_FILE_SAVEAS"))->Enable(false);
-    list->GetCommand(_T("EDITOR_FILE_CLOSE"))->Enable(false);
-    list->GetCommand(_T("EDITOR_ZOOM_OUT"))->Enable(false);
-    list->GetCommand(_T("EDITOR_ZOOM_IN"))->Enable(false);
+    for (size_t i=0; i<WXSIZEOF(m_commands); ++i)
+    {
+        penv::Command* cmd = list->GetCommand(m_commands[i]);
+        if (cmd != NULL) cmd->Enable(enable);
+    }
 }
 
 
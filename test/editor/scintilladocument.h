@@ -35,6 +35,7 @@ class ScintillaDocument : public penv::WindowDocument
         virtual void OnPageAfterChange();
         virtual void OnPageBeforeHidden();
         virtual void OnDocumentModified(wxScintillaEvent& event);
+        void EnableCommands(bool enable);
 
     public:
         void ZoomIn();
@@ -43,6 +44,7 @@ class ScintillaDocument : public penv::WindowDocument
     protected:
         wxPanel*     m_panel;
         wxScintilla* m_scintilla;
+        penv::CommandHandle m_commands[5];
 };
 
 